@@ -0,0 +1,171 @@
+#include "paradice/command_table.hpp"
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+//* =========================================================================
+//  Measures the cost of finding the command that a player typed, as
+//  happens for every line of input.  The linear, lower-casing search that
+//  the command table replaced is measured alongside for comparison.
+//* =========================================================================
+namespace {
+
+std::size_t calls = 0;
+
+void count_call(
+    std::shared_ptr<paradice::context> &
+  , boost::string_view
+  , std::shared_ptr<paradice::client>  &)
+{
+    ++calls;
+}
+
+#define BENCHMARK_ENTRY(name) { name, count_call, 0, 0, false }
+
+paradice::command_table const commands =
+{
+    BENCHMARK_ENTRY("!")
+  , BENCHMARK_ENTRY("say")
+  , BENCHMARK_ENTRY(".")
+  , BENCHMARK_ENTRY("whisper")
+  , BENCHMARK_ENTRY(">")
+  , BENCHMARK_ENTRY("emote")
+  , BENCHMARK_ENTRY(":")
+  , BENCHMARK_ENTRY("set")
+  , BENCHMARK_ENTRY("title")
+  , BENCHMARK_ENTRY("surname")
+  , BENCHMARK_ENTRY("prefix")
+  , BENCHMARK_ENTRY("honorific")
+  , BENCHMARK_ENTRY("roll")
+  , BENCHMARK_ENTRY("rollprivate")
+  , BENCHMARK_ENTRY("showrolls")
+  , BENCHMARK_ENTRY("clearrolls")
+  , BENCHMARK_ENTRY("table")
+  , BENCHMARK_ENTRY("help")
+  , BENCHMARK_ENTRY("password")
+  , BENCHMARK_ENTRY("quit")
+  , BENCHMARK_ENTRY("logout")
+  , BENCHMARK_ENTRY("gm")
+  , BENCHMARK_ENTRY("admin_set_password")
+  , BENCHMARK_ENTRY("admin_shutdown")
+  , BENCHMARK_ENTRY("admin_restart")
+  , BENCHMARK_ENTRY("admin_stats")
+  , BENCHMARK_ENTRY("admin_trace")
+};
+
+#undef BENCHMARK_ENTRY
+
+struct linear_command
+{
+    std::string                             name_;
+    paradice::command_table::function_type  function_;
+};
+
+std::vector<linear_command> make_linear_commands()
+{
+    std::vector<linear_command> linear;
+
+    for (auto const &name : {
+        "!", "say", ".", "whisper", ">", "emote", ":", "set", "title",
+        "surname", "prefix", "honorific", "roll", "rollprivate", "showrolls",
+        "clearrolls", "table", "help", "password", "quit", "logout", "gm",
+        "admin_set_password", "admin_shutdown", "admin_restart",
+        "admin_stats", "admin_trace" })
+    {
+        linear.push_back({ name, count_call });
+    }
+
+    return linear;
+}
+
+std::shared_ptr<paradice::context> ctx;
+std::shared_ptr<paradice::client>  player;
+boost::string_view                 arguments;
+
+void dispatch_table(std::string const &name)
+{
+    auto const found = commands.find(name);
+
+    if (found.command_ != nullptr)
+    {
+        found.command_->function_(ctx, arguments, player);
+    }
+}
+
+void dispatch_linear(
+    std::vector<linear_command> const &linear
+  , std::string                        name)
+{
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    for (auto const &cmd : linear)
+    {
+        if (cmd.name_ == name)
+        {
+            cmd.function_(ctx, arguments, player);
+            return;
+        }
+    }
+}
+
+template <class Dispatch>
+void run_benchmark(
+    char const        *name
+  , std::string const &input
+  , int                iterations
+  , Dispatch         &&dispatch)
+{
+    calls = 0;
+
+    auto const start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        dispatch(input);
+    }
+
+    auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    printf("%-8s %-14s %10d lookups %10.2f ns/lookup %10zu calls\n",
+        name,
+        input.c_str(),
+        iterations,
+        double(elapsed.count()) / iterations,
+        calls);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = 1000000;
+
+    if (argc > 1)
+    {
+        iterations = boost::lexical_cast<int>(argv[1]);
+    }
+
+    auto const linear = make_linear_commands();
+
+    for (std::string const input :
+         { "say", "admin_trace", "Honorific", "showr", "s", "dance" })
+    {
+        run_benchmark("table", input, iterations, dispatch_table);
+        run_benchmark(
+            "linear"
+          , input
+          , iterations
+          , [&linear](std::string const &name)
+            {
+                dispatch_linear(linear, name);
+            });
+    }
+
+    return EXIT_SUCCESS;
+}
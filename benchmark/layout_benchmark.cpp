@@ -0,0 +1,84 @@
+#include "hugin/user_interface.hpp"
+#include "munin/container.hpp"
+#include "munin/grid_layout.hpp"
+#include "munin/window.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+//* =========================================================================
+//  Simulates a user dragging the corner of their terminal window around by
+//  repeatedly resizing a window containing a complete user interface, and
+//  reports the time taken to lay out and repaint after each resize.
+//* =========================================================================
+static void run_benchmark(std::string const &face, int iterations)
+{
+    boost::asio::io_service io_service;
+    boost::asio::strand     strand(io_service);
+
+    munin::window window(strand, terminalpp::behaviour{});
+
+    auto user_interface = std::make_shared<hugin::user_interface>(
+        std::ref(strand));
+
+    auto content = window.get_content();
+    content->set_layout(munin::make_grid_layout(1, 1));
+    content->add_component(user_interface);
+    content->set_focus();
+
+    user_interface->select_face(face);
+
+    std::size_t repaint_bytes = 0;
+    window.on_repaint.connect(
+        [&repaint_bytes](auto const &paint_data)
+        {
+            repaint_bytes += paint_data.size();
+        });
+
+    window.set_size({80, 24});
+    io_service.poll();
+    io_service.reset();
+
+    auto const start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        // Sweep back and forth across a range of sizes, as the drag of a
+        // window would.
+        auto const step = iteration % 40;
+        auto const delta = step < 20 ? step : 40 - step;
+
+        window.set_size(terminalpp::extent(80 + delta * 2, 24 + delta));
+        io_service.poll();
+        io_service.reset();
+    }
+
+    auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    printf("%-12s %8d resizes %10.2f us/resize %12zu bytes repainted\n",
+        face.c_str(),
+        iterations,
+        double(elapsed.count()) / iterations,
+        repaint_bytes);
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = 1000;
+
+    if (argc > 1)
+    {
+        iterations = boost::lexical_cast<int>(argv[1]);
+    }
+
+    run_benchmark(hugin::FACE_INTRO, iterations);
+    run_benchmark(hugin::FACE_MAIN, iterations);
+    run_benchmark(hugin::FACE_GM_TOOLS, iterations);
+
+    return EXIT_SUCCESS;
+}
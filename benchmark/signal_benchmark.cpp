@@ -0,0 +1,77 @@
+#include "munin/rectangle.hpp"
+#include "odin/signal.hpp"
+#include <boost/lexical_cast.hpp>
+#include <boost/signals2/signal.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+//* =========================================================================
+//  Measures the cost of emitting a signal shaped like component::on_redraw
+//  to a handful of slots, as happens for every redraw that bubbles up the
+//  component hierarchy.  boost::signals2 is measured alongside for
+//  comparison.
+//* =========================================================================
+template <class Signal>
+static void run_benchmark(char const *name, int slots, int iterations)
+{
+    Signal sig;
+    std::size_t total = 0;
+
+    for (int slot = 0; slot < slots; ++slot)
+    {
+        sig.connect(
+            [&total](std::vector<munin::rectangle> const &regions)
+            {
+                total += regions.size();
+            });
+    }
+
+    std::vector<munin::rectangle> const regions = {
+        munin::rectangle({0, 0}, {80, 1})
+    };
+
+    auto const start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        sig(regions);
+    }
+
+    auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    printf("%-16s %2d slots %10d emissions %10.2f ns/emission\n",
+        name,
+        slots,
+        iterations,
+        double(elapsed.count()) / iterations);
+
+    if (total != std::size_t(slots) * iterations)
+    {
+        printf("unexpected slot call count\n");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = 1000000;
+
+    if (argc > 1)
+    {
+        iterations = boost::lexical_cast<int>(argv[1]);
+    }
+
+    typedef void signature(std::vector<munin::rectangle> const &);
+
+    for (int slots : { 0, 1, 4 })
+    {
+        run_benchmark<odin::signal<signature>>(
+            "odin::signal", slots, iterations);
+        run_benchmark<boost::signals2::signal<signature>>(
+            "boost::signals2", slots, iterations);
+    }
+
+    return EXIT_SUCCESS;
+}
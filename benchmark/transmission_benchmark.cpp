@@ -0,0 +1,255 @@
+#include "odin/net/socket.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+//* =========================================================================
+//  Measures how the write classes of odin::net::socket affect a session
+//  over loopback.  For each keystroke that the client sends, the server
+//  writes a short echo followed by a repaint in several pieces, as happens
+//  when several components redraw.  The client times the arrival of the
+//  echo and of the end of the repaint.  On Linux, the number of data
+//  segments sent by the server is also reported.
+//
+//  The maximum segment size is reduced to that of Ethernet so that the
+//  segmentation resembles that of a real network.
+//* =========================================================================
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+typedef std::chrono::duration<double, std::micro> microseconds;
+
+enum class mode
+{
+    untagged,
+    interactive,
+    classified
+};
+
+char const *mode_name(mode m)
+{
+    switch (m)
+    {
+        case mode::untagged    : return "untagged";
+        case mode::interactive : return "all interactive";
+        default                : return "classified";
+    }
+}
+
+#if defined(__linux__)
+// The later fields of the kernel's tcp_info, which the C library's
+// declaration lacks.
+struct extended_tcp_info : tcp_info
+{
+    std::uint64_t pacing_rate;
+    std::uint64_t max_pacing_rate;
+    std::uint64_t bytes_acked;
+    std::uint64_t bytes_received;
+    std::uint32_t segs_out;
+    std::uint32_t segs_in;
+    std::uint32_t notsent_bytes;
+    std::uint32_t min_rtt;
+    std::uint32_t data_segs_in;
+    std::uint32_t data_segs_out;
+};
+#endif
+
+// Returns the number of data segments sent on the socket, or -1 if that
+// is unknown.
+long data_segments_sent(boost::asio::ip::tcp::socket &sock)
+{
+#if defined(__linux__)
+    extended_tcp_info info = {};
+    socklen_t length = sizeof(info);
+
+    if (getsockopt(
+            sock.native_handle(), IPPROTO_TCP, TCP_INFO, &info, &length) == 0
+     && length >= sizeof(info))
+    {
+        return long(info.data_segs_out);
+    }
+#else
+    (void)sock;
+#endif
+
+    return -1;
+}
+
+void limit_segment_size(boost::asio::ip::tcp::socket &sock)
+{
+#if defined(__linux__)
+    int mss = 1448;
+    setsockopt(
+        sock.native_handle(), IPPROTO_TCP, TCP_MAXSEG, &mss, sizeof(mss));
+#else
+    (void)sock;
+#endif
+}
+
+void serve(
+    std::shared_ptr<boost::asio::ip::tcp::socket> tcp_socket,
+    mode                                          m,
+    int                                           keystrokes,
+    int                                           pieces,
+    int                                           piece_size)
+{
+    odin::net::socket sock(tcp_socket);
+
+    odin::net::socket::output_storage_type const echo(3, 'x');
+    odin::net::socket::output_storage_type const piece(piece_size, 'r');
+
+    for (int keystroke = 0; keystroke < keystrokes; ++keystroke)
+    {
+        if (sock.read(1).empty())
+        {
+            return;
+        }
+
+        switch (m)
+        {
+            case mode::untagged :
+                sock.write(echo);
+
+                for (int index = 0; index < pieces; ++index)
+                {
+                    sock.write(piece);
+                }
+                break;
+
+            case mode::interactive :
+                sock.write(echo, odin::net::socket::write_class::interactive);
+
+                for (int index = 0; index < pieces; ++index)
+                {
+                    sock.write(
+                        piece, odin::net::socket::write_class::interactive);
+                }
+                break;
+
+            case mode::classified :
+                sock.write(echo, odin::net::socket::write_class::interactive);
+
+                for (int index = 0; index < pieces; ++index)
+                {
+                    sock.write(piece, odin::net::socket::write_class::repaint);
+                }
+
+                sock.flush();
+                break;
+        }
+    }
+}
+
+double percentile(std::vector<double> times, double fraction)
+{
+    std::sort(times.begin(), times.end());
+    return times[std::size_t(fraction * (times.size() - 1))];
+}
+
+void run_benchmark(mode m, int keystrokes, int pieces, int piece_size)
+{
+    boost::asio::io_service io_service;
+
+    boost::asio::ip::tcp::acceptor acceptor(io_service);
+    boost::asio::ip::tcp::endpoint const endpoint(
+        boost::asio::ip::address_v4::loopback(), 0);
+    acceptor.open(endpoint.protocol());
+    acceptor.bind(endpoint);
+    acceptor.listen();
+
+    boost::asio::ip::tcp::socket client(io_service);
+    client.open(endpoint.protocol());
+    limit_segment_size(client);
+    client.connect(acceptor.local_endpoint());
+
+    auto server = std::make_shared<boost::asio::ip::tcp::socket>(io_service);
+    acceptor.accept(*server);
+    limit_segment_size(*server);
+
+    std::thread server_thread(serve, server, m, keystrokes, pieces, piece_size);
+
+    std::vector<odin::u8> response(3 + pieces * piece_size);
+    std::vector<double> echo_times;
+    std::vector<double> repaint_times;
+
+    for (int keystroke = 0; keystroke < keystrokes; ++keystroke)
+    {
+        odin::u8 const key = 'k';
+        auto const start = clock_type::now();
+        boost::asio::write(client, boost::asio::buffer(&key, 1));
+
+        boost::asio::read(client, boost::asio::buffer(response.data(), 3));
+        echo_times.push_back(microseconds(clock_type::now() - start).count());
+
+        boost::asio::read(
+            client, 
+            boost::asio::buffer(response.data() + 3, response.size() - 3));
+        repaint_times.push_back(
+            microseconds(clock_type::now() - start).count());
+    }
+
+    server_thread.join();
+
+    auto const segments = data_segments_sent(*server);
+
+    printf("%-16s echo %9.1f us (p99 %9.1f)  repaint %9.1f us (p99 %9.1f)",
+        mode_name(m),
+        percentile(echo_times, 0.5),
+        percentile(echo_times, 0.99),
+        percentile(repaint_times, 0.5),
+        percentile(repaint_times, 0.99));
+
+    if (segments >= 0)
+    {
+        printf("  %6.2f segments/keystroke", double(segments) / keystrokes);
+    }
+
+    printf("\n");
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    int keystrokes = 200;
+    int pieces     = 4;
+    int piece_size = 700;
+
+    if (argc > 1)
+    {
+        keystrokes = boost::lexical_cast<int>(argv[1]);
+    }
+
+    if (argc > 2)
+    {
+        pieces = boost::lexical_cast<int>(argv[2]);
+    }
+
+    if (argc > 3)
+    {
+        piece_size = boost::lexical_cast<int>(argv[3]);
+    }
+
+    printf("%d keystrokes, each answered by a 3 byte echo and a repaint of "
+           "%d pieces of %d bytes\n", keystrokes, pieces, piece_size);
+
+    for (auto m : { mode::untagged, mode::interactive, mode::classified })
+    {
+        run_benchmark(m, keystrokes, pieces, piece_size);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -59,7 +59,7 @@ public :
     /// \brief Set a function to be called when the user inputs the details
     /// for the creation of an account.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::string const &account_name,
               std::string const &password,
               std::string const &password_verify)> on_account_created;
@@ -68,14 +68,14 @@ public :
     /// \brief Set a function to be called when the user cancels the creation
     /// of an account.
     //* =====================================================================
-    boost::signal<void ()> on_account_creation_cancelled;
+    odin::signal<void ()> on_account_creation_cancelled;
     
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
@@ -55,10 +55,12 @@ public :
     void set_gm_mode(bool mode);
 
     //* =====================================================================
-    /// \brief Sets the encounter that the view should work with.
+    /// \brief Sets the encounter that the view should work with.  If it
+    /// is the encounter the view already shows, then only the rows that
+    /// have changed since it was last set are updated.
     //* =====================================================================
     void set_encounter(
-        std::shared_ptr<paradice::active_encounter> const &encounter);
+        std::shared_ptr<paradice::active_encounter const> const &encounter);
 
 private :
     struct impl;
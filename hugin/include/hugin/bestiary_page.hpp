@@ -69,31 +69,31 @@ public :
     /// \fn on_new
     /// \brief Called when the 'new' button is pressed.
     //* =====================================================================
-    boost::signal<void ()> on_new;
+    odin::signal<void ()> on_new;
 
     //* =====================================================================
     /// \fn on_clone
     /// \brief Called when the 'clone' button is pressed.
     //* =====================================================================
-    boost::signal<void (std::shared_ptr<paradice::beast> const &)> on_clone;
+    odin::signal<void (std::shared_ptr<paradice::beast> const &)> on_clone;
 
     //* =====================================================================
     /// \fn on_edit
     /// \brief Called when the 'edit' button is pressed.
     //* =====================================================================
-    boost::signal<void (std::shared_ptr<paradice::beast> const &)> on_edit;
+    odin::signal<void (std::shared_ptr<paradice::beast> const &)> on_edit;
 
     //* =====================================================================
     /// \fn on_fight
     /// \brief Called when the 'fight!' button is pressed.
     //* =====================================================================
-    boost::signal<void (std::shared_ptr<paradice::beast> const &)> on_fight;
+    odin::signal<void (std::shared_ptr<paradice::beast> const &)> on_fight;
 
     //* =====================================================================
     /// \fn on_delete
     /// \brief Called when the 'delete' button is pressed.
     //* =====================================================================
-    boost::signal<void (std::shared_ptr<paradice::beast> const &)> on_delete;
+    odin::signal<void (std::shared_ptr<paradice::beast> const &)> on_delete;
 
 private :
     struct impl;
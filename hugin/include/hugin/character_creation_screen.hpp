@@ -59,21 +59,21 @@ public :
     /// \brief Set a function to be called when the user inputs the details
     /// for the creation of an character.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::string const &name, bool is_gm)> on_character_created;
     
     //* =====================================================================
     /// \brief Set a function to be called when the user cancels the creation
     /// of an character.
     //* =====================================================================
-    boost::signal<void ()> on_character_creation_cancelled;
+    odin::signal<void ()> on_character_creation_cancelled;
 
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
@@ -70,20 +70,20 @@ public :
     /// \brief Provide a function to be called if the user opts to create
     /// a new character.
     //* =====================================================================
-    boost::signal<void ()> on_new_character;
+    odin::signal<void ()> on_new_character;
     
     //* =====================================================================
     /// \brief Provide a function to be called if the user opts to use an
     /// existing character.
     //* =====================================================================
-    boost::signal<void (std::string const &name)> on_character_selected;
+    odin::signal<void (std::string const &name)> on_character_selected;
     
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
@@ -65,7 +65,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
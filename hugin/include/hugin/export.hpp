@@ -0,0 +1,42 @@
+
+#ifndef HUGIN_EXPORT_H
+#define HUGIN_EXPORT_H
+
+#ifdef HUGIN_STATIC_DEFINE
+#  define HUGIN_EXPORT
+#  define HUGIN_NO_EXPORT
+#else
+#  ifndef HUGIN_EXPORT
+#    ifdef hugin_EXPORTS
+        /* We are building this library */
+#      define HUGIN_EXPORT 
+#    else
+        /* We are using this library */
+#      define HUGIN_EXPORT 
+#    endif
+#  endif
+
+#  ifndef HUGIN_NO_EXPORT
+#    define HUGIN_NO_EXPORT 
+#  endif
+#endif
+
+#ifndef HUGIN_DEPRECATED
+#  define HUGIN_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef HUGIN_DEPRECATED_EXPORT
+#  define HUGIN_DEPRECATED_EXPORT HUGIN_EXPORT HUGIN_DEPRECATED
+#endif
+
+#ifndef HUGIN_DEPRECATED_NO_EXPORT
+#  define HUGIN_DEPRECATED_NO_EXPORT HUGIN_NO_EXPORT HUGIN_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef HUGIN_NO_DEPRECATED
+#    define HUGIN_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* HUGIN_EXPORT_H */
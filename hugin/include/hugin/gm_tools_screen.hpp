@@ -76,7 +76,7 @@ public :
     /// \fn on_fight_beast
     /// \brief Called when a beast is selected to enter the active encounter.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void (std::shared_ptr<paradice::beast> const &)
     > on_fight_beast;
@@ -86,7 +86,7 @@ public :
     /// \brief Called when an encounter is selected to enter the active 
     /// encounter.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void (std::shared_ptr<paradice::encounter> const &)
     > on_fight_encounter;
@@ -96,14 +96,14 @@ public :
     /// \brief Called when the 'back' button is pressed on the GM Tools
     /// screen.
     //* =====================================================================
-    boost::signal<void ()> on_back;
+    odin::signal<void ()> on_back;
 
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
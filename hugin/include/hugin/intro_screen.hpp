@@ -54,21 +54,21 @@ public :
     /// \brief Set a function to be called when the user inputs a name
     /// and password on the intro screen.
     //* =====================================================================
-    boost::signal<void (std::string, std::string)> on_login;
+    odin::signal<void (std::string, std::string)> on_login;
 
     //* =====================================================================
     /// \fn on_new_account
     /// \brief Set a function to be called when the user clicks on the
     /// new account button.
     //* =====================================================================
-    boost::signal<void ()> on_new_account;
+    odin::signal<void ()> on_new_account;
 
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
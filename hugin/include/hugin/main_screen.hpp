@@ -59,7 +59,7 @@ public :
     /// \brief Set a function to be called when the user inputs a command
     /// on the main screen.
     //* =====================================================================
-    boost::signal<void (std::string const &input)> on_input_entered;
+    odin::signal<void (std::string const &input)> on_input_entered;
     
     //* =====================================================================
     /// \brief Adds output to the output text area on the main screen.
@@ -100,7 +100,9 @@ public :
     /// \brief Sets the Active Encounter.
     //* =====================================================================
     void set_active_encounter(
-        std::shared_ptr<paradice::active_encounter> const &active_encounter);
+        std::shared_ptr<
+            paradice::active_encounter const
+        > const &active_encounter);
 
     //* =====================================================================
     /// \brief Sets the text contained in the Help window.
@@ -112,14 +114,14 @@ public :
     /// \brief Register a callback for when the close button on the help
     /// screen is called.
     //* =====================================================================
-    boost::signal<void ()> on_help_closed;
+    odin::signal<void ()> on_help_closed;
 
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
@@ -58,7 +58,7 @@ public :
     /// \brief Set a function to be called when the user inputs the details
     /// for the change of a password.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::string const &old_password
             , std::string const &new_password
             , std::string const &new_password_verify)> on_password_changed;
@@ -67,14 +67,14 @@ public :
     /// \brief Set a function to be called when the user cancels the change
     /// of a password.
     //* =====================================================================
-    boost::signal<void ()> on_password_change_cancelled;
+    odin::signal<void ()> on_password_change_cancelled;
 
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this 
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(munin::event_type const &event);
 
 private :
     struct impl;
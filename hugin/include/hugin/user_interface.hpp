@@ -98,7 +98,7 @@ public :
     /// \brief Set a function to be called when the user inputs the details
     /// for the change of a password.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::string const &old_password,
               std::string const &new_password,
               std::string const &new_password_verify)> on_password_changed;
@@ -107,13 +107,13 @@ public :
     /// \brief Set a function to be called when the user cancels the change
     /// of a password.
     //* =====================================================================
-    boost::signal<void ()> on_password_change_cancelled;
+    odin::signal<void ()> on_password_change_cancelled;
 
     //* =====================================================================
     /// \brief Set a function to be called when the user inputs a name
     /// and password on the intro screen.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::string const &username,
               std::string const &hashed_password)> on_login;
 
@@ -121,13 +121,13 @@ public :
     /// \brief Set a function to be called when the user wants to create
     /// a new account.
     //* =====================================================================
-    boost::signal<void ()> on_new_account;
+    odin::signal<void ()> on_new_account;
 
     //* =====================================================================
     /// \brief Set a function to be called when the user inputs the details
     /// for the creation of an account.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::string const &account_name,
               std::string const &password,
               std::string const &password_verify)> on_account_created;
@@ -136,57 +136,57 @@ public :
     /// \brief Set a function to be called when the user cancels the creation
     /// of an account.
     //* =====================================================================
-    boost::signal<void ()> on_account_creation_cancelled;
+    odin::signal<void ()> on_account_creation_cancelled;
 
     //* =====================================================================
     /// \brief Set a function to be called when the user inputs a command
     /// on the main screen.
     //* =====================================================================
-    boost::signal<void (std::string const &input)> on_input_entered;
+    odin::signal<void (std::string const &input)> on_input_entered;
 
     //* =====================================================================
     /// \brief Provide a function to be called if the user opts to create
     /// a new character.o
     //* =====================================================================
-    boost::signal<void ()> on_new_character;
+    odin::signal<void ()> on_new_character;
     
     //* =====================================================================
     /// \brief Provide a function to be called if the user opts to use an
     /// existing character.
     //* =====================================================================
-    boost::signal<void (std::string const &name)> on_character_selected;
+    odin::signal<void (std::string const &name)> on_character_selected;
 
     //* =====================================================================
     /// \brief Provide a function to be called if the user creates a new
     /// character.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::string const &name, bool is_gm)> on_character_created;
 
     //* =====================================================================
     /// \brief Provide a function to be called if the user decides to cancel
     /// the creation of a character.
     //* =====================================================================
-    boost::signal<void ()> on_character_creation_cancelled;
+    odin::signal<void ()> on_character_creation_cancelled;
 
     //* =====================================================================
     /// \brief Provide a function to be called if the user hits the 'back'
     /// button on the GM Tools screen
     //* =====================================================================
-    boost::signal<void ()> on_gm_tools_back;
+    odin::signal<void ()> on_gm_tools_back;
 
     //* =====================================================================
     /// \brief Provide a function to be called if the user inserts a
     /// beast into the current encounter.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::shared_ptr<paradice::beast> const &)> on_gm_fight_beast;
 
     //* =====================================================================
     /// \brief Provide a function to be called if the user inserts an
     /// encounter into the current encounter.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (std::shared_ptr<paradice::encounter> const &)
     > on_gm_fight_encounter;
 
@@ -201,10 +201,13 @@ public :
     void hide_active_encounter_window();
 
     //* =====================================================================
-    /// \brief Sets the Active Encounter.
+    /// \brief Sets the Active Encounter.  This is a snapshot of the
+    /// encounter, which may be shared with other user interfaces.
     //* =====================================================================
     void set_active_encounter(
-        std::shared_ptr<paradice::active_encounter> const &active_encounter);
+        std::shared_ptr<
+            paradice::active_encounter const
+        > const &active_encounter);
 
     //* =====================================================================
     /// \brief Sets the character names belonging to this account.
@@ -241,6 +244,12 @@ public :
     //* =====================================================================
     void select_face(std::string const &face_name);
 
+    //* =====================================================================
+    /// \brief Returns the name of the user interface screen most recently
+    /// selected to be shown.
+    //* =====================================================================
+    std::string get_face() const;
+
     //* =====================================================================
     /// \brief Adds output to the output text area on the main screen.
     //* =====================================================================
@@ -275,7 +284,7 @@ public :
     /// \brief Set up a callback for when the close icon on the help
     /// window is clicked.
     //* =====================================================================
-    boost::signal<void ()> on_help_closed;
+    odin::signal<void ()> on_help_closed;
 
     //* =====================================================================
     /// \brief Sets the text contained in the Help window.
@@ -97,7 +97,7 @@ struct account_creation_screen::impl
     std::shared_ptr<munin::button>            ok_button_;
     std::shared_ptr<munin::button>            cancel_button_;
 
-    std::vector<boost::signals::connection>   connections_;
+    std::vector<odin::connection>   connections_;
 };
 
 // ==========================================================================
@@ -214,9 +214,9 @@ void account_creation_screen::clear()
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void account_creation_screen::do_event(boost::any const &ev)
+void account_creation_screen::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     bool handled = false;
     
     if (vk)
@@ -29,103 +29,212 @@
 #include <munin/container.hpp>
 #include <munin/grid_layout.hpp>
 #include <munin/list.hpp>
+#include <munin/list_model.hpp>
 #include <munin/scroll_pane.hpp>
-#include <paradice/beast.hpp>
-#include <paradice/character.hpp>
-#include <terminalpp/encoder.hpp>
-#include <boost/format.hpp>
-#include <numeric>
+#include <terminalpp/string.hpp>
+#include <algorithm>
+#include <vector>
 
 namespace hugin {
 
+namespace {
+
+// ==========================================================================
+// ENCOUNTER_LIST_MODEL
+// ==========================================================================
+// A list model whose rows are the shared, pre-formatted text of the
+// encounter's entries.  Each alteration notifies the list of only the rows
+// that it affects.
+class encounter_list_model : public munin::list_model
+{
+public :
+    typedef std::shared_ptr<terminalpp::string const> row;
+
+    void reset(std::vector<row> rows)
+    {
+        rows_ = std::move(rows);
+        on_model_reset();
+    }
+
+    void insert(odin::u32 index, row const &text)
+    {
+        index = (std::min)(index, odin::u32(rows_.size()));
+        rows_.insert(rows_.begin() + index, text);
+        on_items_inserted(index, 1);
+    }
+
+    void remove(odin::u32 index)
+    {
+        if (index < rows_.size())
+        {
+            rows_.erase(rows_.begin() + index);
+            on_items_removed(index, 1);
+        }
+    }
+
+    void move(odin::u32 from_index, odin::u32 to_index)
+    {
+        if (from_index >= rows_.size() || to_index >= rows_.size())
+        {
+            return;
+        }
+
+        auto const begin = rows_.begin();
+        auto const low   = (std::min)(from_index, to_index);
+        auto const high  = (std::max)(from_index, to_index);
+
+        if (to_index < from_index)
+        {
+            std::rotate(begin + low, begin + high, begin + high + 1);
+        }
+        else
+        {
+            std::rotate(begin + low, begin + low + 1, begin + high + 1);
+        }
+
+        on_items_changed(low, high - low + 1);
+    }
+
+    void replace(odin::u32 index, row const &text)
+    {
+        if (index < rows_.size())
+        {
+            rows_[index] = text;
+            on_items_changed(index, 1);
+        }
+    }
+
+protected :
+    odin::u32 do_get_number_of_items() const override
+    {
+        return odin::u32(rows_.size());
+    }
+
+    terminalpp::string do_get_item(odin::u32 index) const override
+    {
+        return *rows_[index];
+    }
+
+    odin::u32 do_get_item_width(odin::u32 index) const override
+    {
+        return odin::u32(rows_[index]->size());
+    }
+
+private :
+    std::vector<row> rows_;
+};
+
+}
+
 // ==========================================================================
 // ACTIVE_ENCOUNTER_VIEW::IMPLEMENTATION STRUCTURE
 // ==========================================================================
 struct active_encounter_view::impl
 {
-    std::shared_ptr<paradice::active_encounter> encounter_;
-    bool                                        gm_mode_;
+    std::shared_ptr<paradice::active_encounter const> encounter_;
+    odin::u32                                         version_;
+    bool                                              gm_mode_;
 
-    std::shared_ptr<munin::list>                participant_list_;
+    std::shared_ptr<encounter_list_model>             model_;
+    std::shared_ptr<munin::list>                      participant_list_;
 
-    struct active_encounter_entry_visitor : boost::static_visitor<std::string>
+    // Rebuilds every row from the encounter's entries.
+    void reset()
     {
-        std::string operator()(paradice::active_encounter::player const &ply) const
+        std::vector<encounter_list_model::row> rows;
+
+        if (encounter_)
         {
-            std::shared_ptr<paradice::character> ch = ply.character_.lock();
+            rows.reserve(encounter_->entries_.size());
 
-            if (ch)
+            for (auto const &entry : encounter_->entries_)
             {
-                return ch->get_name();
-            }
-            else
-            {
-                return ply.name_;
+                rows.push_back(entry.text_);
             }
+
+            version_ = encounter_->version_;
+        }
+        else
+        {
+            version_ = 0;
         }
 
-        std::string operator()(std::shared_ptr<paradice::beast> const &beast) const
+        model_->reset(std::move(rows));
+    }
+
+    // Applies a single change to the rows.
+    void apply(paradice::active_encounter::change const &chg)
+    {
+        typedef paradice::active_encounter::change_kind change_kind;
+
+        switch (chg.kind_)
         {
-            return beast->get_name();
+            case change_kind::added :
+                model_->insert(chg.index_, chg.text_);
+                break;
+
+            case change_kind::removed :
+                model_->remove(chg.index_);
+                break;
+
+            case change_kind::moved :
+                model_->move(chg.from_index_, chg.index_);
+                break;
+
+            case change_kind::annotated :
+                // Fall-through
+            case change_kind::rolled :
+                model_->replace(chg.index_, chg.text_);
+                break;
+
+            case change_kind::cleared :
+                model_->reset({});
+                break;
         }
-    };
-    
-    void update()
+    }
+
+    // Brings the rows up to date with a snapshot of the encounter.  If it
+    // is a later snapshot of the encounter already shown, then only the
+    // changes since the version last shown are applied, provided that they
+    // are still recorded.
+    void update(
+        std::shared_ptr<paradice::active_encounter const> const &encounter)
     {
-        if (!encounter_)
+        if (!encounter
+         || !encounter_
+         || encounter->identity_ != encounter_->identity_)
         {
-            participant_list_->set_items({});
+            encounter_ = encounter;
+            reset();
             return;
         }
 
-        auto selected_index = participant_list_->get_item_index();
-
-        active_encounter_entry_visitor entry_visitor;
-        std::vector<terminalpp::string> list_data;
-
-        for (auto const &entry : encounter_->entries_)
+        // Snapshots taken on the encounter's strand may arrive here out of
+        // order.  One that is no newer than that shown adds nothing.
+        if (encounter->version_ <= version_)
         {
-            std::string name = boost::apply_visitor(entry_visitor, entry.participant_);
-            std::string text = boost::str(boost::format("(%d)") % entry.id_)
-                 + " "
-                 + name;
+            return;
+        }
 
-            if (!entry.annotation_.empty())
-            {
-                text += boost::str(boost::format(" [%s]") % entry.annotation_);
-            }
+        encounter_ = encounter;
 
-            boost::optional<paradice::dice_result> const &last_roll =
-                entry.roll_data_.empty()
-              ? boost::optional<paradice::dice_result>()
-              : entry.roll_data_.back();
+        auto const &changes = encounter_->changes_;
 
-            if (last_roll)
+        if (changes.empty() || changes.front().version_ > version_ + 1)
+        {
+            reset();
+            return;
+        }
+
+        for (auto const &chg : changes)
+        {
+            if (chg.version_ > version_)
             {
-                odin::s32 total_score = 0;
-
-                for (auto const &repetition : last_roll->results_)
-                {
-                    using std::begin;
-                    using std::end;
-                    
-                    total_score += std::accumulate(
-                        begin(repetition),
-                        end(repetition),
-                        last_roll->roll_.bonus_);
-                }
-
-                text += boost::str(
-                    boost::format(" | %s -> %d")
-                        % describe_dice(last_roll->roll_) 
-                        % total_score);
+                apply(chg);
             }
-
-            list_data.push_back(terminalpp::encode(text));
         }
 
-        participant_list_->set_items(list_data);
-        participant_list_->set_item_index(selected_index);
+        version_ = encounter_->version_;
     }
 };
 
@@ -135,8 +244,11 @@ struct active_encounter_view::impl
 active_encounter_view::active_encounter_view()
     : pimpl_(std::make_shared<impl>())
 {
+    pimpl_->version_ = 0;
     pimpl_->gm_mode_ = false;
+    pimpl_->model_ = std::make_shared<encounter_list_model>();
     pimpl_->participant_list_ = munin::make_list();
+    pimpl_->participant_list_->set_model(pimpl_->model_);
 
     auto content = get_container();
     content->set_layout(munin::make_grid_layout(1, 1));
@@ -156,17 +268,15 @@ active_encounter_view::~active_encounter_view()
 void active_encounter_view::set_gm_mode(bool mode)
 {
     pimpl_->gm_mode_ = mode;
-    pimpl_->update();
 }
 
 // ==========================================================================
 // SET_ENCOUNTER
 // ==========================================================================
 void active_encounter_view::set_encounter(
-    std::shared_ptr<paradice::active_encounter> const &encounter)
+    std::shared_ptr<paradice::active_encounter const> const &encounter)
 {
-    pimpl_->encounter_ = encounter;
-    pimpl_->update();
+    pimpl_->update(encounter);
 }
 
 }
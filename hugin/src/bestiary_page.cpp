@@ -34,6 +34,7 @@
 #include <munin/framed_component.hpp>
 #include <munin/grid_layout.hpp>
 #include <munin/list.hpp>
+#include <munin/list_model.hpp>
 #include <munin/scroll_pane.hpp>
 #include <munin/solid_frame.hpp>
 #include <munin/text_area.hpp>
@@ -53,6 +54,7 @@ struct bestiary_page::impl
 {
     bestiary_page                    &self_;
     std::shared_ptr<munin::list>      beast_list_;
+    std::shared_ptr<munin::string_list_model> beast_names_;
     std::shared_ptr<munin::edit>      name_field_;
     std::shared_ptr<munin::text_area> description_area_;
     std::shared_ptr<munin::button>    new_button_;
@@ -66,9 +68,8 @@ struct bestiary_page::impl
     std::shared_ptr<munin::container> details_container_;
 
     std::vector<std::shared_ptr<paradice::beast>> beasts_;
-    std::vector<terminalpp::string>   names_;
 
-    std::vector<boost::signals::connection> connections_;
+    std::vector<odin::connection> connections_;
 
     // ======================================================================
     // CONSTRUCTOR
@@ -90,7 +91,7 @@ struct bestiary_page::impl
         if (index != -1)
         {
             split_container_->add_component(details_container_);
-            name_field_->get_document()->set_text(names_[index]);
+            name_field_->get_document()->set_text(beasts_[index]->get_name());
 
             auto description = beasts_[index]->get_description();
             description_area_->get_document()->set_text(description);
@@ -166,6 +167,7 @@ bestiary_page::bestiary_page()
     pimpl_ = std::make_shared<impl>(boost::ref(*this));
 
     pimpl_->beast_list_       = munin::make_list();
+    pimpl_->beast_names_      = munin::make_string_list_model();
     pimpl_->name_field_       = munin::make_edit();
     pimpl_->description_area_ = munin::make_text_area();
     pimpl_->new_button_       = munin::make_button("New");
@@ -174,6 +176,8 @@ bestiary_page::bestiary_page()
     pimpl_->fight_button_     = munin::make_button("Fight!");
     pimpl_->delete_button_    = munin::make_button("Delete");
 
+    pimpl_->beast_list_->set_model(pimpl_->beast_names_);
+
     // Set up event callbacks.
     pimpl_->connections_.push_back(
         pimpl_->beast_list_->on_item_changed.connect(
@@ -263,16 +267,20 @@ void bestiary_page::set_beasts(
 {
     pimpl_->beasts_ = beasts;
 
-    // rebuild the vector of ansi strings to match the names of the beasts.
-    pimpl_->names_.clear();
+    // Pass the names of the beasts to the list's model.  Only those names
+    // that differ from the ones it already has will cause the list to
+    // redraw, so this stays cheap for large bestiaries.
+    std::vector<std::string> names;
+    names.reserve(beasts.size());
 
     for (auto &current_beast : beasts)
     {
-        pimpl_->names_.push_back(current_beast->get_name());
+        names.push_back(current_beast->get_name());
     }
 
-    // Set this as the current list of beasts and ensure it is de-selected.
-    pimpl_->beast_list_->set_items(pimpl_->names_);
+    pimpl_->beast_names_->set_items(std::move(names));
+
+    // Ensure that the list is de-selected.
     pimpl_->beast_list_->set_item_index(-1);
 }
 
@@ -83,7 +83,7 @@ struct character_creation_screen::impl
     std::shared_ptr<munin::toggle_button>   gm_toggle_;
     std::shared_ptr<munin::button>          ok_button_;
     std::shared_ptr<munin::button>          cancel_button_;
-    std::vector<boost::signals::connection> connections_;
+    std::vector<odin::connection> connections_;
 };
 
 // ==========================================================================
@@ -178,9 +178,9 @@ void character_creation_screen::clear()
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void character_creation_screen::do_event(boost::any const &ev)
+void character_creation_screen::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     bool handled = false;
     
     if (vk)
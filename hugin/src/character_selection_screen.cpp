@@ -124,9 +124,9 @@ void character_selection_screen::set_character_names(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void character_selection_screen::do_event(boost::any const &event)
+void character_selection_screen::do_event(munin::event_type const &event)
 {
-    auto vk = boost::any_cast<terminalpp::virtual_key>(&event);
+    auto vk = boost::get<terminalpp::virtual_key>(&event);
     
     if (vk)
     {
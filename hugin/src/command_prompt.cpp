@@ -97,9 +97,9 @@ void command_prompt::clear_history()
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void command_prompt::do_event(boost::any const &ev)
+void command_prompt::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     bool handled = false;
 
     if (vk)
@@ -35,6 +35,7 @@
 #include <munin/vertical_squeeze_layout.hpp>
 #include <munin/vertical_strip_layout.hpp>
 #include <munin/list.hpp>
+#include <munin/list_model.hpp>
 #include <munin/scroll_pane.hpp>
 #include <munin/view.hpp>
 #include <terminalpp/string.hpp>
@@ -49,6 +50,8 @@ struct encounters_page::impl
     encounters_page                   &self_;
     std::shared_ptr<munin::list>       encounters_list_;
     std::shared_ptr<munin::list>       beasts_list_;
+    std::shared_ptr<munin::string_list_model> encounter_names_;
+    std::shared_ptr<munin::string_list_model> beast_names_;
     std::shared_ptr<munin::button>     new_button_;
     std::shared_ptr<munin::button>     edit_button_;
     std::shared_ptr<munin::button>     clone_button_;
@@ -60,7 +63,7 @@ struct encounters_page::impl
 
     std::vector<std::shared_ptr<paradice::encounter>> encounters_;
 
-    std::vector<boost::signals::connection> connections_;
+    std::vector<odin::connection> connections_;
 
 
     // ======================================================================
@@ -78,20 +81,21 @@ struct encounters_page::impl
     {
         split_container_->remove_component(details_container_);
 
-        std::vector<terminalpp::string> beast_names;
+        std::vector<std::string> names;
 
         auto index = encounters_list_->get_item_index();
 
         if (index >= 0 && size_t(index) < encounters_.size())
         {
             auto beasts = encounters_[index]->get_beasts();
+            names.reserve(beasts.size());
 
             for (auto const &beast : beasts)
             {
-                beast_names.push_back(beast->get_name());
+                names.push_back(beast->get_name());
             }
 
-            beasts_list_->set_items(beast_names);
+            beast_names_->set_items(std::move(names));
             split_container_->add_component(details_container_);
         }
     }
@@ -165,6 +169,11 @@ encounters_page::encounters_page()
     pimpl_ = std::make_shared<impl>(std::ref(*this));
     pimpl_->encounters_list_ = munin::make_list();
     pimpl_->beasts_list_     = munin::make_list();
+    pimpl_->encounter_names_ = munin::make_string_list_model();
+    pimpl_->beast_names_     = munin::make_string_list_model();
+
+    pimpl_->encounters_list_->set_model(pimpl_->encounter_names_);
+    pimpl_->beasts_list_->set_model(pimpl_->beast_names_);
 
     pimpl_->new_button_       = munin::make_button("New");
     pimpl_->clone_button_     = munin::make_button("Clone");
@@ -249,14 +258,17 @@ void encounters_page::set_encounters(
 {
     pimpl_->encounters_ = encounters;
 
-    std::vector<terminalpp::string> encounter_names;
+    // Only those names that differ from the ones the model already has will
+    // cause the list to redraw.
+    std::vector<std::string> names;
+    names.reserve(encounters.size());
 
     for (auto const &enc : pimpl_->encounters_)
     {
-        encounter_names.push_back(enc->get_name());
+        names.push_back(enc->get_name());
     }
 
-    pimpl_->encounters_list_->set_items(encounter_names);
+    pimpl_->encounter_names_->set_items(std::move(names));
     pimpl_->encounters_list_->set_item_index(-1);
 }
 
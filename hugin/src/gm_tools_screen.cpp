@@ -439,9 +439,9 @@ std::vector< std::shared_ptr<paradice::encounter> > gm_tools_screen::get_encount
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void gm_tools_screen::do_event(boost::any const &ev)
+void gm_tools_screen::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     bool handled = false;
     
     if (vk)
@@ -214,9 +214,9 @@ void intro_screen::clear()
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void intro_screen::do_event(boost::any const &ev)
+void intro_screen::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     bool handled = false;
     
     if (vk)
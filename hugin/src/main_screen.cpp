@@ -243,7 +243,7 @@ void main_screen::hide_active_encounter_window()
 // SET_ACTIVE_ENCOUNTER
 // ==========================================================================
 void main_screen::set_active_encounter(
-    std::shared_ptr<paradice::active_encounter> const &active_encounter)
+    std::shared_ptr<paradice::active_encounter const> const &active_encounter)
 {
     pimpl_->active_encounter_view_->set_encounter(active_encounter);
 }
@@ -261,9 +261,9 @@ void main_screen::set_help_window_text(terminalpp::string const &text)
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void main_screen::do_event(boost::any const &ev)
+void main_screen::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     bool handled = false;
     
     if (vk)
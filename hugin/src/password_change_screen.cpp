@@ -95,7 +95,7 @@ struct password_change_screen::impl
     std::shared_ptr<munin::edit>            new_password_verify_field_;
     std::shared_ptr<munin::button>          ok_button_;
     std::shared_ptr<munin::button>          cancel_button_;
-    std::vector<boost::signals::connection> connections_;
+    std::vector<odin::connection> connections_;
 };
 
 // ==========================================================================
@@ -215,9 +215,9 @@ void password_change_screen::clear()
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void password_change_screen::do_event(boost::any const &ev)
+void password_change_screen::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     bool handled = false;
     
     if (vk)
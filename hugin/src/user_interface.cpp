@@ -76,6 +76,9 @@ struct user_interface::impl
 
     std::mutex                                  dispatch_queue_mutex_;
     std::deque<std::function<void ()>>          dispatch_queue_;
+
+    mutable std::mutex                          face_name_mutex_;
+    std::string                                 face_name_;
     
     // ======================================================================
     // SELECT_FACE
@@ -85,6 +88,9 @@ struct user_interface::impl
         ensure_face_created(face_name);
         active_screen_->select_face(face_name);
         active_screen_->set_focus();
+
+        std::unique_lock<std::mutex> lock(face_name_mutex_);
+        face_name_ = face_name;
     }
     
     // ======================================================================
@@ -282,7 +288,8 @@ user_interface::user_interface(boost::asio::strand &strand)
   : pimpl_(std::make_shared<impl>(std::ref(*this), std::ref(strand)))
 {
     pimpl_->active_screen_              = std::make_shared<munin::card>();
-    pimpl_->status_bar_                 = std::make_shared<munin::status_bar>();
+    pimpl_->status_bar_                 =
+        std::make_shared<munin::status_bar>(std::ref(strand));
 
     pimpl_->select_face(hugin::FACE_INTRO);    
 
@@ -398,7 +405,12 @@ void user_interface::clear_password_change_screen()
 // ==========================================================================
 void user_interface::show_active_encounter_window()
 {
-    pimpl_->main_screen_->show_active_encounter_window();
+    pimpl_->async(
+        [pimpl_=pimpl_]
+        {
+            pimpl_->ensure_face_created(hugin::FACE_MAIN);
+            pimpl_->main_screen_->show_active_encounter_window();
+        });
 }
 
 // ==========================================================================
@@ -406,16 +418,26 @@ void user_interface::show_active_encounter_window()
 // ==========================================================================
 void user_interface::hide_active_encounter_window()
 {
-    pimpl_->main_screen_->hide_active_encounter_window();
+    pimpl_->async(
+        [pimpl_=pimpl_]
+        {
+            pimpl_->ensure_face_created(hugin::FACE_MAIN);
+            pimpl_->main_screen_->hide_active_encounter_window();
+        });
 }
 
 // ==========================================================================
 // SET_ACTIVE_ENCOUNTER
 // ==========================================================================
 void user_interface::set_active_encounter(
-    std::shared_ptr<paradice::active_encounter> const &enc)
+    std::shared_ptr<paradice::active_encounter const> const &enc)
 {
-    pimpl_->main_screen_->set_active_encounter(enc);
+    pimpl_->async(
+        [pimpl_=pimpl_, enc]
+        {
+            pimpl_->ensure_face_created(hugin::FACE_MAIN);
+            pimpl_->main_screen_->set_active_encounter(enc);
+        });
 }
 
 // ==========================================================================
@@ -479,6 +501,15 @@ void user_interface::select_face(std::string const &face_name)
     pimpl_->async([pimpl_=pimpl_, face_name]{pimpl_->select_face(face_name);});
 }
 
+// ==========================================================================
+// GET_FACE
+// ==========================================================================
+std::string user_interface::get_face() const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->face_name_mutex_);
+    return pimpl_->face_name_;
+}
+
 // ==========================================================================
 // ADD_OUTPUT_TEXT
 // ==========================================================================
@@ -377,9 +377,9 @@ void wholist::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void wholist::do_event(boost::any const &ev)
+void wholist::do_event(munin::event_type const &ev)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&ev);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&ev);
     
     if (vk)
     {
@@ -0,0 +1,121 @@
+// ==========================================================================
+// Paradice9 Loadgen Controller
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file 
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor 
+//    or contributors, which in any way restrict the ability of any party 
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE 
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS 
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR 
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+// ==========================================================================
+#ifndef LOADGEN_CONTROLLER_HPP_
+#define LOADGEN_CONTROLLER_HPP_
+
+#include "loadgen/session.hpp"
+#include "odin/net/io_service_pool.hpp"
+#include <chrono>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace loadgen {
+
+//* =========================================================================
+/// \brief Settings for a load test.
+//* =========================================================================
+struct controller_settings
+{
+    /// \brief The settings from which each session's are made.  Each
+    /// session is given a name of its own.
+    session_settings session;
+
+    /// \brief The prefix of the sessions' account and character names.
+    /// It must be alphabetic.
+    std::string name_prefix = "Loadgen";
+
+    /// \brief The number of sessions with which the test begins.
+    odin::u32 sessions = 10;
+
+    /// \brief If greater than the number of sessions, the test ramps up
+    /// to this many sessions, adding ramp_step every ramp_interval, until
+    /// the server falls over.
+    odin::u32                 maximum_sessions = 0;
+    odin::u32                 ramp_step        = 10;
+    std::chrono::milliseconds ramp_interval    = std::chrono::seconds(30);
+
+    /// \brief The number of new connections made each second.
+    double connect_rate = 20;
+
+    /// \brief How long a test without a ramp runs for.
+    std::chrono::milliseconds duration = std::chrono::seconds(60);
+
+    /// \brief How often a line of measurements is printed.
+    std::chrono::milliseconds report_interval = std::chrono::seconds(5);
+
+    /// \brief A step of the ramp fails if the 99th percentile latency of
+    /// its commands exceeds this, or if any session fails during it.
+    std::chrono::milliseconds latency_limit = std::chrono::milliseconds(500);
+
+    /// \brief The process whose CPU usage is reported, or 0 for none.
+    odin::s32 server_pid = 0;
+};
+
+//* =========================================================================
+/// \brief Runs a load test: connects sessions at the configured rate,
+/// prints measurements as it goes, and ramps up the number of sessions
+/// until the server falls over if asked to.
+/// \par
+/// The controller runs on the pool's home io_service, and the sessions are
+/// spread across all of its io_services.  When the test is over, the pool's
+/// work is released so that its run() returns.
+//* =========================================================================
+class controller
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    controller(
+        odin::net::io_service_pool       &pool
+      , controller_settings        const &settings
+      , std::ostream                     &out);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~controller();
+
+    //* =====================================================================
+    /// \brief Begins the test.
+    //* =====================================================================
+    void start();
+
+    //* =====================================================================
+    /// \brief Returns true if the test found the server falling over.
+    //* =====================================================================
+    bool has_server_fallen_over() const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}
+
+#endif
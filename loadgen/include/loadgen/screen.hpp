@@ -0,0 +1,90 @@
+// ==========================================================================
+// Paradice9 Loadgen Screen
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file 
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor 
+//    or contributors, which in any way restrict the ability of any party 
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE 
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS 
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR 
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+// ==========================================================================
+#ifndef LOADGEN_SCREEN_HPP_
+#define LOADGEN_SCREEN_HPP_
+
+#include "odin/core.hpp"
+#include <memory>
+#include <string>
+
+namespace loadgen {
+
+//* =========================================================================
+/// \brief A minimal model of a terminal screen.
+/// \par
+/// The server paints its user interface by moving the cursor around and
+/// writing only the cells that have changed, so the text it sends cannot
+/// be searched directly.  Instead, its output is played onto this screen,
+/// and the rows of the screen are searched.
+/// \par
+/// Only the control sequences that a server can be expected to use for
+/// cursor movement and erasure are understood.  Colours, modes and window
+/// titles are consumed and ignored, and anything that is not plain ASCII
+/// is shown as a '?'.
+//* =========================================================================
+class screen
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    screen(odin::u16 width, odin::u16 height);
+
+    //* =====================================================================
+    /// \brief Plays the passed output onto the screen.
+    //* =====================================================================
+    void write(char const *data, std::size_t size);
+
+    //* =====================================================================
+    /// \brief Returns the height of the screen.
+    //* =====================================================================
+    odin::u16 get_height() const;
+
+    //* =====================================================================
+    /// \brief Returns the text of the given row.
+    //* =====================================================================
+    std::string const &get_row(odin::u16 row) const;
+
+    //* =====================================================================
+    /// \brief Returns true if any row contains the passed text.
+    //* =====================================================================
+    bool contains(std::string const &text) const;
+
+    //* =====================================================================
+    /// \brief Returns the lowest row that contains the passed text, or the
+    /// height of the screen if no row does.
+    //* =====================================================================
+    odin::u16 find_last_row(std::string const &text) const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+// ==========================================================================
+// Paradice9 Loadgen Session
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file 
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor 
+//    or contributors, which in any way restrict the ability of any party 
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE 
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS 
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR 
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+// ==========================================================================
+#ifndef LOADGEN_SESSION_HPP_
+#define LOADGEN_SESSION_HPP_
+
+#include "odin/core.hpp"
+#include "odin/metrics.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace loadgen {
+
+//* =========================================================================
+/// \brief The commands that a session issues once it has entered the game.
+//* =========================================================================
+enum class command
+{
+    say,
+    emote,
+    whisper,
+    roll,
+    showrolls
+};
+
+BOOST_STATIC_CONSTANT(odin::u32, NUMBER_OF_COMMANDS = 5);
+
+//* =========================================================================
+/// \brief Returns the name of a command, as typed.
+//* =========================================================================
+char const *get_command_name(command cmd);
+
+//* =========================================================================
+/// \brief Measurements shared by every session.  Times are recorded in
+/// nanoseconds.
+//* =========================================================================
+struct load_statistics
+{
+    odin::metrics::gauge     connected;
+    odin::metrics::gauge     in_game;
+    odin::metrics::counter   failed_logins;
+    odin::metrics::counter   dropped;
+    odin::metrics::counter   timeouts;
+    odin::metrics::histogram login_time;
+    odin::metrics::histogram latency[NUMBER_OF_COMMANDS];
+};
+
+//* =========================================================================
+/// \brief Settings for a session.
+//* =========================================================================
+struct session_settings
+{
+    /// \brief The address of the server.
+    boost::asio::ip::tcp::endpoint endpoint;
+
+    /// \brief The account and character with which the session logs in.
+    /// They are created if they do not already exist.
+    std::string name;
+    std::string password;
+
+    /// \brief The names of the characters that may be whispered to.
+    std::shared_ptr<std::vector<std::string> const> whisper_targets;
+
+    /// \brief The size of the window reported with NAWS, and the terminal
+    /// type reported with TERMINAL-TYPE.
+    odin::u16   width         = 80;
+    odin::u16   height        = 24;
+    std::string terminal_type = "xterm";
+
+    /// \brief Whether the session agrees to MCCP compression.
+    bool compression = true;
+
+    /// \brief The mean number of commands issued per second, and the
+    /// relative weights with which each command is chosen.
+    double                               command_rate = 0.2;
+    std::array<double, NUMBER_OF_COMMANDS> command_mix = {{ 4, 2, 2, 3, 1 }};
+
+    /// \brief How long the session waits for the server at any step before
+    /// giving up.
+    std::chrono::steady_clock::duration timeout = std::chrono::seconds(30);
+};
+
+//* =========================================================================
+/// \brief A scripted player.
+/// \par
+/// A session connects to the server, negotiates NAWS, TERMINAL-TYPE and
+/// MCCP as a real client would, and then walks through the intro, login
+/// and character selection screens, creating its account and character
+/// if necessary.  Once in the game, it issues commands at random at the
+/// configured rate.
+/// \par
+/// The latency of a command is measured from the moment that its Enter
+/// key is sent to the moment that the server clears it from the command
+/// prompt.  The server clears the prompt in the same repaint that shows
+/// the command's output, so this is the time the player waits for a
+/// response, and it is not confused by output caused by other players.
+/// \par
+/// All of a session's work is done on the io_service passed to it, which
+/// must be run by a single thread.
+//* =========================================================================
+class session
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    session(
+        boost::asio::io_service                &io_service
+      , session_settings                 const &settings
+      , std::shared_ptr<load_statistics> const &statistics);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~session();
+
+    //* =====================================================================
+    /// \brief Connects to the server and begins the script.
+    //* =====================================================================
+    void start();
+
+    //* =====================================================================
+    /// \brief Disconnects from the server.  May be called from any thread.
+    //* =====================================================================
+    void stop();
+
+    //* =====================================================================
+    /// \brief Returns the number of bytes received from the server.  May be
+    /// called from any thread.
+    //* =====================================================================
+    odin::u64 get_bytes_received() const;
+
+    //* =====================================================================
+    /// \brief Returns the number of bytes received from the server once
+    /// decompressed.  May be called from any thread.
+    //* =====================================================================
+    odin::u64 get_bytes_decoded() const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}
+
+#endif
@@ -0,0 +1,572 @@
+// ==========================================================================
+// Paradice9 Loadgen Controller
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file 
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor 
+//    or contributors, which in any way restrict the ability of any party 
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE 
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS 
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR 
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+// ==========================================================================
+#include "loadgen/controller.hpp"
+#include <boost/asio/steady_timer.hpp>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace loadgen {
+
+namespace {
+    typedef odin::metrics::histogram::snapshot snapshot;
+
+    BOOST_STATIC_CONSTANT(odin::u32, NAME_LETTERS = 4);
+
+    // ======================================================================
+    // MAKE_NAME
+    // ======================================================================
+    std::string make_name(std::string const &prefix, odin::u32 index)
+    {
+        // Names must be alphabetic, so the index is written in base 26.
+        std::string suffix(NAME_LETTERS, 'a');
+
+        for (auto letter = suffix.rbegin(); letter != suffix.rend(); ++letter)
+        {
+            *letter = char('a' + index % 26);
+            index /= 26;
+        }
+
+        return prefix + suffix;
+    }
+
+    // ======================================================================
+    // ADD
+    // ======================================================================
+    void add(snapshot &total, snapshot const &other)
+    {
+        total.count += other.count;
+        total.sum   += other.sum;
+        total.max    = (std::max)(total.max, other.max);
+        total.buckets.resize(
+            (std::max)(total.buckets.size(), other.buckets.size()));
+
+        for (std::size_t index = 0; index < other.buckets.size(); ++index)
+        {
+            total.buckets[index] += other.buckets[index];
+        }
+    }
+
+    // ======================================================================
+    // SUBTRACT
+    // ======================================================================
+    snapshot subtract(snapshot later, snapshot const &earlier)
+    {
+        // The maximum cannot be subtracted, so the later one is kept; it
+        // only serves to cap the quantiles, which come from the buckets.
+        later.count -= earlier.count;
+        later.sum   -= earlier.sum;
+
+        for (std::size_t index = 0; index < earlier.buckets.size(); ++index)
+        {
+            later.buckets[index] -= earlier.buckets[index];
+        }
+
+        return later;
+    }
+
+    // ======================================================================
+    // TO_MILLISECONDS
+    // ======================================================================
+    double to_milliseconds(odin::u64 nanoseconds)
+    {
+        return nanoseconds / 1e6;
+    }
+
+    // ======================================================================
+    // SAMPLE
+    // ======================================================================
+    struct sample
+    {
+        std::chrono::steady_clock::time_point time;
+        snapshot                              latency;
+        odin::u64                             failures       = 0;
+        odin::u64                             bytes_received = 0;
+        double                                cpu_seconds    = -1;
+    };
+
+    // ======================================================================
+    // GET_CPU_SECONDS
+    // ======================================================================
+    double get_cpu_seconds(odin::s32 pid)
+    {
+#if defined(__linux__)
+        if (pid == 0)
+        {
+            return -1;
+        }
+
+        std::ifstream stat(boost::str(boost::format("/proc/%d/stat") % pid));
+        std::string line;
+
+        if (!std::getline(stat, line))
+        {
+            return -1;
+        }
+
+        // The command name may contain spaces, but is in parentheses, and
+        // the user and system times are the 12th and 13th fields after it.
+        auto const end_of_name = line.rfind(')');
+
+        if (end_of_name == std::string::npos)
+        {
+            return -1;
+        }
+
+        std::istringstream fields(line.substr(end_of_name + 1));
+        std::string field;
+
+        for (int index = 0; index < 11; ++index)
+        {
+            fields >> field;
+        }
+
+        unsigned long long user_ticks = 0;
+        unsigned long long system_ticks = 0;
+
+        if (!(fields >> user_ticks >> system_ticks))
+        {
+            return -1;
+        }
+
+        return double(user_ticks + system_ticks) / sysconf(_SC_CLK_TCK);
+#else
+        return -1;
+#endif
+    }
+}
+
+// ==========================================================================
+// CONTROLLER::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct controller::impl
+    : std::enable_shared_from_this<controller::impl>
+{
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(
+        odin::net::io_service_pool       &pool
+      , controller_settings        const &settings
+      , std::ostream                     &out)
+      : pool_(pool),
+        settings_(settings),
+        out_(out),
+        statistics_(std::make_shared<load_statistics>()),
+        connect_timer_(pool.get_io_service()),
+        report_timer_(pool.get_io_service()),
+        target_(settings.sessions)
+    {
+        // Whispers are sent to the sessions that the test begins with, so
+        // that most of them find someone.
+        auto targets = std::make_shared<std::vector<std::string>>();
+
+        for (odin::u32 index = 0; index < settings_.sessions; ++index)
+        {
+            targets->push_back(make_name(settings_.name_prefix, index));
+        }
+
+        settings_.session.whisper_targets = targets;
+    }
+
+    // ======================================================================
+    // START
+    // ======================================================================
+    void start()
+    {
+        start_time_ = std::chrono::steady_clock::now();
+        step_start_ = take_sample();
+        last_report_ = step_start_;
+
+        out_ << "   time sessions  in-game   failed   cmds/s    p50ms    p90ms"
+                "    p99ms  p99.9ms    maxms  KB/s/client  cpu%\n";
+
+        schedule_connect();
+        schedule_report();
+    }
+
+    // ======================================================================
+    // HAS_FALLEN_OVER
+    // ======================================================================
+    bool has_fallen_over() const
+    {
+        return fallen_over_;
+    }
+
+private :
+    // ======================================================================
+    // SCHEDULE_CONNECT
+    // ======================================================================
+    void schedule_connect()
+    {
+        auto const interval = std::chrono::duration<double>(
+            1.0 / (std::max)(settings_.connect_rate, 0.001));
+
+        connect_timer_.expires_from_now(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                interval));
+        connect_timer_.async_wait(
+            [pthis=shared_from_this()](boost::system::error_code const &ec)
+            {
+                if (!ec && !pthis->finished_)
+                {
+                    pthis->connect_next();
+                    pthis->schedule_connect();
+                }
+            });
+    }
+
+    // ======================================================================
+    // CONNECT_NEXT
+    // ======================================================================
+    void connect_next()
+    {
+        if (sessions_.size() >= target_)
+        {
+            return;
+        }
+
+        auto settings = settings_.session;
+        settings.name = make_name(
+            settings_.name_prefix, odin::u32(sessions_.size()));
+
+        auto const index = pool_.assign();
+        auto new_session = std::make_shared<session>(
+            std::ref(pool_.get_io_service(index)), settings, statistics_);
+
+        sessions_.push_back(new_session);
+        new_session->start();
+    }
+
+    // ======================================================================
+    // SCHEDULE_REPORT
+    // ======================================================================
+    void schedule_report()
+    {
+        report_timer_.expires_from_now(settings_.report_interval);
+        report_timer_.async_wait(
+            [pthis=shared_from_this()](boost::system::error_code const &ec)
+            {
+                if (!ec && !pthis->finished_)
+                {
+                    pthis->report();
+                }
+            });
+    }
+
+    // ======================================================================
+    // TAKE_SAMPLE
+    // ======================================================================
+    sample take_sample()
+    {
+        sample result;
+        result.time = std::chrono::steady_clock::now();
+
+        for (auto const &latency : statistics_->latency)
+        {
+            add(result.latency, latency.get_snapshot());
+        }
+
+        result.failures = statistics_->failed_logins.get_value()
+                        + statistics_->dropped.get_value()
+                        + statistics_->timeouts.get_value();
+
+        for (auto const &current : sessions_)
+        {
+            result.bytes_received += current->get_bytes_received();
+        }
+
+        result.cpu_seconds = get_cpu_seconds(settings_.server_pid);
+
+        return result;
+    }
+
+    // ======================================================================
+    // REPORT
+    // ======================================================================
+    void report()
+    {
+        auto const now = take_sample();
+        auto const latency = subtract(now.latency, last_report_.latency);
+        auto const seconds = std::chrono::duration<double>(
+            now.time - last_report_.time).count();
+        auto const elapsed = std::chrono::duration<double>(
+            now.time - start_time_).count();
+        auto const connected = statistics_->connected.get_value();
+
+        auto const per_client = connected > 0
+            ? (now.bytes_received - last_report_.bytes_received)
+                  / 1024.0 / seconds / connected
+            : 0.0;
+
+        std::string cpu = "n/a";
+
+        if (now.cpu_seconds >= 0 && last_report_.cpu_seconds >= 0)
+        {
+            cpu = boost::str(boost::format("%.0f")
+                % ((now.cpu_seconds - last_report_.cpu_seconds) / seconds * 100));
+        }
+
+        out_ << boost::format(
+                "%7.0f %8d %8d %8d %8.1f %8.2f %8.2f %8.2f %8.2f %8.2f %12.2f %5s\n")
+            % elapsed
+            % sessions_.size()
+            % statistics_->in_game.get_value()
+            % now.failures
+            % (latency.count / seconds)
+            % to_milliseconds(latency.get_quantile(0.5))
+            % to_milliseconds(latency.get_quantile(0.9))
+            % to_milliseconds(latency.get_quantile(0.99))
+            % to_milliseconds(latency.get_quantile(0.999))
+            % to_milliseconds(latency.get_quantile(1.0))
+            % per_client
+            % cpu;
+        out_.flush();
+
+        last_report_ = now;
+
+        if (settings_.maximum_sessions > settings_.sessions)
+        {
+            evaluate_step(now);
+        }
+        else if (now.time - start_time_ >= settings_.duration)
+        {
+            finish();
+        }
+
+        if (!finished_)
+        {
+            schedule_report();
+        }
+    }
+
+    // ======================================================================
+    // EVALUATE_STEP
+    // ======================================================================
+    void evaluate_step(sample const &now)
+    {
+        // A step is only judged once all of its sessions have been given
+        // the chance to connect and have run for the whole interval.
+        if (sessions_.size() < target_
+         || now.time - step_start_.time < settings_.ramp_interval)
+        {
+            return;
+        }
+
+        auto const latency = subtract(now.latency, step_start_.latency);
+        auto const p99 = to_milliseconds(latency.get_quantile(0.99));
+        auto const failures = now.failures - step_start_.failures;
+
+        if (failures != 0 || p99 > settings_.latency_limit.count())
+        {
+            fallen_over_ = true;
+
+            out_ << boost::format(
+                        "\nThe server fell over at %d sessions "
+                        "(99th percentile %.2fms, %d failures).\n")
+                  % target_
+                  % p99
+                  % failures;
+
+            if (last_good_step_ != 0)
+            {
+                out_ << boost::format("The highest sustained load was %d sessions.\n")
+                      % last_good_step_;
+            }
+
+            finish();
+            return;
+        }
+
+        last_good_step_ = target_;
+
+        if (target_ >= settings_.maximum_sessions)
+        {
+            out_ << boost::format(
+                        "\nThe server sustained %d sessions without falling over.\n")
+                  % target_;
+            finish();
+            return;
+        }
+
+        target_ = (std::min)(
+            target_ + settings_.ramp_step, settings_.maximum_sessions);
+        step_start_ = now;
+    }
+
+    // ======================================================================
+    // FINISH
+    // ======================================================================
+    void finish()
+    {
+        finished_ = true;
+
+        boost::system::error_code unused;
+        connect_timer_.cancel(unused);
+        report_timer_.cancel(unused);
+
+        write_summary();
+
+        for (auto const &current : sessions_)
+        {
+            current->stop();
+        }
+
+        pool_.release_work();
+    }
+
+    // ======================================================================
+    // WRITE_SUMMARY
+    // ======================================================================
+    void write_summary()
+    {
+        out_ << "\ncommand        count    p50ms    p90ms    p99ms  p99.9ms    maxms\n";
+
+        snapshot total;
+
+        for (odin::u32 index = 0; index < NUMBER_OF_COMMANDS; ++index)
+        {
+            auto const latency = statistics_->latency[index].get_snapshot();
+            write_latency(get_command_name(command(index)), latency);
+            add(total, latency);
+        }
+
+        write_latency("all", total);
+
+        auto const logins = statistics_->login_time.get_snapshot();
+
+        out_ << boost::format(
+                    "\nlogins: %d (p50 %.2fms, p99 %.2fms); failed logins: %d; "
+                    "dropped: %d; command timeouts: %d\n")
+              % logins.count
+              % to_milliseconds(logins.get_quantile(0.5))
+              % to_milliseconds(logins.get_quantile(0.99))
+              % statistics_->failed_logins.get_value()
+              % statistics_->dropped.get_value()
+              % statistics_->timeouts.get_value();
+
+        if (!sessions_.empty())
+        {
+            std::vector<odin::u64> received;
+            odin::u64 decoded = 0;
+
+            for (auto const &current : sessions_)
+            {
+                received.push_back(current->get_bytes_received());
+                decoded += current->get_bytes_decoded();
+            }
+
+            auto const bounds = std::minmax_element(received.begin(), received.end());
+            auto const total_received = std::accumulate(
+                received.begin(), received.end(), odin::u64(0));
+
+            out_ << boost::format(
+                        "received per client: mean %.1fKB (min %.1fKB, max %.1fKB); "
+                        "%.1fKB once decompressed\n")
+                  % (total_received / 1024.0 / received.size())
+                  % (*bounds.first / 1024.0)
+                  % (*bounds.second / 1024.0)
+                  % (decoded / 1024.0 / received.size());
+        }
+
+        out_.flush();
+    }
+
+    // ======================================================================
+    // WRITE_LATENCY
+    // ======================================================================
+    void write_latency(char const *name, snapshot const &latency)
+    {
+        out_ << boost::format("%-10s %9d %8.2f %8.2f %8.2f %8.2f %8.2f\n")
+              % name
+              % latency.count
+              % to_milliseconds(latency.get_quantile(0.5))
+              % to_milliseconds(latency.get_quantile(0.9))
+              % to_milliseconds(latency.get_quantile(0.99))
+              % to_milliseconds(latency.get_quantile(0.999))
+              % to_milliseconds(latency.get_quantile(1.0));
+    }
+
+    odin::net::io_service_pool            &pool_;
+    controller_settings                    settings_;
+    std::ostream                          &out_;
+    std::shared_ptr<load_statistics>       statistics_;
+    std::vector<std::shared_ptr<session>>  sessions_;
+    boost::asio::steady_timer              connect_timer_;
+    boost::asio::steady_timer              report_timer_;
+    odin::u32                              target_;
+    odin::u32                              last_good_step_ = 0;
+    std::chrono::steady_clock::time_point  start_time_;
+    sample                                 step_start_;
+    sample                                 last_report_;
+    bool                                   finished_    = false;
+    bool                                   fallen_over_ = false;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+controller::controller(
+    odin::net::io_service_pool       &pool
+  , controller_settings        const &settings
+  , std::ostream                     &out)
+    : pimpl_(std::make_shared<impl>(std::ref(pool), settings, std::ref(out)))
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+controller::~controller()
+{
+}
+
+// ==========================================================================
+// START
+// ==========================================================================
+void controller::start()
+{
+    pimpl_->start();
+}
+
+// ==========================================================================
+// HAS_SERVER_FALLEN_OVER
+// ==========================================================================
+bool controller::has_server_fallen_over() const
+{
+    return pimpl_->has_fallen_over();
+}
+
+}
@@ -0,0 +1,223 @@
+// ==========================================================================
+// Paradice9 Loadgen
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file 
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor 
+//    or contributors, which in any way restrict the ability of any party 
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE 
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS 
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR 
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+// ==========================================================================
+#include "loadgen/controller.hpp"
+#include "odin/net/io_service_pool.hpp"
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace po = boost::program_options;
+
+namespace {
+
+// ==========================================================================
+// PARSE_MIX
+// ==========================================================================
+void parse_mix(
+    std::string const                                           &text
+  , std::array<double, loadgen::NUMBER_OF_COMMANDS>              &mix)
+{
+    // The mix is a list of command=weight pairs, such as "say=4,roll=1".
+    // Commands that are not mentioned are not issued.
+    mix.fill(0);
+
+    std::vector<std::string> entries;
+    boost::split(entries, text, boost::is_any_of(","));
+
+    for (auto const &entry : entries)
+    {
+        auto const equals = entry.find('=');
+        auto const name = entry.substr(0, equals);
+        odin::u32 index = 0;
+
+        while (index < loadgen::NUMBER_OF_COMMANDS
+            && name != loadgen::get_command_name(loadgen::command(index)))
+        {
+            ++index;
+        }
+
+        if (index == loadgen::NUMBER_OF_COMMANDS || equals == std::string::npos)
+        {
+            throw po::error("Invalid command mix entry: " + entry);
+        }
+
+        try
+        {
+            mix[index] = boost::lexical_cast<double>(entry.substr(equals + 1));
+        }
+        catch (boost::bad_lexical_cast const &)
+        {
+            throw po::error("Invalid command mix weight: " + entry);
+        }
+    }
+
+    if (std::all_of(mix.begin(), mix.end(), [](double weight){ return weight <= 0; }))
+    {
+        throw po::error("The command mix must include at least one command");
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    loadgen::controller_settings settings;
+
+    std::string  host            = "127.0.0.1";
+    unsigned int port            = 4000;
+    unsigned int threads         = 1;
+    std::string  mix             = "say=4,emote=2,whisper=2,roll=3,showrolls=1";
+    double       ramp_interval   = 30;
+    double       duration        = 60;
+    double       report_interval = 5;
+    unsigned int latency_limit   = 500;
+    unsigned int timeout         = 30;
+    bool         no_compression  = false;
+
+    settings.session.password = "loadgen";
+
+    po::options_description description("Available options");
+    description.add_options()
+        ( "help,h",                                                           "show this help message" )
+        ( "host",            po::value<std::string>(&host),                   "address of the server (loopback by default)" )
+        ( "port,p",          po::value<unsigned int>(&port),                  "port of the server" )
+        ( "threads,t",       po::value<unsigned int>(&threads),               "number of threads running sessions" )
+        ( "sessions,n",      po::value<odin::u32>(&settings.sessions),        "number of sessions with which to begin" )
+        ( "max-sessions",    po::value<odin::u32>(&settings.maximum_sessions), "ramp up to this many sessions until the server falls over" )
+        ( "ramp-step",       po::value<odin::u32>(&settings.ramp_step),       "sessions added at each step of the ramp" )
+        ( "ramp-interval",   po::value<double>(&ramp_interval),               "seconds that each step of the ramp runs for" )
+        ( "connect-rate",    po::value<double>(&settings.connect_rate),       "new connections per second" )
+        ( "rate",            po::value<double>(&settings.session.command_rate), "commands per second issued by each session" )
+        ( "mix",             po::value<std::string>(&mix),                    "relative weights of the commands, as command=weight pairs separated by commas" )
+        ( "duration",        po::value<double>(&duration),                    "seconds that a test without a ramp runs for" )
+        ( "report-interval", po::value<double>(&report_interval),             "seconds between lines of measurements" )
+        ( "latency-limit",   po::value<unsigned int>(&latency_limit),         "99th percentile latency, in milliseconds, at which the server is judged to have fallen over" )
+        ( "timeout",         po::value<unsigned int>(&timeout),               "seconds to wait for the server at any step before giving up on a session" )
+        ( "prefix",          po::value<std::string>(&settings.name_prefix),   "alphabetic prefix of the scripted account and character names" )
+        ( "password",        po::value<std::string>(&settings.session.password), "password of the scripted accounts" )
+        ( "width",           po::value<odin::u16>(&settings.session.width),   "window width reported by each session" )
+        ( "height",          po::value<odin::u16>(&settings.session.height),  "window height reported by each session" )
+        ( "terminal-type",   po::value<std::string>(&settings.session.terminal_type), "terminal type reported by each session" )
+        ( "no-compression",  po::bool_switch(&no_compression),                "refuse MCCP compression" )
+        ( "server-pid",      po::value<odin::s32>(&settings.server_pid),      "process ID of the server, whose CPU usage is reported" )
+        ;
+
+    try
+    {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, description), vm);
+        po::notify(vm);
+
+        if (vm.count("help") != 0)
+        {
+            throw po::error("");
+        }
+
+        boost::system::error_code ec;
+        auto const address = boost::asio::ip::address::from_string(host, ec);
+
+        if (ec)
+        {
+            throw po::error("Invalid host address: " + host);
+        }
+
+        settings.session.endpoint = { address, odin::u16(port) };
+
+        if (settings.name_prefix.empty()
+         || !std::all_of(
+                settings.name_prefix.begin(),
+                settings.name_prefix.end(),
+                [](char ch){ return std::isalpha(static_cast<unsigned char>(ch)) != 0; }))
+        {
+            throw po::error("The name prefix must be alphabetic");
+        }
+
+        if (settings.sessions == 0 || threads == 0)
+        {
+            throw po::error("There must be at least one session and thread");
+        }
+
+        if (settings.connect_rate <= 0)
+        {
+            throw po::error("The connect rate must be positive");
+        }
+
+        parse_mix(mix, settings.session.command_mix);
+
+        settings.session.compression = !no_compression;
+        settings.session.timeout     = std::chrono::seconds(timeout);
+        settings.ramp_interval       = std::chrono::milliseconds(
+            odin::s64(ramp_interval * 1000));
+        settings.duration            = std::chrono::milliseconds(
+            odin::s64(duration * 1000));
+        settings.report_interval     = std::chrono::milliseconds(
+            odin::s64((std::max)(report_interval, 0.1) * 1000));
+        settings.latency_limit       = std::chrono::milliseconds(latency_limit);
+        settings.ramp_step           = (std::max)(settings.ramp_step, odin::u32(1));
+    }
+    catch (po::error &err)
+    {
+        if (strlen(err.what()) == 0)
+        {
+            std::cout << boost::format("USAGE: %s <options>\n") % argv[0]
+                      << description
+                      << std::endl;
+
+            return EXIT_SUCCESS;
+        }
+
+        std::cerr << boost::format("ERROR: %s\n\nUSAGE: %s <options>\n")
+                     % err.what()
+                     % argv[0]
+                  << description
+                  << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    // Each io_service is run by a single thread, which is what a session
+    // requires.
+    odin::net::io_service_pool pool(threads, 1);
+
+    loadgen::controller test(pool, settings, std::cout);
+    test.start();
+
+    pool.run();
+
+    return test.has_server_fallen_over() ? 2 : EXIT_SUCCESS;
+}
@@ -0,0 +1,526 @@
+// ==========================================================================
+// Paradice9 Loadgen Screen
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file 
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor 
+//    or contributors, which in any way restrict the ability of any party 
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE 
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS 
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR 
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+// ==========================================================================
+#include "loadgen/screen.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace loadgen {
+
+namespace {
+    BOOST_STATIC_CONSTANT(char, ESC = 0x1B);
+    BOOST_STATIC_CONSTANT(char, BEL = 0x07);
+    BOOST_STATIC_CONSTANT(unsigned char, CSI_8BIT = 0x9B);
+    BOOST_STATIC_CONSTANT(unsigned char, OSC_8BIT = 0x9D);
+    BOOST_STATIC_CONSTANT(unsigned char, ST_8BIT  = 0x9C);
+
+    enum class parse_state
+    {
+        ground,
+        escape,
+        designate,
+        csi,
+        osc,
+        osc_escape,
+        utf8
+    };
+}
+
+// ==========================================================================
+// SCREEN::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct screen::impl
+{
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(odin::u16 width, odin::u16 height)
+        : width_(width),
+          height_(height),
+          rows_(height, std::string(width, ' '))
+    {
+    }
+
+    // ======================================================================
+    // WRITE
+    // ======================================================================
+    void write(unsigned char ch)
+    {
+        switch (state_)
+        {
+            case parse_state::ground :
+                write_ground(ch);
+                break;
+
+            case parse_state::escape :
+                write_escape(ch);
+                break;
+
+            case parse_state::designate :
+                // The character set that is being designated is ignored.
+                state_ = parse_state::ground;
+                break;
+
+            case parse_state::csi :
+                write_csi(ch);
+                break;
+
+            case parse_state::osc :
+                if (ch == BEL || ch == ST_8BIT)
+                {
+                    state_ = parse_state::ground;
+                }
+                else if (ch == ESC)
+                {
+                    state_ = parse_state::osc_escape;
+                }
+                break;
+
+            case parse_state::osc_escape :
+                state_ = ch == '\\' ? parse_state::ground : parse_state::osc;
+                break;
+
+            case parse_state::utf8 :
+                if (--utf8_remaining_ == 0)
+                {
+                    put('?');
+                    state_ = parse_state::ground;
+                }
+                break;
+        }
+    }
+
+    // ======================================================================
+    // WRITE_GROUND
+    // ======================================================================
+    void write_ground(unsigned char ch)
+    {
+        if (ch == ESC)
+        {
+            state_ = parse_state::escape;
+        }
+        else if (ch == CSI_8BIT)
+        {
+            begin_csi();
+        }
+        else if (ch == OSC_8BIT)
+        {
+            state_ = parse_state::osc;
+        }
+        else if (ch == '\r')
+        {
+            column_ = 0;
+        }
+        else if (ch == '\n')
+        {
+            line_feed();
+        }
+        else if (ch == '\b')
+        {
+            column_ = column_ == 0 ? 0 : column_ - 1;
+        }
+        else if (ch == '\t')
+        {
+            column_ = (std::min)(odin::u16((column_ / 8 + 1) * 8), last_column());
+        }
+        else if (ch >= 0x20 && ch < 0x7F)
+        {
+            put(char(ch));
+        }
+        else if (ch >= 0xC2 && ch <= 0xF4)
+        {
+            // The lead byte of a UTF-8 sequence gives its length.
+            utf8_remaining_ = ch >= 0xF0 ? 3 : ch >= 0xE0 ? 2 : 1;
+            state_ = parse_state::utf8;
+        }
+    }
+
+    // ======================================================================
+    // WRITE_ESCAPE
+    // ======================================================================
+    void write_escape(unsigned char ch)
+    {
+        state_ = parse_state::ground;
+
+        switch (ch)
+        {
+            case '[' : begin_csi(); break;
+            case ']' : state_ = parse_state::osc; break;
+            case '(' : // Fall through
+            case ')' : // Fall through
+            case '*' : // Fall through
+            case '+' : state_ = parse_state::designate; break;
+            case '7' : save_cursor(); break;
+            case '8' : restore_cursor(); break;
+            case 'D' : line_feed(); break;
+            case 'E' : column_ = 0; line_feed(); break;
+            case 'M' : reverse_line_feed(); break;
+            case 'c' : clear(0, 0, height_, width_); row_ = column_ = 0; break;
+            default :  break;
+        }
+    }
+
+    // ======================================================================
+    // BEGIN_CSI
+    // ======================================================================
+    void begin_csi()
+    {
+        parameters_.clear();
+        state_ = parse_state::csi;
+    }
+
+    // ======================================================================
+    // WRITE_CSI
+    // ======================================================================
+    void write_csi(unsigned char ch)
+    {
+        if (ch < 0x40 || ch > 0x7E)
+        {
+            parameters_ += char(ch);
+            return;
+        }
+
+        state_ = parse_state::ground;
+
+        // Private sequences, such as those that set modes, do not affect
+        // the contents of the screen.
+        if (!parameters_.empty()
+         && (parameters_[0] == '?' || parameters_[0] == '>'))
+        {
+            return;
+        }
+
+        auto const first  = get_parameter(0, 1);
+        auto const second = get_parameter(1, 1);
+
+        switch (ch)
+        {
+            case 'A' : row_ = row_ > first ? row_ - first : 0; break;
+            case 'B' : row_ = clamp_row(row_ + first); break;
+            case 'C' : column_ = clamp_column(column_ + first); break;
+            case 'D' : column_ = column_ > first ? column_ - first : 0; break;
+            case 'E' : row_ = clamp_row(row_ + first); column_ = 0; break;
+            case 'F' : row_ = row_ > first ? row_ - first : 0; column_ = 0; break;
+            case 'G' : // Fall through
+            case '`' : column_ = clamp_column(first - 1); break;
+            case 'd' : row_ = clamp_row(first - 1); break;
+            case 'H' : // Fall through
+            case 'f' :
+                row_    = clamp_row(first - 1);
+                column_ = clamp_column(second - 1);
+                break;
+            case 'J' : erase_in_display(get_parameter(0, 0)); break;
+            case 'K' : erase_in_line(get_parameter(0, 0)); break;
+            case 'X' :
+                clear(row_, column_, row_ + 1, clamp_column(column_ + first - 1) + 1);
+                break;
+            case '@' : insert_characters(first); break;
+            case 'P' : delete_characters(first); break;
+            case 's' : save_cursor(); break;
+            case 'u' : restore_cursor(); break;
+            default :  break;
+        }
+
+        pending_wrap_ = false;
+    }
+
+    // ======================================================================
+    // GET_PARAMETER
+    // ======================================================================
+    odin::u32 get_parameter(odin::u32 index, odin::u32 default_value) const
+    {
+        std::string::size_type begin = 0;
+
+        for (odin::u32 current = 0; current < index; ++current)
+        {
+            begin = parameters_.find(';', begin);
+
+            if (begin == std::string::npos)
+            {
+                return default_value;
+            }
+
+            ++begin;
+        }
+
+        auto const value = std::strtoul(parameters_.c_str() + begin, nullptr, 10);
+        return value == 0 ? default_value : odin::u32(value);
+    }
+
+    // ======================================================================
+    // PUT
+    // ======================================================================
+    void put(char ch)
+    {
+        // A character written to the last column leaves the cursor there,
+        // and only wraps when the next character is written.
+        if (pending_wrap_)
+        {
+            column_ = 0;
+            line_feed();
+            pending_wrap_ = false;
+        }
+
+        rows_[row_][column_] = ch;
+
+        if (column_ == last_column())
+        {
+            pending_wrap_ = true;
+        }
+        else
+        {
+            ++column_;
+        }
+    }
+
+    // ======================================================================
+    // LINE_FEED
+    // ======================================================================
+    void line_feed()
+    {
+        if (row_ + 1 < height_)
+        {
+            ++row_;
+        }
+        else
+        {
+            rows_.erase(rows_.begin());
+            rows_.push_back(std::string(width_, ' '));
+        }
+    }
+
+    // ======================================================================
+    // REVERSE_LINE_FEED
+    // ======================================================================
+    void reverse_line_feed()
+    {
+        if (row_ > 0)
+        {
+            --row_;
+        }
+        else
+        {
+            rows_.pop_back();
+            rows_.insert(rows_.begin(), std::string(width_, ' '));
+        }
+    }
+
+    // ======================================================================
+    // ERASE_IN_DISPLAY
+    // ======================================================================
+    void erase_in_display(odin::u32 mode)
+    {
+        switch (mode)
+        {
+            case 0 :
+                clear(row_, column_, row_ + 1, width_);
+                clear(row_ + 1, 0, height_, width_);
+                break;
+
+            case 1 :
+                clear(0, 0, row_, width_);
+                clear(row_, 0, row_ + 1, column_ + 1);
+                break;
+
+            default :
+                clear(0, 0, height_, width_);
+                break;
+        }
+    }
+
+    // ======================================================================
+    // ERASE_IN_LINE
+    // ======================================================================
+    void erase_in_line(odin::u32 mode)
+    {
+        switch (mode)
+        {
+            case 0 :  clear(row_, column_, row_ + 1, width_); break;
+            case 1 :  clear(row_, 0, row_ + 1, column_ + 1); break;
+            default : clear(row_, 0, row_ + 1, width_); break;
+        }
+    }
+
+    // ======================================================================
+    // INSERT_CHARACTERS
+    // ======================================================================
+    void insert_characters(odin::u32 amount)
+    {
+        auto &row = rows_[row_];
+        amount = (std::min)(amount, odin::u32(width_ - column_));
+        row.insert(column_, amount, ' ');
+        row.resize(width_);
+    }
+
+    // ======================================================================
+    // DELETE_CHARACTERS
+    // ======================================================================
+    void delete_characters(odin::u32 amount)
+    {
+        auto &row = rows_[row_];
+        amount = (std::min)(amount, odin::u32(width_ - column_));
+        row.erase(column_, amount);
+        row.append(amount, ' ');
+    }
+
+    // ======================================================================
+    // CLEAR
+    // ======================================================================
+    void clear(
+        odin::u32 top, odin::u32 left, odin::u32 bottom, odin::u32 right)
+    {
+        for (auto row = top; row < bottom && row < height_; ++row)
+        {
+            for (auto column = left; column < right && column < width_; ++column)
+            {
+                rows_[row][column] = ' ';
+            }
+        }
+    }
+
+    // ======================================================================
+    // SAVE_CURSOR
+    // ======================================================================
+    void save_cursor()
+    {
+        saved_row_    = row_;
+        saved_column_ = column_;
+    }
+
+    // ======================================================================
+    // RESTORE_CURSOR
+    // ======================================================================
+    void restore_cursor()
+    {
+        row_    = saved_row_;
+        column_ = saved_column_;
+    }
+
+    // ======================================================================
+    // CLAMP_ROW
+    // ======================================================================
+    odin::u16 clamp_row(odin::u32 row) const
+    {
+        return odin::u16((std::min)(row, odin::u32(height_ - 1)));
+    }
+
+    // ======================================================================
+    // CLAMP_COLUMN
+    // ======================================================================
+    odin::u16 clamp_column(odin::u32 column) const
+    {
+        return odin::u16((std::min)(column, odin::u32(last_column())));
+    }
+
+    // ======================================================================
+    // LAST_COLUMN
+    // ======================================================================
+    odin::u16 last_column() const
+    {
+        return odin::u16(width_ - 1);
+    }
+
+    odin::u16                width_;
+    odin::u16                height_;
+    std::vector<std::string> rows_;
+    odin::u16                row_          = 0;
+    odin::u16                column_       = 0;
+    odin::u16                saved_row_    = 0;
+    odin::u16                saved_column_ = 0;
+    bool                     pending_wrap_ = false;
+    parse_state              state_        = parse_state::ground;
+    std::string              parameters_;
+    odin::u32                utf8_remaining_ = 0;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+screen::screen(odin::u16 width, odin::u16 height)
+    : pimpl_(std::make_shared<impl>(
+          (std::max)(width, odin::u16(1)), (std::max)(height, odin::u16(1))))
+{
+}
+
+// ==========================================================================
+// WRITE
+// ==========================================================================
+void screen::write(char const *data, std::size_t size)
+{
+    for (std::size_t index = 0; index < size; ++index)
+    {
+        pimpl_->write(static_cast<unsigned char>(data[index]));
+    }
+}
+
+// ==========================================================================
+// GET_HEIGHT
+// ==========================================================================
+odin::u16 screen::get_height() const
+{
+    return pimpl_->height_;
+}
+
+// ==========================================================================
+// GET_ROW
+// ==========================================================================
+std::string const &screen::get_row(odin::u16 row) const
+{
+    return pimpl_->rows_[row];
+}
+
+// ==========================================================================
+// CONTAINS
+// ==========================================================================
+bool screen::contains(std::string const &text) const
+{
+    return std::any_of(
+        pimpl_->rows_.begin()
+      , pimpl_->rows_.end()
+      , [&text](std::string const &row)
+        {
+            return row.find(text) != std::string::npos;
+        });
+}
+
+// ==========================================================================
+// FIND_LAST_ROW
+// ==========================================================================
+odin::u16 screen::find_last_row(std::string const &text) const
+{
+    for (auto row = pimpl_->height_; row != 0; --row)
+    {
+        if (pimpl_->rows_[row - 1].find(text) != std::string::npos)
+        {
+            return odin::u16(row - 1);
+        }
+    }
+
+    return pimpl_->height_;
+}
+
+}
@@ -0,0 +1,987 @@
+// ==========================================================================
+// Paradice9 Loadgen Session
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file 
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor 
+//    or contributors, which in any way restrict the ability of any party 
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE 
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS 
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR 
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
+// ==========================================================================
+#include "loadgen/session.hpp"
+#include "loadgen/screen.hpp"
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/format.hpp>
+#include <zlib.h>
+#include <atomic>
+#include <deque>
+#include <random>
+
+namespace loadgen {
+
+namespace {
+    // Telnet commands and option codes.
+    BOOST_STATIC_CONSTANT(odin::u8, SE   = 240);
+    BOOST_STATIC_CONSTANT(odin::u8, SB   = 250);
+    BOOST_STATIC_CONSTANT(odin::u8, WILL = 251);
+    BOOST_STATIC_CONSTANT(odin::u8, WONT = 252);
+    BOOST_STATIC_CONSTANT(odin::u8, DO   = 253);
+    BOOST_STATIC_CONSTANT(odin::u8, DONT = 254);
+    BOOST_STATIC_CONSTANT(odin::u8, IAC  = 255);
+
+    BOOST_STATIC_CONSTANT(odin::u8, ECHO          = 1);
+    BOOST_STATIC_CONSTANT(odin::u8, SGA           = 3);
+    BOOST_STATIC_CONSTANT(odin::u8, TERMINAL_TYPE = 24);
+    BOOST_STATIC_CONSTANT(odin::u8, NAWS          = 31);
+    BOOST_STATIC_CONSTANT(odin::u8, COMPRESS2     = 86);
+
+    BOOST_STATIC_CONSTANT(odin::u8, TERMINAL_TYPE_IS   = 0);
+    BOOST_STATIC_CONSTANT(odin::u8, TERMINAL_TYPE_SEND = 1);
+
+    BOOST_STATIC_CONSTANT(std::size_t, READ_BUFFER_SIZE = 8192);
+
+    // Text that identifies each of the server's screens.
+    char const INTRO_MARKER[]              = "Password:";
+    char const LOGIN_FAILED_MARKER[]       = "Invalid username";
+    char const ACCOUNT_CREATION_MARKER[]   = "ACCOUNT CREATION";
+    char const CHARACTER_SELECTION_MARKER[] = "<Create new character>";
+    char const FIRST_CHARACTER_MARKER[]    = "0. ";
+    char const CHARACTER_CREATION_MARKER[] = "CHARACTER CREATION";
+    char const MAIN_SCREEN_MARKER[]        = "CURRENTLY PLAYING";
+
+    // The server understands these as keys.
+    char const TAB[]   = "\t";
+    char const ENTER[] = "\r";
+    char const SPACE[] = " ";
+
+    enum class script_state
+    {
+        connecting,
+        awaiting_intro,
+        logging_in,
+        opening_account_creation,
+        creating_account,
+        selecting_character,
+        creating_character,
+        entering,
+        idle,
+        typing,
+        executing,
+        finished
+    };
+
+    enum class telnet_state
+    {
+        data,
+        iac,
+        negotiation,
+        subnegotiation,
+        subnegotiation_iac
+    };
+
+    // ======================================================================
+    // GET_RANDOM_ENGINE
+    // ======================================================================
+    std::mt19937 &get_random_engine()
+    {
+        thread_local std::mt19937 engine{std::random_device()()};
+        return engine;
+    }
+}
+
+// ==========================================================================
+// GET_COMMAND_NAME
+// ==========================================================================
+char const *get_command_name(command cmd)
+{
+    static char const *const names[] = {
+        "say", "emote", "whisper", "roll", "showrolls"
+    };
+
+    return names[static_cast<odin::u32>(cmd)];
+}
+
+// ==========================================================================
+// SESSION::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct session::impl
+    : std::enable_shared_from_this<session::impl>
+{
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(
+        boost::asio::io_service                &io_service
+      , session_settings                 const &settings
+      , std::shared_ptr<load_statistics> const &statistics)
+      : io_service_(io_service),
+        settings_(settings),
+        statistics_(statistics),
+        socket_(io_service),
+        timeout_timer_(io_service),
+        command_timer_(io_service),
+        screen_(settings.width, settings.height),
+        command_distribution_(
+            settings.command_mix.begin(), settings.command_mix.end())
+    {
+        inflater_.zalloc = Z_NULL;
+        inflater_.zfree  = Z_NULL;
+        inflater_.opaque = Z_NULL;
+        inflateInit(&inflater_);
+    }
+
+    // ======================================================================
+    // DESTRUCTOR
+    // ======================================================================
+    ~impl()
+    {
+        inflateEnd(&inflater_);
+    }
+
+    // ======================================================================
+    // START
+    // ======================================================================
+    void start()
+    {
+        start_time_ = std::chrono::steady_clock::now();
+        arm_timeout();
+
+        socket_.async_connect(
+            settings_.endpoint,
+            [pthis=shared_from_this()](boost::system::error_code const &ec)
+            {
+                pthis->on_connect(ec);
+            });
+    }
+
+    // ======================================================================
+    // FINISH
+    // ======================================================================
+    void finish()
+    {
+        if (state_ == script_state::finished)
+        {
+            return;
+        }
+
+        if (connected_)
+        {
+            statistics_->connected.add(-1);
+        }
+
+        if (in_game_)
+        {
+            statistics_->in_game.add(-1);
+        }
+
+        state_ = script_state::finished;
+
+        boost::system::error_code unused;
+        socket_.close(unused);
+        timeout_timer_.cancel(unused);
+        command_timer_.cancel(unused);
+    }
+
+    // ======================================================================
+    // FAIL
+    // ======================================================================
+    void fail()
+    {
+        if (state_ == script_state::finished)
+        {
+            return;
+        }
+
+        if (in_game_)
+        {
+            statistics_->dropped.add();
+        }
+        else
+        {
+            statistics_->failed_logins.add();
+        }
+
+        finish();
+    }
+
+    boost::asio::io_service               &io_service_;
+    session_settings                       settings_;
+    std::shared_ptr<load_statistics>       statistics_;
+    std::atomic<odin::u64>                 bytes_received_{0};
+    std::atomic<odin::u64>                 bytes_decoded_{0};
+
+private :
+    // ======================================================================
+    // ON_CONNECT
+    // ======================================================================
+    void on_connect(boost::system::error_code const &ec)
+    {
+        if (state_ == script_state::finished)
+        {
+            return;
+        }
+
+        if (ec)
+        {
+            fail();
+            return;
+        }
+
+        connected_ = true;
+        statistics_->connected.add(1);
+
+        boost::system::error_code unused;
+        socket_.set_option(boost::asio::ip::tcp::no_delay(true), unused);
+
+        state_ = script_state::awaiting_intro;
+        read();
+    }
+
+    // ======================================================================
+    // READ
+    // ======================================================================
+    void read()
+    {
+        socket_.async_read_some(
+            boost::asio::buffer(read_buffer_),
+            [pthis=shared_from_this()](
+                boost::system::error_code const &ec, std::size_t size)
+            {
+                pthis->on_read(ec, size);
+            });
+    }
+
+    // ======================================================================
+    // ON_READ
+    // ======================================================================
+    void on_read(boost::system::error_code const &ec, std::size_t size)
+    {
+        if (state_ == script_state::finished)
+        {
+            return;
+        }
+
+        if (ec)
+        {
+            fail();
+            return;
+        }
+
+        bytes_received_ += size;
+
+        if (!receive(read_buffer_.data(), size))
+        {
+            fail();
+            return;
+        }
+
+        advance();
+
+        if (state_ != script_state::finished)
+        {
+            read();
+        }
+    }
+
+    // ======================================================================
+    // RECEIVE
+    // ======================================================================
+    bool receive(char const *data, std::size_t size)
+    {
+        // Data after the start of compression must be inflated, and data
+        // after its end must not, so the two are handled in turn until the
+        // buffer is used up.
+        while (size != 0)
+        {
+            auto const consumed = inflating_
+                ? inflate(data, size)
+                : parse_telnet(data, size);
+
+            if (consumed == 0 && inflating_ && inflate_failed_)
+            {
+                return false;
+            }
+
+            data += consumed;
+            size -= consumed;
+        }
+
+        return !inflate_failed_;
+    }
+
+    // ======================================================================
+    // INFLATE
+    // ======================================================================
+    std::size_t inflate(char const *data, std::size_t size)
+    {
+        inflater_.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        inflater_.avail_in = uInt(size);
+
+        do
+        {
+            inflater_.next_out  = reinterpret_cast<Bytef *>(inflate_buffer_.data());
+            inflater_.avail_out = uInt(inflate_buffer_.size());
+
+            auto const result = ::inflate(&inflater_, Z_NO_FLUSH);
+            auto const produced = inflate_buffer_.size() - inflater_.avail_out;
+
+            if (produced != 0)
+            {
+                parse_telnet(inflate_buffer_.data(), produced);
+            }
+
+            if (result == Z_STREAM_END)
+            {
+                inflating_ = false;
+                break;
+            }
+
+            if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                inflate_failed_ = true;
+                break;
+            }
+        }
+        while (inflater_.avail_in != 0 || inflater_.avail_out == 0);
+
+        return size - inflater_.avail_in;
+    }
+
+    // ======================================================================
+    // PARSE_TELNET
+    // ======================================================================
+    std::size_t parse_telnet(char const *data, std::size_t size)
+    {
+        std::string text;
+        std::size_t index = 0;
+
+        while (index < size)
+        {
+            auto const ch = odin::u8(data[index++]);
+
+            switch (telnet_state_)
+            {
+                case telnet_state::data :
+                    if (ch == IAC)
+                    {
+                        telnet_state_ = telnet_state::iac;
+                    }
+                    else
+                    {
+                        text += char(ch);
+                    }
+                    break;
+
+                case telnet_state::iac :
+                    if (ch == IAC)
+                    {
+                        text += char(ch);
+                        telnet_state_ = telnet_state::data;
+                    }
+                    else if (ch >= WILL && ch <= DONT)
+                    {
+                        negotiation_ = ch;
+                        telnet_state_ = telnet_state::negotiation;
+                    }
+                    else if (ch == SB)
+                    {
+                        subnegotiation_.clear();
+                        telnet_state_ = telnet_state::subnegotiation;
+                    }
+                    else
+                    {
+                        telnet_state_ = telnet_state::data;
+                    }
+                    break;
+
+                case telnet_state::negotiation :
+                    on_negotiation(negotiation_, ch);
+                    telnet_state_ = telnet_state::data;
+                    break;
+
+                case telnet_state::subnegotiation :
+                    if (ch == IAC)
+                    {
+                        telnet_state_ = telnet_state::subnegotiation_iac;
+                    }
+                    else
+                    {
+                        subnegotiation_ += char(ch);
+                    }
+                    break;
+
+                case telnet_state::subnegotiation_iac :
+                    if (ch == SE)
+                    {
+                        telnet_state_ = telnet_state::data;
+
+                        if (on_subnegotiation())
+                        {
+                            // Everything after this is compressed.
+                            screen_.write(text.data(), text.size());
+                            bytes_decoded_ += text.size();
+                            return index;
+                        }
+                    }
+                    else
+                    {
+                        subnegotiation_ += char(ch);
+                        telnet_state_ = telnet_state::subnegotiation;
+                    }
+                    break;
+            }
+        }
+
+        screen_.write(text.data(), text.size());
+        bytes_decoded_ += text.size();
+        return index;
+    }
+
+    // ======================================================================
+    // ON_NEGOTIATION
+    // ======================================================================
+    void on_negotiation(odin::u8 request, odin::u8 option)
+    {
+        // Each option is answered only when its state changes, so that the
+        // negotiation cannot loop.
+        if (request == WILL || request == WONT)
+        {
+            bool const agree = request == WILL
+                && (option == ECHO
+                 || option == SGA
+                 || (option == COMPRESS2 && settings_.compression));
+
+            if (remote_options_[option] != agree || !remote_answered_[option])
+            {
+                remote_options_[option]  = agree;
+                remote_answered_[option] = true;
+                send_negotiation(agree ? DO : DONT, option);
+            }
+        }
+        else
+        {
+            bool const agree = request == DO
+                && (option == NAWS || option == TERMINAL_TYPE);
+
+            if (local_options_[option] != agree || !local_answered_[option])
+            {
+                local_options_[option]  = agree;
+                local_answered_[option] = true;
+                send_negotiation(agree ? WILL : WONT, option);
+
+                if (agree && option == NAWS)
+                {
+                    send_window_size();
+                }
+            }
+        }
+    }
+
+    // ======================================================================
+    // ON_SUBNEGOTIATION
+    // ======================================================================
+    bool on_subnegotiation()
+    {
+        if (subnegotiation_.empty())
+        {
+            return false;
+        }
+
+        auto const option = odin::u8(subnegotiation_[0]);
+
+        if (option == TERMINAL_TYPE
+         && subnegotiation_.size() > 1
+         && odin::u8(subnegotiation_[1]) == TERMINAL_TYPE_SEND)
+        {
+            std::string reply;
+            reply += char(IAC);
+            reply += char(SB);
+            reply += char(TERMINAL_TYPE);
+            reply += char(TERMINAL_TYPE_IS);
+            reply += settings_.terminal_type;
+            reply += char(IAC);
+            reply += char(SE);
+            write(reply);
+        }
+        else if (option == COMPRESS2 && settings_.compression && !inflating_)
+        {
+            inflateReset(&inflater_);
+            inflating_ = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    // ======================================================================
+    // SEND_NEGOTIATION
+    // ======================================================================
+    void send_negotiation(odin::u8 request, odin::u8 option)
+    {
+        write({ char(IAC), char(request), char(option) });
+    }
+
+    // ======================================================================
+    // SEND_WINDOW_SIZE
+    // ======================================================================
+    void send_window_size()
+    {
+        std::string message = { char(IAC), char(SB), char(NAWS) };
+
+        for (auto value : { settings_.width, settings_.height })
+        {
+            for (auto byte : { odin::u8(value >> 8), odin::u8(value & 0xFF) })
+            {
+                message += char(byte);
+
+                if (byte == IAC)
+                {
+                    message += char(byte);
+                }
+            }
+        }
+
+        message += char(IAC);
+        message += char(SE);
+        write(message);
+    }
+
+    // ======================================================================
+    // WRITE
+    // ======================================================================
+    void write(std::string const &data)
+    {
+        write_queue_.push_back(data);
+
+        if (write_queue_.size() == 1)
+        {
+            write_next();
+        }
+    }
+
+    // ======================================================================
+    // WRITE_NEXT
+    // ======================================================================
+    void write_next()
+    {
+        boost::asio::async_write(
+            socket_,
+            boost::asio::buffer(write_queue_.front()),
+            [pthis=shared_from_this()](
+                boost::system::error_code const &ec, std::size_t)
+            {
+                pthis->on_write(ec);
+            });
+    }
+
+    // ======================================================================
+    // ON_WRITE
+    // ======================================================================
+    void on_write(boost::system::error_code const &ec)
+    {
+        if (state_ == script_state::finished)
+        {
+            return;
+        }
+
+        if (ec)
+        {
+            fail();
+            return;
+        }
+
+        write_queue_.pop_front();
+
+        if (!write_queue_.empty())
+        {
+            write_next();
+        }
+    }
+
+    // ======================================================================
+    // ADVANCE
+    // ======================================================================
+    void advance()
+    {
+        // Each step of the script waits for the screen to show that the
+        // server has reached the next one.  Some steps lead straight into
+        // others without waiting for more output.
+        for (auto previous = script_state::finished; previous != state_; )
+        {
+            previous = state_;
+            advance_script();
+        }
+    }
+
+    // ======================================================================
+    // ADVANCE_SCRIPT
+    // ======================================================================
+    void advance_script()
+    {
+        switch (state_)
+        {
+            case script_state::awaiting_intro :
+                if (screen_.contains(INTRO_MARKER))
+                {
+                    type(settings_.name + TAB + settings_.password + ENTER);
+                    enter_state(script_state::logging_in);
+                }
+                break;
+
+            case script_state::logging_in :
+                if (screen_.contains(CHARACTER_SELECTION_MARKER))
+                {
+                    enter_state(script_state::selecting_character);
+                }
+                else if (screen_.contains(LOGIN_FAILED_MARKER))
+                {
+                    // The focus is on the password field, so the "New"
+                    // button is two tabs away.
+                    type(std::string(TAB) + TAB + SPACE);
+                    enter_state(script_state::opening_account_creation);
+                }
+                break;
+
+            case script_state::opening_account_creation :
+                if (screen_.contains(ACCOUNT_CREATION_MARKER))
+                {
+                    type(settings_.name + TAB
+                       + settings_.password + TAB
+                       + settings_.password + TAB
+                       + SPACE);
+                    enter_state(script_state::creating_account);
+                }
+                break;
+
+            case script_state::creating_account :
+                if (screen_.contains(CHARACTER_SELECTION_MARKER))
+                {
+                    enter_state(script_state::selecting_character);
+                }
+                break;
+
+            case script_state::selecting_character :
+                if (screen_.contains(FIRST_CHARACTER_MARKER))
+                {
+                    type("0");
+                    enter_state(script_state::entering);
+                }
+                else
+                {
+                    type("+");
+                    enter_state(script_state::creating_character);
+                }
+                break;
+
+            case script_state::creating_character :
+                if (screen_.contains(CHARACTER_CREATION_MARKER))
+                {
+                    // Past the name are the GM toggle and the OK button.
+                    type(settings_.name + TAB + TAB + SPACE);
+                    enter_state(script_state::creating_account);
+                }
+                break;
+
+            case script_state::entering :
+                if (screen_.contains(MAIN_SCREEN_MARKER))
+                {
+                    in_game_ = true;
+                    statistics_->in_game.add(1);
+                    statistics_->login_time.record(
+                        std::chrono::steady_clock::now() - start_time_);
+                    schedule_command();
+                }
+                break;
+
+            case script_state::typing :
+                on_typing();
+                break;
+
+            case script_state::executing :
+                on_executing();
+                break;
+
+            default :
+                break;
+        }
+    }
+
+    // ======================================================================
+    // ENTER_STATE
+    // ======================================================================
+    void enter_state(script_state state)
+    {
+        state_ = state;
+        arm_timeout();
+    }
+
+    // ======================================================================
+    // TYPE
+    // ======================================================================
+    void type(std::string const &keys)
+    {
+        write(keys);
+    }
+
+    // ======================================================================
+    // ARM_TIMEOUT
+    // ======================================================================
+    void arm_timeout()
+    {
+        timeout_timer_.expires_from_now(settings_.timeout);
+        timeout_timer_.async_wait(
+            [wp=std::weak_ptr<impl>(shared_from_this()), state=state_](
+                boost::system::error_code const &ec)
+            {
+                auto pthis = wp.lock();
+
+                if (!ec && pthis && pthis->state_ == state)
+                {
+                    pthis->on_timeout();
+                }
+            });
+    }
+
+    // ======================================================================
+    // ON_TIMEOUT
+    // ======================================================================
+    void on_timeout()
+    {
+        if (state_ == script_state::typing || state_ == script_state::executing)
+        {
+            statistics_->timeouts.add();
+        }
+
+        fail();
+    }
+
+    // ======================================================================
+    // SCHEDULE_COMMAND
+    // ======================================================================
+    void schedule_command()
+    {
+        state_ = script_state::idle;
+
+        boost::system::error_code unused;
+        timeout_timer_.cancel(unused);
+
+        std::exponential_distribution<double> delay(settings_.command_rate);
+        auto const seconds = settings_.command_rate > 0
+            ? delay(get_random_engine())
+            : 3600.0;
+
+        command_timer_.expires_from_now(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(seconds)));
+        command_timer_.async_wait(
+            [wp=std::weak_ptr<impl>(shared_from_this())](
+                boost::system::error_code const &ec)
+            {
+                auto pthis = wp.lock();
+
+                if (!ec && pthis && pthis->state_ == script_state::idle)
+                {
+                    pthis->issue_command();
+                }
+            });
+    }
+
+    // ======================================================================
+    // ISSUE_COMMAND
+    // ======================================================================
+    void issue_command()
+    {
+        current_command_ = command(command_distribution_(get_random_engine()));
+        current_text_    = make_command_text(current_command_);
+
+        type(current_text_);
+        enter_state(script_state::typing);
+        advance();
+    }
+
+    // ======================================================================
+    // MAKE_COMMAND_TEXT
+    // ======================================================================
+    std::string make_command_text(command cmd)
+    {
+        // A sequence number keeps successive commands distinct.
+        auto const sequence = ++command_sequence_;
+
+        switch (cmd)
+        {
+            case command::say :
+                return boost::str(boost::format("say testing %d") % sequence);
+
+            case command::emote :
+                return boost::str(boost::format("emote waves %d") % sequence);
+
+            case command::whisper :
+                return boost::str(boost::format("whisper %s psst %d")
+                    % choose_whisper_target()
+                    % sequence);
+
+            case command::roll :
+                return "roll 2d6";
+
+            default :
+                // This category is never rolled in, so the listing stays
+                // the same size however long the test runs.
+                return "showrolls loadgen";
+        }
+    }
+
+    // ======================================================================
+    // CHOOSE_WHISPER_TARGET
+    // ======================================================================
+    std::string choose_whisper_target()
+    {
+        auto const &targets = settings_.whisper_targets;
+
+        if (!targets || targets->empty())
+        {
+            return settings_.name;
+        }
+
+        std::uniform_int_distribution<std::size_t> choice(0, targets->size() - 1);
+        return (*targets)[choice(get_random_engine())];
+    }
+
+    // ======================================================================
+    // ON_TYPING
+    // ======================================================================
+    void on_typing()
+    {
+        // The prompt is the lowest row on which the typed command appears.
+        // Once found, it is remembered, since the output above it may
+        // contain similar text.
+        if (!prompt_found_)
+        {
+            prompt_row_   = screen_.find_last_row(current_text_);
+            prompt_found_ = prompt_row_ != screen_.get_height();
+        }
+
+        if (prompt_found_
+         && screen_.get_row(prompt_row_).find(current_text_) != std::string::npos)
+        {
+            command_start_ = std::chrono::steady_clock::now();
+            type(ENTER);
+            enter_state(script_state::executing);
+        }
+    }
+
+    // ======================================================================
+    // ON_EXECUTING
+    // ======================================================================
+    void on_executing()
+    {
+        if (screen_.get_row(prompt_row_).find(current_text_) == std::string::npos)
+        {
+            statistics_->latency[static_cast<odin::u32>(current_command_)]
+                .record(std::chrono::steady_clock::now() - command_start_);
+            schedule_command();
+        }
+    }
+
+    boost::asio::ip::tcp::socket                 socket_;
+    boost::asio::steady_timer                    timeout_timer_;
+    boost::asio::steady_timer                    command_timer_;
+    std::array<char, READ_BUFFER_SIZE>           read_buffer_;
+    std::array<char, READ_BUFFER_SIZE>           inflate_buffer_;
+    std::deque<std::string>                      write_queue_;
+
+    z_stream                                     inflater_;
+    bool                                         inflating_      = false;
+    bool                                         inflate_failed_ = false;
+
+    telnet_state                                 telnet_state_ = telnet_state::data;
+    odin::u8                                     negotiation_  = 0;
+    std::string                                  subnegotiation_;
+    std::array<bool, 256>                        local_options_   = {{}};
+    std::array<bool, 256>                        local_answered_  = {{}};
+    std::array<bool, 256>                        remote_options_  = {{}};
+    std::array<bool, 256>                        remote_answered_ = {{}};
+
+    screen                                       screen_;
+    script_state                                 state_     = script_state::connecting;
+    bool                                         connected_ = false;
+    bool                                         in_game_   = false;
+    std::chrono::steady_clock::time_point        start_time_;
+
+    std::discrete_distribution<odin::u32>        command_distribution_;
+    command                                      current_command_ = command::say;
+    std::string                                  current_text_;
+    odin::u32                                    command_sequence_ = 0;
+    odin::u16                                    prompt_row_   = 0;
+    bool                                         prompt_found_ = false;
+    std::chrono::steady_clock::time_point        command_start_;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+session::session(
+    boost::asio::io_service                &io_service
+  , session_settings                 const &settings
+  , std::shared_ptr<load_statistics> const &statistics)
+    : pimpl_(std::make_shared<impl>(
+          std::ref(io_service), settings, statistics))
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+session::~session()
+{
+}
+
+// ==========================================================================
+// START
+// ==========================================================================
+void session::start()
+{
+    pimpl_->io_service_.post([pimpl=pimpl_]{pimpl->start();});
+}
+
+// ==========================================================================
+// STOP
+// ==========================================================================
+void session::stop()
+{
+    pimpl_->io_service_.post([pimpl=pimpl_]{pimpl->finish();});
+}
+
+// ==========================================================================
+// GET_BYTES_RECEIVED
+// ==========================================================================
+odin::u64 session::get_bytes_received() const
+{
+    return pimpl_->bytes_received_;
+}
+
+// ==========================================================================
+// GET_BYTES_DECODED
+// ==========================================================================
+odin::u64 session::get_bytes_decoded() const
+{
+    return pimpl_->bytes_decoded_;
+}
+
+}
@@ -48,6 +48,20 @@ boost::optional<rectangle> intersection(
     rectangle const &lhs
   , rectangle const &rhs);
 
+//* =========================================================================
+/// \brief Returns the parts of the first rectangle that are not covered by
+/// the second.
+/// \par
+/// The parts are returned as at most four non-overlapping rectangles: the
+/// band above the covered area, the parts to its left and right, and the
+/// band below it.  If the rectangles do not overlap, then the first
+/// rectangle is returned unchanged.
+//* =========================================================================
+MUNIN_EXPORT
+std::vector<rectangle> difference(
+    rectangle const &lhs
+  , rectangle const &rhs);
+
 //* =========================================================================
 /// \brief Returns an array of sliced rectangles.
 /// \par
@@ -209,7 +209,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event) override;
+    virtual void do_event(event_type const &event) override;
 
 private :
     struct impl;
@@ -243,7 +243,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event) override;
+    virtual void do_event(event_type const &event) override;
 
     //* =====================================================================
     /// \brief Called by get_cursor_state().  Derived classes must override
@@ -28,7 +28,7 @@
 #define MUNIN_BUTTON_HPP_
 
 #include "munin/composite_component.hpp"
-#include <boost/signal.hpp>
+#include "odin/signal.hpp"
 
 namespace terminalpp {
     class string;
@@ -59,14 +59,14 @@ public :
     /// button either being clicked, or having focus and receiving an
     /// enter or space keypress.
     //* =====================================================================
-    boost::signal<void ()> on_click;
+    odin::signal<void ()> on_click;
 
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
     struct impl;
     std::shared_ptr<impl> pimpl_;
@@ -28,11 +28,12 @@
 #define MUNIN_COMPONENT_HPP_
 
 #include "munin/export.hpp"
+#include "munin/event.hpp"
 #include "munin/rectangle.hpp"
+#include "odin/signal.hpp"
 #include <terminalpp/point.hpp>
 #include <terminalpp/extent.hpp>
 #include <boost/any.hpp>
-#include <boost/signal.hpp>
 #include <memory>
 #include <vector>
 
@@ -206,6 +207,14 @@ public :
     //* =====================================================================
     void layout();
 
+    //* =====================================================================
+    /// \brief Returns true if drawing the component paints every cell of
+    /// any region it is asked to draw, false otherwise.  Containers use
+    /// this to avoid drawing components that are hidden beneath opaque
+    /// components on higher layers.
+    //* =====================================================================
+    bool is_opaque() const;
+
     //* =====================================================================
     /// \brief Draws the component.
     ///
@@ -218,11 +227,19 @@ public :
       , rectangle const &region);
 
     //* =====================================================================
-    /// \brief Send an event to the component.  This may be of any type.
-    /// A component must specify the types of messages it may receive and
-    /// what it will do with it.
+    /// \brief Send an event to the component.  Terminal input is sent as
+    /// one of the types in event_type; anything else can be sent as a
+    /// custom event.  A component must specify the types of messages it may
+    /// receive and what it will do with it.
+    //* =====================================================================
+    void event(event_type const &event);
+
+    //* =====================================================================
+    /// \brief Returns true if the component can receive contiguous
+    /// printable input as a single text_run event, false if each character
+    /// must be sent as a separate virtual key.
     //* =====================================================================
-    void event(boost::any const &event);
+    bool accepts_text_runs() const;
 
     //* =====================================================================
     /// \fn on_redraw
@@ -230,7 +247,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the component should be redrawn.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void (std::vector<rectangle> const &regions)
     > on_redraw;
@@ -241,7 +258,7 @@ public :
     /// update the overall layout should be done.  Connect to this signal
     /// in order to receive notifications about this.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void ()
     > on_layout_change;
@@ -252,7 +269,7 @@ public :
     /// such as text controls that grow with the text within them.  Connect
     /// to this signal in order to receive notifications about this.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void ()
     > on_preferred_size_changed;
@@ -262,7 +279,7 @@ public :
     /// \brief Certain components sizes change during their lifetime.
     /// Connect to this signal in order to receive notifications about this.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void ()
     > on_size_changed;
@@ -274,7 +291,7 @@ public :
     /// \brief Connect to this signal in order to receive notification about
     /// when the component changes position.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void (terminalpp::point from, terminalpp::point to)
     > on_position_changed;
@@ -284,7 +301,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the component has gained focus.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void ()
     > on_focus_set;
 
@@ -293,7 +310,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the component has lost focus.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void ()
     > on_focus_lost;
 
@@ -302,7 +319,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the component's cursor state changes.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (bool)
     > on_cursor_state_changed;
 
@@ -311,7 +328,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the component's cursor position changes.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (terminalpp::point)
     > on_cursor_position_changed;
 
@@ -472,6 +489,13 @@ protected :
     //* =====================================================================
     virtual void do_layout() = 0;
 
+    //* =====================================================================
+    /// \brief Called by is_opaque().  Derived classes may override this
+    /// function in order to declare that they completely cover whatever is
+    /// beneath them.  By default, a component is not opaque.
+    //* =====================================================================
+    virtual bool do_is_opaque() const;
+
     //* =====================================================================
     /// \brief Called by draw().  Derived classes must override this function
     /// in order to draw onto the passed context.  A component must only draw
@@ -489,7 +513,14 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event) = 0;
+    virtual void do_event(event_type const &event) = 0;
+
+    //* =====================================================================
+    /// \brief Called by accepts_text_runs().  Derived classes may override
+    /// this function in order to receive text runs.  By default, a
+    /// component does not accept them.
+    //* =====================================================================
+    virtual bool do_accepts_text_runs() const;
 };
 
 }
@@ -213,6 +213,13 @@ protected :
     //* =====================================================================
     virtual void do_layout() override;
 
+    //* =====================================================================
+    /// \brief Called by is_opaque().  Derived classes may override this
+    /// function in order to declare that they completely cover whatever is
+    /// beneath them.
+    //* =====================================================================
+    virtual bool do_is_opaque() const override;
+
     //* =====================================================================
     /// \brief Called by draw().  Derived classes must override this function
     /// in order to draw onto the passed context.  A component must only draw
@@ -230,7 +237,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event) override;
+    virtual void do_event(event_type const &event) override;
 
     //* =====================================================================
     /// \brief Called by set_attribute().  Derived classes must override this
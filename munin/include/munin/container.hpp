@@ -188,6 +188,12 @@ protected :
     //* =====================================================================
     virtual std::vector<odin::u32> do_get_layout_layers() const = 0;
 
+    //* =====================================================================
+    /// \brief Called by is_opaque().  A container is opaque if its opaque
+    /// components cover the whole of it between them.
+    //* =====================================================================
+    virtual bool do_is_opaque() const override;
+
     //* =====================================================================
     /// \brief Called by draw().  Derived classes must override this function
     /// in order to draw onto the passed context.  A component must only draw
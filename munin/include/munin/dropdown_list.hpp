@@ -37,6 +37,8 @@ namespace terminalpp {
 
 namespace munin {
 
+class list_model;
+
 //* =========================================================================
 /// \brief A class that models a dropdown_list of items.
 //* =========================================================================
@@ -53,6 +55,17 @@ public :
     //* =====================================================================
     virtual ~dropdown_list();
 
+    //* =====================================================================
+    /// \brief Sets the model from which the drop-down list draws its items.
+    //* =====================================================================
+    void set_model(std::shared_ptr<list_model> const &model);
+
+    //* =====================================================================
+    /// \brief Returns the model from which the drop-down list draws its
+    /// items.
+    //* =====================================================================
+    std::shared_ptr<list_model> get_model() const;
+
     //* =====================================================================
     /// \brief Sets the items in the drop-down list.
     //* =====================================================================
@@ -80,7 +93,7 @@ public :
     /// \brief Connect to this signal to receive updates about when the
     /// selected item changes.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (odin::s32)
     > on_item_changed;
 
@@ -89,7 +102,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
 private :
     struct impl;
@@ -96,7 +96,13 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event) override;
+    virtual void do_event(event_type const &event) override;
+
+    //* =====================================================================
+    /// \brief Called by accepts_text_runs().  Derived classes may override
+    /// this function in order to receive text runs.
+    //* =====================================================================
+    virtual bool do_accepts_text_runs() const override;
 
     //* =====================================================================
     /// \brief Called by set_attribute().  Derived classes must override this
@@ -0,0 +1,78 @@
+// ==========================================================================
+// Munin Event.
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef MUNIN_EVENT_HPP_
+#define MUNIN_EVENT_HPP_
+
+#include <terminalpp/string.hpp>
+#include <terminalpp/token.hpp>
+#include <boost/any.hpp>
+#include <boost/variant.hpp>
+
+namespace munin {
+
+//* =========================================================================
+/// \brief A run of contiguous printable text that was received as a single
+/// unit, such as a paste.
+//* =========================================================================
+struct text_run
+{
+    terminalpp::string text;
+};
+
+//* =========================================================================
+/// \brief The type of all events that can be sent to a component.
+/// \par
+/// Input from a terminal arrives as one of the terminal's own event types,
+/// or as a run of text.  Any other type of event may be sent as a custom
+/// event, which is held in a boost::any.  Components can either inspect an
+/// event with boost::get, or handle several types at once with a
+/// boost::static_visitor.
+//* =========================================================================
+typedef boost::variant<
+    terminalpp::virtual_key
+  , terminalpp::ansi::mouse::report
+  , terminalpp::ansi::control_sequence
+  , text_run
+  , boost::any
+> event_type;
+
+//* =========================================================================
+/// \brief Returns a pointer to the custom event of the given type held in
+/// the event, or nullptr if there is no such custom event.
+//* =========================================================================
+template <class CustomEvent>
+CustomEvent const *custom_event_cast(event_type const &event)
+{
+    auto const *custom = boost::get<boost::any>(&event);
+    return custom != nullptr
+         ? boost::any_cast<CustomEvent>(custom)
+         : nullptr;
+}
+
+}
+
+#endif
@@ -84,6 +84,13 @@ protected :
     virtual void do_set_attribute(
         std::string const &name, boost::any const &attr);
 
+    //* =====================================================================
+    /// \brief Called by is_opaque().  Derived classes may override this
+    /// function in order to declare that they completely cover whatever is
+    /// beneath them.
+    //* =====================================================================
+    virtual bool do_is_opaque() const;
+
     //* =====================================================================
     /// \brief Called by draw().  Derived classes must override this function
     /// in order to draw onto the passed context.  A component must only draw
@@ -69,7 +69,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
     struct impl;
     std::shared_ptr<impl> pimpl_;
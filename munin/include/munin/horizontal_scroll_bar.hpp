@@ -57,7 +57,7 @@ public :
     /// \brief Connect to this signal in order to be informed of a control
     /// that causes the scrollbar to want to be paged left.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void()
     > on_page_left;
 
@@ -66,7 +66,7 @@ public :
     /// \brief Connect to this signal in order to be informed of a control
     /// that causes the scrollbar to want to be paged right.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void()
     > on_page_right;
 
@@ -118,7 +118,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
     //* =====================================================================
     /// \brief Called by set_attribute().  Derived classes must override this
@@ -96,6 +96,44 @@ protected :
         terminalpp::extent                              size) = 0;
 };
 
+//* =========================================================================
+/// \brief An object that marks a layout pass as being in progress on the
+/// current thread for as long as it exists.
+/// \par
+/// During a layout pass, the sizes of components are being changed from the
+/// top of the tree down, but the preferred sizes of those components are
+/// not.  Containers may therefore remember the preferred sizes they compute
+/// for the remainder of the pass, rather than having each level of the tree
+/// re-measure the entire subtree beneath it.
+//* =========================================================================
+class MUNIN_EXPORT layout_pass
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor.  Begins a new layout pass.
+    //* =====================================================================
+    layout_pass();
+
+    //* =====================================================================
+    /// \brief Destructor.  Ends the layout pass, restoring any pass that
+    /// was in progress when this one began.
+    //* =====================================================================
+    ~layout_pass();
+
+    //* =====================================================================
+    /// \brief Returns an identifier for the layout pass currently in
+    /// progress on this thread, or 0 if there is no such pass.  Identifiers
+    /// are never reused.
+    //* =====================================================================
+    static odin::u64 current();
+
+private :
+    layout_pass(layout_pass const &) = delete;
+    layout_pass &operator=(layout_pass const &) = delete;
+
+    odin::u64 previous_;
+};
+
 }
 
 #endif
@@ -30,6 +30,8 @@
 #include "munin/export.hpp"
 #include "munin/basic_component.hpp"
 #include "odin/core.hpp"
+#include <string>
+#include <vector>
 
 namespace terminalpp {
     class string;
@@ -37,8 +39,15 @@ namespace terminalpp {
 
 namespace munin {
 
+class list_model;
+
 //* =========================================================================
 /// \brief A class that models a list of items.
+/// \par
+/// The items are drawn from a list_model, and only the rows that are
+/// actually being drawn are requested from it.  Typing while the list has
+/// focus narrows the rows shown to those items that contain the typed text;
+/// backspace widens the search again.
 //* =========================================================================
 class MUNIN_EXPORT list : public munin::basic_component
 {
@@ -54,12 +63,36 @@ public :
     virtual ~list();
 
     //* =====================================================================
-    /// \brief Sets the items in the list.
+    /// \brief Sets the model from which the list draws its items.
+    //* =====================================================================
+    void set_model(std::shared_ptr<list_model> const &model);
+
+    //* =====================================================================
+    /// \brief Returns the model from which the list draws its items.
+    //* =====================================================================
+    std::shared_ptr<list_model> get_model() const;
+
+    //* =====================================================================
+    /// \brief Sets the items in the list.  This replaces any model that
+    /// was set with a simple model containing only these items.
     //* =====================================================================
     void set_items(std::vector<terminalpp::string> const &items);
 
     //* =====================================================================
-    /// \brief Selects an item with the given index.
+    /// \brief Sets the text used to filter the list.  Only items that
+    /// contain the text (ignoring case) are shown.  An empty string shows
+    /// all items.
+    //* =====================================================================
+    void set_filter(std::string const &filter);
+
+    //* =====================================================================
+    /// \brief Returns the text currently used to filter the list.
+    //* =====================================================================
+    std::string get_filter() const;
+
+    //* =====================================================================
+    /// \brief Selects an item with the given index.  If the item is hidden
+    /// by the current filter, then the filter is cleared.
     /// \param selected_item the item to select, or -1 for no item.
     //* =====================================================================
     void set_item_index(odin::s32 index);
@@ -82,7 +115,7 @@ public :
     /// \par index The index that the item was changed from (you can query
     /// the component if you need to know the one it changed to.)
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void (odin::s32 index)
     > on_item_changed;
 
@@ -125,7 +158,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
 private :
     struct impl;
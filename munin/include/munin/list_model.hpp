@@ -0,0 +1,268 @@
+// ==========================================================================
+// Munin List Model.
+//
+// Copyright (C) 2011 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef MUNIN_LIST_MODEL_HPP_
+#define MUNIN_LIST_MODEL_HPP_
+
+#include "munin/export.hpp"
+#include "odin/core.hpp"
+#include "odin/signal.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace terminalpp {
+    class string;
+}
+
+namespace munin {
+
+//* =========================================================================
+/// \brief A source of the items that are displayed in a list.
+/// \par
+/// A list does not hold its items itself.  Instead, it asks its model for
+/// only the items it is about to draw, and the model notifies the list of
+/// changes so that only the affected rows need to be redrawn.  This allows
+/// a list to present very large collections without formatting every item
+/// whenever any one of them changes.
+//* =========================================================================
+class MUNIN_EXPORT list_model
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    list_model();
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    virtual ~list_model();
+
+    //* =====================================================================
+    /// \brief Returns the number of items in the model.
+    //* =====================================================================
+    odin::u32 get_number_of_items() const;
+
+    //* =====================================================================
+    /// \brief Returns the item at the given index, formatted for display.
+    //* =====================================================================
+    terminalpp::string get_item(odin::u32 index) const;
+
+    //* =====================================================================
+    /// \brief Returns the width of the item at the given index.
+    //* =====================================================================
+    odin::u32 get_item_width(odin::u32 index) const;
+
+    //* =====================================================================
+    /// \fn on_items_inserted
+    /// \brief Models emit this signal after items have been inserted.
+    /// \par index the index of the first inserted item.
+    /// \par count the number of items inserted.
+    //* =====================================================================
+    odin::signal<
+        void (odin::u32 index, odin::u32 count)
+    > on_items_inserted;
+
+    //* =====================================================================
+    /// \fn on_items_removed
+    /// \brief Models emit this signal after items have been removed.
+    /// \par index the index that the first removed item had.
+    /// \par count the number of items removed.
+    //* =====================================================================
+    odin::signal<
+        void (odin::u32 index, odin::u32 count)
+    > on_items_removed;
+
+    //* =====================================================================
+    /// \fn on_items_changed
+    /// \brief Models emit this signal after items have been altered in
+    /// place.
+    /// \par index the index of the first altered item.
+    /// \par count the number of items altered.
+    //* =====================================================================
+    odin::signal<
+        void (odin::u32 index, odin::u32 count)
+    > on_items_changed;
+
+    //* =====================================================================
+    /// \fn on_model_reset
+    /// \brief Models emit this signal after their contents have been
+    /// replaced wholesale.
+    //* =====================================================================
+    odin::signal<
+        void ()
+    > on_model_reset;
+
+protected :
+    //* =====================================================================
+    /// \brief Called by get_number_of_items().  Derived classes must
+    /// override this function in order to return the number of items in
+    /// the model.
+    //* =====================================================================
+    virtual odin::u32 do_get_number_of_items() const = 0;
+
+    //* =====================================================================
+    /// \brief Called by get_item().  Derived classes must override this
+    /// function in order to return the item at the given index.
+    //* =====================================================================
+    virtual terminalpp::string do_get_item(odin::u32 index) const = 0;
+
+    //* =====================================================================
+    /// \brief Called by get_item_width().  By default, this formats the
+    /// item and measures it.  Derived classes may override this function
+    /// in order to measure an item without formatting it.
+    //* =====================================================================
+    virtual odin::u32 do_get_item_width(odin::u32 index) const;
+};
+
+//* =========================================================================
+/// \brief A list model that holds its items in a vector.
+//* =========================================================================
+class MUNIN_EXPORT basic_list_model : public list_model
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    basic_list_model();
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    virtual ~basic_list_model();
+
+    //* =====================================================================
+    /// \brief Replaces all of the items in the model.
+    //* =====================================================================
+    void set_items(std::vector<terminalpp::string> items);
+
+    //* =====================================================================
+    /// \brief Inserts items into the model before the given index.
+    //* =====================================================================
+    void insert_items(
+        odin::u32                              index
+      , std::vector<terminalpp::string> const &items);
+
+    //* =====================================================================
+    /// \brief Removes a number of items from the model, starting at the
+    /// given index.
+    //* =====================================================================
+    void remove_items(odin::u32 index, odin::u32 count);
+
+protected :
+    //* =====================================================================
+    /// \brief Called by get_number_of_items().  Derived classes must
+    /// override this function in order to return the number of items in
+    /// the model.
+    //* =====================================================================
+    virtual odin::u32 do_get_number_of_items() const;
+
+    //* =====================================================================
+    /// \brief Called by get_item().  Derived classes must override this
+    /// function in order to return the item at the given index.
+    //* =====================================================================
+    virtual terminalpp::string do_get_item(odin::u32 index) const;
+
+    //* =====================================================================
+    /// \brief Called by get_item_width().  Derived classes may override
+    /// this function in order to measure an item without formatting it.
+    //* =====================================================================
+    virtual odin::u32 do_get_item_width(odin::u32 index) const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief A list model that holds its items as plain text, and only
+/// formats them for display when they are drawn.
+/// \par
+/// Setting the items compares them against the current items, and only
+/// notifies of the items that have actually been inserted, removed or
+/// altered.  This makes it cheap to refresh a list from a large
+/// collection in which little has changed.
+//* =========================================================================
+class MUNIN_EXPORT string_list_model : public list_model
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    string_list_model();
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    virtual ~string_list_model();
+
+    //* =====================================================================
+    /// \brief Sets the items in the model.
+    //* =====================================================================
+    void set_items(std::vector<std::string> items);
+
+protected :
+    //* =====================================================================
+    /// \brief Called by get_number_of_items().  Derived classes must
+    /// override this function in order to return the number of items in
+    /// the model.
+    //* =====================================================================
+    virtual odin::u32 do_get_number_of_items() const;
+
+    //* =====================================================================
+    /// \brief Called by get_item().  Derived classes must override this
+    /// function in order to return the item at the given index.
+    //* =====================================================================
+    virtual terminalpp::string do_get_item(odin::u32 index) const;
+
+    //* =====================================================================
+    /// \brief Called by get_item_width().  Derived classes may override
+    /// this function in order to measure an item without formatting it.
+    //* =====================================================================
+    virtual odin::u32 do_get_item_width(odin::u32 index) const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief Returns a newly created basic list model.
+//* =========================================================================
+MUNIN_EXPORT
+std::shared_ptr<basic_list_model> make_list_model(
+    std::vector<terminalpp::string> items = {});
+
+//* =========================================================================
+/// \brief Returns a newly created string list model.
+//* =========================================================================
+MUNIN_EXPORT
+std::shared_ptr<string_list_model> make_string_list_model();
+
+}
+
+#endif
@@ -66,7 +66,7 @@ public :
     /// \fn on_close
     /// \brief A signal that is raised whenever the close icon is clicked.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void ()
     > on_close;
 
@@ -75,7 +75,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
 private :
     struct impl;
@@ -28,6 +28,7 @@
 #define MUNIN_STATUS_BAR_HPP_
 
 #include "munin/composite_component.hpp"
+#include <boost/asio/strand.hpp>
 
 namespace terminalpp {
     class string;
@@ -44,8 +45,11 @@ class MUNIN_EXPORT status_bar
 public :
     //* =====================================================================
     /// \brief Constructor
+    /// \param strand The strand on which the status bar's marquee is run.
+    /// This must be the strand in which the status bar is drawn, and must
+    /// outlive it.
     //* =====================================================================
-    status_bar();
+    status_bar(boost::asio::strand &strand);
 
     //* =====================================================================
     /// \brief Destructor
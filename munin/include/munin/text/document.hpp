@@ -30,9 +30,9 @@
 #include "munin/export.hpp"
 #include "munin/rectangle.hpp"
 #include "odin/core.hpp"
+#include "odin/signal.hpp"
 #include <terminalpp/extent.hpp>
 #include <terminalpp/point.hpp>
-#include <boost/signal.hpp>
 
 namespace terminalpp {
     class string;
@@ -124,7 +124,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the component should be redrawn.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void (std::vector<munin::rectangle> const &regions)
     > on_redraw;
@@ -134,7 +134,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the caret has changed position.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void ()
     > on_caret_position_changed;
@@ -0,0 +1,195 @@
+// ==========================================================================
+// Munin Timer Wheel.
+//
+// Copyright (C) 2011 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef MUNIN_TIMER_WHEEL_HPP_
+#define MUNIN_TIMER_WHEEL_HPP_
+
+#include "munin/export.hpp"
+#include "odin/core.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace munin {
+
+//* =========================================================================
+/// \brief A service that runs timed callbacks for all of the components
+/// that share an io_service, using a single underlying timer.
+/// \par
+/// Timers are held in a hierarchical timing wheel, so that scheduling and
+/// cancelling them is cheap no matter how many there are.  Callbacks are
+/// always run on the strand that was passed in when they were scheduled.
+/// Callbacks that fall due on the same tick for the same strand are run
+/// together in a single handler, so that any redraws they cause are
+/// coalesced by the window into a single repaint.
+//* =========================================================================
+class MUNIN_EXPORT timer_wheel : public boost::asio::io_service::service
+{
+    struct entry;
+    struct impl;
+
+public :
+    typedef std::chrono::steady_clock::duration duration;
+
+    //* =====================================================================
+    /// \brief The interval between ticks of a wheel that is created by
+    /// get_timer_wheel().  All timers are rounded up to a whole number of
+    /// ticks.
+    //* =====================================================================
+    static std::chrono::milliseconds const default_tick_interval;
+
+    //* =====================================================================
+    /// \brief The identifier of this service within an io_service.
+    //* =====================================================================
+    static boost::asio::io_service::id id;
+
+    //* =====================================================================
+    /// \brief A handle to a scheduled callback.  The callback is cancelled
+    /// when the subscription is cancelled or destroyed.
+    //* =====================================================================
+    class MUNIN_EXPORT subscription
+    {
+    public :
+        //* =================================================================
+        /// \brief Constructor
+        //* =================================================================
+        subscription();
+
+        //* =================================================================
+        /// \brief Move Constructor
+        //* =================================================================
+        subscription(subscription &&other);
+
+        //* =================================================================
+        /// \brief Move Assignment
+        //* =================================================================
+        subscription &operator=(subscription &&other);
+
+        subscription(subscription const &) = delete;
+        subscription &operator=(subscription const &) = delete;
+
+        //* =================================================================
+        /// \brief Destructor
+        //* =================================================================
+        ~subscription();
+
+        //* =================================================================
+        /// \brief Cancels the callback.  Once this returns, the callback
+        /// will not be called again.
+        //* =================================================================
+        void cancel();
+
+        //* =================================================================
+        /// \brief Returns true if the subscription has a callback that has
+        /// not been cancelled.  One-shot callbacks remain active until
+        /// they are cancelled, even after they have been called.
+        //* =================================================================
+        bool active() const;
+
+    private :
+        friend class timer_wheel;
+
+        subscription(
+            std::weak_ptr<impl>    wheel
+          , std::shared_ptr<entry> ent);
+
+        std::weak_ptr<impl>    wheel_;
+        std::shared_ptr<entry> entry_;
+    };
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    explicit timer_wheel(boost::asio::io_service &io_service);
+
+    //* =====================================================================
+    /// \brief Constructor for a wheel with the given interval between
+    /// ticks.  To be used in place of the default wheel, it must be added
+    /// to the io_service with boost::asio::add_service before anything
+    /// retrieves the wheel with get_timer_wheel().
+    //* =====================================================================
+    timer_wheel(
+        boost::asio::io_service   &io_service
+      , std::chrono::milliseconds  tick_interval);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    virtual ~timer_wheel();
+
+    //* =====================================================================
+    /// \brief Returns the interval between ticks of the wheel.
+    //* =====================================================================
+    std::chrono::milliseconds get_tick_interval() const;
+
+    //* =====================================================================
+    /// \brief Schedules a callback to be run once on the given strand after
+    /// the given delay.
+    //* =====================================================================
+    subscription schedule(
+        boost::asio::strand         &strand
+      , duration                     delay
+      , std::function<void ()> const &callback);
+
+    //* =====================================================================
+    /// \brief Subscribes a callback to be run on the given strand on every
+    /// tick of the wheel.  This is intended for animations, which then all
+    /// share the same cadence.
+    //* =====================================================================
+    subscription subscribe_to_ticks(
+        boost::asio::strand         &strand
+      , std::function<void ()> const &callback);
+
+    //* =====================================================================
+    /// \brief Subscribes a callback to be run on the given strand at the
+    /// start of every minute of the wall clock.
+    //* =====================================================================
+    subscription subscribe_to_minutes(
+        boost::asio::strand         &strand
+      , std::function<void ()> const &callback);
+
+private :
+    //* =====================================================================
+    /// \brief Called by the io_service when it is shutting down.  Destroys
+    /// any outstanding callbacks.
+    //* =====================================================================
+    virtual void shutdown_service();
+
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief Returns the timer wheel for the given io_service, creating it
+/// if necessary.
+//* =========================================================================
+MUNIN_EXPORT
+timer_wheel &get_timer_wheel(boost::asio::io_service &io_service);
+
+}
+
+#endif
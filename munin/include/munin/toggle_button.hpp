@@ -64,14 +64,14 @@ public :
     /// button either being clicked, or having focus and receiving an
     /// enter or space keypress.
     //* =====================================================================
-    boost::signal<void (bool)> on_toggle;
+    odin::signal<void (bool)> on_toggle;
 
 protected :
     //* =====================================================================
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
     struct impl;
     std::shared_ptr<impl> pimpl_;
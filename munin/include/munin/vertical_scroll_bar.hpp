@@ -56,7 +56,7 @@ public :
     /// \brief Connect to this signal in order to be informed of a control
     /// that causes the scrollbar to want to be paged up.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void()
     > on_page_up;
 
@@ -65,7 +65,7 @@ public :
     /// \brief Connect to this signal in order to be informed of a control
     /// that causes the scrollbar to want to be paged down.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void()
     > on_page_down;
 
@@ -117,7 +117,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event) override;
+    virtual void do_event(event_type const &event) override;
 
     //* =====================================================================
     /// \brief Called by set_attribute().  Derived classes must override this
@@ -74,7 +74,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the subcomponent's size has changed.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void ()
     > on_subcomponent_size_changed;
 
@@ -83,7 +83,7 @@ public :
     /// \brief Connect to this signal in order to receive notifications about
     /// when the viewport's origin changes.
     //* =====================================================================
-    boost::signal<
+    odin::signal<
         void ()
     > on_origin_changed;
 
@@ -224,7 +224,7 @@ protected :
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    virtual void do_event(boost::any const &event);
+    virtual void do_event(event_type const &event);
 
     //* =====================================================================
     /// \brief Called by set_attribute().  Derived classes must override this
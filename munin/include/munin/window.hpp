@@ -28,12 +28,12 @@
 #define MUNIN_ANSI_WINDOW_HPP_
 
 #include "munin/export.hpp"
+#include "odin/signal.hpp"
 #include <terminalpp/extent.hpp>
 #include <terminalpp/behaviour.hpp>
 #include <terminalpp/terminal.hpp>
 #include <boost/any.hpp>
 #include <boost/asio/strand.hpp>
-#include <boost/signal.hpp>
 #include <string>
 
 namespace munin {
@@ -114,7 +114,7 @@ public :
     /// \brief Connect to this signal in order to receive notification about
     /// when the window has repainted and the data for how to repaint it.
     //* =====================================================================
-    boost::signal
+    odin::signal
     <
         void (std::string const &paint_data)
     > on_repaint;
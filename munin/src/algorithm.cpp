@@ -104,6 +104,60 @@ optional<rectangle> intersection(rectangle const &lhs, rectangle const &rhs)
     return overlap;
 }
 
+// ==========================================================================
+// DIFFERENCE
+// ==========================================================================
+vector<rectangle> difference(rectangle const &lhs, rectangle const &rhs)
+{
+    auto const overlap = intersection(lhs, rhs);
+
+    if (!overlap.is_initialized())
+    {
+        return { lhs };
+    }
+
+    vector<rectangle> pieces;
+
+    auto const lhs_right      = lhs.origin.x + lhs.size.width;
+    auto const lhs_bottom     = lhs.origin.y + lhs.size.height;
+    auto const overlap_right  = overlap->origin.x + overlap->size.width;
+    auto const overlap_bottom = overlap->origin.y + overlap->size.height;
+
+    // The full-width band above the overlap.
+    if (overlap->origin.y > lhs.origin.y)
+    {
+        pieces.push_back(rectangle{
+            lhs.origin
+          , {lhs.size.width, overlap->origin.y - lhs.origin.y}});
+    }
+
+    // The parts to the left and right of the overlap, which are only as
+    // tall as the overlap itself.
+    if (overlap->origin.x > lhs.origin.x)
+    {
+        pieces.push_back(rectangle{
+            {lhs.origin.x, overlap->origin.y}
+          , {overlap->origin.x - lhs.origin.x, overlap->size.height}});
+    }
+
+    if (overlap_right < lhs_right)
+    {
+        pieces.push_back(rectangle{
+            {overlap_right, overlap->origin.y}
+          , {lhs_right - overlap_right, overlap->size.height}});
+    }
+
+    // The full-width band below the overlap.
+    if (overlap_bottom < lhs_bottom)
+    {
+        pieces.push_back(rectangle{
+            {lhs.origin.x, overlap_bottom}
+          , {lhs.size.width, lhs_bottom - overlap_bottom}});
+    }
+
+    return pieces;
+}
+
 // ==========================================================================
 // CUT_SLICES
 // ==========================================================================
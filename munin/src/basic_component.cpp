@@ -293,10 +293,10 @@ void basic_component::do_layout()
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void basic_component::do_event(boost::any const &event)
+void basic_component::do_event(event_type const &event)
 {
     auto const *mouse = 
-        boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        boost::get<terminalpp::ansi::mouse::report>(&event);
         
     if (mouse
      && mouse->button_ != terminalpp::ansi::mouse::report::BUTTON_UP)
@@ -28,11 +28,28 @@
 #include "munin/layout.hpp"
 #include <terminalpp/ansi/mouse.hpp>
 #include <boost/scope_exit.hpp>
+#include <algorithm>
 
 namespace munin {
 
 namespace {
+    // Containers with at least this many components keep an index of which
+    // components lie on each row, so that mouse reports can be delivered
+    // without checking the bounds of every component.
+    BOOST_STATIC_CONSTANT(odin::u32, HIT_TEST_INDEX_THRESHOLD = 8);
+
     typedef std::map<odin::u32, std::unique_ptr<layout>> layered_layout_map;
+
+    // ======================================================================
+    // LAYER
+    // ======================================================================
+    struct layer
+    {
+        std::vector<std::shared_ptr<component>> components_;
+        std::vector<boost::any>                 hints_;
+    };
+
+    typedef std::map<odin::u32, layer> layered_component_map;
 }
 
 // ==========================================================================
@@ -48,6 +65,11 @@ struct basic_container::impl
         , has_focus_(false)
         , cursor_state_(false)
         , enabled_(true)
+        , layers_dirty_(true)
+        , layout_dirty_(true)
+        , subtree_dirty_(true)
+        , hit_test_index_dirty_(true)
+        , preferred_size_pass_(0)
     {
     }
 
@@ -61,6 +83,8 @@ struct basic_container::impl
 
         if (focussed_component != NULL)
         {
+            focussed_component_ = focussed_component;
+
             // Iterate through all our subcomponents and ensure that this is
             // the only subcomponent to have focus.  Then, if we do not have
             // focus, set our focus.
@@ -93,23 +117,16 @@ struct basic_container::impl
 
         if (unfocussed_component != NULL)
         {
-            // Iterate through all our subcomponents to see if we have any
-            // subcomponents focused (for example, setting the focus of a
-            // new subcomponent may cause the focus for the reporting
-            // component to be lost).  If we do not, then unfocus this
-            // component.
-            bool component_is_focused = false;
-
-            for (auto const &current_component : components_)
+            // Check to see if we still have a subcomponent focused (for
+            // example, setting the focus of a new subcomponent may cause
+            // the focus for the reporting component to be lost).  If we do
+            // not, then unfocus this component.
+            if (focussed_component_ == unfocussed_component)
             {
-                if (current_component->has_focus())
-                {
-                    component_is_focused = true;
-                    break;
-                }
+                focussed_component_.reset();
             }
 
-            if (!component_is_focused)
+            if (!get_focussed_subcomponent())
             {
                 has_focus_ = false;
                 self_.on_focus_lost();
@@ -124,34 +141,29 @@ struct basic_container::impl
     // ======================================================================
     void focus_changed()
     {
-        if (has_focus_)
+        auto const current_component =
+            has_focus_ ? get_focussed_subcomponent() : nullptr;
+
+        if (current_component)
         {
-            // Find the currently focussed subcomponent.
-            for (auto const &current_component : components_)
-            {
-                if (current_component->has_focus())
-                {
-                    // Update for the new cursor state if necessary.
-                    bool new_cursor_state =
-                        current_component->get_cursor_state();
+            // Update for the new cursor state if necessary.
+            bool new_cursor_state = current_component->get_cursor_state();
 
-                    if (new_cursor_state != cursor_state_)
-                    {
-                        cursor_state_ = new_cursor_state;
-                        self_.on_cursor_state_changed(cursor_state_);
-                    }
+            if (new_cursor_state != cursor_state_)
+            {
+                cursor_state_ = new_cursor_state;
+                self_.on_cursor_state_changed(cursor_state_);
+            }
 
-                    // If the cursor state is enabled, then update for a new
-                    // cursor position.
-                    if (cursor_state_)
-                    {
-                        terminalpp::point cursor_position =
-                            current_component->get_position()
-                          + current_component->get_cursor_position();
+            // If the cursor state is enabled, then update for a new
+            // cursor position.
+            if (cursor_state_)
+            {
+                terminalpp::point cursor_position =
+                    current_component->get_position()
+                  + current_component->get_cursor_position();
 
-                        self_.on_cursor_position_changed(cursor_position);
-                    }
-                }
+                self_.on_cursor_position_changed(cursor_position);
             }
         }
     }
@@ -202,6 +214,8 @@ struct basic_container::impl
 
         if (subcomponent)
         {
+            hit_test_index_dirty_ = true;
+
             auto const subcomponent_size = subcomponent->get_size();
 
             std::vector<rectangle> regions =
@@ -218,6 +232,14 @@ struct basic_container::impl
         }
     }
 
+    // ======================================================================
+    // SUBCOMPONENT_SIZE_CHANGE_HANDLER
+    // ======================================================================
+    void subcomponent_size_change_handler()
+    {
+        hit_test_index_dirty_ = true;
+    }
+
     // ======================================================================
     // SUBCOMPONENT_PREFERRED_SIZE_CHANGE_HANDLER
     // ======================================================================
@@ -228,10 +250,172 @@ struct basic_container::impl
 
         if (subcomponent)
         {
+            // Our own preferred size is derived from the subcomponent's, and
+            // our layout depends on it, so both must be recalculated.  The
+            // change is then propagated up the tree.
+            preferred_size_.reset();
+            layout_dirty_ = true;
             self_.on_preferred_size_changed();
         }
     }
 
+    // ======================================================================
+    // SUBCOMPONENT_LAYOUT_CHANGE_HANDLER
+    // ======================================================================
+    void subcomponent_layout_change_handler()
+    {
+        // Something beneath this container needs laying out, even though
+        // this container's own layout may be unaffected.
+        subtree_dirty_ = true;
+    }
+
+    // ======================================================================
+    // INVALIDATE_LAYERS
+    // ======================================================================
+    void invalidate_layers()
+    {
+        layers_dirty_ = true;
+        layout_dirty_ = true;
+        hit_test_index_dirty_ = true;
+        preferred_size_.reset();
+    }
+
+    // ======================================================================
+    // GET_FOCUSSED_SUBCOMPONENT
+    // ======================================================================
+    std::shared_ptr<component> get_focussed_subcomponent()
+    {
+        // The focussed subcomponent is remembered when it reports that it
+        // has gained focus.  However, not every loss of focus is reported
+        // (containers, for example, lose focus silently), so it is checked
+        // before use.  Only if it has lost its focus is it necessary to
+        // search for whichever subcomponent has taken it.
+        if (focussed_component_ && !focussed_component_->has_focus())
+        {
+            focussed_component_.reset();
+
+            for (auto const &current_component : components_)
+            {
+                if (current_component->has_focus())
+                {
+                    focussed_component_ = current_component;
+                    break;
+                }
+            }
+        }
+
+        return focussed_component_;
+    }
+
+    // ======================================================================
+    // CONTAINS
+    // ======================================================================
+    static bool contains(
+        component         const &comp
+      , terminalpp::point const &point)
+    {
+        auto const position = comp.get_position();
+        auto const size     = comp.get_size();
+
+        return point.x >= position.x
+            && point.x <  position.x + size.width
+            && point.y >= position.y
+            && point.y <  position.y + size.height;
+    }
+
+    // ======================================================================
+    // ENSURE_HIT_TEST_INDEX
+    // ======================================================================
+    void ensure_hit_test_index()
+    {
+        if (hit_test_index_dirty_)
+        {
+            // For each row of the container, record the indices of the
+            // components that lie on that row, in the order that they
+            // were added.
+            hit_test_rows_.assign(bounds_.size.height, {});
+
+            for (odin::u32 index = 0; index < components_.size(); ++index)
+            {
+                auto const position = components_[index]->get_position();
+                auto const size     = components_[index]->get_size();
+
+                auto const first_row = (std::max)(odin::s32(position.y), 0);
+                auto const last_row  = (std::min)(
+                    odin::s32(position.y + size.height)
+                  , odin::s32(bounds_.size.height));
+
+                for (auto row = first_row; row < last_row; ++row)
+                {
+                    hit_test_rows_[row].push_back(index);
+                }
+            }
+
+            hit_test_index_dirty_ = false;
+        }
+    }
+
+    // ======================================================================
+    // FIND_COMPONENT_AT
+    // ======================================================================
+    std::shared_ptr<component> find_component_at(terminalpp::point const &point)
+    {
+        // With only a few components, it is quicker to check them all
+        // than to maintain an index.
+        if (components_.size() >= HIT_TEST_INDEX_THRESHOLD
+         && point.y >= 0
+         && point.y < bounds_.size.height)
+        {
+            ensure_hit_test_index();
+
+            for (auto index : hit_test_rows_[point.y])
+            {
+                if (contains(*components_[index], point))
+                {
+                    return components_[index];
+                }
+            }
+        }
+
+        // Either the index was not used, or nothing was found in it.  Since
+        // a component may have been moved without reporting it, fall back
+        // to checking every component.
+        for (auto const &current_component : components_)
+        {
+            if (contains(*current_component, point))
+            {
+                return current_component;
+            }
+        }
+
+        return {};
+    }
+
+    // ======================================================================
+    // GET_LAYERS
+    // ======================================================================
+    layered_component_map const &get_layers()
+    {
+        // The components are only sorted into their layers when the set of
+        // components has changed, rather than each time that the container
+        // is measured or laid out.
+        if (layers_dirty_)
+        {
+            layers_.clear();
+
+            for (odin::u32 index = 0; index < components_.size(); ++index)
+            {
+                auto &lyr = layers_[component_layers_[index]];
+                lyr.components_.push_back(components_[index]);
+                lyr.hints_.push_back(component_hints_[index]);
+            }
+
+            layers_dirty_ = false;
+        }
+
+        return layers_;
+    }
+
     // ======================================================================
     // FOCUS_NEXT_HAS_FOCUS
     // ======================================================================
@@ -379,12 +563,21 @@ struct basic_container::impl
     std::vector<std::shared_ptr<component>>              components_;
     std::vector<boost::any>                              component_hints_;
     std::vector<odin::u32>                               component_layers_;
-    std::vector<std::vector<boost::signals::connection>> component_connections_;
+    std::vector<std::vector<odin::connection>> component_connections_;
+    std::shared_ptr<component>                           focussed_component_;
+    std::vector<std::vector<odin::u32>>                  hit_test_rows_;
     layered_layout_map                                   layouts_;
+    layered_component_map                                layers_;
     rectangle                                            bounds_;
     bool                                                 has_focus_;
     bool                                                 cursor_state_;
     bool                                                 enabled_;
+    bool                                                 layers_dirty_;
+    bool                                                 layout_dirty_;
+    bool                                                 subtree_dirty_;
+    bool                                                 hit_test_index_dirty_;
+    boost::optional<terminalpp::extent>                  preferred_size_;
+    odin::u64                                            preferred_size_pass_;
 };
 
 // ==========================================================================
@@ -430,8 +623,15 @@ terminalpp::point basic_container::do_get_position() const
 // ==========================================================================
 void basic_container::do_set_size(terminalpp::extent const &size)
 {
-    pimpl_->bounds_.size = size;
-    on_layout_change();
+    // Re-setting the same size (as a parent's layout frequently does) has
+    // no effect on how this container's components are arranged.
+    if (size != pimpl_->bounds_.size)
+    {
+        pimpl_->bounds_.size = size;
+        pimpl_->layout_dirty_ = true;
+        pimpl_->hit_test_index_dirty_ = true;
+        on_layout_change();
+    }
 }
 
 // ==========================================================================
@@ -470,34 +670,26 @@ terminalpp::extent basic_container::do_get_preferred_size() const
         return get_size();
     }
 
-    terminalpp::extent preferred_size(0, 0);
-
-    // Sort the components/hints into layers
-    typedef std::map<odin::u32, std::vector<std::shared_ptr<component>>> clmap;
-    typedef std::map<odin::u32, std::vector<boost::any>>                 chmap;
+    // During a layout pass, the preferred sizes of our subcomponents cannot
+    // change, so the size calculated earlier in the pass remains accurate.
+    auto const pass = layout_pass::current();
 
-    clmap component_layers_map;
-    chmap component_hints_map;
-
-    // Iterate through the components, sorting them by layer
-    for (odin::u32 index = 0; index < pimpl_->components_.size(); ++index)
+    if (pass != 0
+     && pimpl_->preferred_size_
+     && pimpl_->preferred_size_pass_ == pass)
     {
-        auto comp =  pimpl_->components_[index];
-        auto hint =  pimpl_->component_hints_[index];
-        auto layer = pimpl_->component_layers_[index];
-
-        component_layers_map[layer].push_back(comp);
-        component_hints_map[layer].push_back(hint);
+        return *pimpl_->preferred_size_;
     }
 
-    // Iterate through the layers, layout out each.
-    for (auto &component_layer_pair : component_layers_map)
+    terminalpp::extent preferred_size(0, 0);
+
+    // Iterate through the layers, measuring each.
+    for (auto const &layer_pair : pimpl_->get_layers())
     {
-        auto layer =      component_layer_pair.first;
-        auto components = component_layer_pair.second;
-        auto hints =      component_hints_map[layer];
+        auto const &components = layer_pair.second.components_;
+        auto const &hints      = layer_pair.second.hints_;
 
-        auto lyt = get_layout(layer);
+        auto lyt = get_layout(layer_pair.first);
 
         if (!lyt || components.size() == 0)
         {
@@ -515,6 +707,9 @@ terminalpp::extent basic_container::do_get_preferred_size() const
             (std::max)(preferred_size.height, lp_preferred_size.height);
     }
 
+    pimpl_->preferred_size_      = preferred_size;
+    pimpl_->preferred_size_pass_ = pass;
+
     return preferred_size;
 }
 
@@ -539,7 +734,7 @@ void basic_container::do_add_component(
     pimpl_->component_hints_.push_back(hint);
     pimpl_->component_layers_.push_back(layer);
 
-    std::vector<boost::signals::connection> component_connections;
+    std::vector<odin::connection> component_connections;
 
     // Register for callbacks for when the new subcomponent either gains
     // or loses focus.  We can make sure our own focus is correct based
@@ -582,6 +777,11 @@ void basic_container::do_add_component(
           , std::placeholders::_1
           , std::placeholders::_2)));
 
+    component_connections.push_back(comp->on_size_changed.connect(
+        std::bind(
+            &basic_container::impl::subcomponent_size_change_handler
+          , pimpl_)));
+
     // Register for callbacks for when the subcomponent's preferred size
     // changes.
     component_connections.push_back(comp->on_preferred_size_changed.connect(
@@ -590,7 +790,21 @@ void basic_container::do_add_component(
            , pimpl_
            , std::weak_ptr<component>(comp))));
 
+    // Register for callbacks for when the subcomponent requires that it,
+    // or something within it, be laid out again.
+    component_connections.push_back(comp->on_layout_change.connect(
+        std::bind(
+            &basic_container::impl::subcomponent_layout_change_handler
+          , pimpl_)));
+
     pimpl_->component_connections_.push_back(component_connections);
+    pimpl_->invalidate_layers();
+
+    // A component may have been focussed before it was added.
+    if (!pimpl_->focussed_component_ && comp->has_focus())
+    {
+        pimpl_->focussed_component_ = comp;
+    }
 
     comp->set_parent(shared_from_this());
 }
@@ -635,6 +849,12 @@ void basic_container::do_remove_component(
         }
     }
 
+    if (pimpl_->focussed_component_ == comp)
+    {
+        pimpl_->focussed_component_.reset();
+    }
+
+    pimpl_->invalidate_layers();
     comp->set_parent({});
 }
 
@@ -670,6 +890,8 @@ void basic_container::do_set_layout(
   , odin::u32                      layer)
 {
     pimpl_->layouts_[layer] = std::move(lyt);
+    pimpl_->layout_dirty_ = true;
+    pimpl_->preferred_size_.reset();
 }
 
 // ==========================================================================
@@ -808,12 +1030,11 @@ std::shared_ptr<component> basic_container::do_get_focussed_component()
 {
     if (has_focus())
     {
-        for (auto const &current_component : pimpl_->components_)
+        auto const current_component = pimpl_->get_focussed_subcomponent();
+
+        if (current_component)
         {
-            if (current_component->has_focus())
-            {
-                return current_component->get_focussed_component();
-            }
+            return current_component->get_focussed_component();
         }
     }
 
@@ -847,49 +1068,40 @@ bool basic_container::do_is_enabled() const
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void basic_container::do_event(boost::any const &event)
+void basic_container::do_event(event_type const &event)
 {
     // We split the events into two types.  Mouse events are passed to
     // whichever component is under the mouse click.  All other events are
     // passed to the focussed component.
-    auto report = boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+    auto report = boost::get<terminalpp::ansi::mouse::report>(&event);
     
     if (report != NULL)
     {
-        for (auto const &current_component : pimpl_->components_)
+        // Find the component whose bounds contain the reported position.
+        auto const current_component = pimpl_->find_component_at(
+            terminalpp::point(report->x_position_, report->y_position_));
+
+        if (current_component)
         {
-            auto position = current_component->get_position();
-            auto size =     current_component->get_size();
-
-            // Check to see if the reported position is within the component's
-            // bounds.
-            if (report->x_position_ >= position.x
-             && report->x_position_  < position.x + size.width
-             && report->y_position_ >= position.y
-             && report->y_position_  < position.y + size.height)
-            {
-                // Copy the mouse's report and adjust it so that the
-                // subcomponent's position is taken into account.
-                terminalpp::ansi::mouse::report subreport;
-                subreport.button_     = report->button_;
-                subreport.x_position_ = odin::u8(report->x_position_ - position.x);
-                subreport.y_position_ = odin::u8(report->y_position_ - position.y);
-
-                // Forward the event onto the component, then look no further.
-                current_component->event(subreport);
-                break;
-            }
+            auto const position = current_component->get_position();
+
+            // Copy the mouse's report and adjust it so that the
+            // subcomponent's position is taken into account.
+            terminalpp::ansi::mouse::report subreport;
+            subreport.button_     = report->button_;
+            subreport.x_position_ = odin::u8(report->x_position_ - position.x);
+            subreport.y_position_ = odin::u8(report->y_position_ - position.y);
+
+            current_component->event(subreport);
         }
     }
     else
     {
-        for (auto const &current_component : pimpl_->components_)
+        auto const current_component = pimpl_->get_focussed_subcomponent();
+
+        if (current_component)
         {
-            if (current_component->has_focus())
-            {
-                current_component->event(event);
-                break;
-            }
+            current_component->event(event);
         }
     }
 }
@@ -913,13 +1125,12 @@ terminalpp::point basic_container::do_get_cursor_position() const
         // Find the subcomponent that has focus and get its cursor
         // position.  This must then be offset by the subcomponent's
         // position within our container.
-        for (auto const &current_component : pimpl_->components_)
+        auto const current_component = pimpl_->get_focussed_subcomponent();
+
+        if (current_component)
         {
-            if (current_component->has_focus())
-            {
-                return current_component->get_position()
-                     + current_component->get_cursor_position();
-            }
+            return current_component->get_position()
+                 + current_component->get_cursor_position();
         }
     }
 
@@ -939,13 +1150,12 @@ void basic_container::do_set_cursor_position(terminalpp::point const &position)
         // Find the subcomponent that has focus and set its cursor
         // position.  This must then be offset by the subcomponent's
         // position within our container.
-        for (auto const &current_component : pimpl_->components_)
+        auto const current_component = pimpl_->get_focussed_subcomponent();
+
+        if (current_component)
         {
-            if (current_component->has_focus())
-            {
-                current_component->set_cursor_position(
-                    position - current_component->get_position());
-            }
+            current_component->set_cursor_position(
+                position - current_component->get_position());
         }
     }
 }
@@ -970,48 +1180,50 @@ void basic_container::do_set_attribute(
 // ==========================================================================
 void basic_container::do_layout()
 {
-    // Sort the components/hints into layers
-    typedef std::map<odin::u32, std::vector<std::shared_ptr<component>>> clmap;
-    typedef std::map<odin::u32, std::vector<boost::any>>                 chmap;
-
-    clmap component_layers_map;
-    chmap component_hints_map;
-
-    // Iterate through the components, sorting them by layer
-    for (odin::u32 index = 0; index < pimpl_->components_.size(); ++index)
+    // If neither this container's size, its components, nor their
+    // preferred sizes have changed since it was last laid out, and nothing
+    // beneath it has asked to be laid out, then there is nothing to do.
+    if (!pimpl_->layout_dirty_ && !pimpl_->subtree_dirty_)
     {
-        auto comp =  pimpl_->components_[index];
-        auto hint =  pimpl_->component_hints_[index];
-        auto layer = pimpl_->component_layers_[index];
-
-        component_layers_map[layer].push_back(comp);
-        component_hints_map[layer].push_back(hint);
+        return;
     }
 
-    auto size = get_size();
+    // The flags are cleared before any work is done so that any further
+    // changes reported while laying out are honoured by the next layout.
+    bool const relayout = pimpl_->layout_dirty_;
+    pimpl_->layout_dirty_  = false;
+    pimpl_->subtree_dirty_ = false;
 
-    // Iterate through the layers, layout out each.
-    for (auto const &component_layer_pair : component_layers_map)
+    if (relayout)
     {
-        auto layer =      component_layer_pair.first;
-        auto components = component_layer_pair.second;
-        auto hints =      component_hints_map[layer];
-
-        auto lyt = get_layout(layer);
+        auto size = get_size();
 
-        if (!lyt || components.size() == 0)
+        // Iterate through the layers, layout out each.
+        for (auto const &layer_pair : pimpl_->get_layers())
         {
-            // Either there is no layout for this layer, or there are no
-            // components in this layer.  Hence no point in laying it out.
-            // Continue with the next layer.
-            continue;
+            auto const &components = layer_pair.second.components_;
+            auto const &hints      = layer_pair.second.hints_;
+
+            auto lyt = get_layout(layer_pair.first);
+
+            if (!lyt || components.size() == 0)
+            {
+                // Either there is no layout for this layer, or there are no
+                // components in this layer.  Hence no point in laying it
+                // out.  Continue with the next layer.
+                continue;
+            }
+
+            (*lyt)(components, hints, size);
         }
 
-        (*lyt)(components, hints, size);
+        // The layouts will have moved the components about.
+        pimpl_->hit_test_index_dirty_ = true;
     }
 
     // Now that all the sizes are correct for this container, iterate through
-    // each subcomponent, and lay them out in turn.
+    // each subcomponent, and lay them out in turn.  Those whose sizes and
+    // contents are unchanged will return immediately.
     for (auto const &comp : pimpl_->components_)
     {
         comp->layout();
@@ -83,9 +83,9 @@ button::~button()
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void button::do_event(boost::any const &event)
+void button::do_event(event_type const &event)
 {
-    auto vk = boost::any_cast<terminalpp::virtual_key>(&event);
+    auto vk = boost::get<terminalpp::virtual_key>(&event);
     
     if (vk)
     {
@@ -96,7 +96,7 @@ void button::do_event(boost::any const &event)
         }
     }
     
-    auto report = boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+    auto report = boost::get<terminalpp::ansi::mouse::report>(&event);
     
     if (report
      && report->button_ == terminalpp::ansi::mouse::report::LEFT_BUTTON_DOWN)
@@ -282,7 +282,7 @@ void card::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void card::do_event(boost::any const &event)
+void card::do_event(event_type const &event)
 {
     if (pimpl_->current_face_.is_initialized())
     {
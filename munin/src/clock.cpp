@@ -30,9 +30,8 @@
 #include "munin/container.hpp"
 #include "munin/image.hpp"
 #include "munin/grid_layout.hpp"
+#include "munin/timer_wheel.hpp"
 #include <terminalpp/string.hpp>
-#include <boost/asio.hpp>
-#include <boost/asio/deadline_timer.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/format.hpp>
 #include <memory>
@@ -42,10 +41,10 @@ namespace munin {
 // ==========================================================================
 // CLOCK::IMPLEMENTATION STRUCTURE
 // ==========================================================================
-struct clock::impl : public std::enable_shared_from_this<impl>
+struct clock::impl
 {
-    std::shared_ptr<boost::asio::deadline_timer> timer_;
-    std::shared_ptr<image>                       image_;
+    std::shared_ptr<image>    image_;
+    timer_wheel::subscription minute_subscription_;
 
     void update_time()
     {
@@ -56,39 +55,6 @@ struct clock::impl : public std::enable_shared_from_this<impl>
 
         image_->set_image(terminalpp::string(boost::str(
             boost::format("%02d:%02d") % hours % minutes)));
-
-        schedule_next_update();
-    }
-
-private :
-    void schedule_next_update()
-    {
-        auto now = boost::posix_time::second_clock::local_time();
-        long seconds_until_next_minute =
-            60 - (now.time_of_day().seconds() % 60);
-
-        timer_->expires_from_now(boost::posix_time::seconds(seconds_until_next_minute));
-        timer_->async_wait(
-            [wp=std::weak_ptr<impl>(shared_from_this())]
-            (auto ec)
-            {
-                impl::schedule_next_update_thunk(wp, ec);
-            });
-    }
-
-    static void schedule_next_update_thunk(
-        std::weak_ptr<impl> weak_this
-      , boost::system::error_code const &ec)
-    {
-        if (!ec)
-        {
-            std::shared_ptr<impl> strong_this(weak_this.lock());
-
-            if (strong_this)
-            {
-                strong_this->update_time();
-            }
-        }
     }
 };
 
@@ -118,12 +84,26 @@ void clock::do_draw(
     context         &ctx
   , rectangle const &region)
 {
-    // If draw has never been called before, then it is time to initialise
-    // the timer.
-    if (!pimpl_->timer_)
+    // If draw has never been called before, then it is time to subscribe
+    // to the minute ticks of the timer wheel.  These are shared between all
+    // clocks, so they all update together.
+    if (!pimpl_->minute_subscription_.active())
     {
-        pimpl_->timer_ = std::make_shared<boost::asio::deadline_timer>(
-            std::ref(ctx.get_strand().get_io_service()));
+        auto &strand = ctx.get_strand();
+
+        pimpl_->minute_subscription_ =
+            get_timer_wheel(strand.get_io_service()).subscribe_to_minutes(
+                strand
+              , [wp=std::weak_ptr<impl>(pimpl_)]
+                {
+                    auto pthis = wp.lock();
+
+                    if (pthis)
+                    {
+                        pthis->update_time();
+                    }
+                });
+
         pimpl_->update_time();
     }
 
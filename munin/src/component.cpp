@@ -229,6 +229,14 @@ void component::layout()
     do_layout();
 }
 
+// ==========================================================================
+// IS_OPAQUE
+// ==========================================================================
+bool component::is_opaque() const
+{
+    return do_is_opaque();
+}
+
 // ==========================================================================
 // DRAW
 // ==========================================================================
@@ -242,10 +250,34 @@ void component::draw(
 // ==========================================================================
 // EVENT
 // ==========================================================================
-void component::event(boost::any const &ev)
+void component::event(event_type const &ev)
 {
     do_event(ev);
 }
 
+// ==========================================================================
+// ACCEPTS_TEXT_RUNS
+// ==========================================================================
+bool component::accepts_text_runs() const
+{
+    return do_accepts_text_runs();
+}
+
+// ==========================================================================
+// DO_IS_OPAQUE
+// ==========================================================================
+bool component::do_is_opaque() const
+{
+    return false;
+}
+
+// ==========================================================================
+// DO_ACCEPTS_TEXT_RUNS
+// ==========================================================================
+bool component::do_accepts_text_runs() const
+{
+    return false;
+}
+
 }
 
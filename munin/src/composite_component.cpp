@@ -262,6 +262,14 @@ void composite_component::do_layout()
     pimpl_->container_->layout();
 }
 
+// ==========================================================================
+// DO_IS_OPAQUE
+// ==========================================================================
+bool composite_component::do_is_opaque() const
+{
+    return pimpl_->container_->is_opaque();
+}
+
 // ==========================================================================
 // DO_DRAW
 // ==========================================================================
@@ -275,7 +283,7 @@ void composite_component::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void composite_component::do_event(boost::any const &event)
+void composite_component::do_event(event_type const &event)
 {
     pimpl_->container_->event(event);
 }
@@ -37,7 +37,7 @@ namespace munin {
 namespace {
     typedef std::pair<
         std::shared_ptr<component>
-      , std::vector<boost::signals::connection>
+      , std::vector<odin::connection>
     > component_connections_type;
 }
 
@@ -133,6 +133,24 @@ struct container::impl
         }
     }
 
+    // ======================================================================
+    // REMOVE_REGION
+    // ======================================================================
+    static std::vector<rectangle> remove_region(
+        std::vector<rectangle> const &regions
+      , rectangle              const &removed)
+    {
+        std::vector<rectangle> remaining;
+
+        for (auto const &region : regions)
+        {
+            auto const pieces = difference(region, removed);
+            remaining.insert(remaining.end(), pieces.begin(), pieces.end());
+        }
+
+        return remaining;
+    }
+
     container                               &self_;
     bool                                     dirty_ = true;
     std::vector<std::shared_ptr<component>>  components_;
@@ -306,40 +324,108 @@ void container::do_draw(
     // First, we obtain a list of components sorted by layer from lowest
     // to highest.
     pimpl_->ensure_components_sorted();
-
-    for (auto const &current_component : pimpl_->components_)
+    auto const &components = pimpl_->components_;
+
+    // Working from the highest layer down, work out which parts of the
+    // region each component can be seen in.  Anything that lies beneath an
+    // opaque component would only be painted over, so it is removed from
+    // the part of the region that is still uncovered.  Once nothing is
+    // uncovered, the remaining components are not drawn at all.
+    std::vector<std::vector<rectangle>> visible_regions(components.size());
+    std::vector<rectangle> uncovered_regions = { region };
+
+    for (auto index = components.size();
+         index > 0 && !uncovered_regions.empty();
+         --index)
     {
-        // The area we want to draw is the intersection of the region
-        // passed in above and the region of space that the component
-        // occupies.
+        auto const &current_component = components[index - 1];
+
         rectangle component_region(
             current_component->get_position()
           , current_component->get_size());
 
-        auto draw_region = intersection(region, component_region);
+        for (auto const &uncovered_region : uncovered_regions)
+        {
+            auto visible_region =
+                intersection(uncovered_region, component_region);
+
+            if (visible_region.is_initialized())
+            {
+                visible_regions[index - 1].push_back(visible_region.get());
+            }
+        }
+
+        if (!visible_regions[index - 1].empty()
+         && current_component->is_opaque())
+        {
+            uncovered_regions = impl::remove_region(
+                uncovered_regions, component_region);
+        }
+    }
+
+    // Now draw the visible parts of each component from the lowest layer
+    // to the highest.
+    for (size_t index = 0; index < components.size(); ++index)
+    {
+        auto const &current_component = components[index];
+
+        if (visible_regions[index].empty())
+        {
+            continue;
+        }
+
+        // The canvas must have an offset applied to it so that the
+        // inner component can pretend that it is being drawn with its
+        // container being at position (0,0).
+        auto const position = current_component->get_position();
+        cvs.offset_by({position.x, position.y});
 
-        if (draw_region.is_initialized())
+        // Ensure that the offset is unapplied before the next component
+        // is drawn.
+        BOOST_SCOPE_EXIT( (&cvs)(&position) )
+        {
+            cvs.offset_by({-position.x, -position.y});
+        } BOOST_SCOPE_EXIT_END
+
+        for (auto draw_region : visible_regions[index])
         {
             // The draw region is currently relative to this container's
             // origin.  It should be relative to the child's origin.
-            draw_region->origin -= component_region.origin;
+            draw_region.origin -= position;
+            current_component->draw(ctx, draw_region);
+        }
+    }
+}
+
+// ==========================================================================
+// DO_IS_OPAQUE
+// ==========================================================================
+bool container::do_is_opaque() const
+{
+    pimpl_->ensure_components_sorted();
 
-            // The canvas must have an offset applied to it so that the
-            // inner component can pretend that it is being drawn with its
-            // container being at position (0,0).
-            auto const position = current_component->get_position();
-            cvs.offset_by({position.x, position.y});
+    std::vector<rectangle> uncovered_regions = {
+        rectangle({}, get_size())
+    };
 
-            // Ensure that the offset is unapplied before exit of this
-            // function.
-            BOOST_SCOPE_EXIT( (&cvs)(&position) )
-            {
-                cvs.offset_by({-position.x, -position.y});
-            } BOOST_SCOPE_EXIT_END
+    for (auto const &current_component : pimpl_->components_)
+    {
+        if (uncovered_regions.empty())
+        {
+            break;
+        }
 
-            current_component->draw(ctx, draw_region.get());
+        if (current_component->is_opaque())
+        {
+            uncovered_regions = impl::remove_region(
+                uncovered_regions
+              , rectangle(
+                    current_component->get_position()
+                  , current_component->get_size()));
         }
     }
+
+    return uncovered_regions.empty();
 }
 
 }
@@ -382,6 +382,22 @@ dropdown_list::~dropdown_list()
 {
 }
 
+// ==========================================================================
+// SET_MODEL
+// ==========================================================================
+void dropdown_list::set_model(std::shared_ptr<list_model> const &model)
+{
+    pimpl_->list_->set_model(model);
+}
+
+// ==========================================================================
+// GET_MODEL
+// ==========================================================================
+std::shared_ptr<list_model> dropdown_list::get_model() const
+{
+    return pimpl_->list_->get_model();
+}
+
 // ==========================================================================
 // SET_ITEMS
 // ==========================================================================
@@ -417,11 +433,11 @@ terminalpp::string dropdown_list::get_item() const
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void dropdown_list::do_event(boost::any const &event)
+void dropdown_list::do_event(event_type const &event)
 {
     bool handled = false;
 
-    auto vk = boost::any_cast<terminalpp::virtual_key>(&event);
+    auto vk = boost::get<terminalpp::virtual_key>(&event);
     
     if (vk)
     {
@@ -429,7 +445,7 @@ void dropdown_list::do_event(boost::any const &event)
     }
 
     auto report =
-        boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        boost::get<terminalpp::ansi::mouse::report>(&event);
 
     if (report)
     {
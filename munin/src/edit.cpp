@@ -148,23 +148,10 @@ struct edit::impl
     /// \brief Called by event().  Derived classes must override this
     /// function in order to handle events in a custom manner.
     //* =====================================================================
-    void do_event(boost::any const &event)
+    void do_event(event_type const &event)
     {
-        auto const *vk = boost::any_cast<terminalpp::virtual_key>(&event);
-        
-        if (vk)
-        {
-            do_vk_event(*vk);
-        }
-        
-        auto const *report = 
-            boost::any_cast<terminalpp::ansi::mouse::report>(&event);
-            
-        if (report)
-        {
-            do_mouse_event(*report);
-        }
-        
+        event_dispatcher dispatcher(*this);
+        boost::apply_visitor(dispatcher, event);
     }
 
     //* =====================================================================
@@ -182,6 +169,40 @@ struct edit::impl
     }
 
 private :
+    //* =====================================================================
+    /// \brief Passes each type of event that an edit understands on to its
+    /// handler, and ignores all others.
+    //* =====================================================================
+    struct event_dispatcher : boost::static_visitor<>
+    {
+        event_dispatcher(impl &self)
+            : self_(self)
+        {
+        }
+
+        void operator()(terminalpp::virtual_key const &vk) const
+        {
+            self_.do_vk_event(vk);
+        }
+
+        void operator()(terminalpp::ansi::mouse::report const &report) const
+        {
+            self_.do_mouse_event(report);
+        }
+
+        void operator()(text_run const &run) const
+        {
+            self_.do_text_run_event(run);
+        }
+
+        template <class Event>
+        void operator()(Event const &) const
+        {
+        }
+
+        impl &self_;
+    };
+
     //* =====================================================================
     /// \brief Called when the underlying document changes.
     //* =====================================================================
@@ -368,6 +389,19 @@ private :
         }
     }
 
+    //* =====================================================================
+    /// \brief Called by do_event when a run of text has been received.
+    /// The whole run is inserted at once, so that the document changes and
+    /// is redrawn only once.
+    //* =====================================================================
+    void do_text_run_event(text_run const &run)
+    {
+        if (self_.is_enabled())
+        {
+            document_->insert_text(run.text);
+        }
+    }
+
     //* =====================================================================
     /// \brief Called by do_event when an ANSI mouse report has been
     /// received.
@@ -461,11 +495,19 @@ void edit::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void edit::do_event(boost::any const &event)
+void edit::do_event(event_type const &event)
 {
     pimpl_->do_event(event);
 }
 
+// ==========================================================================
+// DO_ACCEPTS_TEXT_RUNS
+// ==========================================================================
+bool edit::do_accepts_text_runs() const
+{
+    return true;
+}
+
 // ==========================================================================
 // DO_SET_ATTRIBUTE
 // ==========================================================================
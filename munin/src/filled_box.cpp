@@ -143,6 +143,15 @@ void filled_box::do_set_attribute(std::string const &name, boost::any const &att
     }
 }
 
+// ==========================================================================
+// DO_IS_OPAQUE
+// ==========================================================================
+bool filled_box::do_is_opaque() const
+{
+    // Every cell of the box is painted with the fill.
+    return true;
+}
+
 // ==========================================================================
 // DO_DRAW
 // ==========================================================================
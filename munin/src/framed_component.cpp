@@ -253,12 +253,12 @@ void framed_component::do_set_attribute(std::string const &name, boost::any cons
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void framed_component::do_event(boost::any const &event)
+void framed_component::do_event(event_type const &event)
 {
     bool handled = false;
 
     auto report =
-        boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        boost::get<terminalpp::ansi::mouse::report>(&event);
 
     if (report)
     {
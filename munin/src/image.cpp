@@ -105,6 +105,15 @@ terminalpp::extent image::do_get_preferred_size() const
     return preferred_size;
 }
 
+// ==========================================================================
+// DO_IS_OPAQUE
+// ==========================================================================
+bool image::do_is_opaque() const
+{
+    // Any cell not covered by the image is painted with a blank.
+    return true;
+}
+
 // ==========================================================================
 // DO_DRAW
 // ==========================================================================
@@ -25,9 +25,15 @@
 //             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ==========================================================================
 #include "munin/layout.hpp"
+#include <atomic>
 
 namespace munin {
 
+namespace {
+    std::atomic<odin::u64>  next_layout_pass(1);
+    thread_local odin::u64  current_layout_pass = 0;
+}
+
 // ==========================================================================
 // CONSTRUCTOR
 // ==========================================================================
@@ -63,5 +69,29 @@ void layout::operator()(
     do_layout(components, hints, size);
 }
 
+// ==========================================================================
+// LAYOUT_PASS::CONSTRUCTOR
+// ==========================================================================
+layout_pass::layout_pass()
+    : previous_(current_layout_pass)
+{
+    current_layout_pass = next_layout_pass++;
+}
+
+// ==========================================================================
+// LAYOUT_PASS::DESTRUCTOR
+// ==========================================================================
+layout_pass::~layout_pass()
+{
+    current_layout_pass = previous_;
+}
+
+// ==========================================================================
+// LAYOUT_PASS::CURRENT
+// ==========================================================================
+odin::u64 layout_pass::current()
+{
+    return current_layout_pass;
 }
 
+}
@@ -26,12 +26,28 @@
 // ==========================================================================
 #include "munin/list.hpp"
 #include "munin/context.hpp"
+#include "munin/list_model.hpp"
 #include <terminalpp/canvas_view.hpp>
 #include <terminalpp/string.hpp>
 #include <terminalpp/virtual_key.hpp>
+#include <algorithm>
+#include <cctype>
+#include <map>
 
 namespace munin {
 
+namespace {
+
+// ==========================================================================
+// TO_LOWER
+// ==========================================================================
+char to_lower(char ch)
+{
+    return char(std::tolower(static_cast<unsigned char>(ch)));
+}
+
+}
+
 // ==========================================================================
 // LIST::IMPLEMENTATION STRUCTURE
 // ==========================================================================
@@ -45,18 +61,483 @@ struct list::impl
     {
     }
 
+    // ======================================================================
+    // SET_MODEL
+    // ======================================================================
+    void set_model(std::shared_ptr<list_model> const &model)
+    {
+        model_connections_.clear();
+        model_ = model;
+
+        model_connections_.emplace_back(model_->on_model_reset.connect(
+            [this]{on_model_reset();}));
+        model_connections_.emplace_back(model_->on_items_inserted.connect(
+            [this](auto index, auto count){on_items_inserted(index, count);}));
+        model_connections_.emplace_back(model_->on_items_removed.connect(
+            [this](auto index, auto count){on_items_removed(index, count);}));
+        model_connections_.emplace_back(model_->on_items_changed.connect(
+            [this](auto index, auto count){on_items_changed(index, count);}));
+
+        on_model_reset();
+    }
+
+    // ======================================================================
+    // GET_NUMBER_OF_ROWS
+    // ======================================================================
+    odin::u32 get_number_of_rows() const
+    {
+        return filter_.empty()
+             ? model_->get_number_of_items()
+             : odin::u32(rows_.size());
+    }
+
+    // ======================================================================
+    // GET_INDEX_OF_ROW
+    // ======================================================================
+    odin::u32 get_index_of_row(odin::u32 row) const
+    {
+        return filter_.empty() ? row : rows_[row];
+    }
+
+    // ======================================================================
+    // GET_ROW_OF_INDEX
+    // ======================================================================
+    odin::s32 get_row_of_index(odin::s32 index) const
+    {
+        if (index < 0 || filter_.empty())
+        {
+            return index;
+        }
+
+        // The rows are always held in item order, so the row of an item
+        // can be found by binary search.
+        auto row = std::lower_bound(
+            rows_.begin(), rows_.end(), odin::u32(index));
+
+        return row != rows_.end() && *row == odin::u32(index)
+             ? odin::s32(row - rows_.begin())
+             : -1;
+    }
+
+    // ======================================================================
+    // GET_FIRST_ROW_AT_OR_AFTER_INDEX
+    // ======================================================================
+    odin::u32 get_first_row_at_or_after_index(odin::u32 index) const
+    {
+        return filter_.empty()
+             ? index
+             : odin::u32(
+                   std::lower_bound(rows_.begin(), rows_.end(), index)
+                 - rows_.begin());
+    }
+
+    // ======================================================================
+    // GET_SELECTED_ROW
+    // ======================================================================
+    odin::s32 get_selected_row() const
+    {
+        return get_row_of_index(item_index_);
+    }
+
+    // ======================================================================
+    // GET_MAX_WIDTH
+    // ======================================================================
+    odin::u32 get_max_width() const
+    {
+        return width_counts_.empty() ? 0 : width_counts_.rbegin()->first;
+    }
+
+    // ======================================================================
+    // ADD_WIDTHS
+    // ======================================================================
+    void add_widths(odin::u32 index, odin::u32 count)
+    {
+        std::vector<odin::u32> widths;
+        widths.reserve(count);
+
+        for (odin::u32 current = index; current < index + count; ++current)
+        {
+            auto const width = model_->get_item_width(current);
+            widths.push_back(width);
+            ++width_counts_[width];
+        }
+
+        widths_.insert(widths_.begin() + index, widths.begin(), widths.end());
+    }
+
+    // ======================================================================
+    // REMOVE_WIDTHS
+    // ======================================================================
+    void remove_widths(odin::u32 index, odin::u32 count)
+    {
+        for (odin::u32 current = index; current < index + count; ++current)
+        {
+            auto count_entry = width_counts_.find(widths_[current]);
+
+            if (--count_entry->second == 0)
+            {
+                width_counts_.erase(count_entry);
+            }
+        }
+
+        widths_.erase(
+            widths_.begin() + index
+          , widths_.begin() + index + count);
+    }
+
+    // ======================================================================
+    // MATCHES_FILTER
+    // ======================================================================
+    bool matches_filter(odin::u32 index, std::string const &filter) const
+    {
+        auto const item = model_->get_item(index);
+
+        std::string text;
+        text.reserve(item.size());
+
+        for (odin::u32 column = 0; column < item.size(); ++column)
+        {
+            text += to_lower(item[column].glyph_.character_);
+        }
+
+        return text.find(filter) != std::string::npos;
+    }
+
+    // ======================================================================
+    // FILTER_ALL_ITEMS
+    // ======================================================================
+    std::vector<odin::u32> filter_all_items(std::string const &filter) const
+    {
+        std::vector<odin::u32> rows;
+        auto const number_of_items = model_->get_number_of_items();
+
+        for (odin::u32 index = 0; index < number_of_items; ++index)
+        {
+            if (matches_filter(index, filter))
+            {
+                rows.push_back(index);
+            }
+        }
+
+        return rows;
+    }
+
+    // ======================================================================
+    // PUSH_FILTER_CHARACTER
+    // ======================================================================
+    void push_filter_character(char ch)
+    {
+        auto const filter = filter_ + to_lower(ch);
+
+        if (filter_.empty())
+        {
+            rows_ = filter_all_items(filter);
+        }
+        else
+        {
+            // A longer filter can only ever match a subset of the rows
+            // that the current filter matches, so only those need to be
+            // searched.  The current rows are kept so that removing the
+            // character again is immediate.
+            std::vector<odin::u32> rows;
+
+            for (auto index : rows_)
+            {
+                if (matches_filter(index, filter))
+                {
+                    rows.push_back(index);
+                }
+            }
+
+            filter_history_.push_back(std::move(rows_));
+            rows_ = std::move(rows);
+        }
+
+        filter_ = filter;
+        on_filter_changed();
+    }
+
+    // ======================================================================
+    // POP_FILTER_CHARACTER
+    // ======================================================================
+    void pop_filter_character()
+    {
+        filter_.erase(filter_.size() - 1);
+
+        if (filter_.empty())
+        {
+            rows_.clear();
+            filter_history_.clear();
+        }
+        else if (!filter_history_.empty())
+        {
+            rows_ = std::move(filter_history_.back());
+            filter_history_.pop_back();
+        }
+        else
+        {
+            rows_ = filter_all_items(filter_);
+        }
+
+        on_filter_changed();
+    }
+
+    // ======================================================================
+    // SET_FILTER
+    // ======================================================================
+    void set_filter(std::string const &filter)
+    {
+        std::string lower_filter;
+
+        for (auto ch : filter)
+        {
+            lower_filter += to_lower(ch);
+        }
+
+        if (lower_filter != filter_)
+        {
+            filter_ = lower_filter;
+            filter_history_.clear();
+            rows_ = filter_.empty()
+                  ? std::vector<odin::u32>()
+                  : filter_all_items(filter_);
+
+            on_filter_changed();
+        }
+    }
+
+    // ======================================================================
+    // ON_FILTER_CHANGED
+    // ======================================================================
+    void on_filter_changed()
+    {
+        // If the selected item has been filtered out, then move the
+        // selection onto the best remaining match.
+        if (get_selected_row() == -1 && !filter_.empty())
+        {
+            auto old_index = item_index_;
+            item_index_ = rows_.empty() ? -1 : odin::s32(rows_[0]);
+
+            if (item_index_ != old_index)
+            {
+                self_.on_item_changed(old_index);
+            }
+        }
+
+        redraw_all();
+        self_.on_preferred_size_changed();
+        self_.on_cursor_position_changed(self_.get_cursor_position());
+    }
+
+    // ======================================================================
+    // ON_MODEL_RESET
+    // ======================================================================
+    void on_model_reset()
+    {
+        widths_.clear();
+        width_counts_.clear();
+        add_widths(0, model_->get_number_of_items());
+
+        filter_history_.clear();
+
+        if (!filter_.empty())
+        {
+            rows_ = filter_all_items(filter_);
+        }
+
+        // If the selected item index was previously valid, then ensure that
+        // the currently selected item is not a non-existent item.
+        if (item_index_ != -1)
+        {
+            select_row(
+                (std::min)(
+                    get_selected_row()
+                  , odin::s32(get_number_of_rows()) - 1));
+        }
+
+        // We will probably require redrawing the entire component.
+        redraw_all();
+
+        // This may well change the preferred size of this component.
+        self_.on_preferred_size_changed();
+    }
+
+    // ======================================================================
+    // ON_ITEMS_INSERTED
+    // ======================================================================
+    void on_items_inserted(odin::u32 index, odin::u32 count)
+    {
+        add_widths(index, count);
+        filter_history_.clear();
+
+        auto const first_row = get_first_row_at_or_after_index(index);
+
+        if (!filter_.empty())
+        {
+            // Shift the rows after the insertion point, then add any of the
+            // new items that match the filter.
+            std::vector<odin::u32> inserted_rows;
+
+            for (auto current = index; current < index + count; ++current)
+            {
+                if (matches_filter(current, filter_))
+                {
+                    inserted_rows.push_back(current);
+                }
+            }
+
+            auto insertion_point = rows_.begin() + first_row;
+
+            std::for_each(
+                insertion_point
+              , rows_.end()
+              , [count](auto &row){row += count;});
+
+            rows_.insert(
+                insertion_point, inserted_rows.begin(), inserted_rows.end());
+        }
+
+        // The selected item does not change, but its index might.
+        if (item_index_ >= odin::s32(index))
+        {
+            item_index_ += count;
+            self_.on_cursor_position_changed(self_.get_cursor_position());
+        }
+
+        // Only the rows from the insertion point downwards have moved.
+        redraw_rows(first_row, get_number_of_rows());
+        self_.on_preferred_size_changed();
+    }
+
+    // ======================================================================
+    // ON_ITEMS_REMOVED
+    // ======================================================================
+    void on_items_removed(odin::u32 index, odin::u32 count)
+    {
+        remove_widths(index, count);
+        filter_history_.clear();
+
+        // The model has already lost the items, but the filtered rows have
+        // yet to be updated.
+        auto const old_number_of_rows =
+            get_number_of_rows() + (filter_.empty() ? count : 0);
+        auto const first_row = get_first_row_at_or_after_index(index);
+
+        if (!filter_.empty())
+        {
+            auto first_removed = rows_.begin() + first_row;
+            auto last_removed = std::lower_bound(
+                first_removed, rows_.end(), index + count);
+
+            std::for_each(
+                last_removed
+              , rows_.end()
+              , [count](auto &row){row -= count;});
+
+            rows_.erase(first_removed, last_removed);
+        }
+
+        auto const old_index = item_index_;
+
+        if (item_index_ >= odin::s32(index + count))
+        {
+            item_index_ -= count;
+            self_.on_cursor_position_changed(self_.get_cursor_position());
+        }
+        else if (item_index_ >= odin::s32(index))
+        {
+            item_index_ = -1;
+            self_.on_item_changed(old_index);
+            self_.on_cursor_position_changed(self_.get_cursor_position());
+        }
+
+        // Redraw from the removal point down to what used to be the end of
+        // the list, so that any vacated rows are cleared.
+        redraw_rows(first_row, (std::max)(first_row, old_number_of_rows));
+        self_.on_preferred_size_changed();
+    }
+
+    // ======================================================================
+    // ON_ITEMS_CHANGED
+    // ======================================================================
+    void on_items_changed(odin::u32 index, odin::u32 count)
+    {
+        auto const old_max_width = get_max_width();
+
+        remove_widths(index, count);
+        add_widths(index, count);
+
+        if (filter_.empty())
+        {
+            redraw_rows(index, index + count);
+        }
+        else
+        {
+            // Changed items may now fall in or out of the filter.
+            filter_history_.clear();
+            rows_ = filter_all_items(filter_);
+            on_filter_changed();
+        }
+
+        if (get_max_width() != old_max_width)
+        {
+            self_.on_preferred_size_changed();
+        }
+    }
+
+    // ======================================================================
+    // SELECT_ROW
+    // ======================================================================
+    void select_row(odin::s32 row)
+    {
+        auto const number_of_rows = odin::s32(get_number_of_rows());
+
+        if (row >= number_of_rows)
+        {
+            row = number_of_rows - 1;
+        }
+
+        self_.set_item_index(
+            row < 0 ? -1 : odin::s32(get_index_of_row(odin::u32(row))));
+    }
+
+    // ======================================================================
+    // REDRAW_ROWS
+    // ======================================================================
+    void redraw_rows(odin::u32 first_row, odin::u32 last_row)
+    {
+        if (last_row > first_row)
+        {
+            self_.on_redraw({
+                rectangle(
+                    terminalpp::point(0, first_row)
+                  , terminalpp::extent(
+                        self_.get_size().width, last_row - first_row))});
+        }
+    }
+
+    // ======================================================================
+    // REDRAW_ALL
+    // ======================================================================
+    void redraw_all()
+    {
+        self_.on_redraw({rectangle({}, self_.get_size())});
+    }
+
     // ======================================================================
     // DO_CURSOR_UP_KEY_EVENT
     // ======================================================================
     void do_cursor_up_key_event(odin::u32 times)
     {
-        if (odin::s32(times) >= item_index_)
+        auto const row = get_selected_row();
+
+        if (odin::s32(times) >= row)
         {
-            self_.set_item_index(0);
+            select_row(0);
         }
         else
         {
-            self_.set_item_index(item_index_ - times);
+            select_row(row - times);
         }
     }
 
@@ -65,7 +546,7 @@ struct list::impl
     // ======================================================================
     void do_cursor_down_key_event(odin::u32 times)
     {
-        self_.set_item_index(item_index_ + times);
+        select_row(get_selected_row() + times);
     }
 
     // ======================================================================
@@ -73,7 +554,7 @@ struct list::impl
     // ======================================================================
     void do_home_key_event()
     {
-        self_.set_item_index(0);
+        select_row(0);
     }
 
     // ======================================================================
@@ -81,7 +562,7 @@ struct list::impl
     // ======================================================================
     void do_end_key_event()
     {
-        self_.set_item_index(items_.size() - 1);
+        select_row(odin::s32(get_number_of_rows()) - 1);
     }
     
     // ======================================================================
@@ -109,12 +590,26 @@ struct list::impl
                 
             case terminalpp::vk::bs : // fall-through
             case terminalpp::vk::del :
-                self_.set_item_index(-1);
+                if (filter_.empty())
+                {
+                    self_.set_item_index(-1);
+                }
+                else
+                {
+                    pop_filter_character();
+                }
                 break;
                 
             default :
-                // Do nothing.
+            {
+                terminalpp::glyph gly(char(vk.key));
+
+                if (is_printable(gly))
+                {
+                    push_filter_character(char(vk.key));
+                }
                 break;
+            }
         }
     }
 
@@ -125,17 +620,17 @@ struct list::impl
     {
         if (report.button_ == terminalpp::ansi::mouse::report::LEFT_BUTTON_DOWN)
         {
-            auto item_selected = report.y_position_;
+            auto row_selected = report.y_position_;
 
-            if (odin::u32(item_selected) <= items_.size())
+            if (odin::u32(row_selected) < get_number_of_rows())
             {
-                if (self_.get_item_index() == item_selected)
+                if (get_selected_row() == row_selected)
                 {
                     self_.set_item_index(-1);
                 }
                 else
                 {
-                    self_.set_item_index(item_selected);
+                    select_row(row_selected);
                 }
             }
 
@@ -143,9 +638,24 @@ struct list::impl
         }
     }
 
-    list                            &self_;
-    std::vector<terminalpp::string>  items_;
-    odin::s32                        item_index_;
+    list                                  &self_;
+    std::shared_ptr<list_model>            model_;
+    std::shared_ptr<basic_list_model>      default_model_;
+    std::vector<odin::scoped_connection>   model_connections_;
+    odin::s32                              item_index_ = -1;
+
+    // The width of each item in the model, and the number of items of each
+    // width, so that the widest item is always known without measuring all
+    // of the items again.
+    std::vector<odin::u32>                 widths_;
+    std::map<odin::u32, odin::u32>         width_counts_;
+
+    // When the list is filtered, the rows hold the indices of the items
+    // that match the filter, in item order.  The history holds the rows
+    // for each shorter filter, so that backspacing over the filter is cheap.
+    std::string                            filter_;
+    std::vector<odin::u32>                 rows_;
+    std::vector<std::vector<odin::u32>>    filter_history_;
 };
 
 // ==========================================================================
@@ -154,7 +664,8 @@ struct list::impl
 list::list()
 {
     pimpl_ = std::make_shared<impl>(std::ref(*this));
-    pimpl_->item_index_ = -1;
+    pimpl_->default_model_ = make_list_model();
+    pimpl_->set_model(pimpl_->default_model_);
 }
 
 // ==========================================================================
@@ -164,28 +675,49 @@ list::~list()
 {
 }
 
+// ==========================================================================
+// SET_MODEL
+// ==========================================================================
+void list::set_model(std::shared_ptr<list_model> const &model)
+{
+    pimpl_->set_model(model ? model : pimpl_->default_model_);
+}
+
+// ==========================================================================
+// GET_MODEL
+// ==========================================================================
+std::shared_ptr<list_model> list::get_model() const
+{
+    return pimpl_->model_;
+}
+
 // ==========================================================================
 // SET_ITEMS
 // ==========================================================================
 void list::set_items(std::vector<terminalpp::string> const &items)
 {
-    auto old_items_size = pimpl_->items_.size();
-    auto size = get_size();
-
-    pimpl_->items_ = std::move(items);
+    pimpl_->default_model_->set_items(items);
 
-    // If the displayed item index was previously valid, then ensure that the
-    // currently selected item is not a non-existent item.
-    if (get_item_index() != -1)
+    if (pimpl_->model_ != pimpl_->default_model_)
     {
-        set_item_index((std::min)(old_items_size - 1, items.size() - 1));
+        pimpl_->set_model(pimpl_->default_model_);
     }
+}
 
-    // We will probably require redrawing the entire component.
-    on_redraw({rectangle({}, size)});
+// ==========================================================================
+// SET_FILTER
+// ==========================================================================
+void list::set_filter(std::string const &filter)
+{
+    pimpl_->set_filter(filter);
+}
 
-    // This may well change the preferred size of this component.
-    on_preferred_size_changed();
+// ==========================================================================
+// GET_FILTER
+// ==========================================================================
+std::string list::get_filter() const
+{
+    return pimpl_->filter_;
 }
 
 // ==========================================================================
@@ -194,32 +726,38 @@ void list::set_items(std::vector<terminalpp::string> const &items)
 void list::set_item_index(odin::s32 index)
 {
     auto old_index = pimpl_->item_index_;
+    auto const number_of_items = odin::s32(
+        pimpl_->model_->get_number_of_items());
+
+    if (index >= number_of_items)
+    {
+        index = number_of_items - 1;
+    }
 
-    if (index >= odin::s32(pimpl_->items_.size()))
+    // An item that is hidden by the filter can't be shown as selected, so
+    // the filter is cleared.
+    if (index >= 0 && pimpl_->get_row_of_index(index) == -1)
     {
-        index = pimpl_->items_.size() - 1;
+        pimpl_->set_filter("");
+        old_index = pimpl_->item_index_;
     }
 
+    auto const old_row = pimpl_->get_selected_row();
+
     pimpl_->item_index_ = index;
 
     // We will need to redraw the item both at the old index and the new
     // index.
-    auto size = get_size();
-
-    if (old_index >= 0)
+    if (old_row >= 0)
     {
-        on_redraw({
-            rectangle(
-                terminalpp::point(0, old_index)
-              , terminalpp::extent(size.width, 1))});
+        pimpl_->redraw_rows(old_row, old_row + 1);
     }
 
-    if (index >= 0)
+    auto const new_row = pimpl_->get_selected_row();
+
+    if (new_row >= 0)
     {
-        on_redraw({
-            rectangle(
-                terminalpp::point(0, index)
-              , terminalpp::extent(size.width, 1))});
+        pimpl_->redraw_rows(new_row, new_row + 1);
     }
 
     on_item_changed(old_index);
@@ -241,7 +779,7 @@ terminalpp::string list::get_item() const
 {
     return pimpl_->item_index_ < 0
       ? terminalpp::string()
-      : pimpl_->items_[pimpl_->item_index_];
+      : pimpl_->model_->get_item(pimpl_->item_index_);
 }
 
 // ==========================================================================
@@ -250,15 +788,11 @@ terminalpp::string list::get_item() const
 terminalpp::extent list::do_get_preferred_size() const
 {
     // The preferred size of this component is the widest item wide, and
-    // the number of components high.
-    odin::u32 max_width = 0;
-
-    for (auto const &item : pimpl_->items_)
-    {
-        max_width = (std::max)(max_width, odin::u32(item.size()));
-    }
-
-    return terminalpp::extent(max_width, pimpl_->items_.size());
+    // the number of rows high.  The width is of all items, not just those
+    // that match the filter, so that the list does not change width while
+    // the user types.
+    return terminalpp::extent(
+        pimpl_->get_max_width(), pimpl_->get_number_of_rows());
 }
 
 // ==========================================================================
@@ -267,9 +801,9 @@ terminalpp::extent list::do_get_preferred_size() const
 terminalpp::point list::do_get_cursor_position() const
 {
     // The 'cursor' is the selected element, or (0,0) if none is selected.
-    return terminalpp::point(
-        0
-      , pimpl_->item_index_ == -1 ? 0 : pimpl_->item_index_);
+    auto const row = pimpl_->get_selected_row();
+
+    return terminalpp::point(0, row == -1 ? 0 : row);
 }
 
 // ==========================================================================
@@ -277,7 +811,7 @@ terminalpp::point list::do_get_cursor_position() const
 // ==========================================================================
 void list::do_set_cursor_position(terminalpp::point const &position)
 {
-    set_item_index(position.y);
+    pimpl_->select_row(position.y);
 }
 
 // ==========================================================================
@@ -289,18 +823,21 @@ void list::do_draw(
 {
     static terminalpp::element const default_element(' ');
     auto &cvs = ctx.get_canvas();
+    auto const number_of_rows = odin::s32(pimpl_->get_number_of_rows());
+    auto const selected_row = pimpl_->get_selected_row();
 
+    // Only the items for the rows being drawn are requested from the
+    // model.
     for (odin::s32 y_coord = region.origin.y;
         y_coord < region.origin.y + region.size.height;
         ++y_coord)
     {
-        if (y_coord < odin::s32(pimpl_->items_.size()))
+        if (y_coord >= 0 && y_coord < number_of_rows)
         {
-            bool is_selected_item =
-                y_coord >= 0
-             && y_coord == pimpl_->item_index_;
+            bool is_selected_item = y_coord == selected_row;
 
-            auto item = pimpl_->items_[y_coord];
+            auto const item = pimpl_->model_->get_item(
+                pimpl_->get_index_of_row(y_coord));
 
             for (odin::s32 x_coord = region.origin.x;
                  x_coord < region.origin.x + region.size.width;
@@ -337,9 +874,9 @@ void list::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void list::do_event(boost::any const &event)
+void list::do_event(event_type const &event)
 {
-    auto const *vk = boost::any_cast<terminalpp::virtual_key>(&event);
+    auto const *vk = boost::get<terminalpp::virtual_key>(&event);
     
     if (vk)
     {
@@ -347,7 +884,7 @@ void list::do_event(boost::any const &event)
     }
     
     auto const *report = 
-        boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        boost::get<terminalpp::ansi::mouse::report>(&event);
         
     if (report)
     {
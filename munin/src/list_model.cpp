@@ -0,0 +1,312 @@
+// ==========================================================================
+// Munin List Model.
+//
+// Copyright (C) 2011 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "munin/list_model.hpp"
+#include <terminalpp/string.hpp>
+#include <algorithm>
+
+namespace munin {
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+list_model::list_model()
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+list_model::~list_model()
+{
+}
+
+// ==========================================================================
+// GET_NUMBER_OF_ITEMS
+// ==========================================================================
+odin::u32 list_model::get_number_of_items() const
+{
+    return do_get_number_of_items();
+}
+
+// ==========================================================================
+// GET_ITEM
+// ==========================================================================
+terminalpp::string list_model::get_item(odin::u32 index) const
+{
+    return do_get_item(index);
+}
+
+// ==========================================================================
+// GET_ITEM_WIDTH
+// ==========================================================================
+odin::u32 list_model::get_item_width(odin::u32 index) const
+{
+    return do_get_item_width(index);
+}
+
+// ==========================================================================
+// DO_GET_ITEM_WIDTH
+// ==========================================================================
+odin::u32 list_model::do_get_item_width(odin::u32 index) const
+{
+    return odin::u32(get_item(index).size());
+}
+
+// ==========================================================================
+// BASIC_LIST_MODEL::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct basic_list_model::impl
+{
+    std::vector<terminalpp::string> items_;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+basic_list_model::basic_list_model()
+    : pimpl_(std::make_shared<impl>())
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+basic_list_model::~basic_list_model()
+{
+}
+
+// ==========================================================================
+// SET_ITEMS
+// ==========================================================================
+void basic_list_model::set_items(std::vector<terminalpp::string> items)
+{
+    pimpl_->items_ = std::move(items);
+    on_model_reset();
+}
+
+// ==========================================================================
+// INSERT_ITEMS
+// ==========================================================================
+void basic_list_model::insert_items(
+    odin::u32                              index
+  , std::vector<terminalpp::string> const &items)
+{
+    if (items.empty())
+    {
+        return;
+    }
+
+    index = (std::min)(index, odin::u32(pimpl_->items_.size()));
+
+    pimpl_->items_.insert(
+        pimpl_->items_.begin() + index
+      , items.begin()
+      , items.end());
+
+    on_items_inserted(index, odin::u32(items.size()));
+}
+
+// ==========================================================================
+// REMOVE_ITEMS
+// ==========================================================================
+void basic_list_model::remove_items(odin::u32 index, odin::u32 count)
+{
+    auto const size = odin::u32(pimpl_->items_.size());
+
+    if (index >= size)
+    {
+        return;
+    }
+
+    count = (std::min)(count, size - index);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    pimpl_->items_.erase(
+        pimpl_->items_.begin() + index
+      , pimpl_->items_.begin() + index + count);
+
+    on_items_removed(index, count);
+}
+
+// ==========================================================================
+// DO_GET_NUMBER_OF_ITEMS
+// ==========================================================================
+odin::u32 basic_list_model::do_get_number_of_items() const
+{
+    return odin::u32(pimpl_->items_.size());
+}
+
+// ==========================================================================
+// DO_GET_ITEM
+// ==========================================================================
+terminalpp::string basic_list_model::do_get_item(odin::u32 index) const
+{
+    return pimpl_->items_[index];
+}
+
+// ==========================================================================
+// DO_GET_ITEM_WIDTH
+// ==========================================================================
+odin::u32 basic_list_model::do_get_item_width(odin::u32 index) const
+{
+    return odin::u32(pimpl_->items_[index].size());
+}
+
+// ==========================================================================
+// STRING_LIST_MODEL::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct string_list_model::impl
+{
+    std::vector<std::string> items_;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+string_list_model::string_list_model()
+    : pimpl_(std::make_shared<impl>())
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+string_list_model::~string_list_model()
+{
+}
+
+// ==========================================================================
+// SET_ITEMS
+// ==========================================================================
+void string_list_model::set_items(std::vector<std::string> items)
+{
+    auto &current = pimpl_->items_;
+
+    // Find the items at the start and the end that have not changed.
+    odin::u32 prefix = 0;
+
+    while (prefix < current.size()
+        && prefix < items.size()
+        && current[prefix] == items[prefix])
+    {
+        ++prefix;
+    }
+
+    odin::u32 suffix = 0;
+
+    while (suffix < current.size() - prefix
+        && suffix < items.size() - prefix
+        && current[current.size() - suffix - 1]
+               == items[items.size() - suffix - 1])
+    {
+        ++suffix;
+    }
+
+    // Whatever lies between them has been altered, inserted or removed.
+    // The model is updated one step at a time so that it always agrees
+    // with each notification as it is sent.
+    auto const old_count = odin::u32(current.size()) - prefix - suffix;
+    auto const new_count = odin::u32(items.size()) - prefix - suffix;
+    auto const altered   = (std::min)(old_count, new_count);
+
+    if (altered != 0)
+    {
+        std::copy(
+            items.begin() + prefix
+          , items.begin() + prefix + altered
+          , current.begin() + prefix);
+
+        on_items_changed(prefix, altered);
+    }
+
+    if (old_count > new_count)
+    {
+        current.erase(
+            current.begin() + prefix + altered
+          , current.begin() + prefix + old_count);
+
+        on_items_removed(prefix + altered, old_count - new_count);
+    }
+    else if (new_count > old_count)
+    {
+        current.insert(
+            current.begin() + prefix + altered
+          , items.begin() + prefix + altered
+          , items.begin() + prefix + new_count);
+
+        on_items_inserted(prefix + altered, new_count - old_count);
+    }
+}
+
+// ==========================================================================
+// DO_GET_NUMBER_OF_ITEMS
+// ==========================================================================
+odin::u32 string_list_model::do_get_number_of_items() const
+{
+    return odin::u32(pimpl_->items_.size());
+}
+
+// ==========================================================================
+// DO_GET_ITEM
+// ==========================================================================
+terminalpp::string string_list_model::do_get_item(odin::u32 index) const
+{
+    return terminalpp::string(pimpl_->items_[index]);
+}
+
+// ==========================================================================
+// DO_GET_ITEM_WIDTH
+// ==========================================================================
+odin::u32 string_list_model::do_get_item_width(odin::u32 index) const
+{
+    return odin::u32(pimpl_->items_[index].size());
+}
+
+// ==========================================================================
+// MAKE_LIST_MODEL
+// ==========================================================================
+std::shared_ptr<basic_list_model> make_list_model(
+    std::vector<terminalpp::string> items)
+{
+    auto model = std::make_shared<basic_list_model>();
+    model->set_items(std::move(items));
+    return model;
+}
+
+// ==========================================================================
+// MAKE_STRING_LIST_MODEL
+// ==========================================================================
+std::shared_ptr<string_list_model> make_string_list_model()
+{
+    return std::make_shared<string_list_model>();
+}
+
+}
@@ -292,12 +292,12 @@ void named_frame::set_closeable(bool closeable)
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void named_frame::do_event(boost::any const &event)
+void named_frame::do_event(event_type const &event)
 {
     bool handled = false;
 
     auto report =
-        boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        boost::get<terminalpp::ansi::mouse::report>(&event);
 
     if (report)
     {
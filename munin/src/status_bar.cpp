@@ -30,17 +30,15 @@
 #include "munin/context.hpp"
 #include "munin/image.hpp"
 #include "munin/grid_layout.hpp"
+#include "munin/timer_wheel.hpp"
 #include "terminalpp/string.hpp"
-#include <boost/asio.hpp>
-#include <boost/asio/deadline_timer.hpp>
-#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/format.hpp>
 
 namespace munin {
 
 namespace {
+    // The marquee moves on every tick of the timer wheel.
     BOOST_STATIC_CONSTANT(odin::u32, DELAY_BEFORE_MARQUEE   = 3);
-    BOOST_STATIC_CONSTANT(odin::u32, MARQUEE_SPEED_MS       = 15);
     BOOST_STATIC_CONSTANT(odin::u32, CHARACTERS_PER_MARQUEE = 2);
 }
 
@@ -49,24 +47,47 @@ namespace {
 // ==========================================================================
 struct status_bar::impl : public std::enable_shared_from_this<impl>
 {
-    std::shared_ptr<boost::asio::deadline_timer> timer_;
-    std::shared_ptr<image>                       image_;
-    terminalpp::string                           message_;
-    odin::s32                                    tick_;
+    impl(boost::asio::strand &strand)
+      : strand_(strand),
+        wheel_(get_timer_wheel(strand.get_io_service()))
+    {
+    }
+
+    boost::asio::strand        &strand_;
+    timer_wheel                &wheel_;
+    timer_wheel::subscription   delay_;
+    timer_wheel::subscription   marquee_;
+    std::shared_ptr<image>      image_;
+    terminalpp::string          message_;
+    odin::s32                   tick_;
 
     void start_marquee()
     {
         tick_ = 0;
-        timer_->expires_from_now(boost::posix_time::seconds(DELAY_BEFORE_MARQUEE));
-        timer_->async_wait(
-            [wp=std::weak_ptr<impl>(shared_from_this())]
-            (auto const &)
+
+        // Replacing the subscriptions cancels any marquee that is still in
+        // progress for a previous message.
+        marquee_.cancel();
+        delay_ = wheel_.schedule(
+            strand_
+          , std::chrono::seconds(DELAY_BEFORE_MARQUEE)
+          , [wp=std::weak_ptr<impl>(shared_from_this())]
             {
                 auto pthis = wp.lock();
 
                 if (pthis)
                 {
-                    pthis->marquee_progress();
+                    pthis->marquee_ = pthis->wheel_.subscribe_to_ticks(
+                        pthis->strand_
+                      , [wp]
+                        {
+                            auto pthis = wp.lock();
+
+                            if (pthis)
+                            {
+                                pthis->marquee_progress();
+                            }
+                        });
                 }
             });
     }
@@ -77,25 +98,13 @@ private :
         if (message_.size() < CHARACTERS_PER_MARQUEE)
         {
             image_->set_image("");
+            marquee_.cancel();
         }
         else
         {
-            message_ = terminalpp::string{message_.begin() + CHARACTERS_PER_MARQUEE, message_.end()};
+            message_ = terminalpp::string{
+                message_.begin() + CHARACTERS_PER_MARQUEE, message_.end()};
             image_->set_image(message_);
-
-            timer_->expires_from_now(boost::posix_time::milliseconds(MARQUEE_SPEED_MS));
-            timer_->async_wait(
-                [wp=std::weak_ptr<impl>(shared_from_this())]
-                (auto const &)
-                {
-                    auto pthis = wp.lock();
-
-                    if (pthis)
-                    {
-                        pthis->marquee_progress();
-                    }
-                });
-
         }
     }
 };
@@ -103,8 +112,8 @@ private :
 // ==========================================================================
 // CONSTRUCTOR
 // ==========================================================================
-status_bar::status_bar()
-  : pimpl_(std::make_shared<impl>())
+status_bar::status_bar(boost::asio::strand &strand)
+  : pimpl_(std::make_shared<impl>(std::ref(strand)))
 {
     pimpl_->image_ = make_image(pimpl_->message_);
     pimpl_->tick_  = 0;
@@ -137,14 +146,6 @@ void status_bar::do_draw(
     context         &ctx
   , rectangle const &region)
 {
-    // If draw has never been called before, then it is time to initialise
-    // the timer.
-    if (!pimpl_->timer_)
-    {
-        pimpl_->timer_ = std::move(std::make_shared<boost::asio::deadline_timer>(
-            std::ref(ctx.get_strand().get_io_service())));
-    }
-
     // If a message has been written since the last time this was redrawn,
     // then we must begin a timer to ensure that it marquees (if necessary)
     // and then vanishes.
@@ -142,16 +142,16 @@ public :
         bottom_box_->set_fill(element);
     }
 
-    boost::signal<void ()> on_click;
+    odin::signal<void ()> on_click;
 
 protected :
     // ======================================================================
     // DO_EVENT
     // ======================================================================
-    void do_event(boost::any const &event)
+    void do_event(event_type const &event)
     {
         auto *report = 
-            boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+            boost::get<terminalpp::ansi::mouse::report>(&event);
             
         if (report
          && report->button_ != terminalpp::ansi::mouse::report::BUTTON_UP)
@@ -249,16 +249,16 @@ public :
         update_highlights();
     }
 
-    boost::signal<void (std::string)> on_tab_selected;
+    odin::signal<void (std::string)> on_tab_selected;
 
 protected :
     // ======================================================================
     // DO_EVENT
     // ======================================================================
-    void do_event(boost::any const &event)
+    void do_event(event_type const &event)
     {
         bool handled = false;
-        auto *vk = boost::any_cast<terminalpp::virtual_key>(&event);
+        auto *vk = boost::get<terminalpp::virtual_key>(&event);
 
         if (vk)
         {
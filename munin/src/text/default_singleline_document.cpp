@@ -145,9 +145,11 @@ void default_singleline_document::do_insert_text(
 
     set_caret_index(get_caret_index() + stripped_text.size());
 
+    // Everything from the insertion point onwards has moved, so it must
+    // all be redrawn.
     on_redraw({rectangle(
         terminalpp::point(old_index, 0)
-      , terminalpp::extent(odin::s32(text.size()), 0))});
+      , terminalpp::extent(odin::s32(pimpl_->text_.size() - old_index), 1))});
 }
 
 // ==========================================================================
@@ -154,25 +154,47 @@ struct text_area::impl
     //* =====================================================================
     /// \brief Processes events.
     //* =====================================================================
-    void do_event(boost::any const &event)
+    void do_event(event_type const &event)
     {
-        auto vk = boost::any_cast<terminalpp::virtual_key>(&event);
-        
-        if (vk)
+        event_dispatcher dispatcher(*this);
+        boost::apply_visitor(dispatcher, event);
+    }
+
+private :
+    //* =====================================================================
+    /// \brief Passes each type of event that a text area understands on to
+    /// its handler, and ignores all others.
+    //* =====================================================================
+    struct event_dispatcher : boost::static_visitor<>
+    {
+        event_dispatcher(impl &self)
+            : self_(self)
         {
-            do_vk_event(*vk);
         }
 
-        auto report =
-            boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        void operator()(terminalpp::virtual_key const &vk) const
+        {
+            self_.do_vk_event(vk);
+        }
 
-        if (report)
+        void operator()(terminalpp::ansi::mouse::report const &report) const
         {
-            do_mouse_event(*report);
+            self_.do_mouse_event(report);
         }
-    }
 
-private :
+        void operator()(text_run const &run) const
+        {
+            self_.do_text_run_event(run);
+        }
+
+        template <class Event>
+        void operator()(Event const &) const
+        {
+        }
+
+        impl &self_;
+    };
+
     //* =====================================================================
     /// \brief Called when the underlying document changes.
     //* =====================================================================
@@ -397,6 +419,19 @@ private :
         }
     }
 
+    //* =====================================================================
+    /// \brief Called by do_event when a run of text has been received.
+    /// The whole run is inserted at once, so that the document is reindexed
+    /// and redrawn only once.
+    //* =====================================================================
+    void do_text_run_event(text_run const &run)
+    {
+        if (self_.is_enabled())
+        {
+            document_->insert_text(run.text);
+        }
+    }
+
     //* =====================================================================
     /// \brief Called by do_event when an ANSI mouse report has been
     /// received.
@@ -512,11 +547,19 @@ void text_area::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void text_area::do_event(boost::any const &event)
+void text_area::do_event(event_type const &event)
 {
     pimpl_->do_event(event);
 }
 
+// ==========================================================================
+// DO_ACCEPTS_TEXT_RUNS
+// ==========================================================================
+bool text_area::do_accepts_text_runs() const
+{
+    return true;
+}
+
 // ==========================================================================
 // MAKE_TEXT_AREA
 // ==========================================================================
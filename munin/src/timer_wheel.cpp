@@ -0,0 +1,645 @@
+// ==========================================================================
+// Munin Timer Wheel.
+//
+// Copyright (C) 2011 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "munin/timer_wheel.hpp"
+#include <boost/asio/steady_timer.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace munin {
+
+namespace {
+    // The wheel has four levels of 64 slots.  With the default tick of
+    // 15ms, the levels span roughly 1 second, 1 minute, 1 hour and 2.5 days.  Timers
+    // further in the future than that are parked in the last slot and
+    // rescheduled when they are reached.
+    BOOST_STATIC_CONSTANT(odin::u32, SLOT_BITS       = 6);
+    BOOST_STATIC_CONSTANT(odin::u32, SLOTS_PER_LEVEL = 1u << SLOT_BITS);
+    BOOST_STATIC_CONSTANT(odin::u32, SLOT_MASK       = SLOTS_PER_LEVEL - 1);
+    BOOST_STATIC_CONSTANT(odin::u32, LEVELS          = 4);
+}
+
+std::chrono::milliseconds const timer_wheel::default_tick_interval(15);
+boost::asio::io_service::id timer_wheel::id;
+
+// ==========================================================================
+// TIMER_WHEEL::ENTRY
+// ==========================================================================
+struct timer_wheel::entry
+{
+    boost::asio::strand    *strand_;
+    std::function<void ()>  callback_;
+    odin::u64               due_tick_ = 0;
+    std::atomic<bool>       cancelled_{false};
+};
+
+// ==========================================================================
+// TIMER_WHEEL::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct timer_wheel::impl
+{
+    typedef std::vector<std::shared_ptr<entry>> entries;
+
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(
+        boost::asio::io_service   &io_service,
+        std::chrono::milliseconds  tick_interval)
+        : timer_(io_service),
+          tick_interval_(tick_interval),
+          start_time_(std::chrono::steady_clock::now())
+    {
+    }
+
+    // ======================================================================
+    // TICK_AT
+    // ======================================================================
+    odin::u64 tick_at(std::chrono::steady_clock::time_point when) const
+    {
+        // Round up, so that nothing is ever run early.
+        auto const elapsed = when - start_time_;
+        auto const ticks =
+            (elapsed + tick_interval_ - duration(1)) / tick_interval_;
+
+        return ticks < 0 ? 0 : odin::u64(ticks);
+    }
+
+    // ======================================================================
+    // TICKS_ELAPSED
+    // ======================================================================
+    odin::u64 ticks_elapsed(std::chrono::steady_clock::time_point when) const
+    {
+        // Round down, so that a tick is only run once it has been reached.
+        auto const ticks = (when - start_time_) / tick_interval_;
+
+        return ticks < 0 ? 0 : odin::u64(ticks);
+    }
+
+    // ======================================================================
+    // IS_EMPTY
+    // ======================================================================
+    bool is_empty() const
+    {
+        return pending_ == 0
+            && tick_subscribers_.empty()
+            && minute_subscribers_.empty();
+    }
+
+    // ======================================================================
+    // CATCH_UP
+    // ======================================================================
+    void catch_up()
+    {
+        // When nothing is scheduled, the wheel is not turning, and so it
+        // may have fallen behind the clock.  Since it is empty, it can be
+        // moved straight to the present.
+        if (is_empty())
+        {
+            current_tick_ = (std::max)(
+                current_tick_
+              , ticks_elapsed(std::chrono::steady_clock::now()));
+        }
+    }
+
+    // ======================================================================
+    // INSERT
+    // ======================================================================
+    void insert(std::shared_ptr<entry> const &ent)
+    {
+        // Anything that is already due is placed in the current slot, which
+        // only happens while cascading, before the current slot is run.
+        auto due_tick = (std::max)(ent->due_tick_, current_tick_);
+        auto const delta = due_tick - current_tick_;
+
+        odin::u32 level = 0;
+
+        while (level < LEVELS - 1
+            && delta >= (odin::u64(1) << (SLOT_BITS * (level + 1))))
+        {
+            ++level;
+        }
+
+        auto const span = odin::u64(1) << (SLOT_BITS * LEVELS);
+
+        if (delta >= span)
+        {
+            due_tick = current_tick_ + span - 1;
+        }
+
+        auto const slot = (due_tick >> (SLOT_BITS * level)) & SLOT_MASK;
+        wheel_[level][slot].push_back(ent);
+        ++pending_;
+    }
+
+    // ======================================================================
+    // CASCADE
+    // ======================================================================
+    bool cascade(odin::u32 level)
+    {
+        auto const slot = (current_tick_ >> (SLOT_BITS * level)) & SLOT_MASK;
+
+        entries cascaded;
+        cascaded.swap(wheel_[level][slot]);
+        pending_ -= cascaded.size();
+
+        for (auto const &ent : cascaded)
+        {
+            if (!ent->cancelled_)
+            {
+                insert(ent);
+            }
+        }
+
+        return slot == 0;
+    }
+
+    // ======================================================================
+    // ADVANCE
+    // ======================================================================
+    void advance(entries &due)
+    {
+        ++current_tick_;
+
+        // Each time a level wraps around, the next slot of the level above
+        // it is spread out over the levels below.
+        if ((current_tick_ & SLOT_MASK) == 0)
+        {
+            odin::u32 level = 1;
+
+            while (level < LEVELS && cascade(level))
+            {
+                ++level;
+            }
+        }
+
+        auto &slot = wheel_[0][current_tick_ & SLOT_MASK];
+        pending_ -= slot.size();
+
+        for (auto &ent : slot)
+        {
+            if (ent->cancelled_)
+            {
+                continue;
+            }
+
+            if (ent->due_tick_ <= current_tick_)
+            {
+                due.push_back(std::move(ent));
+            }
+            else
+            {
+                // This was parked beyond the range of the wheel.
+                insert(ent);
+            }
+        }
+
+        slot.clear();
+    }
+
+    // ======================================================================
+    // GET_NEXT_WAKE_TICK
+    // ======================================================================
+    odin::u64 get_next_wake_tick() const
+    {
+        auto next_tick = std::numeric_limits<odin::u64>::max();
+
+        if (!tick_subscribers_.empty())
+        {
+            return current_tick_ + 1;
+        }
+
+        if (!minute_subscribers_.empty())
+        {
+            next_tick = next_minute_tick_;
+        }
+
+        // For each level, find the next slot that has anything in it.  The
+        // wheel must wake when that slot is reached so that it can either
+        // run the timers or spread them across the lower levels.
+        for (odin::u32 level = 0; level < LEVELS; ++level)
+        {
+            auto const shift = SLOT_BITS * level;
+
+            for (odin::u64 step = 1; step <= SLOTS_PER_LEVEL; ++step)
+            {
+                auto const tick = ((current_tick_ >> shift) + step) << shift;
+
+                if (tick >= next_tick)
+                {
+                    break;
+                }
+
+                if (!wheel_[level][(tick >> shift) & SLOT_MASK].empty())
+                {
+                    next_tick = tick;
+                    break;
+                }
+            }
+        }
+
+        return next_tick;
+    }
+
+    // ======================================================================
+    // SCHEDULE_WAKE
+    // ======================================================================
+    void schedule_wake()
+    {
+        if (is_empty())
+        {
+            return;
+        }
+
+        auto const wake_tick = get_next_wake_tick();
+
+        if (wake_tick == std::numeric_limits<odin::u64>::max()
+         || (armed_ && armed_tick_ <= wake_tick))
+        {
+            return;
+        }
+
+        armed_ = true;
+        armed_tick_ = wake_tick;
+
+        auto const generation = ++generation_;
+
+        timer_.expires_at(
+            start_time_
+          + std::chrono::milliseconds::rep(wake_tick) * tick_interval_);
+        timer_.async_wait(
+            [this, generation](boost::system::error_code const &ec)
+            {
+                if (!ec)
+                {
+                    on_wake(generation);
+                }
+            });
+    }
+
+    // ======================================================================
+    // NEXT_MINUTE_TICK
+    // ======================================================================
+    odin::u64 next_minute_tick() const
+    {
+        auto const now = std::chrono::system_clock::now();
+        auto const since_minute =
+            now.time_since_epoch() % std::chrono::minutes(1);
+
+        return tick_at(
+            std::chrono::steady_clock::now()
+          + (std::chrono::minutes(1) - since_minute));
+    }
+
+    // ======================================================================
+    // ADD_SUBSCRIBERS
+    // ======================================================================
+    static void add_subscribers(entries &due, entries &subscribers)
+    {
+        subscribers.erase(
+            std::remove_if(
+                subscribers.begin()
+              , subscribers.end()
+              , [](auto const &ent){return bool(ent->cancelled_);})
+          , subscribers.end());
+
+        due.insert(due.end(), subscribers.begin(), subscribers.end());
+    }
+
+    // ======================================================================
+    // DISPATCH
+    // ======================================================================
+    static void dispatch(entries &due)
+    {
+        // Gather the callbacks by strand, so that each strand receives only
+        // a single handler per tick.
+        std::map<boost::asio::strand *, entries> by_strand;
+
+        for (auto &ent : due)
+        {
+            by_strand[ent->strand_].push_back(std::move(ent));
+        }
+
+        for (auto &strand_entries : by_strand)
+        {
+            strand_entries.first->post(
+                [ents=std::move(strand_entries.second)]
+                {
+                    for (auto const &ent : ents)
+                    {
+                        if (!ent->cancelled_)
+                        {
+                            ent->callback_();
+                        }
+                    }
+                });
+        }
+    }
+
+    // ======================================================================
+    // ON_WAKE
+    // ======================================================================
+    void on_wake(odin::u64 generation)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (generation != generation_)
+        {
+            // The wheel has been re-armed since this wait began.
+            return;
+        }
+
+        armed_ = false;
+
+        auto const now_tick =
+            ticks_elapsed(std::chrono::steady_clock::now());
+        entries due;
+        bool ticked = false;
+
+        while (current_tick_ < now_tick)
+        {
+            advance(due);
+            ticked = true;
+        }
+
+        if (ticked)
+        {
+            add_subscribers(due, tick_subscribers_);
+        }
+
+        if (!minute_subscribers_.empty() && current_tick_ >= next_minute_tick_)
+        {
+            add_subscribers(due, minute_subscribers_);
+            next_minute_tick_ = next_minute_tick();
+        }
+
+        // Posting to the strands happens under the lock so that a
+        // subscription, which also takes the lock to cancel, can never be
+        // cancelled and its strand destroyed while it is being posted to.
+        dispatch(due);
+        schedule_wake();
+    }
+
+    std::mutex                                  mutex_;
+    boost::asio::steady_timer                   timer_;
+    std::chrono::milliseconds const             tick_interval_;
+    std::chrono::steady_clock::time_point       start_time_;
+    odin::u64                                   current_tick_ = 0;
+    odin::u64                                   next_minute_tick_ = 0;
+    odin::u64                                   pending_ = 0;
+    bool                                        armed_ = false;
+    odin::u64                                   armed_tick_ = 0;
+    odin::u64                                   generation_ = 0;
+    std::array<std::array<entries, SLOTS_PER_LEVEL>, LEVELS> wheel_;
+    entries                                     tick_subscribers_;
+    entries                                     minute_subscribers_;
+};
+
+// ==========================================================================
+// SUBSCRIPTION::CONSTRUCTOR
+// ==========================================================================
+timer_wheel::subscription::subscription()
+{
+}
+
+// ==========================================================================
+// SUBSCRIPTION::CONSTRUCTOR
+// ==========================================================================
+timer_wheel::subscription::subscription(
+    std::weak_ptr<impl>    wheel
+  , std::shared_ptr<entry> ent)
+    : wheel_(std::move(wheel)),
+      entry_(std::move(ent))
+{
+}
+
+// ==========================================================================
+// SUBSCRIPTION::MOVE CONSTRUCTOR
+// ==========================================================================
+timer_wheel::subscription::subscription(subscription &&other)
+    : wheel_(std::move(other.wheel_)),
+      entry_(std::move(other.entry_))
+{
+    other.entry_.reset();
+}
+
+// ==========================================================================
+// SUBSCRIPTION::MOVE ASSIGNMENT
+// ==========================================================================
+timer_wheel::subscription &timer_wheel::subscription::operator=(
+    subscription &&other)
+{
+    if (this != &other)
+    {
+        cancel();
+        wheel_ = std::move(other.wheel_);
+        entry_ = std::move(other.entry_);
+        other.entry_.reset();
+    }
+
+    return *this;
+}
+
+// ==========================================================================
+// SUBSCRIPTION::DESTRUCTOR
+// ==========================================================================
+timer_wheel::subscription::~subscription()
+{
+    cancel();
+}
+
+// ==========================================================================
+// SUBSCRIPTION::CANCEL
+// ==========================================================================
+void timer_wheel::subscription::cancel()
+{
+    if (entry_)
+    {
+        auto wheel = wheel_.lock();
+
+        if (wheel)
+        {
+            std::unique_lock<std::mutex> lock(wheel->mutex_);
+            entry_->cancelled_ = true;
+        }
+        else
+        {
+            entry_->cancelled_ = true;
+        }
+
+        entry_.reset();
+    }
+}
+
+// ==========================================================================
+// SUBSCRIPTION::ACTIVE
+// ==========================================================================
+bool timer_wheel::subscription::active() const
+{
+    return entry_ && !entry_->cancelled_;
+}
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+timer_wheel::timer_wheel(boost::asio::io_service &io_service)
+    : timer_wheel(io_service, default_tick_interval)
+{
+}
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+timer_wheel::timer_wheel(
+    boost::asio::io_service   &io_service
+  , std::chrono::milliseconds  tick_interval)
+    : boost::asio::io_service::service(io_service),
+      pimpl_(std::make_shared<impl>(std::ref(io_service), tick_interval))
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+timer_wheel::~timer_wheel()
+{
+}
+
+// ==========================================================================
+// GET_TICK_INTERVAL
+// ==========================================================================
+std::chrono::milliseconds timer_wheel::get_tick_interval() const
+{
+    return pimpl_->tick_interval_;
+}
+
+// ==========================================================================
+// SCHEDULE
+// ==========================================================================
+timer_wheel::subscription timer_wheel::schedule(
+    boost::asio::strand          &strand
+  , duration                      delay
+  , std::function<void ()> const &callback)
+{
+    auto ent = std::make_shared<entry>();
+    ent->strand_   = &strand;
+    ent->callback_ = callback;
+
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    pimpl_->catch_up();
+
+    // Never schedule into the current tick, which has already been run.
+    ent->due_tick_ = (std::max)(
+        pimpl_->tick_at(std::chrono::steady_clock::now() + delay)
+      , pimpl_->current_tick_ + 1);
+    pimpl_->insert(ent);
+    pimpl_->schedule_wake();
+
+    return subscription(pimpl_, ent);
+}
+
+// ==========================================================================
+// SUBSCRIBE_TO_TICKS
+// ==========================================================================
+timer_wheel::subscription timer_wheel::subscribe_to_ticks(
+    boost::asio::strand          &strand
+  , std::function<void ()> const &callback)
+{
+    auto ent = std::make_shared<entry>();
+    ent->strand_   = &strand;
+    ent->callback_ = callback;
+
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    pimpl_->catch_up();
+    pimpl_->tick_subscribers_.push_back(ent);
+    pimpl_->schedule_wake();
+
+    return subscription(pimpl_, ent);
+}
+
+// ==========================================================================
+// SUBSCRIBE_TO_MINUTES
+// ==========================================================================
+timer_wheel::subscription timer_wheel::subscribe_to_minutes(
+    boost::asio::strand          &strand
+  , std::function<void ()> const &callback)
+{
+    auto ent = std::make_shared<entry>();
+    ent->strand_   = &strand;
+    ent->callback_ = callback;
+
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    pimpl_->catch_up();
+
+    if (pimpl_->minute_subscribers_.empty())
+    {
+        pimpl_->next_minute_tick_ = pimpl_->next_minute_tick();
+    }
+
+    pimpl_->minute_subscribers_.push_back(ent);
+    pimpl_->schedule_wake();
+
+    return subscription(pimpl_, ent);
+}
+
+// ==========================================================================
+// SHUTDOWN_SERVICE
+// ==========================================================================
+void timer_wheel::shutdown_service()
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+
+    boost::system::error_code ec;
+    pimpl_->timer_.cancel(ec);
+    ++pimpl_->generation_;
+
+    for (auto &level : pimpl_->wheel_)
+    {
+        for (auto &slot : level)
+        {
+            slot.clear();
+        }
+    }
+
+    pimpl_->pending_ = 0;
+    pimpl_->tick_subscribers_.clear();
+    pimpl_->minute_subscribers_.clear();
+}
+
+// ==========================================================================
+// GET_TIMER_WHEEL
+// ==========================================================================
+timer_wheel &get_timer_wheel(boost::asio::io_service &io_service)
+{
+    return boost::asio::use_service<timer_wheel>(io_service);
+}
+
+}
@@ -104,9 +104,9 @@ bool toggle_button::get_toggle() const
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void toggle_button::do_event(boost::any const &event)
+void toggle_button::do_event(event_type const &event)
 {
-    auto vk = boost::any_cast<terminalpp::virtual_key>(&event);
+    auto vk = boost::get<terminalpp::virtual_key>(&event);
     
     if (vk)
     {
@@ -118,7 +118,7 @@ void toggle_button::do_event(boost::any const &event)
         }
     }
     
-    auto report = boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+    auto report = boost::get<terminalpp::ansi::mouse::report>(&event);
     
     if (report
      && report->button_ == terminalpp::ansi::mouse::report::LEFT_BUTTON_DOWN)
@@ -255,10 +255,10 @@ void vertical_scroll_bar::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void vertical_scroll_bar::do_event(boost::any const &event)
+void vertical_scroll_bar::do_event(event_type const &event)
 {
     auto report =
-        boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        boost::get<terminalpp::ansi::mouse::report>(&event);
 
     if (report)
     {
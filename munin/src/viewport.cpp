@@ -301,16 +301,16 @@ struct viewport::impl
     // ======================================================================
     // DO_EVENT
     // ======================================================================
-    bool do_event(boost::any const &event)
+    bool do_event(event_type const &event)
     {
-        auto vk = boost::any_cast<terminalpp::virtual_key>(&event);
+        auto vk = boost::get<terminalpp::virtual_key>(&event);
         
         if (vk)
         {
             return do_vk_event(*vk);
         }
         
-        auto report = boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        auto report = boost::get<terminalpp::ansi::mouse::report>(&event);
         
         if (report)
         {
@@ -607,10 +607,10 @@ void viewport::do_draw(
 // ==========================================================================
 // DO_EVENT
 // ==========================================================================
-void viewport::do_event(boost::any const &event)
+void viewport::do_event(event_type const &event)
 {
     auto report =
-        boost::any_cast<terminalpp::ansi::mouse::report>(&event);
+        boost::get<terminalpp::ansi::mouse::report>(&event);
         
     if (report != nullptr)
     {
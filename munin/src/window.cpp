@@ -29,23 +29,50 @@
 #include "munin/container.hpp"
 #include "munin/basic_container.hpp"
 #include "munin/context.hpp"
+#include "munin/layout.hpp"
+#include "odin/flight_recorder.hpp"
+#include "odin/metrics.hpp"
 #include <terminalpp/ansi_terminal.hpp>
 #include <terminalpp/canvas_view.hpp>
 #include <terminalpp/screen.hpp>
 #include <boost/format.hpp>
+#include <chrono>
+#include <vector>
 
 namespace munin {
     
 namespace {
 
+// ==========================================================================
+// GET_REPAINT_TIME
+// ==========================================================================
+odin::metrics::histogram &get_repaint_time()
+{
+    static auto &repaint_time = odin::metrics::get_registry().get_histogram(
+        "munin_repaint_seconds", 
+        "Time taken to draw a window and encode its changes.",
+        1e-9);
+    return repaint_time;
+}
+
+// ==========================================================================
+// GET_REPAINT_SIZE
+// ==========================================================================
+odin::metrics::histogram &get_repaint_size()
+{
+    static auto &repaint_size = odin::metrics::get_registry().get_histogram(
+        "munin_repaint_bytes", "Size of each repaint sent to a terminal.");
+    return repaint_size;
+}
+
 // ==========================================================================
 // UNPACKAGE_VISITOR
 // ==========================================================================
-struct unpackage_visitor : boost::static_visitor<boost::any>
+struct unpackage_visitor : boost::static_visitor<event_type>
 {
-    // Simply package up any input into a Boost.Any and return it.
+    // Every kind of token is also a kind of event, so simply rewrap it.
     template <class Packaged>
-    boost::any operator()(Packaged &&pack)
+    event_type operator()(Packaged const &pack) const
     {
         return pack;
     }
@@ -196,14 +223,78 @@ public :
         static unpackage_visitor visitor;
 
         auto tokens = terminal_.read(data);
-        
+
+        // Contiguous printable keys, such as those from a paste, are
+        // gathered up and sent as a single run of text if the focussed
+        // component can accept it.
+        std::vector<terminalpp::virtual_key> pending_text;
+
         for (auto const &token : tokens)
         {
-            content_->event(boost::apply_visitor(visitor, token));
+            auto const *vk = boost::get<terminalpp::virtual_key>(&token);
+
+            if (vk != nullptr && is_text(*vk)
+             && (!pending_text.empty() || focus_accepts_text_runs()))
+            {
+                pending_text.push_back(*vk);
+            }
+            else
+            {
+                send_text(pending_text);
+                content_->event(boost::apply_visitor(visitor, token));
+            }
         }
+
+        send_text(pending_text);
     }
 
 private :
+    // ======================================================================
+    // IS_TEXT
+    // ======================================================================
+    static bool is_text(terminalpp::virtual_key const &vk)
+    {
+        return vk.modifiers == terminalpp::vk_modifier::none
+            && odin::u32(vk.key) < 0x80
+            && is_printable(terminalpp::glyph(char(vk.key)));
+    }
+
+    // ======================================================================
+    // FOCUS_ACCEPTS_TEXT_RUNS
+    // ======================================================================
+    bool focus_accepts_text_runs()
+    {
+        auto const focussed_component = content_->get_focussed_component();
+        return focussed_component && focussed_component->accepts_text_runs();
+    }
+
+    // ======================================================================
+    // SEND_TEXT
+    // ======================================================================
+    void send_text(std::vector<terminalpp::virtual_key> &pending_text)
+    {
+        if (pending_text.size() == 1)
+        {
+            // A single key is sent as it is.
+            content_->event(pending_text.front());
+        }
+        else if (!pending_text.empty())
+        {
+            std::vector<terminalpp::element> elements;
+            elements.reserve(pending_text.size());
+
+            for (auto const &vk : pending_text)
+            {
+                elements.push_back(terminalpp::glyph(char(vk.key)));
+            }
+
+            content_->event(
+                text_run{terminalpp::string(elements.begin(), elements.end())});
+        }
+
+        pending_text.clear();
+    }
+
     // ======================================================================
     // SCHEDULE_REPAINT
     // ======================================================================
@@ -214,7 +305,9 @@ private :
         // any further repaint requests.
         if (!repaint_scheduled_)
         {
-            strand_.post([sp=shared_from_this()]{sp->do_repaint();});
+            strand_.post(odin::flight_recorder::trace(
+                "window.repaint"
+              , [sp=shared_from_this()]{sp->do_repaint();}));
             repaint_scheduled_ = true;
         }
     }
@@ -228,7 +321,9 @@ private :
         // if there's one already scheduled.
         if (!layout_scheduled_)
         {
-            strand_.post([sp=shared_from_this()]{sp->do_layout();});
+            strand_.post(odin::flight_recorder::trace(
+                "window.layout"
+              , [sp=shared_from_this()]{sp->do_layout();}));
             layout_scheduled_ = true;
         }
     }
@@ -253,8 +348,10 @@ private :
     // ======================================================================
     void preferred_size_change_handler()
     {
-        // Force the content to re-lay itself out.
-        content_->set_size(content_->get_size());
+        // The containers between here and the component whose preferred
+        // size changed have already marked themselves as requiring a
+        // layout, so it is only necessary to schedule one.
+        schedule_layout();
     }
 
     // ======================================================================
@@ -283,6 +380,7 @@ private :
     // ======================================================================
     void do_repaint()
     {
+        auto const start_time = std::chrono::steady_clock::now();
         auto size = content_->get_size();
         
         // If the canvas has changed size, then many things can happen.
@@ -333,6 +431,9 @@ private :
             repaint_data += terminal_.hide_cursor();
         }
         
+        get_repaint_time().record(std::chrono::steady_clock::now() - start_time);
+        get_repaint_size().record(repaint_data.size());
+
         if (self_valid_)
         {
             self_.on_repaint(repaint_data);
@@ -349,7 +450,11 @@ private :
     // ======================================================================
     void do_layout()
     {
-        content_->layout();
+        {
+            layout_pass pass;
+            content_->layout();
+        }
+
         layout_scheduled_ = false;
 
         redraw_handler({
@@ -377,7 +482,7 @@ private :
     bool                          handling_newline_;
     char                          newline_char_;
 
-    std::vector<boost::signals::connection> connections_;
+    std::vector<odin::connection> connections_;
 };
 
 // ==========================================================================
@@ -0,0 +1,169 @@
+// ==========================================================================
+// Odin Flight Recorder
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef ODIN_FLIGHT_RECORDER_HPP_
+#define ODIN_FLIGHT_RECORDER_HPP_
+
+#include "odin/core.hpp"
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+//* =========================================================================
+/// \brief A recorder of the handlers that run on the process's threads,
+/// for finding out which of them held up a strand.
+/// \par
+/// Each thread keeps the most recent handlers it ran in a fixed-size ring
+/// of its own, so recording takes no locks.  The rings can be written out
+/// on demand, or automatically when a handler runs for longer than a
+/// threshold, in the JSON format read by Chrome's trace viewer
+/// (chrome://tracing) and Perfetto.
+/// \par
+/// The recorder is disabled until it is configured, and a disabled
+/// recorder costs a single load per handler.
+//* =========================================================================
+namespace odin { namespace flight_recorder {
+
+typedef std::chrono::steady_clock clock;
+
+//* =========================================================================
+/// \brief Settings for the flight recorder.
+//* =========================================================================
+struct settings
+{
+    /// \brief Whether handlers are recorded at all.
+    bool enabled = false;
+
+    /// \brief A handler that runs for at least this long causes the rings
+    /// to be written out.  Zero disables automatic dumps.
+    clock::duration slow_threshold = clock::duration::zero();
+
+    /// \brief The minimum time between two automatic dumps, so that a
+    /// burst of slow handlers produces only the first dump.
+    clock::duration dump_interval = std::chrono::seconds(10);
+
+    /// \brief The prefix of the files to which dumps are written.  A
+    /// sequence number and ".json" are appended to it.
+    std::string dump_prefix = "flight";
+};
+
+//* =========================================================================
+/// \brief Applies the passed settings.  Handlers that were traced before
+/// the recorder was enabled are not recorded.
+//* =========================================================================
+ODIN_EXPORT void configure(settings const &config);
+
+//* =========================================================================
+/// \brief Returns true if handlers are being recorded.
+//* =========================================================================
+ODIN_EXPORT bool is_enabled();
+
+//* =========================================================================
+/// \brief Records that a handler of the given type, queued at the first
+/// time, ran between the second and third times on this thread.  The tag
+/// must be a string literal, or otherwise outlive the recorder.
+//* =========================================================================
+ODIN_EXPORT void record(
+    char const        *tag
+  , clock::time_point  enqueued
+  , clock::time_point  started
+  , clock::time_point  finished);
+
+//* =========================================================================
+/// \brief Writes the contents of every thread's ring as a Chrome trace.
+//* =========================================================================
+ODIN_EXPORT void write_trace(std::ostream &out);
+
+//* =========================================================================
+/// \brief Writes the contents of every thread's ring as a Chrome trace to
+/// the next file named by the dump prefix, and returns its name.
+//* =========================================================================
+ODIN_EXPORT std::string dump();
+
+//* =========================================================================
+/// \brief A handler that records when it ran.  Created with trace().
+//* =========================================================================
+template <class Handler>
+class traced_handler
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    traced_handler(char const *tag, Handler handler)
+        : tag_(tag),
+          handler_(std::move(handler))
+    {
+        if (is_enabled())
+        {
+            enqueued_ = clock::now();
+        }
+    }
+
+    //* =====================================================================
+    /// \brief Calls the handler, recording it if it was traced.
+    //* =====================================================================
+    template <class... Args>
+    void operator()(Args &&...args)
+    {
+        if (enqueued_ == clock::time_point())
+        {
+            handler_(std::forward<Args>(args)...);
+        }
+        else
+        {
+            auto const started = clock::now();
+            handler_(std::forward<Args>(args)...);
+            record(tag_, enqueued_, started, clock::now());
+        }
+    }
+
+private :
+    char const        *tag_;
+    Handler            handler_;
+    clock::time_point  enqueued_;
+};
+
+//* =========================================================================
+/// \brief Wraps a handler that is about to be posted so that the time it
+/// waited and the time it took are recorded under the passed tag.
+/// For example:
+/// \code
+///     strand.post(odin::flight_recorder::trace("window.repaint", fn));
+/// \endcode
+//* =========================================================================
+template <class Handler>
+traced_handler<typename std::decay<Handler>::type> trace(
+    char const *tag, Handler &&handler)
+{
+    return { tag, std::forward<Handler>(handler) };
+}
+
+}}
+
+#endif
@@ -0,0 +1,254 @@
+// ==========================================================================
+// Odin Metrics
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef ODIN_METRICS_HPP_
+#define ODIN_METRICS_HPP_
+
+#include "odin/core.hpp"
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace odin { namespace metrics {
+
+//* =========================================================================
+/// \brief A count that only ever increases.
+/// \par
+/// The count is split into cells, and each thread adds to its own cell, so
+/// that threads that add at the same time do not contend with each other.
+/// Adding never blocks.
+//* =========================================================================
+class ODIN_EXPORT counter
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    counter();
+
+    //* =====================================================================
+    /// \brief Adds to the count.
+    //* =====================================================================
+    void add(odin::u64 amount = 1);
+
+    //* =====================================================================
+    /// \brief Returns the count.
+    //* =====================================================================
+    odin::u64 get_value() const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief A value that may increase and decrease, such as the depth of a
+/// queue.  As with a counter, each thread adjusts its own cell.
+//* =========================================================================
+class ODIN_EXPORT gauge
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    gauge();
+
+    //* =====================================================================
+    /// \brief Adjusts the value by the passed amount.
+    //* =====================================================================
+    void add(odin::s64 amount);
+
+    //* =====================================================================
+    /// \brief Returns the value.
+    //* =====================================================================
+    odin::s64 get_value() const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief A distribution of recorded values, such as latencies.
+/// \par
+/// Values are counted in buckets whose width grows with the size of the
+/// value, in the manner of an HDR histogram.  Values below 16 are counted
+/// exactly, and larger values to within an eighth of their size.  As with
+/// a counter, each thread records into its own buckets.
+//* =========================================================================
+class ODIN_EXPORT histogram
+{
+public :
+    //* =====================================================================
+    /// \brief The state of a histogram at a moment in time.
+    //* =====================================================================
+    struct snapshot
+    {
+        odin::u64              count = 0;
+        odin::u64              sum   = 0;
+        odin::u64              max   = 0;
+        std::vector<odin::u64> buckets;
+
+        //* =================================================================
+        /// \brief Returns the value below which the passed fraction of the
+        /// recorded values fall, or 0 if nothing has been recorded.
+        //* =================================================================
+        odin::u64 get_quantile(double fraction) const;
+    };
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    histogram();
+
+    //* =====================================================================
+    /// \brief Records a value.
+    //* =====================================================================
+    void record(odin::u64 value);
+
+    //* =====================================================================
+    /// \brief Records a duration in nanoseconds.
+    //* =====================================================================
+    void record(std::chrono::steady_clock::duration duration);
+
+    //* =====================================================================
+    /// \brief Returns the current state of the histogram.
+    //* =====================================================================
+    snapshot get_snapshot() const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief Records the time between its construction and destruction into
+/// a histogram.
+//* =========================================================================
+class ODIN_EXPORT scoped_timer
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    explicit scoped_timer(histogram &hist);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~scoped_timer();
+
+    scoped_timer(scoped_timer const &) = delete;
+    scoped_timer &operator=(scoped_timer const &) = delete;
+
+private :
+    histogram                             &histogram_;
+    std::chrono::steady_clock::time_point  start_;
+};
+
+//* =========================================================================
+/// \brief A set of named metrics, which can be written out either for
+/// people to read or in the text format that Prometheus scrapes.
+/// \par
+/// Metrics are created on first use and live as long as the registry, so
+/// references to them may be kept.  Asking again for a metric of the same
+/// name returns the same metric.
+//* =========================================================================
+class ODIN_EXPORT registry
+{
+public :
+    //* =====================================================================
+    /// \brief A handle to a function registered with add_function.  The
+    /// function is removed when the last copy of its handle is destroyed.
+    //* =====================================================================
+    typedef std::shared_ptr<void> function_handle;
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    registry();
+
+    //* =====================================================================
+    /// \brief Returns the counter of the given name, creating it if
+    /// necessary.
+    //* =====================================================================
+    counter &get_counter(std::string const &name, std::string const &help);
+
+    //* =====================================================================
+    /// \brief Returns the gauge of the given name, creating it if
+    /// necessary.
+    //* =====================================================================
+    gauge &get_gauge(std::string const &name, std::string const &help);
+
+    //* =====================================================================
+    /// \brief Returns the histogram of the given name, creating it if
+    /// necessary.  Values are multiplied by the passed scale when they are
+    /// written out; for example, a histogram of nanoseconds with a scale
+    /// of 1e-9 is written out in seconds.
+    //* =====================================================================
+    histogram &get_histogram(
+        std::string const &name
+      , std::string const &help
+      , double             scale = 1.0);
+
+    //* =====================================================================
+    /// \brief Registers a function whose result is written out as a gauge
+    /// of the given name.  This is for values that are kept elsewhere,
+    /// such as the number of connections waiting to be negotiated.
+    //* =====================================================================
+    function_handle add_function(
+        std::string const             &name
+      , std::string const             &help
+      , std::function<double ()> const &fn);
+
+    //* =====================================================================
+    /// \brief Writes out each metric in the Prometheus text format.
+    /// Histograms are written as summaries.
+    //* =====================================================================
+    void write_exposition(std::ostream &out) const;
+
+    //* =====================================================================
+    /// \brief Writes out each metric on a line of its own, in a form
+    /// suitable for people to read.
+    //* =====================================================================
+    void write_summary(std::ostream &out) const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief Returns the registry into which the server records its metrics.
+//* =========================================================================
+ODIN_EXPORT registry &get_registry();
+
+}}
+
+#endif
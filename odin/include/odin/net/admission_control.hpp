@@ -0,0 +1,128 @@
+// ==========================================================================
+// Odin Net Admission Control
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef ODIN_NET_ADMISSION_CONTROL_HPP_
+#define ODIN_NET_ADMISSION_CONTROL_HPP_
+
+#include "odin/core.hpp"
+#include <boost/asio/ip/address.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace odin { namespace net {
+
+//* =========================================================================
+/// \brief Decides whether a newly accepted connection may proceed.
+/// \par
+/// A connection is refused if its source address matches the deny list,
+/// or if there is an allow list and the address does not match it.  It is
+/// also refused if its address has opened connections faster than the
+/// permitted rate, which is measured with a token bucket per address, or
+/// if the maximum number of concurrent connections has been reached.
+/// \par
+/// Each admitted connection is given a ticket, which must be kept for as
+/// long as the connection lives.  The connection is counted against the
+/// maximum until the last copy of its ticket is destroyed.
+/// \par
+/// All functions may be called concurrently from several threads.
+//* =========================================================================
+class ODIN_EXPORT admission_control
+{
+public :
+    typedef std::shared_ptr<void> ticket;
+
+    //* =====================================================================
+    /// \brief The settings with which to control admission.
+    //* =====================================================================
+    struct settings
+    {
+        /// \brief The sustained rate at which a single address may open
+        /// connections.  A value of 0 places no limit on the rate.
+        double connections_per_second = 0;
+
+        /// \brief The number of connections a single address may open in
+        /// quick succession before the rate applies.
+        odin::u32 connection_burst = 1;
+
+        /// \brief The maximum number of concurrent connections.  A value of
+        /// 0 places no limit on the number of connections.
+        odin::u32 maximum_connections = 0;
+
+        /// \brief Networks, written as "address/prefix" or as a single
+        /// address, from which connections are admitted.  If empty,
+        /// connections are admitted from any network that is not denied.
+        std::vector<std::string> allow;
+
+        /// \brief Networks, written as above, from which connections are
+        /// never admitted.
+        std::vector<std::string> deny;
+    };
+
+    //* =====================================================================
+    /// \brief Counts of the decisions that have been made.
+    //* =====================================================================
+    struct statistics
+    {
+        odin::u32 active           = 0;
+        odin::u32 admitted         = 0;
+        odin::u32 refused_access   = 0;
+        odin::u32 refused_rate     = 0;
+        odin::u32 refused_capacity = 0;
+    };
+
+    //* =====================================================================
+    /// \brief Constructor
+    /// \throws std::invalid_argument if a network in the allow or deny
+    ///         list cannot be parsed.
+    //* =====================================================================
+    explicit admission_control(settings const &config);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~admission_control();
+
+    //* =====================================================================
+    /// \brief Decides whether a connection from the given address may
+    /// proceed.  Returns a ticket for the connection if it may, or an empty
+    /// ticket if it may not.
+    //* =====================================================================
+    ticket admit(boost::asio::ip::address const &address);
+
+    //* =====================================================================
+    /// \brief Returns counts of the decisions that have been made.
+    //* =====================================================================
+    statistics get_statistics() const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}}
+
+#endif
@@ -0,0 +1,135 @@
+// ==========================================================================
+// Odin Net Handover Channel
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef ODIN_NET_HANDOVER_CHANNEL_HPP_
+#define ODIN_NET_HANDOVER_CHANNEL_HPP_
+
+#include "odin/core.hpp"
+#include <boost/optional.hpp>
+#include <boost/system/error_code.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace boost { namespace asio {
+    class io_service;
+}}
+
+namespace odin { namespace net {
+
+//* =========================================================================
+/// \brief A channel over which a process may pass open sockets, together
+/// with a description of each, to another process.
+/// \par
+/// The channel is one end of a Unix domain socket.  Each message consists
+/// of a payload and a number of native handles, which arrive in the
+/// receiving process as new handles to the same open sockets.  This is only
+/// available on POSIX platforms; elsewhere, all operations throw.
+/// \par
+/// Operations on the channel block, and errors are reported by throwing
+/// boost::system::system_error, except for async_receive, which waits
+/// within an io_service and reports errors to its callback.
+//* =========================================================================
+class ODIN_EXPORT handover_channel
+{
+public :
+    typedef int native_handle_type;
+
+    //* =====================================================================
+    /// \brief A single message passed along the channel.
+    //* =====================================================================
+    struct message
+    {
+        std::string                     payload;
+        std::vector<native_handle_type> handles;
+    };
+
+    /// \brief The greatest number of handles that may be passed in a single
+    /// message.
+    BOOST_STATIC_CONSTANT(odin::u32, MAXIMUM_HANDLES = 64);
+
+    //* =====================================================================
+    /// \brief Creates a connected pair of channels.
+    //* =====================================================================
+    static std::pair<handover_channel, handover_channel> create_pair();
+
+    //* =====================================================================
+    /// \brief Constructor.  The channel takes ownership of the handle, and
+    /// closes it when the last copy of the channel is destroyed.
+    //* =====================================================================
+    explicit handover_channel(native_handle_type handle);
+
+    //* =====================================================================
+    /// \brief Returns the native handle of the channel.
+    //* =====================================================================
+    native_handle_type get_native_handle() const;
+
+    //* =====================================================================
+    /// \brief Allows the channel's handle to be inherited by a process
+    /// that is executed after this call.
+    //* =====================================================================
+    void set_inheritable();
+
+    //* =====================================================================
+    /// \brief Sends a message along the channel.
+    //* =====================================================================
+    void send(message const &msg);
+
+    //* =====================================================================
+    /// \brief Receives a message from the channel, or returns no message
+    /// if the other end of the channel has been closed.  The caller takes
+    /// ownership of any handles in the message.
+    //* =====================================================================
+    boost::optional<message> receive();
+
+    //* =====================================================================
+    /// \brief Waits within the passed io_service for a message to arrive,
+    /// then receives it and calls the callback with it.  The callback is
+    /// passed no message if the other end of the channel has been closed
+    /// or an error occurred, in which case the error is also passed.
+    //* =====================================================================
+    void async_receive(
+        boost::asio::io_service &io_service
+      , std::function<
+            void (boost::system::error_code const &,
+                  boost::optional<message> const &)
+        > const &callback);
+
+    //* =====================================================================
+    /// \brief Closes the channel.
+    //* =====================================================================
+    void close();
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}}
+
+#endif
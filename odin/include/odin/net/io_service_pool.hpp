@@ -0,0 +1,155 @@
+// ==========================================================================
+// Odin Net IO Service Pool
+//
+// Copyright (C) 2009 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef ODIN_NET_IO_SERVICE_POOL_HPP_
+#define ODIN_NET_IO_SERVICE_POOL_HPP_
+
+#include "odin/core.hpp"
+#include <boost/asio/io_service.hpp>
+#include <functional>
+#include <memory>
+
+namespace odin { namespace net {
+
+//* =========================================================================
+/// \brief A set of io_services, each run by its own threads.
+/// \par
+/// A pool with a single io_service run by many threads is the classic
+/// model, where any thread may run any handler.  A pool with one
+/// io_service per thread instead gives each thread its own reactor and
+/// handler queue, so that everything belonging to a connection stays on
+/// one thread.  In that model, anything that must touch another
+/// io_service does so by posting a message to it with post() or
+/// post_to_all().
+/// \par
+/// New work is assigned to io_services by assign(), which picks either
+/// the next io_service in turn or the one with the least outstanding work,
+/// depending on the assignment policy.  Each call to assign() must be
+/// matched by a call to release() once the work has completed.
+//* =========================================================================
+class ODIN_EXPORT io_service_pool
+{
+public :
+    enum class assignment_policy
+    {
+        round_robin,
+        least_loaded
+    };
+
+    //* =====================================================================
+    /// \brief Constructor
+    /// \param io_services the number of io_services in the pool.
+    /// \param threads_per_io_service the number of threads that will run
+    ///        each io_service.
+    /// \param policy the policy by which assign() chooses an io_service.
+    /// \param pin_threads if true, each thread is pinned to a processor
+    ///        core, where the platform allows it.
+    //* =====================================================================
+    io_service_pool(
+        odin::u32         io_services
+      , odin::u32         threads_per_io_service
+      , assignment_policy policy = assignment_policy::round_robin
+      , bool              pin_threads = false);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~io_service_pool();
+
+    //* =====================================================================
+    /// \brief Returns the number of io_services in the pool.
+    //* =====================================================================
+    odin::u32 get_size() const;
+
+    //* =====================================================================
+    /// \brief Returns the io_service with the given index.  The io_service
+    /// with index 0 is the home io_service, on which work that is not
+    /// specific to any connection is run.
+    //* =====================================================================
+    boost::asio::io_service &get_io_service(odin::u32 index = 0);
+
+    //* =====================================================================
+    /// \brief Returns the index of the given io_service within the pool.
+    /// The io_service must belong to the pool.
+    //* =====================================================================
+    odin::u32 get_index(boost::asio::io_service const &io_service) const;
+
+    //* =====================================================================
+    /// \brief Chooses an io_service for a new unit of work according to the
+    /// pool's policy, and returns its index.
+    //* =====================================================================
+    odin::u32 assign();
+
+    //* =====================================================================
+    /// \brief Records that a new unit of work has been assigned to the
+    /// io_service with the given index by some other means.
+    //* =====================================================================
+    void assign(odin::u32 index);
+
+    //* =====================================================================
+    /// \brief Records that a unit of work assigned to the io_service with
+    /// the given index has completed.
+    //* =====================================================================
+    void release(odin::u32 index);
+
+    //* =====================================================================
+    /// \brief Returns the amount of outstanding work assigned to the
+    /// io_service with the given index.
+    //* =====================================================================
+    odin::u32 get_load(odin::u32 index) const;
+
+    //* =====================================================================
+    /// \brief Posts a function to be run on the io_service with the given
+    /// index.
+    //* =====================================================================
+    void post(odin::u32 index, std::function<void ()> const &fn);
+
+    //* =====================================================================
+    /// \brief Posts a function to be run once on every io_service in the
+    /// pool.
+    //* =====================================================================
+    void post_to_all(std::function<void ()> const &fn);
+
+    //* =====================================================================
+    /// \brief Runs the io_services on their threads, and blocks until they
+    /// have all run out of work.
+    //* =====================================================================
+    void run();
+
+    //* =====================================================================
+    /// \brief Releases the work that keeps the io_services running, so
+    /// that run() returns once all outstanding handlers have completed.
+    //* =====================================================================
+    void release_work();
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}}
+
+#endif
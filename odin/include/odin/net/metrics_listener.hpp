@@ -0,0 +1,77 @@
+// ==========================================================================
+// Odin Net Metrics Listener
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef ODIN_NET_METRICS_LISTENER_HPP_
+#define ODIN_NET_METRICS_LISTENER_HPP_
+
+#include "odin/core.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace boost { namespace asio {
+    class io_service;
+}}
+
+namespace odin { namespace net {
+
+//* =========================================================================
+/// \brief Serves a page of metrics over HTTP on a local port, for a
+/// scraper such as Prometheus to poll.
+/// \par
+/// The listener only accepts connections from the loopback interface.  It
+/// answers every request, whatever its path, with the text returned by
+/// the passed function, and then closes the connection.
+/// \par
+/// If the port is in use, for example by a process that is handing over
+/// to this one, the listener tries again once a second until it is free.
+//* =========================================================================
+class ODIN_EXPORT metrics_listener
+{
+public :
+    typedef std::function<std::string ()> page_function;
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    metrics_listener(
+        boost::asio::io_service &io_service
+      , odin::u16                port
+      , page_function const     &page);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~metrics_listener();
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}}
+
+#endif
@@ -31,12 +31,14 @@
 #include <boost/cstdint.hpp>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace boost { namespace asio {
     class io_service;
 }}
 
 namespace odin { namespace net {
+    class admission_control;
     class socket;
 
 //* =========================================================================
@@ -46,6 +48,21 @@ namespace odin { namespace net {
 /// to call whenever a new connection is made.  The handler for these
 /// connections will be called in the io_service's run() method.  To stop the
 /// server and cancel any pending acceptance, call shutdown().
+/// \par
+/// Options may be passed to spread the accepted sockets across several
+/// io_services, either by selecting an io_service for each socket accepted
+/// by a single listener, or by opening one listener per io_service with
+/// SO_REUSEPORT so that the kernel spreads the connections between them.
+/// In the latter case, the accept handler may be called concurrently from
+/// each of the io_services.
+/// \par
+/// If accepting fails, for example because the process has run out of file
+/// descriptors, the listener waits for a short time before trying again.
+/// The wait doubles with each consecutive failure, up to a limit.
+/// \par
+/// If an admission_control is given in the options, each accepted socket
+/// is first put to it, and those that are refused are closed at once,
+/// without the accept handler being called.
 //* =========================================================================
 class ODIN_EXPORT server
 {
@@ -54,6 +71,41 @@ public :
         void (std::shared_ptr<odin::net::socket> const &)
     > accept_handler;
 
+    typedef std::function<
+        boost::asio::io_service &()
+    > io_service_selector;
+
+    //* =====================================================================
+    /// \brief Options for the construction of a server.
+    //* =====================================================================
+    struct options
+    {
+        /// \brief The length of the queue of connections that the kernel
+        /// has completed but that have yet to be accepted.  A value of 0
+        /// uses the system default.
+        odin::s32 backlog = 0;
+
+        /// \brief If not empty, a listener is opened on each of these
+        /// io_services with SO_REUSEPORT, and each socket runs on the
+        /// io_service of the listener that accepted it.  Where SO_REUSEPORT
+        /// is not supported, only the first io_service is used.
+        std::vector<boost::asio::io_service *> reuse_port_io_services;
+
+        /// \brief If set, and there are no reuse_port_io_services, selects
+        /// the io_service on which each accepted socket runs.
+        io_service_selector select_io_service;
+
+        /// \brief If set, decides which accepted sockets are passed on to
+        /// the accept handler.
+        std::shared_ptr<admission_control> admission;
+
+        /// \brief If not empty, the server listens on these already open
+        /// listening sockets, for example those handed over by another
+        /// process, rather than opening its own.  They are shared between
+        /// the io_services in turn as above.
+        std::vector<int> inherited_handles;
+    };
+
     //* =====================================================================
     /// \brief Constructor
     //* =====================================================================
@@ -61,6 +113,14 @@ public :
          , odin::u16                port
          , accept_handler const    &on_accept);
 
+    //* =====================================================================
+    /// \brief Constructor, with options.
+    //* =====================================================================
+    server(boost::asio::io_service &io_service
+         , odin::u16                port
+         , accept_handler const    &on_accept
+         , options const           &opts);
+
     //* =====================================================================
     /// \brief Destructor
     //* =====================================================================
@@ -72,6 +132,12 @@ public :
     //* =====================================================================
     void shutdown();
 
+    //* =====================================================================
+    /// \brief Returns the native handles of the listening sockets, so that
+    /// they may be handed over to another process.
+    //* =====================================================================
+    std::vector<int> get_native_handles() const;
+
 private :
     struct impl;
     std::shared_ptr<impl> pimpl_;
@@ -30,6 +30,7 @@
 #include "odin/core.hpp"
 #include "odin/io/datastream.hpp"
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/strand.hpp>
 #include <functional>
 #include <memory>
 
@@ -39,6 +40,26 @@ class ODIN_EXPORT socket
     : public odin::io::datastream<odin::u8, odin::u8>
 {
 public :
+    //* =====================================================================
+    /// \brief How urgently a write should be transmitted, which determines
+    /// the TCP options that are applied to the socket around it.
+    //* =====================================================================
+    enum class write_class
+    {
+        /// \brief Sent at once, with Nagle's algorithm disabled.  Anything
+        /// held back by an earlier write is sent ahead of it.
+        interactive,
+
+        /// \brief Held back until flush() is called, or an interactive
+        /// write is made, so that a repaint written in several pieces goes
+        /// out in full segments.
+        repaint,
+
+        /// \brief Sent with Nagle's algorithm enabled, so that a series of
+        /// small writes, such as a negotiation, may be coalesced.
+        bulk
+    };
+
     //* =====================================================================
     /// \brief Constructor
     //* =====================================================================
@@ -88,6 +109,19 @@ public :
         input_size_type            size
       , input_callback_type const &callback);
 
+    //* =====================================================================
+    /// \brief Cancels any outstanding reads, leaving the socket open so
+    /// that it may be handed over.
+    ///
+    /// This must be called from within the socket's strand.  A read that
+    /// completed before it could be cancelled is reported as usual, as is
+    /// anything read by a read that was cancelled part way through.  The
+    /// remaining reads are dropped, and the callback is then called from
+    /// within the strand.  Cancelling affects everything outstanding on the
+    /// socket, so there must be no asynchronous writes outstanding.
+    //* =====================================================================
+    void async_cancel_reads(std::function<void ()> const &callback);
+
     //* =====================================================================
     /// \brief Perform a synchronous write to the stream.
     /// \return the number of objects written to the stream.
@@ -95,6 +129,20 @@ public :
     //* =====================================================================
     virtual output_size_type write(output_storage_type const& values);
 
+    //* =====================================================================
+    /// \brief Perform a synchronous write to the stream, transmitting it
+    /// according to the passed class.
+    /// \return the number of objects written to the stream.
+    //* =====================================================================
+    output_size_type write(
+        output_storage_type const &values
+      , write_class                cls);
+
+    //* =====================================================================
+    /// \brief Transmits anything held back by repaint writes.
+    //* =====================================================================
+    void flush();
+
     //* =====================================================================
     /// \brief Schedules an asynchronous write to the stream.
     ///
@@ -120,8 +168,24 @@ public :
     //* =====================================================================
     boost::asio::io_service &get_io_service();
 
+    //* =====================================================================
+    /// \brief Retrieve the strand in which the socket's completions run.
+    ///
+    /// Reads, writes and deaths are all reported from within this strand.
+    /// A user that calls on the socket from more than one thread must do
+    /// so from within it, so that those calls do not race the completions.
+    //* =====================================================================
+    boost::asio::strand &get_strand();
+
+    //* =====================================================================
+    /// \brief Returns the native handle of the socket, so that it may be
+    /// handed over to another process.
+    //* =====================================================================
+    boost::asio::ip::tcp::socket::native_handle_type get_native_handle();
+
     //* =====================================================================
     /// \brief Register a callback to be performed when the socket is closed.
+    /// The callback is released once it has been called.
     //* =====================================================================
     void on_death(std::function<void ()> const &callback);
 
@@ -0,0 +1,450 @@
+// ==========================================================================
+// Odin Signal
+//
+// Copyright (C) 2009 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef ODIN_SIGNAL_HPP_
+#define ODIN_SIGNAL_HPP_
+
+#include "odin/core.hpp"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace odin {
+
+namespace detail {
+
+//* =========================================================================
+/// \brief The part of a signal's state that its connections refer to.
+/// Connections hold this weakly, so that they may be safely disconnected
+/// after the signal itself has been destroyed.
+//* =========================================================================
+class signal_state_base
+{
+public :
+    virtual ~signal_state_base() = default;
+
+    //* =====================================================================
+    /// \brief Disconnects the slot with the given id, if it is connected.
+    //* =====================================================================
+    virtual void disconnect(odin::u64 id) = 0;
+
+    //* =====================================================================
+    /// \brief Returns true if the slot with the given id is connected.
+    //* =====================================================================
+    virtual bool is_connected(odin::u64 id) const = 0;
+};
+
+}
+
+//* =========================================================================
+/// \brief A handle to a slot that has been connected to a signal.
+//* =========================================================================
+class connection
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    connection() = default;
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    connection(
+        std::weak_ptr<detail::signal_state_base> state
+      , odin::u64                                id)
+        : state_(std::move(state)),
+          id_(id)
+    {
+    }
+
+    //* =====================================================================
+    /// \brief Disconnects the slot from its signal.  It is safe to call
+    /// this more than once, or after the signal has been destroyed.
+    //* =====================================================================
+    void disconnect()
+    {
+        auto state = state_.lock();
+
+        if (state)
+        {
+            state->disconnect(id_);
+        }
+
+        state_.reset();
+    }
+
+    //* =====================================================================
+    /// \brief Returns true if the slot is still connected to its signal.
+    //* =====================================================================
+    bool connected() const
+    {
+        auto state = state_.lock();
+        return state && state->is_connected(id_);
+    }
+
+private :
+    std::weak_ptr<detail::signal_state_base> state_;
+    odin::u64                                id_ = 0;
+};
+
+//* =========================================================================
+/// \brief A connection that disconnects its slot when it goes out of
+/// scope.
+//* =========================================================================
+class scoped_connection
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    scoped_connection() = default;
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    scoped_connection(connection cnx)
+        : connection_(std::move(cnx))
+    {
+    }
+
+    //* =====================================================================
+    /// \brief Move Constructor
+    //* =====================================================================
+    scoped_connection(scoped_connection &&other)
+        : connection_(other.release())
+    {
+    }
+
+    //* =====================================================================
+    /// \brief Move Assignment
+    //* =====================================================================
+    scoped_connection &operator=(scoped_connection &&other)
+    {
+        if (this != &other)
+        {
+            disconnect();
+            connection_ = other.release();
+        }
+
+        return *this;
+    }
+
+    scoped_connection(scoped_connection const &) = delete;
+    scoped_connection &operator=(scoped_connection const &) = delete;
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~scoped_connection()
+    {
+        disconnect();
+    }
+
+    //* =====================================================================
+    /// \brief Disconnects the slot from its signal.
+    //* =====================================================================
+    void disconnect()
+    {
+        connection_.disconnect();
+    }
+
+    //* =====================================================================
+    /// \brief Returns true if the slot is still connected to its signal.
+    //* =====================================================================
+    bool connected() const
+    {
+        return connection_.connected();
+    }
+
+    //* =====================================================================
+    /// \brief Relinquishes ownership of the connection without
+    /// disconnecting it.
+    //* =====================================================================
+    connection release()
+    {
+        auto cnx = std::move(connection_);
+        connection_ = connection();
+        return cnx;
+    }
+
+private :
+    connection connection_;
+};
+
+template <class Signature>
+class signal;
+
+//* =========================================================================
+/// \brief A lightweight signal for notifying any number of connected slots.
+///
+/// Unlike boost::signal, this performs no locking and uses no combiners,
+/// and emission does not allocate.  It is therefore only suitable for
+/// objects that are confined to a single thread or strand, which is the
+/// case for all of the user interface components.
+///
+/// Slots may safely connect and disconnect slots (including themselves),
+/// or emit the signal again, during an emission.  Slots connected during
+/// an emission are not called until the next emission.
+//* =========================================================================
+template <class... Args>
+class signal<void (Args...)>
+{
+public :
+    typedef std::function<void (Args...)> slot_type;
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    signal() = default;
+
+    signal(signal const &) = delete;
+    signal &operator=(signal const &) = delete;
+
+    //* =====================================================================
+    /// \brief Connects a slot to the signal.  The slot will be called each
+    /// time the signal is emitted until it is disconnected.
+    //* =====================================================================
+    connection connect(slot_type slot)
+    {
+        if (!state_)
+        {
+            state_ = std::make_shared<state>();
+        }
+
+        auto const id = state_->next_id_++;
+        state_->slots_.push_back(slot_entry{id, true, std::move(slot)});
+        ++state_->live_slots_;
+
+        return connection(state_, id);
+    }
+
+    //* =====================================================================
+    /// \brief Connects another signal to this one, so that emitting this
+    /// signal also emits the other.  The other signal is held by reference,
+    /// and so must either outlive this signal or be disconnected first.
+    //* =====================================================================
+    template <class... OtherArgs>
+    connection connect(signal<void (OtherArgs...)> &other)
+    {
+        return connect(
+            [&other](Args... args)
+            {
+                other(args...);
+            });
+    }
+
+    //* =====================================================================
+    /// \brief Disconnects all slots from the signal.
+    //* =====================================================================
+    void disconnect_all_slots()
+    {
+        if (state_)
+        {
+            state_->disconnect_all();
+        }
+    }
+
+    //* =====================================================================
+    /// \brief Returns true if there are no slots connected to the signal.
+    //* =====================================================================
+    bool empty() const
+    {
+        return !state_ || state_->live_slots_ == 0;
+    }
+
+    //* =====================================================================
+    /// \brief Returns the number of slots connected to the signal.
+    //* =====================================================================
+    odin::u32 num_slots() const
+    {
+        return state_ ? state_->live_slots_ : 0;
+    }
+
+    //* =====================================================================
+    /// \brief Emits the signal, calling each connected slot in the order
+    /// in which they were connected.
+    //* =====================================================================
+    void operator()(Args... args) const
+    {
+        if (!state_ || state_->live_slots_ == 0)
+        {
+            return;
+        }
+
+        // Hold on to the state so that it survives any slot that destroys
+        // this signal.
+        auto const st = state_;
+        emission_guard guard(*st);
+
+        // Only the slots that were connected at the start of the emission
+        // are called.  Indices are used rather than iterators because
+        // slots may connect further slots, and slot entries are never
+        // removed while an emission is in progress.
+        auto const count = st->slots_.size();
+
+        for (decltype(st->slots_.size()) index = 0; index < count; ++index)
+        {
+            auto &entry = st->slots_[index];
+
+            if (entry.connected_)
+            {
+                entry.function_(args...);
+            }
+        }
+    }
+
+private :
+    struct slot_entry
+    {
+        odin::u64 id_;
+        bool      connected_;
+        slot_type function_;
+    };
+
+    // Slots are stored in a deque so that connecting a slot during an
+    // emission does not move the slots that are currently being called.
+    struct state : detail::signal_state_base
+    {
+        void disconnect(odin::u64 id) override
+        {
+            auto entry = find(slots_, id);
+
+            if (entry != slots_.end() && entry->connected_)
+            {
+                entry->connected_ = false;
+                --live_slots_;
+
+                if (emitting_ == 0)
+                {
+                    slots_.erase(entry);
+                }
+                else
+                {
+                    dead_slots_ = true;
+                }
+            }
+        }
+
+        bool is_connected(odin::u64 id) const override
+        {
+            auto entry = find(slots_, id);
+            return entry != slots_.end() && entry->connected_;
+        }
+
+        void disconnect_all()
+        {
+            if (emitting_ == 0)
+            {
+                slots_.clear();
+            }
+            else
+            {
+                for (auto &entry : slots_)
+                {
+                    entry.connected_ = false;
+                }
+
+                dead_slots_ = true;
+            }
+
+            live_slots_ = 0;
+        }
+
+        template <class Slots>
+        static auto find(Slots &slots, odin::u64 id) -> decltype(slots.end())
+        {
+            // Ids are allocated in increasing order, and slots are only
+            // ever appended, so the slots are always sorted by id.
+            auto entry = std::lower_bound(
+                slots.begin()
+              , slots.end()
+              , id
+              , [](slot_entry const &lhs, odin::u64 rhs)
+                {
+                    return lhs.id_ < rhs;
+                });
+
+            return entry != slots.end() && entry->id_ == id
+                 ? entry
+                 : slots.end();
+        }
+
+        void remove_dead_slots()
+        {
+            slots_.erase(
+                std::remove_if(
+                    slots_.begin()
+                  , slots_.end()
+                  , [](slot_entry const &entry)
+                    {
+                        return !entry.connected_;
+                    })
+              , slots_.end());
+
+            dead_slots_ = false;
+        }
+
+        std::deque<slot_entry> slots_;
+        odin::u64              next_id_    = 0;
+        odin::u32              live_slots_ = 0;
+        odin::u32              emitting_   = 0;
+        bool                   dead_slots_ = false;
+    };
+
+    // Tracks the depth of nested emissions, and removes any slots that
+    // were disconnected during an emission once the outermost emission
+    // has completed, even if a slot throws.
+    struct emission_guard
+    {
+        explicit emission_guard(state &st)
+            : state_(st)
+        {
+            ++state_.emitting_;
+        }
+
+        ~emission_guard()
+        {
+            if (--state_.emitting_ == 0 && state_.dead_slots_)
+            {
+                state_.remove_dead_slots();
+            }
+        }
+
+        emission_guard(emission_guard const &) = delete;
+        emission_guard &operator=(emission_guard const &) = delete;
+
+        state &state_;
+    };
+
+    std::shared_ptr<state> state_;
+};
+
+}
+
+#endif
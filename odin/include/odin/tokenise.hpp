@@ -28,13 +28,62 @@
 #define ODIN_TOKENISE_HPP_
 
 #include "odin/core.hpp"
+#include <boost/utility/string_view.hpp>
 #include <utility>
-#include <string>
 
 namespace odin {
 
+//* =========================================================================
+/// \brief Returns the text without its leading and trailing spaces and
+/// tabs.
+//* =========================================================================
 ODIN_EXPORT
-std::pair<std::string, std::string> tokenise(std::string const &text);
+boost::string_view trim(boost::string_view text);
+
+//* =========================================================================
+/// \brief Splits the first word from the text, returning it and the rest
+/// of the text.
+/// \par
+/// Words are separated by spaces and tabs.  A word that begins with a
+/// double quote runs until the next double quote, and so may contain
+/// spaces; the quotes are not part of the word.  The rest of the text is
+/// returned as it is, save that it is trimmed.  If there are no words in
+/// the text, then both are empty.
+/// \par
+/// Nothing is copied: both the word and the rest of the text refer to the
+/// characters of the text that was passed in, and so are only valid for
+/// as long as it is.
+//* =========================================================================
+ODIN_EXPORT
+std::pair<boost::string_view, boost::string_view> tokenise(
+    boost::string_view text);
+
+//* =========================================================================
+/// \brief Reads the words of a text one at a time, as they are asked for,
+/// in the manner of tokenise().
+//* =========================================================================
+class ODIN_EXPORT tokeniser
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    explicit tokeniser(boost::string_view text);
+
+    //* =====================================================================
+    /// \brief Returns the next word of the text, or an empty view if there
+    /// are no more.
+    //* =====================================================================
+    boost::string_view next();
+
+    //* =====================================================================
+    /// \brief Returns the part of the text that has not yet been read.
+    //* =====================================================================
+    boost::string_view rest() const;
+
+private :
+    boost::string_view rest_;
+};
 
 }
 
@@ -0,0 +1,406 @@
+// ==========================================================================
+// Odin Flight Recorder
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "odin/flight_recorder.hpp"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace odin { namespace flight_recorder {
+
+namespace {
+    // The number of handlers that each thread remembers.
+    BOOST_STATIC_CONSTANT(odin::u64, RING_SIZE = 4096);
+
+    // ======================================================================
+    // ENTRY
+    // ======================================================================
+    struct entry
+    {
+        // The fields are atomic so that a dump may read a ring while its
+        // thread is writing to it; the ring's index tells it which of the
+        // entries it read might have been torn.
+        std::atomic<char const *> tag{nullptr};
+        std::atomic<odin::s64>    enqueued{0};
+        std::atomic<odin::s64>    started{0};
+        std::atomic<odin::s64>    finished{0};
+    };
+
+    // ======================================================================
+    // RING
+    // ======================================================================
+    struct ring
+    {
+        explicit ring(odin::u32 id)
+            : thread_id(id)
+        {
+        }
+
+        odin::u32 const        thread_id;
+        std::atomic<odin::u64> next{0};
+        entry                  entries[RING_SIZE];
+    };
+
+    // ======================================================================
+    // SNAPSHOT_ENTRY
+    // ======================================================================
+    struct snapshot_entry
+    {
+        char const *tag;
+        odin::u32   thread_id;
+        odin::s64   enqueued;
+        odin::s64   started;
+        odin::s64   finished;
+    };
+
+    // ======================================================================
+    // RECORDER
+    // ======================================================================
+    struct recorder
+    {
+        std::atomic<bool>      enabled{false};
+        std::atomic<odin::s64> slow_threshold{0};
+        std::atomic<odin::s64> dump_interval{0};
+        std::atomic<odin::s64> last_dump{0};
+        std::atomic<odin::u32> dump_sequence{0};
+
+        // Guards the list of rings and the dump prefix.  Neither is
+        // touched while recording, except when a thread records for the
+        // first time.
+        std::mutex                          mutex;
+        std::vector<std::shared_ptr<ring>>  rings;
+        std::string                         dump_prefix = "flight";
+    };
+
+    // ======================================================================
+    // GET_RECORDER
+    // ======================================================================
+    recorder &get_recorder()
+    {
+        static recorder instance;
+        return instance;
+    }
+
+    // ======================================================================
+    // TO_NANOSECONDS
+    // ======================================================================
+    odin::s64 to_nanoseconds(clock::duration duration)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            duration).count();
+    }
+
+    // ======================================================================
+    // GET_RING
+    // ======================================================================
+    ring &get_ring()
+    {
+        thread_local std::shared_ptr<ring> current;
+
+        if (!current)
+        {
+            auto &rec = get_recorder();
+            std::unique_lock<std::mutex> lock(rec.mutex);
+
+            current = std::make_shared<ring>(odin::u32(rec.rings.size()));
+            rec.rings.push_back(current);
+        }
+
+        return *current;
+    }
+
+    // ======================================================================
+    // READ_RING
+    // ======================================================================
+    void read_ring(ring const &rng, std::vector<snapshot_entry> &entries)
+    {
+        auto const end   = rng.next.load(std::memory_order_acquire);
+        auto const begin = end > RING_SIZE ? end - RING_SIZE : 0;
+        auto const first = entries.size();
+
+        for (auto index = begin; index != end; ++index)
+        {
+            auto const &current = rng.entries[index % RING_SIZE];
+
+            entries.push_back({
+                current.tag.load(std::memory_order_relaxed)
+              , rng.thread_id
+              , current.enqueued.load(std::memory_order_relaxed)
+              , current.started.load(std::memory_order_relaxed)
+              , current.finished.load(std::memory_order_relaxed)
+            });
+        }
+
+        // If the thread recorded more handlers while the ring was being
+        // read, the oldest entries may have been overwritten part way
+        // through.  Only those that are still in the ring can be trusted.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto const now_end = rng.next.load(std::memory_order_relaxed);
+        auto const trusted = now_end >= RING_SIZE ? now_end - RING_SIZE + 1 : 0;
+
+        if (trusted > begin)
+        {
+            auto const torn = (std::min)(trusted - begin, end - begin);
+            entries.erase(
+                entries.begin() + first
+              , entries.begin() + first + std::ptrdiff_t(torn));
+        }
+    }
+
+    // ======================================================================
+    // WRITE_ESCAPED
+    // ======================================================================
+    void write_escaped(std::ostream &out, char const *text)
+    {
+        for (; text != nullptr && *text != '\0'; ++text)
+        {
+            if (*text == '"' || *text == '\\')
+            {
+                out << '\\';
+            }
+
+            out << *text;
+        }
+    }
+
+    // ======================================================================
+    // WRITE_MICROSECONDS
+    // ======================================================================
+    void write_microseconds(std::ostream &out, odin::s64 nanoseconds)
+    {
+        out << boost::format("%d.%03d") 
+            % (nanoseconds / 1000) 
+            % (nanoseconds % 1000);
+    }
+
+    // ======================================================================
+    // AUTOMATIC_DUMP
+    // ======================================================================
+    void automatic_dump(char const *tag, odin::s64 duration, odin::s64 now)
+    {
+        auto &rec = get_recorder();
+        auto last = rec.last_dump.load();
+
+        if (last != 0 && now - last < rec.dump_interval.load())
+        {
+            return;
+        }
+
+        // Only one of the threads that find a slow handler at the same
+        // time does the dump.
+        if (!rec.last_dump.compare_exchange_strong(last, now))
+        {
+            return;
+        }
+
+        try
+        {
+            auto const filename = dump();
+
+            std::printf(
+                "Slow handler %s took %lldus; flight recorder written to %s\n"
+              , tag
+              , static_cast<long long>(duration / 1000)
+              , filename.c_str());
+        }
+        catch (std::exception &ex)
+        {
+            std::printf("Error writing flight recorder: %s\n", ex.what());
+        }
+    }
+}
+
+// ==========================================================================
+// CONFIGURE
+// ==========================================================================
+void configure(settings const &config)
+{
+    auto &rec = get_recorder();
+
+    {
+        std::unique_lock<std::mutex> lock(rec.mutex);
+        rec.dump_prefix = config.dump_prefix;
+    }
+
+    rec.slow_threshold = to_nanoseconds(config.slow_threshold);
+    rec.dump_interval  = to_nanoseconds(config.dump_interval);
+    rec.enabled        = config.enabled;
+}
+
+// ==========================================================================
+// IS_ENABLED
+// ==========================================================================
+bool is_enabled()
+{
+    return get_recorder().enabled.load(std::memory_order_relaxed);
+}
+
+// ==========================================================================
+// RECORD
+// ==========================================================================
+void record(
+    char const        *tag
+  , clock::time_point  enqueued
+  , clock::time_point  started
+  , clock::time_point  finished)
+{
+    auto &rng = get_ring();
+    auto const index = rng.next.load(std::memory_order_relaxed);
+    auto &current = rng.entries[index % RING_SIZE];
+
+    // This fence orders the publication of the previous entry before the
+    // overwriting of the oldest, so that a reader that sees part of this
+    // entry also sees that the oldest has gone.
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto const started_ns  = to_nanoseconds(started.time_since_epoch());
+    auto const finished_ns = to_nanoseconds(finished.time_since_epoch());
+
+    current.tag.store(tag, std::memory_order_relaxed);
+    current.enqueued.store(
+        to_nanoseconds(enqueued.time_since_epoch()), std::memory_order_relaxed);
+    current.started.store(started_ns, std::memory_order_relaxed);
+    current.finished.store(finished_ns, std::memory_order_relaxed);
+
+    rng.next.store(index + 1, std::memory_order_release);
+
+    auto const threshold = get_recorder().slow_threshold.load(
+        std::memory_order_relaxed);
+
+    if (threshold != 0 && finished_ns - started_ns >= threshold)
+    {
+        automatic_dump(tag, finished_ns - started_ns, finished_ns);
+    }
+}
+
+// ==========================================================================
+// WRITE_TRACE
+// ==========================================================================
+void write_trace(std::ostream &out)
+{
+    auto &rec = get_recorder();
+    std::vector<std::shared_ptr<ring>> rings;
+
+    {
+        std::unique_lock<std::mutex> lock(rec.mutex);
+        rings = rec.rings;
+    }
+
+    std::vector<snapshot_entry> entries;
+
+    for (auto const &rng : rings)
+    {
+        read_ring(*rng, entries);
+    }
+
+    // Times are written relative to the earliest that was recorded, which
+    // keeps them short.
+    odin::s64 origin = 0;
+
+    if (!entries.empty())
+    {
+        origin = std::min_element(
+            entries.begin()
+          , entries.end()
+          , [](auto const &lhs, auto const &rhs)
+            {
+                return lhs.enqueued < rhs.enqueued;
+            })->enqueued;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    char const *separator = "\n";
+
+    for (auto const &rng : rings)
+    {
+        out << separator
+            << boost::format(
+                   "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                   "\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}")
+                % rng->thread_id
+                % rng->thread_id;
+        separator = ",\n";
+    }
+
+    for (auto const &current : entries)
+    {
+        out << separator << "{\"name\":\"";
+        write_escaped(out, current.tag);
+        out << "\",\"cat\":\"handler\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+            << current.thread_id
+            << ",\"ts\":";
+        write_microseconds(out, current.started - origin);
+        out << ",\"dur\":";
+        write_microseconds(out, current.finished - current.started);
+        out << ",\"args\":{\"queued_us\":";
+        write_microseconds(out, current.started - current.enqueued);
+        out << "}}";
+        separator = ",\n";
+    }
+
+    out << "\n]}\n";
+}
+
+// ==========================================================================
+// DUMP
+// ==========================================================================
+std::string dump()
+{
+    auto &rec = get_recorder();
+    std::string prefix;
+
+    {
+        std::unique_lock<std::mutex> lock(rec.mutex);
+        prefix = rec.dump_prefix;
+    }
+
+    auto const filename = boost::str(
+        boost::format("%s-%d-%d.json")
+            % prefix
+            % static_cast<long long>(std::time(nullptr))
+            % rec.dump_sequence++);
+
+    std::ofstream out(filename.c_str());
+
+    if (!out)
+    {
+        throw std::runtime_error("could not open " + filename);
+    }
+
+    write_trace(out);
+    return filename;
+}
+
+}}
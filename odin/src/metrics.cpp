@@ -0,0 +1,650 @@
+// ==========================================================================
+// Odin Metrics
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "odin/metrics.hpp"
+#include <boost/io/ios_state.hpp>
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+namespace odin { namespace metrics {
+
+namespace {
+    // Each metric is split into this many cells, each of which is given
+    // a cache line of its own so that threads adding to neighbouring cells
+    // do not contend for it.
+    BOOST_STATIC_CONSTANT(odin::u32, NUMBER_OF_CELLS = 8);
+    BOOST_STATIC_CONSTANT(std::size_t, CACHE_LINE_SIZE = 64);
+
+    // Values below LINEAR_LIMIT have a bucket each.  Above that, each power
+    // of two is split into SUB_BUCKETS buckets.
+    BOOST_STATIC_CONSTANT(odin::u32, SUB_BUCKET_BITS = 3);
+    BOOST_STATIC_CONSTANT(odin::u32, SUB_BUCKETS = 1 << SUB_BUCKET_BITS);
+    BOOST_STATIC_CONSTANT(odin::u32, LINEAR_LIMIT = SUB_BUCKETS * 2);
+    BOOST_STATIC_CONSTANT(odin::u32, LINEAR_BITS = SUB_BUCKET_BITS + 1);
+    BOOST_STATIC_CONSTANT(
+        odin::u32, 
+        NUMBER_OF_BUCKETS = LINEAR_LIMIT + (64 - LINEAR_BITS) * SUB_BUCKETS);
+
+    // ======================================================================
+    // CELL
+    // ======================================================================
+    template <class Value>
+    struct cell
+    {
+        std::atomic<Value> value;
+        char               padding[CACHE_LINE_SIZE - sizeof(std::atomic<Value>)];
+    };
+
+    // ======================================================================
+    // GET_CELL_INDEX
+    // ======================================================================
+    odin::u32 get_cell_index()
+    {
+        // Threads are given cells in turn as they first record something.
+        static std::atomic<odin::u32> next_index(0);
+        thread_local odin::u32 const index = next_index++ % NUMBER_OF_CELLS;
+
+        return index;
+    }
+
+    // ======================================================================
+    // GET_HIGHEST_BIT
+    // ======================================================================
+    odin::u32 get_highest_bit(odin::u64 value)
+    {
+#if defined(__GNUC__)
+        return 63 - odin::u32(__builtin_clzll(value));
+#else
+        odin::u32 bit = 0;
+
+        while (value >>= 1)
+        {
+            ++bit;
+        }
+
+        return bit;
+#endif
+    }
+
+    // ======================================================================
+    // GET_BUCKET_INDEX
+    // ======================================================================
+    odin::u32 get_bucket_index(odin::u64 value)
+    {
+        if (value < LINEAR_LIMIT)
+        {
+            return odin::u32(value);
+        }
+
+        auto const bit = get_highest_bit(value);
+        auto const sub_bucket = 
+            odin::u32(value >> (bit - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+
+        return LINEAR_LIMIT + (bit - LINEAR_BITS) * SUB_BUCKETS + sub_bucket;
+    }
+
+    // ======================================================================
+    // GET_BUCKET_UPPER_BOUND
+    // ======================================================================
+    odin::u64 get_bucket_upper_bound(odin::u32 index)
+    {
+        if (index < LINEAR_LIMIT)
+        {
+            return index;
+        }
+
+        auto const bit = (index - LINEAR_LIMIT) / SUB_BUCKETS + LINEAR_BITS;
+        auto const sub_bucket = (index - LINEAR_LIMIT) % SUB_BUCKETS;
+        auto const width = odin::u64(1) << (bit - SUB_BUCKET_BITS);
+
+        return ((SUB_BUCKETS + sub_bucket) << (bit - SUB_BUCKET_BITS))
+             + (width - 1);
+    }
+
+    // ======================================================================
+    // METRIC_TYPE
+    // ======================================================================
+    enum class metric_type
+    {
+        counter,
+        gauge,
+        histogram,
+        function
+    };
+
+    // ======================================================================
+    // METRIC
+    // ======================================================================
+    struct metric
+    {
+        metric_type                 type;
+        std::string                 help;
+        std::shared_ptr<counter>    counter_;
+        std::shared_ptr<gauge>      gauge_;
+        std::shared_ptr<histogram>  histogram_;
+        double                      scale = 1.0;
+        std::function<double ()>    function_;
+        odin::u64                   function_id = 0;
+    };
+
+    // ======================================================================
+    // TYPE_NAME
+    // ======================================================================
+    char const *type_name(metric_type type)
+    {
+        switch (type)
+        {
+            case metric_type::counter   : return "counter";
+            case metric_type::histogram : return "summary";
+            default                     : return "gauge";
+        }
+    }
+
+    double const QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+}
+
+// ==========================================================================
+// COUNTER::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct counter::impl
+{
+    impl()
+    {
+        for (auto &c : cells_)
+        {
+            c.value = 0;
+        }
+    }
+
+    cell<odin::u64> cells_[NUMBER_OF_CELLS];
+};
+
+// ==========================================================================
+// COUNTER CONSTRUCTOR
+// ==========================================================================
+counter::counter()
+    : pimpl_(std::make_shared<impl>())
+{
+}
+
+// ==========================================================================
+// COUNTER::ADD
+// ==========================================================================
+void counter::add(odin::u64 amount)
+{
+    pimpl_->cells_[get_cell_index()].value.fetch_add(
+        amount, std::memory_order_relaxed);
+}
+
+// ==========================================================================
+// COUNTER::GET_VALUE
+// ==========================================================================
+odin::u64 counter::get_value() const
+{
+    odin::u64 total = 0;
+
+    for (auto const &c : pimpl_->cells_)
+    {
+        total += c.value.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+// ==========================================================================
+// GAUGE::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct gauge::impl
+{
+    impl()
+    {
+        for (auto &c : cells_)
+        {
+            c.value = 0;
+        }
+    }
+
+    cell<odin::s64> cells_[NUMBER_OF_CELLS];
+};
+
+// ==========================================================================
+// GAUGE CONSTRUCTOR
+// ==========================================================================
+gauge::gauge()
+    : pimpl_(std::make_shared<impl>())
+{
+}
+
+// ==========================================================================
+// GAUGE::ADD
+// ==========================================================================
+void gauge::add(odin::s64 amount)
+{
+    pimpl_->cells_[get_cell_index()].value.fetch_add(
+        amount, std::memory_order_relaxed);
+}
+
+// ==========================================================================
+// GAUGE::GET_VALUE
+// ==========================================================================
+odin::s64 gauge::get_value() const
+{
+    odin::s64 total = 0;
+
+    for (auto const &c : pimpl_->cells_)
+    {
+        total += c.value.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+// ==========================================================================
+// HISTOGRAM::SNAPSHOT::GET_QUANTILE
+// ==========================================================================
+odin::u64 histogram::snapshot::get_quantile(double fraction) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    auto const rank = (std::max)(odin::u64(fraction * count + 0.5), odin::u64(1));
+    odin::u64 seen = 0;
+
+    for (odin::u32 index = 0; index < buckets.size(); ++index)
+    {
+        seen += buckets[index];
+
+        if (seen >= rank)
+        {
+            return (std::min)(get_bucket_upper_bound(index), max);
+        }
+    }
+
+    return max;
+}
+
+// ==========================================================================
+// HISTOGRAM::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct histogram::impl
+{
+    struct histogram_cell
+    {
+        std::atomic<odin::u64> buckets[NUMBER_OF_BUCKETS];
+        std::atomic<odin::u64> sum;
+        std::atomic<odin::u64> max;
+        char                   padding[CACHE_LINE_SIZE];
+    };
+
+    impl()
+        : cells_(NUMBER_OF_CELLS)
+    {
+        for (auto &c : cells_)
+        {
+            for (auto &bucket : c.buckets)
+            {
+                bucket = 0;
+            }
+
+            c.sum = 0;
+            c.max = 0;
+        }
+    }
+
+    std::vector<histogram_cell> cells_;
+};
+
+// ==========================================================================
+// HISTOGRAM CONSTRUCTOR
+// ==========================================================================
+histogram::histogram()
+    : pimpl_(std::make_shared<impl>())
+{
+}
+
+// ==========================================================================
+// HISTOGRAM::RECORD
+// ==========================================================================
+void histogram::record(odin::u64 value)
+{
+    auto &c = pimpl_->cells_[get_cell_index()];
+
+    c.buckets[get_bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    c.sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto max = c.max.load(std::memory_order_relaxed);
+
+    while (value > max
+        && !c.max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+// ==========================================================================
+// HISTOGRAM::RECORD
+// ==========================================================================
+void histogram::record(std::chrono::steady_clock::duration duration)
+{
+    auto const nanoseconds = 
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+
+    record(odin::u64(
+        (std::max)(nanoseconds, std::chrono::nanoseconds::rep(0))));
+}
+
+// ==========================================================================
+// HISTOGRAM::GET_SNAPSHOT
+// ==========================================================================
+histogram::snapshot histogram::get_snapshot() const
+{
+    snapshot snap;
+    snap.buckets.resize(NUMBER_OF_BUCKETS);
+
+    for (auto const &c : pimpl_->cells_)
+    {
+        for (odin::u32 index = 0; index < NUMBER_OF_BUCKETS; ++index)
+        {
+            auto const value = c.buckets[index].load(std::memory_order_relaxed);
+            snap.buckets[index] += value;
+            snap.count += value;
+        }
+
+        snap.sum += c.sum.load(std::memory_order_relaxed);
+        snap.max = (std::max)(snap.max, c.max.load(std::memory_order_relaxed));
+    }
+
+    return snap;
+}
+
+// ==========================================================================
+// SCOPED_TIMER CONSTRUCTOR
+// ==========================================================================
+scoped_timer::scoped_timer(histogram &hist)
+    : histogram_(hist),
+      start_(std::chrono::steady_clock::now())
+{
+}
+
+// ==========================================================================
+// SCOPED_TIMER DESTRUCTOR
+// ==========================================================================
+scoped_timer::~scoped_timer()
+{
+    histogram_.record(std::chrono::steady_clock::now() - start_);
+}
+
+// ==========================================================================
+// REGISTRY::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct registry::impl
+{
+    // ======================================================================
+    // FIND_OR_ADD
+    // ======================================================================
+    metric &find_or_add(
+        std::string const &name, std::string const &help, metric_type type)
+    {
+        auto result = metrics_.insert(std::make_pair(name, metric()));
+        auto &met = result.first->second;
+
+        if (result.second)
+        {
+            met.type = type;
+            met.help = help;
+        }
+        else if (met.type != type)
+        {
+            throw std::invalid_argument(
+                "metric " + name + " is already registered as another type");
+        }
+
+        return met;
+    }
+
+    mutable std::mutex                 mutex_;
+    std::map<std::string, metric>      metrics_;
+    odin::u64                          next_function_id_ = 1;
+};
+
+// ==========================================================================
+// REGISTRY CONSTRUCTOR
+// ==========================================================================
+registry::registry()
+    : pimpl_(std::make_shared<impl>())
+{
+}
+
+// ==========================================================================
+// GET_COUNTER
+// ==========================================================================
+counter &registry::get_counter(
+    std::string const &name, std::string const &help)
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    auto &met = pimpl_->find_or_add(name, help, metric_type::counter);
+
+    if (met.counter_ == nullptr)
+    {
+        met.counter_ = std::make_shared<counter>();
+    }
+
+    return *met.counter_;
+}
+
+// ==========================================================================
+// GET_GAUGE
+// ==========================================================================
+gauge &registry::get_gauge(
+    std::string const &name, std::string const &help)
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    auto &met = pimpl_->find_or_add(name, help, metric_type::gauge);
+
+    if (met.gauge_ == nullptr)
+    {
+        met.gauge_ = std::make_shared<gauge>();
+    }
+
+    return *met.gauge_;
+}
+
+// ==========================================================================
+// GET_HISTOGRAM
+// ==========================================================================
+histogram &registry::get_histogram(
+    std::string const &name
+  , std::string const &help
+  , double             scale)
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    auto &met = pimpl_->find_or_add(name, help, metric_type::histogram);
+
+    if (met.histogram_ == nullptr)
+    {
+        met.histogram_ = std::make_shared<histogram>();
+        met.scale      = scale;
+    }
+
+    return *met.histogram_;
+}
+
+// ==========================================================================
+// ADD_FUNCTION
+// ==========================================================================
+registry::function_handle registry::add_function(
+    std::string const              &name
+  , std::string const              &help
+  , std::function<double ()> const &fn)
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    auto &met = pimpl_->find_or_add(name, help, metric_type::function);
+
+    // A later function of the same name replaces the earlier one.
+    auto const id = pimpl_->next_function_id_++;
+    met.function_    = fn;
+    met.function_id  = id;
+
+    std::weak_ptr<impl> weak_impl = pimpl_;
+
+    return function_handle(
+        static_cast<void *>(nullptr),
+        [weak_impl, name, id](void *)
+        {
+            auto pimpl = weak_impl.lock();
+
+            if (pimpl != nullptr)
+            {
+                std::unique_lock<std::mutex> lock(pimpl->mutex_);
+                auto met = pimpl->metrics_.find(name);
+
+                if (met != pimpl->metrics_.end() 
+                 && met->second.function_id == id)
+                {
+                    pimpl->metrics_.erase(met);
+                }
+            }
+        });
+}
+
+// ==========================================================================
+// WRITE_EXPOSITION
+// ==========================================================================
+void registry::write_exposition(std::ostream &out) const
+{
+    boost::io::ios_all_saver saver(out);
+    out << std::setprecision(9);
+
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+
+    for (auto const &entry : pimpl_->metrics_)
+    {
+        auto const &name = entry.first;
+        auto const &met  = entry.second;
+
+        out << "# HELP " << name << " " << met.help << "\n"
+            << "# TYPE " << name << " " << type_name(met.type) << "\n";
+
+        switch (met.type)
+        {
+            case metric_type::counter :
+                out << name << " " << met.counter_->get_value() << "\n";
+                break;
+
+            case metric_type::gauge :
+                out << name << " " << met.gauge_->get_value() << "\n";
+                break;
+
+            case metric_type::function :
+                out << name << " " << met.function_() << "\n";
+                break;
+
+            case metric_type::histogram :
+            {
+                auto const snap = met.histogram_->get_snapshot();
+
+                for (auto const quantile : QUANTILES)
+                {
+                    out << name << "{quantile=\"" << quantile << "\"} "
+                        << snap.get_quantile(quantile) * met.scale << "\n";
+                }
+
+                out << name << "_sum "   << snap.sum * met.scale << "\n"
+                    << name << "_count " << snap.count << "\n";
+                break;
+            }
+        }
+    }
+}
+
+// ==========================================================================
+// WRITE_SUMMARY
+// ==========================================================================
+void registry::write_summary(std::ostream &out) const
+{
+    boost::io::ios_all_saver saver(out);
+    out << std::setprecision(4);
+
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+
+    for (auto const &entry : pimpl_->metrics_)
+    {
+        auto const &name = entry.first;
+        auto const &met  = entry.second;
+
+        out << name << ": ";
+
+        switch (met.type)
+        {
+            case metric_type::counter :
+                out << met.counter_->get_value();
+                break;
+
+            case metric_type::gauge :
+                out << met.gauge_->get_value();
+                break;
+
+            case metric_type::function :
+                out << met.function_();
+                break;
+
+            case metric_type::histogram :
+            {
+                auto const snap = met.histogram_->get_snapshot();
+
+                out << "count " << snap.count;
+
+                if (snap.count != 0)
+                {
+                    out << " mean " << double(snap.sum) / snap.count * met.scale
+                        << " p50 "  << snap.get_quantile(0.5)  * met.scale
+                        << " p99 "  << snap.get_quantile(0.99) * met.scale
+                        << " max "  << snap.max * met.scale;
+                }
+                break;
+            }
+        }
+
+        out << "\n";
+    }
+}
+
+// ==========================================================================
+// GET_REGISTRY
+// ==========================================================================
+registry &get_registry()
+{
+    static registry reg;
+    return reg;
+}
+
+}}
@@ -0,0 +1,366 @@
+// ==========================================================================
+// Odin Net Admission Control
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "odin/net/admission_control.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace odin { namespace net {
+
+namespace {
+    typedef std::array<unsigned char, 16> address_bytes;
+
+    // The table of token buckets is swept of buckets that have refilled,
+    // and so are indistinguishable from new ones, whenever it grows to
+    // twice the size it was after the last sweep.
+    BOOST_STATIC_CONSTANT(std::size_t, MINIMUM_SWEEP_SIZE = 1024);
+
+    // ======================================================================
+    // TO_BYTES
+    // ======================================================================
+    address_bytes to_bytes(boost::asio::ip::address const &address)
+    {
+        // IPv4 addresses are compared as IPv4-mapped IPv6 addresses, so
+        // that an IPv4 network matches connections from either stack.
+        return address.is_v4()
+             ? boost::asio::ip::address_v6::v4_mapped(address.to_v4()).to_bytes()
+             : address.to_v6().to_bytes();
+    }
+
+    // ======================================================================
+    // NETWORK
+    // ======================================================================
+    struct network
+    {
+        address_bytes address;
+        odin::u32     prefix_length;
+    };
+
+    // ======================================================================
+    // PARSE_NETWORK
+    // ======================================================================
+    network parse_network(std::string const &text)
+    {
+        auto const slash = text.find('/');
+
+        boost::system::error_code ec;
+        auto const address = boost::asio::ip::address::from_string(
+            text.substr(0, slash), ec);
+
+        if (ec)
+        {
+            throw std::invalid_argument("Invalid network: " + text);
+        }
+
+        odin::u32 const maximum_prefix_length = address.is_v4() ? 32 : 128;
+        odin::u32 prefix_length = maximum_prefix_length;
+
+        if (slash != std::string::npos)
+        {
+            try
+            {
+                prefix_length = std::stoul(text.substr(slash + 1));
+            }
+            catch (std::exception const &)
+            {
+                throw std::invalid_argument("Invalid network: " + text);
+            }
+
+            if (prefix_length > maximum_prefix_length)
+            {
+                throw std::invalid_argument("Invalid network: " + text);
+            }
+        }
+
+        return { 
+            to_bytes(address), 
+            prefix_length + (128 - maximum_prefix_length) 
+        };
+    }
+
+    // ======================================================================
+    // CONTAINS
+    // ======================================================================
+    bool contains(network const &net, address_bytes const &address)
+    {
+        auto const whole_bytes = net.prefix_length / 8;
+        auto const extra_bits  = net.prefix_length % 8;
+
+        if (!std::equal(
+                address.begin(), 
+                address.begin() + whole_bytes, 
+                net.address.begin()))
+        {
+            return false;
+        }
+
+        if (extra_bits != 0)
+        {
+            unsigned char const mask = 0xFF << (8 - extra_bits);
+            return (address[whole_bytes] & mask) 
+                == (net.address[whole_bytes] & mask);
+        }
+
+        return true;
+    }
+
+    // ======================================================================
+    // ADDRESS_HASH
+    // ======================================================================
+    struct address_hash
+    {
+        std::size_t operator()(address_bytes const &address) const
+        {
+            // FNV-1a
+            std::size_t hash = 2166136261u;
+
+            for (auto byte : address)
+            {
+                hash = (hash ^ byte) * 16777619u;
+            }
+
+            return hash;
+        }
+    };
+
+    // ======================================================================
+    // TOKEN_BUCKET
+    // ======================================================================
+    struct token_bucket
+    {
+        double                                tokens;
+        std::chrono::steady_clock::time_point last_update;
+    };
+}
+
+// ==========================================================================
+// ADMISSION_CONTROL::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct admission_control::impl
+    : std::enable_shared_from_this<admission_control::impl>
+{
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(admission_control::settings const &config)
+      : connections_per_second_(config.connections_per_second),
+        connection_burst_((std::max)(config.connection_burst, odin::u32(1))),
+        maximum_connections_(config.maximum_connections)
+    {
+        for (auto const &text : config.allow)
+        {
+            allow_.push_back(parse_network(text));
+        }
+
+        for (auto const &text : config.deny)
+        {
+            deny_.push_back(parse_network(text));
+        }
+    }
+
+    // ======================================================================
+    // IS_PERMITTED
+    // ======================================================================
+    bool is_permitted(address_bytes const &address) const
+    {
+        auto const matches = [&address](network const &net)
+        {
+            return contains(net, address);
+        };
+
+        if (std::any_of(deny_.begin(), deny_.end(), matches))
+        {
+            return false;
+        }
+
+        return allow_.empty() 
+            || std::any_of(allow_.begin(), allow_.end(), matches);
+    }
+
+    // ======================================================================
+    // REFILL
+    // ======================================================================
+    void refill(
+        token_bucket                                &bucket,
+        std::chrono::steady_clock::time_point const &now) const
+    {
+        std::chrono::duration<double> const elapsed = now - bucket.last_update;
+
+        bucket.tokens = (std::min)(
+            bucket.tokens + elapsed.count() * connections_per_second_,
+            double(connection_burst_));
+        bucket.last_update = now;
+    }
+
+    // ======================================================================
+    // TAKE_TOKEN
+    // ======================================================================
+    bool take_token(address_bytes const &address)
+    {
+        if (connections_per_second_ <= 0)
+        {
+            return true;
+        }
+
+        auto const now = std::chrono::steady_clock::now();
+
+        if (buckets_.size() >= next_sweep_size_)
+        {
+            sweep_buckets(now);
+        }
+
+        auto result = buckets_.insert(
+            std::make_pair(address, token_bucket{ double(connection_burst_), now }));
+        auto &bucket = result.first->second;
+
+        refill(bucket, now);
+
+        if (bucket.tokens < 1)
+        {
+            return false;
+        }
+
+        bucket.tokens -= 1;
+        return true;
+    }
+
+    // ======================================================================
+    // SWEEP_BUCKETS
+    // ======================================================================
+    void sweep_buckets(std::chrono::steady_clock::time_point const &now)
+    {
+        for (auto current = buckets_.begin(); current != buckets_.end(); )
+        {
+            refill(current->second, now);
+
+            if (current->second.tokens >= connection_burst_)
+            {
+                current = buckets_.erase(current);
+            }
+            else
+            {
+                ++current;
+            }
+        }
+
+        next_sweep_size_ = (std::max)(
+            buckets_.size() * 2, std::size_t(MINIMUM_SWEEP_SIZE));
+    }
+
+    // ======================================================================
+    // ADMIT
+    // ======================================================================
+    admission_control::ticket admit(boost::asio::ip::address const &address)
+    {
+        auto const bytes = to_bytes(address);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (!is_permitted(bytes))
+        {
+            ++statistics_.refused_access;
+            return {};
+        }
+
+        if (maximum_connections_ != 0
+         && statistics_.active >= maximum_connections_)
+        {
+            ++statistics_.refused_capacity;
+            return {};
+        }
+
+        if (!take_token(bytes))
+        {
+            ++statistics_.refused_rate;
+            return {};
+        }
+
+        ++statistics_.active;
+        ++statistics_.admitted;
+
+        // The ticket keeps this structure alive, so that it may be
+        // released even after the admission_control itself is destroyed.
+        return admission_control::ticket(
+            this, 
+            [pthis=shared_from_this()](void *)
+            {
+                std::unique_lock<std::mutex> lock(pthis->mutex_);
+                --pthis->statistics_.active;
+            });
+    }
+
+    double                                connections_per_second_;
+    odin::u32                             connection_burst_;
+    odin::u32                             maximum_connections_;
+    std::vector<network>                  allow_;
+    std::vector<network>                  deny_;
+
+    mutable std::mutex                    mutex_;
+    admission_control::statistics         statistics_;
+    std::unordered_map<
+        address_bytes, token_bucket, address_hash
+    >                                     buckets_;
+    std::size_t                           next_sweep_size_ = MINIMUM_SWEEP_SIZE;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+admission_control::admission_control(settings const &config)
+    : pimpl_(std::make_shared<impl>(config))
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+admission_control::~admission_control()
+{
+}
+
+// ==========================================================================
+// ADMIT
+// ==========================================================================
+admission_control::ticket admission_control::admit(
+    boost::asio::ip::address const &address)
+{
+    return pimpl_->admit(address);
+}
+
+// ==========================================================================
+// GET_STATISTICS
+// ==========================================================================
+admission_control::statistics admission_control::get_statistics() const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->statistics_;
+}
+
+}}
@@ -0,0 +1,455 @@
+// ==========================================================================
+// Odin Net Handover Channel
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "odin/net/handover_channel.hpp"
+#include <boost/system/system_error.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define ODIN_HANDOVER_SUPPORTED 1
+
+#if !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+namespace odin { namespace net {
+
+namespace {
+    // Each message is preceded by a header that gives the size of its
+    // payload and the number of handles that accompany it.
+    struct message_header
+    {
+        odin::u32 payload_size;
+        odin::u32 handle_count;
+    };
+
+#if defined(ODIN_HANDOVER_SUPPORTED)
+    // ======================================================================
+    // THROW_LAST_ERROR
+    // ======================================================================
+    [[noreturn]] void throw_last_error(char const *what)
+    {
+        throw boost::system::system_error(
+            errno, boost::system::system_category(), what);
+    }
+#else
+
+    // ======================================================================
+    // THROW_UNSUPPORTED
+    // ======================================================================
+    [[noreturn]] void throw_unsupported()
+    {
+        throw boost::system::system_error(
+            boost::system::errc::make_error_code(
+                boost::system::errc::not_supported),
+            "handover_channel");
+    }
+#endif
+}
+
+// ==========================================================================
+// HANDOVER_CHANNEL::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct handover_channel::impl
+{
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(native_handle_type handle)
+      : handle_(handle)
+    {
+    }
+
+    // ======================================================================
+    // DESTRUCTOR
+    // ======================================================================
+    ~impl()
+    {
+        close();
+    }
+
+    // ======================================================================
+    // CLOSE
+    // ======================================================================
+    void close()
+    {
+#if defined(ODIN_HANDOVER_SUPPORTED)
+        if (handle_ >= 0)
+        {
+            ::close(handle_);
+            handle_ = -1;
+        }
+#endif
+    }
+
+#if defined(ODIN_HANDOVER_SUPPORTED)
+    // ======================================================================
+    // SEND_ALL
+    // ======================================================================
+    void send_all(char const *data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            auto const sent = ::send(handle_, data, size, MSG_NOSIGNAL);
+
+            if (sent < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw_last_error("handover_channel::send");
+            }
+
+            data += sent;
+            size -= sent;
+        }
+    }
+
+    // ======================================================================
+    // RECEIVE_ALL
+    // ======================================================================
+    bool receive_all(char *data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            auto const received = ::recv(handle_, data, size, 0);
+
+            if (received < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                throw_last_error("handover_channel::receive");
+            }
+            else if (received == 0)
+            {
+                return false;
+            }
+
+            data += received;
+            size -= received;
+        }
+
+        return true;
+    }
+
+    // ======================================================================
+    // SEND
+    // ======================================================================
+    void send(handover_channel::message const &msg)
+    {
+        if (msg.handles.size() > handover_channel::MAXIMUM_HANDLES)
+        {
+            throw boost::system::system_error(
+                boost::system::errc::make_error_code(
+                    boost::system::errc::argument_list_too_long),
+                "handover_channel::send");
+        }
+
+        message_header header = {
+            odin::u32(msg.payload.size()),
+            odin::u32(msg.handles.size())
+        };
+
+        // The handles are sent as ancillary data alongside the header,
+        // and the payload follows.
+        iovec iov = { &header, sizeof(header) };
+
+        msghdr hdr = {};
+        hdr.msg_iov    = &iov;
+        hdr.msg_iovlen = 1;
+
+        char control[CMSG_SPACE(sizeof(int) * handover_channel::MAXIMUM_HANDLES)] = {};
+        auto const handles_size = sizeof(int) * msg.handles.size();
+
+        if (!msg.handles.empty())
+        {
+            hdr.msg_control    = control;
+            hdr.msg_controllen = CMSG_SPACE(handles_size);
+
+            auto *cmsg = CMSG_FIRSTHDR(&hdr);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type  = SCM_RIGHTS;
+            cmsg->cmsg_len   = CMSG_LEN(handles_size);
+            std::memcpy(CMSG_DATA(cmsg), msg.handles.data(), handles_size);
+        }
+
+        ssize_t sent;
+
+        do
+        {
+            sent = ::sendmsg(handle_, &hdr, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+
+        if (sent < 0)
+        {
+            throw_last_error("handover_channel::send");
+        }
+
+        // Only the first part of the header is guaranteed to have been
+        // sent along with the handles.
+        send_all(
+            reinterpret_cast<char const *>(&header) + sent,
+            sizeof(header) - sent);
+        send_all(msg.payload.data(), msg.payload.size());
+    }
+
+    // ======================================================================
+    // RECEIVE
+    // ======================================================================
+    boost::optional<handover_channel::message> receive()
+    {
+        message_header header = {};
+        iovec iov = { &header, sizeof(header) };
+
+        char control[CMSG_SPACE(sizeof(int) * handover_channel::MAXIMUM_HANDLES)] = {};
+
+        msghdr hdr = {};
+        hdr.msg_iov        = &iov;
+        hdr.msg_iovlen     = 1;
+        hdr.msg_control    = control;
+        hdr.msg_controllen = sizeof(control);
+
+#if defined(MSG_CMSG_CLOEXEC)
+        int const flags = MSG_CMSG_CLOEXEC;
+#else
+        int const flags = 0;
+#endif
+
+        ssize_t received;
+
+        do
+        {
+            received = ::recvmsg(handle_, &hdr, flags);
+        } while (received < 0 && errno == EINTR);
+
+        if (received < 0)
+        {
+            throw_last_error("handover_channel::receive");
+        }
+        else if (received == 0)
+        {
+            return {};
+        }
+
+        handover_channel::message msg;
+
+        for (auto *cmsg = CMSG_FIRSTHDR(&hdr); 
+             cmsg != nullptr; 
+             cmsg = CMSG_NXTHDR(&hdr, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET 
+             && cmsg->cmsg_type == SCM_RIGHTS)
+            {
+                auto const count = 
+                    (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                auto const old_size = msg.handles.size();
+                msg.handles.resize(old_size + count);
+                std::memcpy(
+                    msg.handles.data() + old_size, 
+                    CMSG_DATA(cmsg), 
+                    count * sizeof(int));
+            }
+        }
+
+        if (!receive_all(
+                reinterpret_cast<char *>(&header) + received,
+                sizeof(header) - received))
+        {
+            return {};
+        }
+
+        msg.payload.resize(header.payload_size);
+
+        if (!receive_all(&msg.payload[0], msg.payload.size()))
+        {
+            return {};
+        }
+
+        return msg;
+    }
+#endif
+
+    native_handle_type handle_;
+};
+
+// ==========================================================================
+// CREATE_PAIR
+// ==========================================================================
+std::pair<handover_channel, handover_channel> handover_channel::create_pair()
+{
+#if defined(ODIN_HANDOVER_SUPPORTED)
+    int handles[2];
+
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, handles) != 0)
+    {
+        throw_last_error("handover_channel::create_pair");
+    }
+
+    // Neither end is inherited by executed processes unless asked for.
+    for (auto handle : handles)
+    {
+        ::fcntl(handle, F_SETFD, ::fcntl(handle, F_GETFD) | FD_CLOEXEC);
+    }
+
+    return std::make_pair(
+        handover_channel(handles[0]), 
+        handover_channel(handles[1]));
+#else
+    throw_unsupported();
+#endif
+}
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+handover_channel::handover_channel(native_handle_type handle)
+    : pimpl_(std::make_shared<impl>(handle))
+{
+}
+
+// ==========================================================================
+// GET_NATIVE_HANDLE
+// ==========================================================================
+handover_channel::native_handle_type handover_channel::get_native_handle() const
+{
+    return pimpl_->handle_;
+}
+
+// ==========================================================================
+// SET_INHERITABLE
+// ==========================================================================
+void handover_channel::set_inheritable()
+{
+#if defined(ODIN_HANDOVER_SUPPORTED)
+    auto const handle = pimpl_->handle_;
+    ::fcntl(handle, F_SETFD, ::fcntl(handle, F_GETFD) & ~FD_CLOEXEC);
+#else
+    throw_unsupported();
+#endif
+}
+
+// ==========================================================================
+// SEND
+// ==========================================================================
+void handover_channel::send(message const &msg)
+{
+#if defined(ODIN_HANDOVER_SUPPORTED)
+    pimpl_->send(msg);
+#else
+    (void)msg;
+    throw_unsupported();
+#endif
+}
+
+// ==========================================================================
+// RECEIVE
+// ==========================================================================
+boost::optional<handover_channel::message> handover_channel::receive()
+{
+#if defined(ODIN_HANDOVER_SUPPORTED)
+    return pimpl_->receive();
+#else
+    throw_unsupported();
+#endif
+}
+
+// ==========================================================================
+// ASYNC_RECEIVE
+// ==========================================================================
+void handover_channel::async_receive(
+    boost::asio::io_service &io_service
+  , std::function<
+        void (boost::system::error_code const &,
+              boost::optional<message> const &)
+    > const &callback)
+{
+#if defined(ODIN_HANDOVER_SUPPORTED)
+    // The descriptor owns, and closes, a duplicate of the handle, so that
+    // the channel's own handle stays open for as long as the channel does.
+    auto const handle = ::dup(pimpl_->handle_);
+
+    if (handle < 0)
+    {
+        throw_last_error("handover_channel::async_receive");
+    }
+
+    auto descriptor =
+        std::make_shared<boost::asio::posix::stream_descriptor>(
+            io_service, handle);
+    auto pimpl = pimpl_;
+
+    descriptor->async_read_some(
+        boost::asio::null_buffers(),
+        [descriptor, pimpl, callback](
+            boost::system::error_code const &error, std::size_t)
+        {
+            boost::system::error_code result = error;
+            boost::optional<message> msg;
+
+            if (!result)
+            {
+                try
+                {
+                    msg = pimpl->receive();
+                }
+                catch (boost::system::system_error const &ex)
+                {
+                    result = ex.code();
+                }
+            }
+
+            callback(result, msg);
+        });
+#else
+    (void)io_service;
+    (void)callback;
+    throw_unsupported();
+#endif
+}
+
+// ==========================================================================
+// CLOSE
+// ==========================================================================
+void handover_channel::close()
+{
+    pimpl_->close();
+}
+
+}}
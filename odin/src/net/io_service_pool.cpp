@@ -0,0 +1,274 @@
+// ==========================================================================
+// Odin Net IO Service Pool
+//
+// Copyright (C) 2009 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "odin/net/io_service_pool.hpp"
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace odin { namespace net {
+
+namespace {
+
+// ==========================================================================
+// PIN_TO_CORE
+// ==========================================================================
+void pin_to_core(std::thread &thread, odin::u32 core)
+{
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+#else
+    // Pinning is not supported on this platform, and so the scheduler is
+    // left to place the thread.
+    (void)thread;
+    (void)core;
+#endif
+}
+
+}
+
+// ==========================================================================
+// IO_SERVICE_POOL::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct io_service_pool::impl
+{
+    typedef std::unique_ptr<boost::asio::io_service>       io_service_ptr;
+    typedef std::unique_ptr<boost::asio::io_service::work> work_ptr;
+
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(
+        odin::u32         io_services
+      , odin::u32         threads_per_io_service
+      , assignment_policy policy
+      , bool              pin_threads)
+      : threads_per_io_service_((std::max)(threads_per_io_service, 1u)),
+        policy_(policy),
+        pin_threads_(pin_threads),
+        loads_(new std::atomic<odin::u32>[(std::max)(io_services, 1u)])
+    {
+        io_services = (std::max)(io_services, 1u);
+
+        for (odin::u32 index = 0; index < io_services; ++index)
+        {
+            io_services_.emplace_back(new boost::asio::io_service);
+            works_.emplace_back(
+                new boost::asio::io_service::work(*io_services_.back()));
+            loads_[index] = 0;
+        }
+    }
+
+    odin::u32                                 threads_per_io_service_;
+    assignment_policy                         policy_;
+    bool                                      pin_threads_;
+    std::vector<io_service_ptr>               io_services_;
+    std::mutex                                works_mutex_;
+    std::vector<work_ptr>                     works_;
+    std::unique_ptr<std::atomic<odin::u32>[]> loads_;
+    std::atomic<odin::u32>                    next_{0};
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+io_service_pool::io_service_pool(
+    odin::u32         io_services
+  , odin::u32         threads_per_io_service
+  , assignment_policy policy
+  , bool              pin_threads)
+    : pimpl_(std::make_shared<impl>(
+          io_services, threads_per_io_service, policy, pin_threads))
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+io_service_pool::~io_service_pool()
+{
+}
+
+// ==========================================================================
+// GET_SIZE
+// ==========================================================================
+odin::u32 io_service_pool::get_size() const
+{
+    return odin::u32(pimpl_->io_services_.size());
+}
+
+// ==========================================================================
+// GET_IO_SERVICE
+// ==========================================================================
+boost::asio::io_service &io_service_pool::get_io_service(odin::u32 index)
+{
+    BOOST_ASSERT(index < get_size());
+    return *pimpl_->io_services_[index];
+}
+
+// ==========================================================================
+// GET_INDEX
+// ==========================================================================
+odin::u32 io_service_pool::get_index(
+    boost::asio::io_service const &io_service) const
+{
+    auto const &io_services = pimpl_->io_services_;
+    auto const found = std::find_if(
+        io_services.begin()
+      , io_services.end()
+      , [&io_service](auto const &candidate)
+        {
+            return candidate.get() == &io_service;
+        });
+
+    BOOST_ASSERT(found != io_services.end());
+    return odin::u32(found - io_services.begin());
+}
+
+// ==========================================================================
+// ASSIGN
+// ==========================================================================
+odin::u32 io_service_pool::assign()
+{
+    auto const size = get_size();
+    odin::u32 index = 0;
+
+    if (pimpl_->policy_ == assignment_policy::round_robin)
+    {
+        index = pimpl_->next_++ % size;
+    }
+    else
+    {
+        // The loads may change while they are being examined, but an
+        // approximately least-loaded io_service is good enough.
+        for (odin::u32 candidate = 1; candidate < size; ++candidate)
+        {
+            if (pimpl_->loads_[candidate] < pimpl_->loads_[index])
+            {
+                index = candidate;
+            }
+        }
+    }
+
+    ++pimpl_->loads_[index];
+    return index;
+}
+
+// ==========================================================================
+// ASSIGN
+// ==========================================================================
+void io_service_pool::assign(odin::u32 index)
+{
+    BOOST_ASSERT(index < get_size());
+    ++pimpl_->loads_[index];
+}
+
+// ==========================================================================
+// RELEASE
+// ==========================================================================
+void io_service_pool::release(odin::u32 index)
+{
+    BOOST_ASSERT(index < get_size());
+    --pimpl_->loads_[index];
+}
+
+// ==========================================================================
+// GET_LOAD
+// ==========================================================================
+odin::u32 io_service_pool::get_load(odin::u32 index) const
+{
+    BOOST_ASSERT(index < get_size());
+    return pimpl_->loads_[index];
+}
+
+// ==========================================================================
+// POST
+// ==========================================================================
+void io_service_pool::post(odin::u32 index, std::function<void ()> const &fn)
+{
+    get_io_service(index).post(fn);
+}
+
+// ==========================================================================
+// POST_TO_ALL
+// ==========================================================================
+void io_service_pool::post_to_all(std::function<void ()> const &fn)
+{
+    for (auto &io_service : pimpl_->io_services_)
+    {
+        io_service->post(fn);
+    }
+}
+
+// ==========================================================================
+// RUN
+// ==========================================================================
+void io_service_pool::run()
+{
+    auto const cores = (std::max)(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::thread> threads;
+
+    for (auto &io_service : pimpl_->io_services_)
+    {
+        for (odin::u32 thr = 0; thr < pimpl_->threads_per_io_service_; ++thr)
+        {
+            threads.emplace_back([&io_service]{io_service->run();});
+
+            if (pimpl_->pin_threads_)
+            {
+                auto const core = odin::u32(threads.size() - 1) % cores;
+                pin_to_core(threads.back(), core);
+            }
+        }
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// ==========================================================================
+// RELEASE_WORK
+// ==========================================================================
+void io_service_pool::release_work()
+{
+    std::unique_lock<std::mutex> lock(pimpl_->works_mutex_);
+    pimpl_->works_.clear();
+}
+
+}}
@@ -0,0 +1,260 @@
+// ==========================================================================
+// Odin Net Metrics Listener
+//
+// Copyright (C) 2016 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "odin/net/metrics_listener.hpp"
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdio>
+
+namespace odin { namespace net {
+
+namespace {
+    // If the port cannot be opened, or a connection cannot be accepted,
+    // the listener waits this long before trying again.
+    std::chrono::seconds const RETRY_DELAY(1);
+
+    // Requests are read only so far as the blank line that ends their
+    // headers, and no further than this.
+    BOOST_STATIC_CONSTANT(std::size_t, MAXIMUM_REQUEST_SIZE = 4096);
+
+    // ======================================================================
+    // REQUEST
+    // ======================================================================
+    struct request
+        : public std::enable_shared_from_this<request>
+    {
+        request(boost::asio::io_service &io_service)
+          : socket_(io_service),
+            buffer_(MAXIMUM_REQUEST_SIZE)
+        {
+        }
+
+        // ==================================================================
+        // START
+        // ==================================================================
+        void start(metrics_listener::page_function const &page)
+        {
+            auto self = shared_from_this();
+
+            boost::asio::async_read_until(
+                socket_, buffer_, "\r\n\r\n",
+                [self, page](boost::system::error_code const &ec, std::size_t)
+                {
+                    // A request too large for the buffer is answered all
+                    // the same.
+                    if (!ec || ec == boost::asio::error::not_found)
+                    {
+                        self->respond(page());
+                    }
+                });
+        }
+
+        // ==================================================================
+        // RESPOND
+        // ==================================================================
+        void respond(std::string const &body)
+        {
+            response_ = 
+                "HTTP/1.0 200 OK\r\n"
+                "Content-Type: text/plain; version=0.0.4\r\n"
+                "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                "Connection: close\r\n"
+                "\r\n"
+              + body;
+
+            auto self = shared_from_this();
+
+            boost::asio::async_write(
+                socket_, boost::asio::buffer(response_),
+                [self](boost::system::error_code const &, std::size_t)
+                {
+                    boost::system::error_code unused_error_code;
+                    self->socket_.shutdown(
+                        boost::asio::ip::tcp::socket::shutdown_both,
+                        unused_error_code);
+                    self->socket_.close(unused_error_code);
+                });
+        }
+
+        boost::asio::ip::tcp::socket socket_;
+        boost::asio::streambuf       buffer_;
+        std::string                  response_;
+    };
+}
+
+// ==========================================================================
+// METRICS_LISTENER::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct metrics_listener::impl
+    : public std::enable_shared_from_this<metrics_listener::impl>
+{
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(
+        boost::asio::io_service               &io_service,
+        odin::u16                              port,
+        metrics_listener::page_function const &page)
+      : io_service_(io_service),
+        acceptor_(io_service),
+        retry_timer_(io_service),
+        endpoint_(boost::asio::ip::address_v4::loopback(), port),
+        page_(page)
+    {
+    }
+
+    // ======================================================================
+    // OPEN
+    // ======================================================================
+    void open()
+    {
+        boost::system::error_code ec;
+
+        acceptor_.open(endpoint_.protocol(), ec);
+
+        if (!ec)
+        {
+            acceptor_.set_option(
+                boost::asio::ip::tcp::acceptor::reuse_address(true), ec);
+            acceptor_.bind(endpoint_, ec);
+        }
+
+        if (!ec)
+        {
+            acceptor_.listen(boost::asio::socket_base::max_connections, ec);
+        }
+
+        if (ec)
+        {
+            boost::system::error_code unused_error_code;
+            acceptor_.close(unused_error_code);
+
+            if (!retrying_)
+            {
+                std::printf("Metrics listener waiting for port %d: %s\n",
+                    int(endpoint_.port()), ec.message().c_str());
+                retrying_ = true;
+            }
+
+            retry([](impl &self){ self.open(); });
+            return;
+        }
+
+        schedule_accept();
+    }
+
+    // ======================================================================
+    // RETRY
+    // ======================================================================
+    void retry(std::function<void (impl &)> const &fn)
+    {
+        retry_timer_.expires_from_now(RETRY_DELAY);
+        retry_timer_.async_wait(
+            [wp=std::weak_ptr<impl>(shared_from_this()), fn](
+                boost::system::error_code const &ec)
+            {
+                auto pthis = wp.lock();
+
+                if (!ec && pthis != nullptr)
+                {
+                    fn(*pthis);
+                }
+            });
+    }
+
+    // ======================================================================
+    // SCHEDULE_ACCEPT
+    // ======================================================================
+    void schedule_accept()
+    {
+        auto req = std::make_shared<request>(io_service_);
+
+        acceptor_.async_accept(
+            req->socket_,
+            [wp=std::weak_ptr<impl>(shared_from_this()), req](
+                boost::system::error_code const &ec)
+            {
+                auto pthis = wp.lock();
+
+                if (pthis == nullptr 
+                 || ec == boost::asio::error::operation_aborted)
+                {
+                    return;
+                }
+
+                if (ec)
+                {
+                    // For example, the process may have run out of file
+                    // descriptors for the moment.
+                    pthis->retry([](impl &self){ self.schedule_accept(); });
+                    return;
+                }
+
+                req->start(pthis->page_);
+                pthis->schedule_accept();
+            });
+    }
+
+    // ======================================================================
+    // CLOSE
+    // ======================================================================
+    void close()
+    {
+        boost::system::error_code unused_error_code;
+        retry_timer_.cancel(unused_error_code);
+        acceptor_.close(unused_error_code);
+    }
+
+    boost::asio::io_service              &io_service_;
+    boost::asio::ip::tcp::acceptor        acceptor_;
+    boost::asio::steady_timer             retry_timer_;
+    boost::asio::ip::tcp::endpoint        endpoint_;
+    metrics_listener::page_function       page_;
+    bool                                  retrying_ = false;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+metrics_listener::metrics_listener(
+    boost::asio::io_service &io_service
+  , odin::u16                port
+  , page_function const     &page)
+    : pimpl_(std::make_shared<impl>(io_service, port, page))
+{
+    pimpl_->open();
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+metrics_listener::~metrics_listener()
+{
+    pimpl_->close();
+}
+
+}}
@@ -25,39 +25,155 @@
 //             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ==========================================================================
 #include "odin/net/server.hpp"
+#include "odin/net/admission_control.hpp"
 #include "odin/net/socket.hpp"
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <algorithm>
+#include <chrono>
 #include <functional>
 
 namespace odin { namespace net {
 
+namespace {
+    // After a failure to accept, the listener waits before trying again.
+    // Each consecutive failure doubles the wait, up to the maximum.
+    std::chrono::milliseconds const MINIMUM_ACCEPT_RETRY_DELAY(10);
+    std::chrono::milliseconds const MAXIMUM_ACCEPT_RETRY_DELAY(1000);
+
+#if defined(SO_REUSEPORT)
+    typedef boost::asio::detail::socket_option::boolean<
+        SOL_SOCKET, SO_REUSEPORT
+    > reuse_port;
+#endif
+}
+
 // ==========================================================================
 // SERVER::IMPLEMENTATION STRUCTURE
 // ==========================================================================
 struct server::impl
     : public std::enable_shared_from_this<server::impl>
 {
+    // ======================================================================
+    // LISTENER
+    // ======================================================================
+    struct listener
+    {
+        listener(boost::asio::io_service &io_service)
+          : io_service_(io_service),
+            acceptor_(io_service),
+            retry_timer_(io_service)
+        {
+        }
+
+        boost::asio::io_service        &io_service_;
+        boost::asio::ip::tcp::acceptor  acceptor_;
+        boost::asio::steady_timer       retry_timer_;
+        std::chrono::milliseconds       retry_delay_ =
+            MINIMUM_ACCEPT_RETRY_DELAY;
+    };
+
     // ======================================================================
     // CONSTRUCTOR
     // ======================================================================
     impl(boost::asio::io_service             &io_service,
          odin::u16                            port,
-         server::accept_handler const        &on_accept)
-      : io_service_(io_service),
-        acceptor_(
-            io_service,
-            boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)),
-        on_accept_(on_accept)
+         server::accept_handler const        &on_accept,
+         server::options const               &opts)
+      : on_accept_(on_accept),
+        select_io_service_(opts.select_io_service),
+        admission_(opts.admission)
     {
+        auto io_services = opts.reuse_port_io_services;
+
+#if defined(SO_REUSEPORT)
+        bool const use_reuse_port = io_services.size() > 1;
+#else
+        // Only one socket may listen on the port, so only the first
+        // io_service can be used.
+        if (io_services.size() > 1)
+        {
+            printf(
+                "SO_REUSEPORT is not supported; listening on 1 io_service "
+                "rather than %zu\n",
+                io_services.size());
+            io_services.resize(1);
+        }
+#endif
+
+        if (io_services.empty())
+        {
+            io_services.push_back(&io_service);
+        }
+        else
+        {
+            // Each socket runs on the io_service of its listener.
+            select_io_service_ = nullptr;
+        }
+
+        if (!opts.inherited_handles.empty())
+        {
+            for (std::size_t index = 0; 
+                 index < opts.inherited_handles.size(); 
+                 ++index)
+            {
+                listeners_.push_back(std::make_unique<listener>(
+                    *io_services[index % io_services.size()]));
+                listeners_.back()->acceptor_.assign(
+                    boost::asio::ip::tcp::v4(), 
+                    opts.inherited_handles[index]);
+            }
+
+            return;
+        }
+
+        boost::asio::ip::tcp::endpoint const endpoint(
+            boost::asio::ip::tcp::v4(), port);
+
+        for (auto *listener_io_service : io_services)
+        {
+            listeners_.push_back(
+                std::make_unique<listener>(*listener_io_service));
+
+            auto &acceptor = listeners_.back()->acceptor_;
+            acceptor.open(endpoint.protocol());
+            acceptor.set_option(
+                boost::asio::ip::tcp::acceptor::reuse_address(true));
+
+#if defined(SO_REUSEPORT)
+            if (use_reuse_port)
+            {
+                acceptor.set_option(reuse_port(true));
+            }
+#endif
+
+            acceptor.bind(endpoint);
+            acceptor.listen(
+                opts.backlog > 0
+              ? opts.backlog
+              : boost::asio::socket_base::max_connections);
+        }
+    }
+
+    // ======================================================================
+    // START
+    // ======================================================================
+    void start()
+    {
+        for (auto &lstnr : listeners_)
+        {
+            schedule_accept(*lstnr);
+        }
     }
 
     // ======================================================================
     // HANDLE_ACCEPT
     // ======================================================================
     void handle_accept(
+        listener                                            &lstnr,
         std::shared_ptr<boost::asio::ip::tcp::socket> const &new_socket,
-        boost::system::error_code const &error)
+        boost::system::error_code const                     &error)
     {
         if (!error)
         {
@@ -67,28 +183,94 @@ struct server::impl
                 new_socket->remote_endpoint().address().to_string().c_str());
 #endif
 
-            auto socket = std::make_shared<odin::net::socket>(new_socket);
+            lstnr.retry_delay_ = MINIMUM_ACCEPT_RETRY_DELAY;
+
+            auto admitted_socket = admit(new_socket);
+
+            if (admitted_socket)
+            {
+                on_accept_(
+                    std::make_shared<odin::net::socket>(admitted_socket));
+            }
+
+            schedule_accept(lstnr);
+        }
+        else if (error != boost::asio::error::operation_aborted
+              && lstnr.acceptor_.is_open())
+        {
+            // Errors such as running out of file descriptors are usually
+            // temporary, so rather than give up on the listener, wait for a
+            // while and then try again.
+            lstnr.retry_timer_.expires_from_now(lstnr.retry_delay_);
+            lstnr.retry_timer_.async_wait(
+                [pthis=shared_from_this(), &lstnr](
+                    boost::system::error_code const &ec)
+                {
+                    if (!ec && lstnr.acceptor_.is_open())
+                    {
+                        pthis->schedule_accept(lstnr);
+                    }
+                });
+
+            lstnr.retry_delay_ = (std::min)(
+                lstnr.retry_delay_ * 2, MAXIMUM_ACCEPT_RETRY_DELAY);
+        }
+    }
+
+    // ======================================================================
+    // ADMIT
+    // ======================================================================
+    std::shared_ptr<boost::asio::ip::tcp::socket> admit(
+        std::shared_ptr<boost::asio::ip::tcp::socket> const &new_socket)
+    {
+        if (!admission_)
+        {
+            return new_socket;
+        }
 
-            on_accept_(socket);
+        boost::system::error_code ec;
+        auto const endpoint = new_socket->remote_endpoint(ec);
+        auto ticket = ec 
+                    ? admission_control::ticket() 
+                    : admission_->admit(endpoint.address());
 
-            schedule_accept();
+        if (!ticket)
+        {
+            // Refused sockets are closed before anything else is built
+            // around them.
+            new_socket->close(ec);
+            return {};
         }
+
+        // The ticket is held for as long as the socket itself.
+        auto const holder = std::make_shared<
+            std::pair<
+                std::shared_ptr<boost::asio::ip::tcp::socket>,
+                admission_control::ticket
+            >
+        >(new_socket, std::move(ticket));
+
+        return std::shared_ptr<boost::asio::ip::tcp::socket>(
+            holder, holder->first.get());
     }
 
     // ======================================================================
     // SCHEDULE_ACCEPT
     // ======================================================================
-    void schedule_accept()
+    void schedule_accept(listener &lstnr)
     {
+        auto &socket_io_service =
+            select_io_service_ ? select_io_service_() : lstnr.io_service_;
+
         auto new_socket =
-            std::make_shared<boost::asio::ip::tcp::socket>(io_service_);
+            std::make_shared<boost::asio::ip::tcp::socket>(socket_io_service);
 
-        acceptor_.async_accept(
+        lstnr.acceptor_.async_accept(
             *new_socket.get(),
-            [this, new_socket](
+            [pthis=shared_from_this(), &lstnr, new_socket](
                 boost::system::error_code const &ec)
             {
-                handle_accept(new_socket, ec);
+                pthis->handle_accept(lstnr, new_socket, ec);
             });
     }
 
@@ -97,13 +279,33 @@ struct server::impl
     // ======================================================================
     void cancel()
     {
-        boost::system::error_code unused_error_code;
-        acceptor_.close(unused_error_code);
+        for (auto &lstnr : listeners_)
+        {
+            boost::system::error_code unused_error_code;
+            lstnr->acceptor_.close(unused_error_code);
+            lstnr->retry_timer_.cancel(unused_error_code);
+        }
     }
 
-    boost::asio::io_service        &io_service_;
-    boost::asio::ip::tcp::acceptor  acceptor_;
-    server::accept_handler          on_accept_;
+    // ======================================================================
+    // GET_NATIVE_HANDLES
+    // ======================================================================
+    std::vector<int> get_native_handles()
+    {
+        std::vector<int> handles;
+
+        for (auto &lstnr : listeners_)
+        {
+            handles.push_back(lstnr->acceptor_.native_handle());
+        }
+
+        return handles;
+    }
+
+    server::accept_handler                  on_accept_;
+    server::io_service_selector             select_io_service_;
+    std::shared_ptr<admission_control>      admission_;
+    std::vector<std::unique_ptr<listener>>  listeners_;
 };
 
 // ==========================================================================
@@ -113,9 +315,21 @@ server::server(
     boost::asio::io_service     &io_service
   , uint16_t                     port
   , accept_handler const        &on_accept)
-    : pimpl_(new impl(io_service, port, on_accept))
+    : server(io_service, port, on_accept, options())
 {
-    pimpl_->schedule_accept();
+}
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+server::server(
+    boost::asio::io_service     &io_service
+  , uint16_t                     port
+  , accept_handler const        &on_accept
+  , options const               &opts)
+    : pimpl_(std::make_shared<impl>(io_service, port, on_accept, opts))
+{
+    pimpl_->start();
 }
 
 // ==========================================================================
@@ -136,5 +350,12 @@ void server::shutdown()
     pimpl_->cancel();
 }
 
-}}
+// ==========================================================================
+// GET_NATIVE_HANDLES
+// ==========================================================================
+std::vector<int> server::get_native_handles() const
+{
+    return pimpl_->get_native_handles();
+}
 
+}}
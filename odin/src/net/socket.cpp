@@ -25,11 +25,50 @@
 //             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ==========================================================================
 #include "odin/net/socket.hpp"
+#include "odin/metrics.hpp"
 #include <boost/asio.hpp>
+#include <boost/optional.hpp>
 #include <deque>
 
 namespace odin { namespace net {
 
+namespace {
+    // ======================================================================
+    // GET_BYTES_READ
+    // ======================================================================
+    odin::metrics::counter &get_bytes_read()
+    {
+        static auto &bytes_read = odin::metrics::get_registry().get_counter(
+            "odin_socket_read_bytes_total", "Bytes read from sockets.");
+        return bytes_read;
+    }
+
+    // ======================================================================
+    // GET_BYTES_WRITTEN
+    // ======================================================================
+    odin::metrics::counter &get_bytes_written()
+    {
+        static auto &bytes_written = odin::metrics::get_registry().get_counter(
+            "odin_socket_written_bytes_total", "Bytes written to sockets.");
+        return bytes_written;
+    }
+
+    // The option that holds back partial segments until it is cleared.
+    // Where there is no such option, Nagle's algorithm is used in its
+    // place.
+#if defined(TCP_CORK)
+    typedef boost::asio::detail::socket_option::boolean<
+        IPPROTO_TCP, TCP_CORK
+    > cork_option;
+    #define ODIN_NET_CORK_SUPPORTED 1
+#elif defined(TCP_NOPUSH)
+    typedef boost::asio::detail::socket_option::boolean<
+        IPPROTO_TCP, TCP_NOPUSH
+    > cork_option;
+    #define ODIN_NET_CORK_SUPPORTED 1
+#endif
+}
+
 // ==========================================================================
 // SOCKET::IMPLEMENTATION STRUCTURE
 // ==========================================================================
@@ -39,7 +78,8 @@ struct socket::impl : std::enable_shared_from_this<impl>
     // CONSTRUCTOR
     // ======================================================================
     impl(std::shared_ptr<boost::asio::ip::tcp::socket> const &socket)
-        : socket_(socket)
+        : socket_(socket),
+          strand_(socket->get_io_service())
     {
     }
 
@@ -78,9 +118,21 @@ struct socket::impl : std::enable_shared_from_this<impl>
             write_requests_.pop_front();
         }
 
+        // The callback is released once it has been called, since it is
+        // likely to hold on to whatever owns this socket.
         if (on_death_ != NULL)
         {
-            on_death_();
+            auto const on_death = std::move(on_death_);
+            on_death_ = NULL;
+            on_death();
+        }
+
+        // The reads that were being cancelled have now gone with the rest.
+        if (on_reads_cancelled_ != NULL)
+        {
+            auto const on_reads_cancelled = std::move(on_reads_cancelled_);
+            on_reads_cancelled_ = NULL;
+            on_reads_cancelled();
         }
     }
 
@@ -126,7 +178,8 @@ struct socket::impl : std::enable_shared_from_this<impl>
         socket::input_storage_type data(size);
 
         boost::system::error_code ec;
-        socket_->read_some(boost::asio::buffer(&*data.begin(), size), ec);
+        get_bytes_read().add(
+            socket_->read_some(boost::asio::buffer(&*data.begin(), size), ec));
 
         /* INPUT DEBUGGING
         for(size_t i = 0; i < data.size(); ++i)
@@ -158,17 +211,41 @@ struct socket::impl : std::enable_shared_from_this<impl>
                 boost::asio::buffer(
                     &*read_requests_[0].values_.begin(),
                     read_requests_[0].values_.size()),
-                [this](
-                    boost::system::error_code const &ec,
-                    std::size_t bytes_transferred)
-                {
-                    read_complete(ec, bytes_transferred);
-                });
+                strand_.wrap(
+                    [this](
+                        boost::system::error_code const &ec,
+                        std::size_t bytes_transferred)
+                    {
+                        read_complete(ec, bytes_transferred);
+                    }));
 
             read_requests_[0].scheduled_ = true;
         }
     }
 
+    // ======================================================================
+    // ASYNC_CANCEL_READS
+    // ======================================================================
+    void async_cancel_reads(std::function<void ()> const &callback)
+    {
+        if (!is_alive()
+         || read_requests_.empty()
+         || !read_requests_.front().scheduled_)
+        {
+            read_requests_.clear();
+            strand_.post(callback);
+            return;
+        }
+
+        // The scheduled read completes with an error, or with whatever it
+        // had read if it was complete already, and the cancellation is
+        // finished from there.
+        on_reads_cancelled_ = callback;
+
+        boost::system::error_code unused_error_code;
+        socket_->cancel(unused_error_code);
+    }
+
     // ======================================================================
     // WRITE
     // ======================================================================
@@ -187,8 +264,57 @@ struct socket::impl : std::enable_shared_from_this<impl>
         //*/
 
         boost::system::error_code ec;
-        return socket_->write_some(
+        auto const written = socket_->write_some(
             boost::asio::buffer(&*values.begin(), values.size()), ec);
+
+        get_bytes_written().add(written);
+        return written;
+    }
+
+    // ======================================================================
+    // WRITE (CLASSIFIED)
+    // ======================================================================
+    socket::output_size_type write(
+        output_storage_type const &values
+      , socket::write_class        cls)
+    {
+        switch (cls)
+        {
+            case socket::write_class::interactive :
+                set_cork(false);
+                set_no_delay(true);
+                break;
+
+            case socket::write_class::repaint :
+#if defined(ODIN_NET_CORK_SUPPORTED)
+                set_no_delay(true);
+                set_cork(true);
+#else
+                set_no_delay(false);
+#endif
+                break;
+
+            case socket::write_class::bulk :
+                set_cork(false);
+                set_no_delay(false);
+                break;
+        }
+
+        return write(values);
+    }
+
+    // ======================================================================
+    // FLUSH
+    // ======================================================================
+    void flush()
+    {
+#if defined(ODIN_NET_CORK_SUPPORTED)
+        set_cork(false);
+#else
+        // Enabling TCP_NODELAY pushes out anything that Nagle's algorithm
+        // was holding back.
+        set_no_delay(true);
+#endif
     }
 
     // ======================================================================
@@ -225,6 +351,22 @@ struct socket::impl : std::enable_shared_from_this<impl>
         return socket_->get_io_service();
     }
 
+    // ======================================================================
+    // GET_STRAND
+    // ======================================================================
+    boost::asio::strand &get_strand()
+    {
+        return strand_;
+    }
+
+    // ======================================================================
+    // GET_NATIVE_HANDLE
+    // ======================================================================
+    boost::asio::ip::tcp::socket::native_handle_type get_native_handle()
+    {
+        return socket_->native_handle();
+    }
+
     // ======================================================================
     // ON_DEATH
     // ======================================================================
@@ -234,6 +376,40 @@ struct socket::impl : std::enable_shared_from_this<impl>
     }
 
 private :
+    // ======================================================================
+    // SET_NO_DELAY
+    // ======================================================================
+    void set_no_delay(bool enable)
+    {
+        // The options are only changed when they need to be, since each
+        // change is a system call.  They are not known until first set,
+        // as the socket may have been inherited from another process.
+        if (no_delay_ != enable)
+        {
+            boost::system::error_code unused_error_code;
+            socket_->set_option(
+                boost::asio::ip::tcp::no_delay(enable), unused_error_code);
+            no_delay_ = enable;
+        }
+    }
+
+    // ======================================================================
+    // SET_CORK
+    // ======================================================================
+    void set_cork(bool enable)
+    {
+#if defined(ODIN_NET_CORK_SUPPORTED)
+        if (corked_ != enable)
+        {
+            boost::system::error_code unused_error_code;
+            socket_->set_option(cork_option(enable), unused_error_code);
+            corked_ = enable;
+        }
+#else
+        (void)enable;
+#endif
+    }
+
     // ======================================================================
     // READ_REQUEST
     // ======================================================================
@@ -298,12 +474,13 @@ private :
             boost::asio::buffer(
                 &*write_requests_.front().values_.begin(),
                 write_requests_.front().values_.size()),
-            [this](
-                boost::system::error_code const &ec,
-                std::size_t bytes_transferred)
-            {
-                write_complete(ec, bytes_transferred);
-            });
+            strand_.wrap(
+                [this](
+                    boost::system::error_code const &ec,
+                    std::size_t bytes_transferred)
+                {
+                    write_complete(ec, bytes_transferred);
+                }));
     }
 
     // ======================================================================
@@ -320,6 +497,8 @@ private :
 
         if (!error)
         {
+            get_bytes_written().add(bytes_transferred);
+
             if (write_requests_.front().callback_)
             {
                 write_requests_.front().callback_(bytes_transferred);
@@ -363,6 +542,8 @@ private :
             }
             //*/
 
+            get_bytes_read().add(bytes_transferred);
+
             if (bytes_transferred >= read_requests_.front().values_.size())
             {
                 if (read_requests_.front().callback_)
@@ -373,32 +554,57 @@ private :
 
                 read_requests_.pop_front();
 
-                if (!read_requests_.empty())
+                if (!read_requests_.empty() && !on_reads_cancelled_)
                 {
                     boost::asio::async_read(
                         *socket_.get(),
                         boost::asio::buffer(
                             &*read_requests_.front().values_.begin(),
                             read_requests_.front().values_.size()),
-                      [this](
-                          boost::system::error_code const &ec,
-                          std::size_t bytes_transferred)
-                      {
-                          read_complete(ec, bytes_transferred);
-                      });
+                      strand_.wrap(
+                          [this](
+                              boost::system::error_code const &ec,
+                              std::size_t bytes_transferred)
+                          {
+                              read_complete(ec, bytes_transferred);
+                          }));
 
                     read_requests_.front().scheduled_ = true;
                 }
             }
         }
+        else if (error == boost::asio::error::operation_aborted
+              && on_reads_cancelled_)
+        {
+            auto &request = read_requests_.front();
+
+            if (bytes_transferred != 0 && request.callback_)
+            {
+                get_bytes_read().add(bytes_transferred);
+                request.values_.resize(bytes_transferred);
+                request.callback_(request.values_);
+            }
+        }
         else
         {
             close();
         }
+
+        if (on_reads_cancelled_)
+        {
+            auto const on_reads_cancelled = std::move(on_reads_cancelled_);
+            on_reads_cancelled_ = NULL;
+            read_requests_.clear();
+            on_reads_cancelled();
+        }
     }
 
     std::shared_ptr<boost::asio::ip::tcp::socket> socket_;
+    boost::asio::strand                           strand_;
     std::function<void ()>                        on_death_;
+    std::function<void ()>                        on_reads_cancelled_;
+    boost::optional<bool>                         no_delay_;
+    boost::optional<bool>                         corked_;
 
     std::deque<read_request>  read_requests_;
     std::deque<write_request> write_requests_;
@@ -428,6 +634,14 @@ void socket::close()
     pimpl_->close();
 }
 
+// ==========================================================================
+// GET_NATIVE_HANDLE
+// ==========================================================================
+boost::asio::ip::tcp::socket::native_handle_type socket::get_native_handle()
+{
+    return pimpl_->get_native_handle();
+}
+
 // ==========================================================================
 // AVAILABLE
 // ==========================================================================
@@ -454,6 +668,14 @@ void socket::async_read(
     pimpl_->async_read(size, callback);
 }
 
+// ==========================================================================
+// ASYNC_CANCEL_READS
+// ==========================================================================
+void socket::async_cancel_reads(std::function<void ()> const &callback)
+{
+    pimpl_->async_cancel_reads(callback);
+}
+
 // ==========================================================================
 // WRITE
 // ==========================================================================
@@ -462,6 +684,24 @@ socket::output_size_type socket::write(output_storage_type const &values)
     return pimpl_->write(values);
 }
 
+// ==========================================================================
+// WRITE (CLASSIFIED)
+// ==========================================================================
+socket::output_size_type socket::write(
+    output_storage_type const &values
+  , write_class                cls)
+{
+    return pimpl_->write(values, cls);
+}
+
+// ==========================================================================
+// FLUSH
+// ==========================================================================
+void socket::flush()
+{
+    pimpl_->flush();
+}
+
 // ==========================================================================
 // ASYNC_WRITE
 // ==========================================================================
@@ -488,6 +728,14 @@ boost::asio::io_service &socket::get_io_service()
     return pimpl_->get_io_service();
 }
 
+// ==========================================================================
+// GET_STRAND
+// ==========================================================================
+boost::asio::strand &socket::get_strand()
+{
+    return pimpl_->get_strand();
+}
+
 // ==========================================================================
 // ON_DEATH
 // ==========================================================================
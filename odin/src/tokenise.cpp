@@ -25,20 +25,88 @@
 //             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ==========================================================================
 #include "odin/tokenise.hpp"
-#include <boost/algorithm/string/trim.hpp>
 #include <algorithm>
-
-using namespace std;
+#include <cctype>
 
 namespace odin {
 
-pair<string, string> tokenise(string const &text)
+namespace {
+
+// As with boost::trim, anything that std::isspace matches is whitespace,
+// including the line endings that arrive with telnet input.
+bool is_space(char ch)
+{
+    return std::isspace(static_cast<unsigned char>(ch)) != 0;
+}
+
+}
+
+// ==========================================================================
+// TRIM
+// ==========================================================================
+boost::string_view trim(boost::string_view text)
+{
+    while (!text.empty() && is_space(text.front()))
+    {
+        text.remove_prefix(1);
+    }
+
+    while (!text.empty() && is_space(text.back()))
+    {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+// ==========================================================================
+// TOKENISE
+// ==========================================================================
+std::pair<boost::string_view, boost::string_view> tokenise(
+    boost::string_view text)
 {
-    auto space_pos = std::find(text.begin(), text.end(), ' ');
+    text = trim(text);
+
+    if (!text.empty() && text.front() == '"')
+    {
+        text.remove_prefix(1);
+
+        auto const quote = std::min(text.find('"'), text.size());
+        auto const after = std::min(quote + 1, text.size());
 
-    return {
-        boost::algorithm::trim_copy(string(text.begin(), space_pos))
-      , boost::algorithm::trim_copy(string(space_pos, text.end()))};
+        return { text.substr(0, quote), trim(text.substr(after)) };
+    }
+
+    auto const space = std::find_if(text.begin(), text.end(), is_space);
+    auto const length = std::size_t(space - text.begin());
+
+    return { text.substr(0, length), trim(text.substr(length)) };
+}
+
+// ==========================================================================
+// TOKENISER::CONSTRUCTOR
+// ==========================================================================
+tokeniser::tokeniser(boost::string_view text)
+    : rest_(trim(text))
+{
+}
+
+// ==========================================================================
+// TOKENISER::NEXT
+// ==========================================================================
+boost::string_view tokeniser::next()
+{
+    auto const token = tokenise(rest_);
+    rest_ = token.second;
+    return token.first;
+}
+
+// ==========================================================================
+// TOKENISER::REST
+// ==========================================================================
+boost::string_view tokeniser::rest() const
+{
+    return rest_;
 }
 
 }
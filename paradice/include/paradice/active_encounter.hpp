@@ -30,18 +30,41 @@
 #include "paradice/beast.hpp"
 #include "paradice/character.hpp"
 #include "paradice/dice_roll_parser.hpp"
+#include "paradice/export.hpp"
+#include <terminalpp/string.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/random_access_index.hpp>
+#include <boost/optional.hpp>
 #include <boost/variant.hpp>
 #include <deque>
+#include <memory>
 #include <string>
-#include <vector>
 
 namespace paradice {
 
 //* =========================================================================
 /// \brief A structure to represent an active in-game encounter.
+/// \par
+/// Every alteration to the encounter increments its version and is
+/// recorded in a short log of changes.  A view that remembers the version
+/// it last showed can then apply only the changes since that version,
+/// rather than rebuilding itself from the entries.  The functions below
+/// maintain the version and the log, and should be used in preference to
+/// altering the entries directly.
+/// \par
+/// The entries are kept in their order in the encounter, and are also
+/// indexed by their ids, so that an entry can be found, and its position
+/// learned, without searching them all.  Ids are handed out in increasing
+/// order and are never reused within an encounter, even after the entry
+/// that had one is removed.
 //* =========================================================================
 struct active_encounter
 {
+    BOOST_STATIC_CONSTANT(odin::u32, max_changes = 64);
+    BOOST_STATIC_CONSTANT(odin::u32, default_max_rolls = 10);
+
     struct player
     {
         std::weak_ptr<character> character_;
@@ -59,14 +82,90 @@ struct active_encounter
         std::string             annotation_;
         std::deque<dice_result> roll_data_;
         odin::u32               id_;
+
+        // The entry formatted for display.  This is shared by every view
+        // of the encounter, and is replaced whenever the entry changes.
+        std::shared_ptr<terminalpp::string const> text_;
     };
 
-    std::vector<entry> entries_;
+    struct by_id {};
+
+    typedef boost::multi_index_container<
+        entry,
+        boost::multi_index::indexed_by<
+            boost::multi_index::random_access<>,
+            boost::multi_index::ordered_unique<
+                boost::multi_index::tag<by_id>,
+                boost::multi_index::member<entry, odin::u32, &entry::id_>
+            >
+        >
+    > entry_container;
+
+    enum class change_kind
+    {
+        added,
+        removed,
+        moved,
+        annotated,
+        rolled,
+        cleared
+    };
+
+    struct change
+    {
+        change_kind kind_;
+        odin::u32   version_;
+        odin::u32   id_;
+
+        // The index of the entry after the change, or before it if the
+        // entry was removed.
+        odin::u32   index_;
+
+        // For a moved entry, the index that it was moved from.
+        odin::u32   from_index_;
+
+        // For an added, annotated or rolled entry, its new text.
+        std::shared_ptr<terminalpp::string const> text_;
+    };
+
+    active_encounter()
+        : next_id_(1),
+          max_rolls_(default_max_rolls),
+          identity_(0),
+          version_(0)
+    {
+    }
+
+    entry_container    entries_;
+
+    // The id to be given to the next entry added to the encounter.
+    odin::u32          next_id_;
+
+    // The number of its most recent rolls that each entry keeps.
+    odin::u32          max_rolls_;
+
+    // Distinguishes the encounter from other encounters.  A copy of an
+    // encounter has the same identity, so that a view can tell whether a
+    // copy it is given follows on from the one that it already shows.
+    odin::u32          identity_;
+
+    odin::u32          version_;
+    std::deque<change> changes_;
 };
 
+//* =========================================================================
+/// \brief Returns the index of the entry with the given id, if there is
+/// one.
+//* =========================================================================
+PARADICE_EXPORT
+boost::optional<odin::u32> find_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id);
+
 //* =========================================================================
 /// \brief Add a new participant to the encounter.
 //* =========================================================================
+PARADICE_EXPORT
 void add_participant(
     std::shared_ptr<active_encounter> const &enc
   , active_encounter::participant const &part);
@@ -74,6 +173,7 @@ void add_participant(
 //* =========================================================================
 /// \brief Adds a character to the encounter.
 //* =========================================================================
+PARADICE_EXPORT
 void add_character(
     std::shared_ptr<active_encounter> const &enc
   , std::shared_ptr<character> const &ch);
@@ -81,10 +181,57 @@ void add_character(
 //* =========================================================================
 /// \brief Adds a beast (clones it first) to the encounter.
 //* =========================================================================
+PARADICE_EXPORT
 void add_beast(
     std::shared_ptr<active_encounter> const &enc
   , std::shared_ptr<paradice::beast> const &beast);
 
+//* =========================================================================
+/// \brief Removes the participant with the given id from the encounter.
+/// Returns false if there was no such participant.
+//* =========================================================================
+PARADICE_EXPORT
+bool remove_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id);
+
+//* =========================================================================
+/// \brief Removes every participant from the encounter.
+//* =========================================================================
+PARADICE_EXPORT
+void clear_participants(std::shared_ptr<active_encounter> const &enc);
+
+//* =========================================================================
+/// \brief Moves the participant with the given id so that it has the
+/// given index.  Returns false if there was no such participant.
+//* =========================================================================
+PARADICE_EXPORT
+bool move_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id
+  , odin::u32 index);
+
+//* =========================================================================
+/// \brief Sets the annotation of the participant with the given id.
+/// Returns false if there was no such participant.
+//* =========================================================================
+PARADICE_EXPORT
+bool annotate_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id
+  , std::string const &annotation);
+
+//* =========================================================================
+/// \brief Records a roll made by the participant with the given id,
+/// keeping at most the encounter's max_rolls_ of its most recent rolls.
+/// Returns false if there was no such participant.
+//* =========================================================================
+PARADICE_EXPORT
+bool add_roll(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id
+  , dice_result const &result);
+
 }
 
 #endif
@@ -33,6 +33,9 @@ namespace paradice {
 
 PARADICE_COMMAND_DECL(admin_set_password);
 PARADICE_COMMAND_DECL(admin_shutdown);
+PARADICE_COMMAND_DECL(admin_restart);
+PARADICE_COMMAND_DECL(admin_stats);
+PARADICE_COMMAND_DECL(admin_trace);
 
 }
 
@@ -31,6 +31,7 @@
 #include "odin/core.hpp"
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace hugin {
@@ -39,9 +40,11 @@ namespace hugin {
 
 namespace paradice {
     class account;
+    class active_encounter;
     class character;
     class connection;
     class context;
+    class table;
 }
 
 namespace munin {
@@ -58,6 +61,19 @@ class PARADICE_EXPORT client
     : public std::enable_shared_from_this<client>
 {
 public :
+    //* =====================================================================
+    /// \brief What a client was doing, as passed to another process when
+    /// the client is handed over to it.
+    //* =====================================================================
+    struct handover_state
+    {
+        std::string account_name;
+        std::string character_name;
+        std::string face;
+        odin::u16   width  = 0;
+        odin::u16   height = 0;
+    };
+
     //* =====================================================================
     /// \brief Constructor
     //* =====================================================================
@@ -75,6 +91,11 @@ public :
     //* =====================================================================
     void set_connection(std::shared_ptr<connection> const &new_connection);
 
+    //* =====================================================================
+    /// \brief Retrieves the connection that the client is currently using.
+    //* =====================================================================
+    std::shared_ptr<connection> get_connection() const;
+
     //* =====================================================================
     /// \brief Gets the user interface for the client.
     //* =====================================================================
@@ -115,6 +136,56 @@ public :
     //* =====================================================================
     std::shared_ptr<character> get_character() const;
 
+    //* =====================================================================
+    /// \brief Seats the client at a table, showing it that table's
+    /// encounter.  A null table unseats the client.
+    //* =====================================================================
+    void set_table(std::shared_ptr<table> const &tbl);
+
+    //* =====================================================================
+    /// \brief Retrieves the table at which the client is sitting.  This
+    /// may be called from any thread.
+    //* =====================================================================
+    std::shared_ptr<table> get_table() const;
+
+    //* =====================================================================
+    /// \brief Shows a new snapshot of the encounter at the given table.
+    /// This may be called from any thread.  The snapshot is shown from
+    /// within the client's strand, and only if the client is still sitting
+    /// at that table by then; otherwise, it is dropped.
+    //* =====================================================================
+    void on_table_encounter_changed(
+        std::shared_ptr<table>                  const &tbl
+      , std::shared_ptr<active_encounter const> const &enc);
+
+    //* =====================================================================
+    /// \brief Shows or hides the encounter at the given table.  As with
+    /// on_table_encounter_changed, this is dropped if the client has left
+    /// that table.
+    //* =====================================================================
+    void on_table_encounter_visibility_changed(
+        std::shared_ptr<table> const &tbl
+      , bool                          visible);
+
+    //* =====================================================================
+    /// \brief Restores a client that has been handed over from another
+    /// process to the account, character and user interface screen that it
+    /// was using there.  Either or both of the account and character may be
+    /// null if the client had not yet reached that point.
+    //* =====================================================================
+    void restore(
+        std::shared_ptr<account>   const &acc
+      , std::shared_ptr<character> const &ch
+      , std::string                const &face);
+
+    //* =====================================================================
+    /// \brief Retrieves what the client is doing, so that it may be handed
+    /// over to another process.  The callback is called from within the
+    /// client's strand.
+    //* =====================================================================
+    void async_get_handover_state(
+        std::function<void (handover_state const &)> const &callback);
+
     //* =====================================================================
     /// \brief Disconnects the client from the server.
     //* =====================================================================
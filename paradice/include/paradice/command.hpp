@@ -28,6 +28,7 @@
 #define PARADICE_COMMAND_HPP_
 
 #include <boost/shared_ptr.hpp>
+#include <boost/utility/string_view.hpp>
 #include <string>
 
 namespace paradice {
@@ -37,11 +38,15 @@ namespace paradice {
 
 //* =========================================================================
 /// \brief Declare a Paradice command.
+/// \par
+/// The arguments refer to the characters of the command line that was
+/// entered, and are only valid for the duration of the command.  Anything
+/// taken from them that must outlive it must be copied.
 //* =========================================================================
 #define PARADICE_COMMAND_DECL(cmd) \
     void do_##cmd ( \
         std::shared_ptr<context> &ctx \
-      , std::string const        &arguments \
+      , boost::string_view        arguments \
       , std::shared_ptr<client>  &player)
 
 //* =========================================================================
@@ -50,7 +55,7 @@ namespace paradice {
 #define PARADICE_COMMAND_IMPL(cmd) \
     void do_##cmd ( \
         std::shared_ptr<context> &ctx \
-      , std::string const        &arguments \
+      , boost::string_view        arguments \
       , std::shared_ptr<client>  &player)
 
 //* =========================================================================
@@ -0,0 +1,139 @@
+// ==========================================================================
+// Paradice Command Table
+//
+// Copyright (C) 2013 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef PARADICE_COMMAND_TABLE_HPP_
+#define PARADICE_COMMAND_TABLE_HPP_
+
+#include "paradice/export.hpp"
+#include "odin/core.hpp"
+#include <boost/utility/string_view.hpp>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paradice {
+
+class client;
+class context;
+
+//* =========================================================================
+/// \brief A table of commands, built once and then shared by everyone who
+/// dispatches through it.
+/// \par
+/// Commands are found by name without regard to case.  A name may also be
+/// abbreviated to any prefix that matches only one of the commands that
+/// are available to the player, unless the command must be typed in full.
+/// A name that matches a command exactly is never taken as an
+/// abbreviation of another.
+/// \par
+/// The commands are ordered by name when the table is constructed, so that
+/// a name and its abbreviations are found by binary search.  The listing of
+/// the commands available at each privilege level is also prepared then.
+//* =========================================================================
+class PARADICE_EXPORT command_table
+{
+public :
+    typedef std::function<
+        void (
+            std::shared_ptr<context> &ctx
+          , boost::string_view        arguments
+          , std::shared_ptr<client>  &player)
+    > function_type;
+
+    //* =====================================================================
+    /// \brief A command in the table.
+    //* =====================================================================
+    struct command
+    {
+        std::string   name_;
+        function_type function_;
+        odin::u32     admin_level_required_;
+        odin::u32     gm_level_required_;
+
+        // If true, then the command is not found by an abbreviation.
+        bool          in_full_;
+    };
+
+    //* =====================================================================
+    /// \brief The result of finding a name in the table.
+    //* =====================================================================
+    struct match
+    {
+        /// \brief The command found, or null if none was.
+        command const *command_;
+
+        /// \brief True if no command was found because the name was an
+        /// abbreviation of more than one.
+        bool           ambiguous_;
+    };
+
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    command_table(std::initializer_list<command> commands);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~command_table();
+
+    //* =====================================================================
+    /// \brief Finds the command with the given name or abbreviation from
+    /// among those available at the given privilege levels.
+    //* =====================================================================
+    match find(
+        boost::string_view name
+      , odin::u32          admin_level = 0
+      , odin::u32          gm_level = 0) const;
+
+    //* =====================================================================
+    /// \brief Returns the names of the commands available at the given
+    /// privilege levels that the given name abbreviates.
+    //* =====================================================================
+    std::vector<std::string> find_abbreviated(
+        boost::string_view name
+      , odin::u32          admin_level = 0
+      , odin::u32          gm_level = 0) const;
+
+    //* =====================================================================
+    /// \brief Returns the names of the commands available at the given
+    /// privilege levels, in the order in which they were given to the
+    /// table, each followed by a space.
+    //* =====================================================================
+    std::string const &get_listing(
+        odin::u32 admin_level = 0
+      , odin::u32 gm_level = 0) const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+// ==========================================================================
+// Paradice Compression
+//
+// Copyright (C) 2009 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef PARADICE_COMPRESSION_HPP_
+#define PARADICE_COMPRESSION_HPP_
+
+#include "paradice/export.hpp"
+#include "odin/core.hpp"
+#include <chrono>
+#include <memory>
+
+namespace telnetpp { namespace options { namespace mccp {
+    class compressor;
+}}}
+
+namespace paradice {
+
+//* =========================================================================
+/// \brief Settings that govern the memory used by, and the work done by,
+/// compressed connections.
+//* =========================================================================
+struct compression_settings
+{
+    /// \brief The zlib memory level (1-9) of each deflate state.  Lower
+    /// levels use less memory at the cost of compression ratio.
+    odin::s32 memory_level = 8;
+
+    /// \brief The base two logarithm of the zlib window size (9-15).
+    /// Smaller windows use less memory at the cost of compression ratio.
+    odin::s32 window_bits = 15;
+
+    /// \brief The compression level used by a connection producing output
+    /// at or above the high output rate.
+    odin::s32 minimum_level = 1;
+
+    /// \brief The compression level used by a connection producing output
+    /// at or below the low output rate.
+    odin::s32 maximum_level = 6;
+
+    /// \brief The output rate, in bytes per second, below which the
+    /// maximum compression level is used.
+    odin::u32 low_output_rate = 1024;
+
+    /// \brief The output rate, in bytes per second, above which the
+    /// minimum compression level is used.
+    odin::u32 high_output_rate = 32768;
+
+    /// \brief The number of idle deflate states kept by the pool for
+    /// reuse.  States released beyond this are freed.
+    odin::u32 maximum_pooled_states = 16;
+
+    /// \brief How long a connection may go without sending anything before
+    /// its compression is ended and its deflate state released.
+    std::chrono::seconds idle_timeout = std::chrono::seconds(120);
+};
+
+//* =========================================================================
+/// \brief A pool of zlib deflate states shared by all compressed
+/// connections.
+/// \par
+/// A compressor made by the pool only holds a deflate state while it is
+/// compressing.  When compression ends, the state is reset and returned
+/// to the pool so that the next connection to begin compressing can reuse
+/// it without reallocating.  While compressing, each compressor measures
+/// its output rate and chooses a compression level between the minimum
+/// and maximum levels of the pool's settings, so that busy connections
+/// spend less time compressing.
+/// \par
+/// The pool may be used from any thread.
+//* =========================================================================
+class PARADICE_EXPORT compression_pool
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    //* =====================================================================
+    explicit compression_pool(
+        compression_settings const &settings = compression_settings());
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~compression_pool();
+
+    //* =====================================================================
+    /// \brief Returns the settings with which the pool was created.
+    //* =====================================================================
+    compression_settings const &get_settings() const;
+
+    //* =====================================================================
+    /// \brief Creates an MCCP compressor that draws its deflate state from
+    /// this pool.
+    //* =====================================================================
+    std::shared_ptr<telnetpp::options::mccp::compressor> make_compressor();
+
+    //* =====================================================================
+    /// \brief Returns the number of deflate states currently in use by
+    /// compressors.
+    //* =====================================================================
+    odin::u32 get_number_of_active_states() const;
+
+    //* =====================================================================
+    /// \brief Returns the number of idle deflate states held for reuse.
+    //* =====================================================================
+    odin::u32 get_number_of_pooled_states() const;
+
+private :
+    class compressor;
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}
+
+#endif
@@ -32,6 +32,8 @@
 #include <terminalpp/ansi/control_sequence.hpp>
 #include <terminalpp/ansi/mouse.hpp>
 #include <terminalpp/virtual_key.hpp>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -43,6 +45,9 @@ namespace odin { namespace net {
 
 namespace paradice {
 
+class compression_pool;
+class idle_sweeper;
+
 //* =========================================================================
 /// \brief An connection to a socket that abstracts away details about the
 /// protocols used.
@@ -50,12 +55,66 @@ namespace paradice {
 class PARADICE_EXPORT connection
 {
 public :
+    //* =====================================================================
+    /// \brief The class of a write, which determines how urgently it is
+    /// transmitted.
+    //* =====================================================================
+    enum class write_class
+    {
+        /// \brief The echo of something typed, which is sent at once.
+        interactive,
+
+        /// \brief A repaint, which is sent in as few segments as possible.
+        repaint,
+
+        /// \brief Negotiation and other traffic that is not waited upon,
+        /// which may be coalesced with the writes that follow it.
+        bulk
+    };
+
+    //* =====================================================================
+    /// \brief The state of the telnet options on a connection, which is
+    /// carried with the connection when it is handed over to another
+    /// process.
+    //* =====================================================================
+    struct telnet_state
+    {
+        bool        echo          = false;
+        bool        suppress_ga   = false;
+        bool        naws          = false;
+        bool        terminal_type = false;
+        bool        mccp          = false;
+        std::string terminal_type_name;
+
+        // Anything the client sent after reading stopped for the handover,
+        // which the next process handles before reading anything else.
+        std::vector<odin::u8> unread_input;
+    };
+
     //* =====================================================================
     /// \brief Create a connection object that uses the passed socket as
     /// a communications point, and calls the passed function whenever data
-    /// is received.
+    /// is received.  Compressed output uses deflate states drawn from the
+    /// passed pool.  Once started, keepalives are sent to the connection,
+    /// and it is disconnected when idle, by the passed sweeper; these are
+    /// carried out on the socket's strand, which the connection shares.
+    //* =====================================================================
+    connection(
+        std::shared_ptr<odin::net::socket> const &socket
+      , std::shared_ptr<compression_pool>  const &compression
+      , std::shared_ptr<idle_sweeper>      const &sweeper);
+
     //* =====================================================================
-    connection(std::shared_ptr<odin::net::socket> const &socket);
+    /// \brief Create a connection object for a socket that has been handed
+    /// over from another process.  Rather than negotiating its options
+    /// afresh, the connection takes them from the passed state, and begins
+    /// a new compressed stream if compression was active.
+    //* =====================================================================
+    connection(
+        std::shared_ptr<odin::net::socket> const &socket
+      , std::shared_ptr<compression_pool>  const &compression
+      , std::shared_ptr<idle_sweeper>      const &sweeper
+      , telnet_state                       const &state);
 
     //* =====================================================================
     /// \brief Destructor.
@@ -69,9 +128,13 @@ public :
     void start();
 
     //* =====================================================================
-    /// \brief Writes data to the connection.
+    /// \brief Writes data to the connection.  The write is carried out on
+    /// the connection's strand, in the order in which writes are made, and
+    /// the callbacks below are also called from within that strand.
     //* =====================================================================
-    void write(std::string const &data);
+    void write(
+        std::string const &data
+      , write_class        cls = write_class::repaint);
 
     //* =====================================================================
     /// \brief Set a function to be called when data arrives from the
@@ -88,12 +151,23 @@ public :
 
     //* =====================================================================
     /// \brief Set up a callback to be called when the underlying socket
-    /// dies.
+    /// dies.  This replaces any earlier callback.  If the socket has
+    /// already died by the time the callback is set up, it is called then,
+    /// so that a death that falls between two callbacks is not lost.
     //* =====================================================================
     void on_socket_death(std::function<void ()> const &callback);
 
     //* =====================================================================
-    /// \brief Disconnects the socket.
+    /// \brief Set up a callback to be called with the time remaining when
+    /// the connection is about to be disconnected for being idle.
+    //* =====================================================================
+    void on_idle_warning(
+        std::function<void (std::chrono::seconds)> const &callback);
+
+    //* =====================================================================
+    /// \brief Disconnects the socket.  This is carried out on the
+    /// connection's strand once any earlier writes have been sent, after
+    /// which nothing more is written.
     //* =====================================================================
     void disconnect();
 
@@ -103,6 +177,22 @@ public :
     void async_get_terminal_type(
         std::function<void (std::string const &)> const &callback);
 
+    //* =====================================================================
+    /// \brief Prepares the connection to be handed over to another process.
+    /// From within the connection's strand, reading from the socket is
+    /// stopped, any compressed stream is ended and nothing further is
+    /// written to the connection.  The callback is then called, from within
+    /// that strand, with the state of its telnet options, including any
+    /// input that arrived while reading was being stopped, and the socket
+    /// to hand over.  If the socket has already died or been handed over,
+    /// the socket passed is null.
+    //* =====================================================================
+    void async_prepare_handover(
+        std::function<
+            void (telnet_state const &,
+                  std::shared_ptr<odin::net::socket> const &)
+        > const &callback);
+
 private :
     struct impl;
     std::shared_ptr<impl> pimpl_;
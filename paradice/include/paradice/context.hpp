@@ -28,6 +28,7 @@
 #define PARADICE_CONTEXT_HPP_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace paradice {
@@ -35,8 +36,8 @@ namespace paradice {
 class account;
 class character;
 class client;
-
-struct active_encounter;
+class help_corpus;
+class table;
 
 //* =========================================================================
 /// \brief Describes the interface for a context in which a Paradice server
@@ -110,31 +111,47 @@ public :
     virtual void shutdown() = 0;
 
     //* =====================================================================
-    /// \brief Gets the currently active encounter
+    /// \brief Enacts a server restart, in which the listening sockets and
+    /// clients are handed over to a new server process.
+    /// \throws std::exception if the restart could not be begun, in which
+    ///         case the server carries on as before.
+    //* =====================================================================
+    virtual void restart() = 0;
+
+    //* =====================================================================
+    /// \brief Returns the table with the given name, setting it up first
+    /// if there is no such table yet.
     //* =====================================================================
-    virtual std::shared_ptr<paradice::active_encounter> get_active_encounter() = 0;
+    virtual std::shared_ptr<table> get_table(std::string const &name) = 0;
 
     //* =====================================================================
-    /// \brief Sets the currently active encounter
+    /// \brief Returns all of the tables that have been set up.
     //* =====================================================================
-    virtual void set_active_encounter(
-        std::shared_ptr<paradice::active_encounter> const &enc) = 0;
+    virtual std::vector<std::shared_ptr<table>> get_tables() = 0;
 
     //* =====================================================================
-    /// \brief Gets the visibility of the encounter.
+    /// \brief Seats the client at the table with the given name, setting
+    /// the table up first if there is no such table yet.  There can be only
+    /// one GM at each table, so a GM is not seated at a table that already
+    /// has one; the check and the seating are made together.  Returns the
+    /// table at which the client was seated, or null if it was not.
+    /// \par
+    /// Any table left empty, other than the default table, is removed.
     //* =====================================================================
-    virtual bool is_active_encounter_visible() const = 0;
+    virtual std::shared_ptr<table> seat_client(
+        std::shared_ptr<client> const &cli
+      , std::string const             &name) = 0;
 
     //* =====================================================================
-    /// \brief Sets the visibility of the encounter for all players.
+    /// \brief Unseats the client from its table, removing the table if it
+    /// is left empty and is not the default table.
     //* =====================================================================
-    virtual void set_active_encounter_visible(bool visibility) = 0;
+    virtual void unseat_client(std::shared_ptr<client> const &cli) = 0;
 
     //* =====================================================================
-    /// \brief Informs the context that changes have been made to the
-    /// active encounter and that any related views should be updated.
+    /// \brief Returns the help that is available to players.
     //* =====================================================================
-    virtual void update_active_encounter() = 0;
+    virtual std::shared_ptr<help_corpus const> get_help() = 0;
 };
 
 }
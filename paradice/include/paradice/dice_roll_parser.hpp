@@ -47,6 +47,15 @@ boost::optional<dice_roll> parse_dice_roll(
     std::string::const_iterator &begin
   , std::string::const_iterator  end);
 
+//* =========================================================================
+/// \brief Parses a string (bounded by the two pointers) into a dice_roll,
+/// as above.
+//* =========================================================================
+PARADICE_EXPORT
+boost::optional<dice_roll> parse_dice_roll(
+    char const *&begin
+  , char const  *end);
+
 }
 
 #endif
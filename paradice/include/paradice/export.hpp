@@ -0,0 +1,42 @@
+
+#ifndef PARADICE_EXPORT_H
+#define PARADICE_EXPORT_H
+
+#ifdef PARADICE_STATIC_DEFINE
+#  define PARADICE_EXPORT
+#  define PARADICE_NO_EXPORT
+#else
+#  ifndef PARADICE_EXPORT
+#    ifdef paradice_EXPORTS
+        /* We are building this library */
+#      define PARADICE_EXPORT 
+#    else
+        /* We are using this library */
+#      define PARADICE_EXPORT 
+#    endif
+#  endif
+
+#  ifndef PARADICE_NO_EXPORT
+#    define PARADICE_NO_EXPORT 
+#  endif
+#endif
+
+#ifndef PARADICE_DEPRECATED
+#  define PARADICE_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef PARADICE_DEPRECATED_EXPORT
+#  define PARADICE_DEPRECATED_EXPORT PARADICE_EXPORT PARADICE_DEPRECATED
+#endif
+
+#ifndef PARADICE_DEPRECATED_NO_EXPORT
+#  define PARADICE_DEPRECATED_NO_EXPORT PARADICE_NO_EXPORT PARADICE_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef PARADICE_NO_DEPRECATED
+#    define PARADICE_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* PARADICE_EXPORT_H */
@@ -26,9 +26,27 @@
 #define PARADICE_HELP_HPP_
 
 #include "command.hpp"
+#include "paradice/export.hpp"
+#include <memory>
+#include <string>
 
 namespace paradice {
 
+class help_corpus;
+
+//* =========================================================================
+/// \brief Returns the help on each of the commands, together with a topic
+/// for each of the files in the given directory, if there is one.
+/// \par
+/// A topic read from a file is named after the file, without its
+/// extension, and replaces the help on any command of that name.
+/// \throws std::runtime_error if the directory or its files could not be
+///         read.
+//* =========================================================================
+PARADICE_EXPORT
+std::shared_ptr<help_corpus const> make_help_corpus(
+    std::string const &directory = std::string());
+
 PARADICE_COMMAND_DECL(help);
 
 }
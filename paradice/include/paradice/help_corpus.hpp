@@ -0,0 +1,113 @@
+// ==========================================================================
+// Paradice Help Corpus
+//
+// Copyright (C) 2013 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef PARADICE_HELP_CORPUS_HPP_
+#define PARADICE_HELP_CORPUS_HPP_
+
+#include "paradice/export.hpp"
+#include "terminalpp/string.hpp"
+#include <boost/utility/string_view.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paradice {
+
+//* =========================================================================
+/// \brief A subject on which help is available.
+//* =========================================================================
+struct help_topic
+{
+    /// \brief The names by which the topic is found.  The first is the
+    /// name under which it appears in search results.
+    std::vector<std::string> names_;
+
+    /// \brief The text of the topic, in the form accepted by
+    /// terminalpp::encode.
+    std::string              text_;
+};
+
+//* =========================================================================
+/// \brief The help that is available to players, built once and then
+/// shared by everyone who reads it.
+/// \par
+/// Each topic is encoded into a page when the corpus is constructed, so
+/// that showing a topic need only hand that page to the help window.
+/// Topics are found by name without regard to case.  If more than one
+/// topic has the same name, then the first of them is found.
+/// \par
+/// The words of every topic are also gathered then into an index, so that
+/// topics can be searched for by the words they contain.
+//* =========================================================================
+class PARADICE_EXPORT help_corpus
+{
+public :
+    typedef std::shared_ptr<terminalpp::string const> page_type;
+
+    //* =====================================================================
+    /// \brief Constructor
+    /// \param topics the topics in the corpus, in the order in which they
+    ///        are listed.
+    /// \param header text that begins every page.
+    //* =====================================================================
+    help_corpus(
+        std::vector<help_topic> const &topics
+      , std::string const             &header);
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~help_corpus();
+
+    //* =====================================================================
+    /// \brief Returns the page of the topic with the given name, or an
+    /// empty page_type if there is no such topic.
+    //* =====================================================================
+    page_type find(boost::string_view name) const;
+
+    //* =====================================================================
+    /// \brief Returns a page that lists the names of every topic.
+    //* =====================================================================
+    page_type get_index() const;
+
+    //* =====================================================================
+    /// \brief Returns the names of the topics that contain every one of
+    /// the given words, in the order in which the topics are listed.
+    /// \par
+    /// Words are runs of letters and digits, and are compared without
+    /// regard to case.  A word matches any word that begins with it, so
+    /// that "enc" finds topics that mention encounters.
+    //* =====================================================================
+    std::vector<std::string> search(boost::string_view words) const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}
+
+#endif
@@ -0,0 +1,185 @@
+// ==========================================================================
+// Paradice Idle Sweeper
+//
+// Copyright (C) 2009 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef PARADICE_IDLE_SWEEPER_HPP_
+#define PARADICE_IDLE_SWEEPER_HPP_
+
+#include "paradice/export.hpp"
+#include "odin/core.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace boost { namespace asio {
+    class io_service;
+}}
+
+namespace paradice {
+
+//* =========================================================================
+/// \brief Settings that govern keepalives and the disconnection of idle
+/// sessions.
+//* =========================================================================
+struct idle_settings
+{
+    /// \brief How often the sweeper examines its sessions.  Keepalives,
+    /// warnings and disconnections happen up to this long after they fall
+    /// due.
+    std::chrono::milliseconds sweep_interval = std::chrono::seconds(1);
+
+    /// \brief How long a session may go without any output before a
+    /// keepalive is sent to it.
+    std::chrono::milliseconds keepalive_interval = std::chrono::seconds(30);
+
+    /// \brief How long a session may go without any input before it is
+    /// disconnected.  A value of 0 means that sessions are never
+    /// disconnected for being idle.
+    std::chrono::milliseconds idle_timeout = std::chrono::seconds(0);
+
+    /// \brief How long before being disconnected for being idle that a
+    /// session is warned.
+    std::chrono::milliseconds idle_warning = std::chrono::seconds(60);
+};
+
+//* =========================================================================
+/// \brief Sends keepalives to, and disconnects, the idle sessions of an
+/// io_service.
+/// \par
+/// Rather than each session keeping its own timer, a single sweeper runs
+/// on its io_service once every sweep interval, which is by default once a
+/// second.  Sessions are kept in buckets according
+/// to when they next need attention, so each sweep only examines the
+/// sessions in the bucket that has come due.  A session is sent a
+/// keepalive only if nothing else has been sent to it recently.
+/// \par
+/// Sessions note their input and output on the session object returned
+/// by add_session, which may be done from any thread.  The callbacks are
+/// called from within the sweeper's io_service, on whichever of its
+/// threads runs the sweep, so a session that confines its state to a
+/// strand must post the work onto that strand itself.  A session is removed
+/// when the last copy of its session object is destroyed.
+//* =========================================================================
+class PARADICE_EXPORT idle_sweeper
+{
+public :
+    //* =====================================================================
+    /// \brief A session, as seen by the sweeper.
+    //* =====================================================================
+    class session;
+
+    //* =====================================================================
+    /// \brief Counts of the sweeper's sessions and what it has done to
+    /// them.
+    //* =====================================================================
+    struct statistics
+    {
+        /// \brief The number of sessions currently known to the sweeper.
+        odin::u32 sessions = 0;
+
+        /// \brief The number of sessions that have received no input for
+        /// at least the keepalive interval.
+        odin::u32 idle = 0;
+
+        /// \brief The number of keepalives sent.
+        odin::u64 keepalives = 0;
+
+        /// \brief The number of sessions warned that they were about to
+        /// be disconnected.
+        odin::u32 warned = 0;
+
+        /// \brief The number of sessions disconnected for being idle.
+        odin::u32 evicted = 0;
+    };
+
+    //* =====================================================================
+    /// \brief Constructor
+    /// \throws std::invalid_argument if the sweep or keepalive interval is
+    ///         not positive, or if there is an idle timeout and the warning
+    ///         is not shorter than it.
+    //* =====================================================================
+    idle_sweeper(
+        boost::asio::io_service &io_service
+      , idle_settings const     &settings = idle_settings());
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~idle_sweeper();
+
+    //* =====================================================================
+    /// \brief Adds a session to the sweeper.
+    /// \param send_keepalive called when the session needs a keepalive.
+    /// \param warn called with the time remaining before the session is
+    ///        disconnected for being idle.
+    /// \param evict called when the session should be disconnected.
+    //* =====================================================================
+    std::shared_ptr<session> add_session(
+        std::function<void ()>                     const &send_keepalive
+      , std::function<void (std::chrono::seconds)> const &warn
+      , std::function<void ()>                     const &evict);
+
+    //* =====================================================================
+    /// \brief Returns counts of the sweeper's sessions and what it has
+    /// done to them.
+    //* =====================================================================
+    statistics get_statistics() const;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief A session, as seen by an idle_sweeper.
+//* =========================================================================
+class PARADICE_EXPORT idle_sweeper::session
+{
+public :
+    //* =====================================================================
+    /// \brief Notes that input has been received from the session.
+    //* =====================================================================
+    void note_input();
+
+    //* =====================================================================
+    /// \brief Notes that output has been sent to the session.
+    //* =====================================================================
+    void note_output();
+
+private :
+    friend struct idle_sweeper::impl;
+
+    session(
+        std::function<void ()>                     const &send_keepalive
+      , std::function<void (std::chrono::seconds)> const &warn
+      , std::function<void ()>                     const &evict);
+
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+}
+
+#endif
@@ -0,0 +1,178 @@
+// ==========================================================================
+// Paradice Table
+//
+// Copyright (C) 2013 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#ifndef PARADICE_TABLE_HPP_
+#define PARADICE_TABLE_HPP_
+
+#include "paradice/active_encounter.hpp"
+#include "paradice/command.hpp"
+#include "paradice/export.hpp"
+#include "paradice/rules.hpp"
+#include "odin/core.hpp"
+#include "odin/signal.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace boost { namespace asio {
+    class io_service;
+}}
+
+namespace paradice {
+
+//* =========================================================================
+/// \brief The name of the table at which players are seated when they
+/// first enter the game.
+//* =========================================================================
+char const DEFAULT_TABLE_NAME[] = "main";
+
+//* =========================================================================
+/// \brief Settings that govern the tables at which players sit.
+//* =========================================================================
+struct table_settings
+{
+    /// \brief The number of its most recent rolls that each participant in
+    /// a table's encounter keeps.
+    odin::u32 max_encounter_rolls = active_encounter::default_max_rolls;
+};
+
+//* =========================================================================
+/// \brief A table at which a group plays: its GM, its players, and the
+/// encounter and roll categories that belong to them.
+/// \par
+/// The table's encounter is confined to the table's strand.  It is only
+/// ever altered by functions passed to modify_encounter(), which are run
+/// there one at a time.  After each alteration, an immutable snapshot of
+/// the encounter is published, and it is these snapshots that are read by
+/// everything else, on whichever thread it runs.
+//* =========================================================================
+class PARADICE_EXPORT table
+    : public std::enable_shared_from_this<table>
+{
+public :
+    //* =====================================================================
+    /// \brief Constructor
+    /// \param io_service the io_service on which the table's strand runs.
+    /// \param name the name by which players find the table.
+    /// \param settings the settings for the table.
+    //* =====================================================================
+    table(
+        boost::asio::io_service &io_service
+      , std::string const       &name
+      , table_settings const    &settings = table_settings());
+
+    //* =====================================================================
+    /// \brief Destructor
+    //* =====================================================================
+    ~table();
+
+    //* =====================================================================
+    /// \brief Returns the name of the table.
+    //* =====================================================================
+    std::string get_name() const;
+
+    //* =====================================================================
+    /// \brief Runs the passed function on the table's strand with the
+    /// table's encounter, which it may alter.  If it does, then a new
+    /// snapshot is published and on_encounter_changed is emitted.
+    //* =====================================================================
+    void modify_encounter(
+        std::function<
+            void (std::shared_ptr<active_encounter> const &)
+        > const &fn);
+
+    //* =====================================================================
+    /// \brief Returns the most recently published snapshot of the
+    /// encounter.
+    //* =====================================================================
+    std::shared_ptr<active_encounter const> get_encounter() const;
+
+    //* =====================================================================
+    /// \brief Sets whether the encounter is shown to the players at the
+    /// table.
+    //* =====================================================================
+    void set_encounter_visible(bool visible);
+
+    //* =====================================================================
+    /// \brief Returns whether the encounter is shown to the players at the
+    /// table.
+    //* =====================================================================
+    bool is_encounter_visible() const;
+
+    //* =====================================================================
+    /// \brief Adds a roll to the given category.
+    //* =====================================================================
+    void add_roll(std::string const &category, roll_data const &data);
+
+    //* =====================================================================
+    /// \brief Returns the rolls in the given category, in the order in
+    /// which they were made.
+    //* =====================================================================
+    std::vector<roll_data> get_rolls(std::string const &category) const;
+
+    //* =====================================================================
+    /// \brief Removes all of the rolls in the given category.
+    //* =====================================================================
+    void clear_rolls(std::string const &category);
+
+    //* =====================================================================
+    /// \fn on_encounter_changed
+    /// \brief Emitted on the table's strand after a snapshot of an altered
+    /// encounter has been published.
+    //* =====================================================================
+    odin::signal<
+        void (std::shared_ptr<active_encounter const> const &)
+    > on_encounter_changed;
+
+    //* =====================================================================
+    /// \fn on_encounter_visibility_changed
+    /// \brief Emitted on the table's strand after the encounter has been
+    /// shown or hidden.
+    //* =====================================================================
+    odin::signal<
+        void (bool visible)
+    > on_encounter_visibility_changed;
+
+private :
+    struct impl;
+    std::shared_ptr<impl> pimpl_;
+};
+
+//* =========================================================================
+/// \brief Returns the client of the GM who is sitting at the given table,
+/// or null if there is none.
+//* =========================================================================
+PARADICE_EXPORT
+std::shared_ptr<client> find_gm(
+    std::shared_ptr<context> const &ctx
+  , std::shared_ptr<table>   const &tbl);
+
+PARADICE_COMMAND_DECL(table);
+
+}
+
+#endif
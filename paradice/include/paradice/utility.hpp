@@ -27,7 +27,7 @@
 #ifndef PARADICE_UTILITY_HPP_
 #define PARADICE_UTILITY_HPP_
 
-#include <string>
+#include <boost/utility/string_view.hpp>
 
 namespace paradice {
 
@@ -35,7 +35,7 @@ namespace paradice {
 /// \brief Returns true if lhs is case-insensitively equal to rhs, false
 /// otherwise.
 //* =========================================================================
-bool is_iequal(std::string const &lhs, std::string const &rhs);
+bool is_iequal(boost::string_view lhs, boost::string_view rhs);
 
 }
 
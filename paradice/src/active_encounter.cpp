@@ -26,31 +26,161 @@
 // ==========================================================================
 #include "paradice/active_encounter.hpp"
 #include "paradice/beast.hpp"
+#include <terminalpp/encoder.hpp>
+#include <boost/format.hpp>
 #include <algorithm>
+#include <numeric>
 
 namespace paradice {
 
+namespace {
+
 // ==========================================================================
-// ADD_PARTICIPANT
+// PARTICIPANT_NAME_VISITOR
 // ==========================================================================
-void add_participant(
+struct participant_name_visitor : boost::static_visitor<std::string>
+{
+    std::string operator()(active_encounter::player const &ply) const
+    {
+        std::shared_ptr<character> ch = ply.character_.lock();
+
+        if (ch)
+        {
+            return ch->get_name();
+        }
+        else
+        {
+            return ply.name_;
+        }
+    }
+
+    std::string operator()(std::shared_ptr<beast> const &bst) const
+    {
+        return bst->get_name();
+    }
+};
+
+// ==========================================================================
+// DESCRIBE_ENTRY
+// ==========================================================================
+std::shared_ptr<terminalpp::string const> describe_entry(
+    active_encounter::entry const &entry)
+{
+    participant_name_visitor name_visitor;
+    std::string name = boost::apply_visitor(name_visitor, entry.participant_);
+    std::string text = boost::str(boost::format("(%d)") % entry.id_)
+         + " "
+         + name;
+
+    if (!entry.annotation_.empty())
+    {
+        text += boost::str(boost::format(" [%s]") % entry.annotation_);
+    }
+
+    if (!entry.roll_data_.empty())
+    {
+        auto const &last_roll = entry.roll_data_.back();
+        odin::s32 total_score = 0;
+
+        for (auto const &repetition : last_roll.results_)
+        {
+            using std::begin;
+            using std::end;
+
+            total_score += std::accumulate(
+                begin(repetition),
+                end(repetition),
+                last_roll.roll_.bonus_);
+        }
+
+        text += boost::str(
+            boost::format(" | %s -> %d")
+                % describe_dice(last_roll.roll_)
+                % total_score);
+    }
+
+    return std::make_shared<terminalpp::string const>(
+        terminalpp::encode(text));
+}
+
+// ==========================================================================
+// RECORD_CHANGE
+// ==========================================================================
+void record_change(
     std::shared_ptr<active_encounter> const &enc
-  , active_encounter::participant const &part)
+  , active_encounter::change_kind kind
+  , odin::u32 id
+  , odin::u32 index
+  , odin::u32 from_index = 0
+  , std::shared_ptr<terminalpp::string const> const &text = {})
 {
-    // First, find the maximum ID currently used in the encounter.
-    odin::u32 max_id = 0;
+    active_encounter::change chg;
+    chg.kind_       = kind;
+    chg.version_    = ++enc->version_;
+    chg.id_         = id;
+    chg.index_      = index;
+    chg.from_index_ = from_index;
+    chg.text_       = text;
 
-    for (auto const &ent : enc->entries_)
+    enc->changes_.push_back(chg);
+
+    if (enc->changes_.size() > active_encounter::max_changes)
+    {
+        enc->changes_.pop_front();
+    }
+}
+
+// ==========================================================================
+// FIND_ENTRY
+// ==========================================================================
+active_encounter::entry_container::iterator find_entry(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id)
+{
+    auto const &by_id = enc->entries_.get<active_encounter::by_id>();
+    return enc->entries_.project<0>(by_id.find(id));
+}
+
+}
+
+// ==========================================================================
+// FIND_PARTICIPANT
+// ==========================================================================
+boost::optional<odin::u32> find_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id)
+{
+    auto const entry = find_entry(enc, id);
+
+    if (entry == enc->entries_.end())
     {
-        max_id = (std::max)(ent.id_, max_id);
+        return {};
     }
 
-    // The next ID should be one higher than the maximum ID.
+    return odin::u32(entry - enc->entries_.begin());
+}
+
+// ==========================================================================
+// ADD_PARTICIPANT
+// ==========================================================================
+void add_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , active_encounter::participant const &part)
+{
     active_encounter::entry new_entry;
-    new_entry.id_ = max_id + 1;
+    new_entry.id_ = enc->next_id_++;
     new_entry.participant_ = part;
+    new_entry.text_ = describe_entry(new_entry);
 
     enc->entries_.push_back(new_entry);
+
+    record_change(
+        enc
+      , active_encounter::change_kind::added
+      , new_entry.id_
+      , odin::u32(enc->entries_.size() - 1)
+      , 0
+      , new_entry.text_);
 }
 
 // ==========================================================================
@@ -83,4 +213,144 @@ void add_beast(
     add_participant(enc, cloned_beast);
 }
 
+// ==========================================================================
+// REMOVE_PARTICIPANT
+// ==========================================================================
+bool remove_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id)
+{
+    auto const entry = find_entry(enc, id);
+
+    if (entry == enc->entries_.end())
+    {
+        return false;
+    }
+
+    auto const index = odin::u32(entry - enc->entries_.begin());
+    enc->entries_.erase(entry);
+
+    record_change(enc, active_encounter::change_kind::removed, id, index);
+    return true;
+}
+
+// ==========================================================================
+// CLEAR_PARTICIPANTS
+// ==========================================================================
+void clear_participants(std::shared_ptr<active_encounter> const &enc)
+{
+    enc->entries_.clear();
+    record_change(enc, active_encounter::change_kind::cleared, 0, 0);
+}
+
+// ==========================================================================
+// MOVE_PARTICIPANT
+// ==========================================================================
+bool move_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id
+  , odin::u32 index)
+{
+    auto const entry = find_entry(enc, id);
+
+    if (entry == enc->entries_.end())
+    {
+        return false;
+    }
+
+    auto const begin      = enc->entries_.begin();
+    auto const from_index = odin::u32(entry - begin);
+
+    index = (std::min)(index, odin::u32(enc->entries_.size() - 1));
+
+    if (index == from_index)
+    {
+        return true;
+    }
+
+    // Relocation places the entry before the given position, which is one
+    // further along when the entry moves towards the end.
+    enc->entries_.relocate(
+        begin + (index < from_index ? index : index + 1)
+      , entry);
+
+    record_change(
+        enc, active_encounter::change_kind::moved, id, index, from_index);
+    return true;
+}
+
+// ==========================================================================
+// ANNOTATE_PARTICIPANT
+// ==========================================================================
+bool annotate_participant(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id
+  , std::string const &annotation)
+{
+    auto const entry = find_entry(enc, id);
+
+    if (entry == enc->entries_.end())
+    {
+        return false;
+    }
+
+    enc->entries_.modify(
+        entry
+      , [&annotation](auto &ent)
+        {
+            ent.annotation_ = annotation;
+            ent.text_ = describe_entry(ent);
+        });
+
+    record_change(
+        enc
+      , active_encounter::change_kind::annotated
+      , id
+      , odin::u32(entry - enc->entries_.begin())
+      , 0
+      , entry->text_);
+    return true;
+}
+
+// ==========================================================================
+// ADD_ROLL
+// ==========================================================================
+bool add_roll(
+    std::shared_ptr<active_encounter> const &enc
+  , odin::u32 id
+  , dice_result const &result)
+{
+    auto const entry = find_entry(enc, id);
+
+    if (entry == enc->entries_.end())
+    {
+        return false;
+    }
+
+    auto const max_rolls = enc->max_rolls_;
+
+    enc->entries_.modify(
+        entry
+      , [&result, max_rolls](auto &ent)
+        {
+            ent.roll_data_.push_back(result);
+
+            while (ent.roll_data_.size() > max_rolls)
+            {
+                ent.roll_data_.pop_front();
+            }
+
+            ent.text_ = describe_entry(ent);
+        });
+
+    record_change(
+        enc
+      , active_encounter::change_kind::rolled
+      , id
+      , odin::u32(entry - enc->entries_.begin())
+      , 0
+      , entry->text_);
+    return true;
+}
+
 }
\ No newline at end of file
@@ -32,11 +32,14 @@
 #include "paradice/connection.hpp"
 #include "paradice/context.hpp"
 #include "paradice/who.hpp"
+#include "odin/flight_recorder.hpp"
+#include "odin/metrics.hpp"
 #include "odin/tokenise.hpp"
 #include <terminalpp/string.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/format.hpp>
 #include <cstdio>
+#include <sstream>
 
 namespace paradice {
 
@@ -56,6 +59,43 @@ static void capitalise(std::string &name)
     }
 }
 
+// ==========================================================================
+// SAVE_CHARACTERS
+// ==========================================================================
+static bool save_characters(
+    std::shared_ptr<context> &ctx
+  , std::shared_ptr<client>  &player)
+{
+    for (auto current_client : ctx->get_clients())
+    {
+        auto ch = current_client->get_character();
+
+        if (ch != NULL)
+        {
+            try
+            {
+                ctx->save_character(ch);
+            }
+            catch(std::exception &ex)
+            {
+                std::printf("Error saving character %s: %s\n",
+                    ch->get_name().c_str(), ex.what());
+
+                send_to_player(
+                    ctx
+                  , terminalpp::string(boost::str(boost::format(
+                        "\\[1Error saving character: %s.")
+                            % ch->get_name()))
+                  , player);
+
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 // ==========================================================================
 // PARADICE COMMAND: ADMIN_SET_PASSWORD
 // ==========================================================================
@@ -66,17 +106,17 @@ PARADICE_COMMAND_IMPL(admin_set_password)
         "\n EXAMPLE:  admin_set_password bob foobar foobar"
         "\n\n";
 
-    auto token0 = odin::tokenise(arguments);
-    auto token1 = odin::tokenise(token0.second);
-    auto token2 = odin::tokenise(token1.second);
+    odin::tokeniser tokens(arguments);
+    auto account_name = tokens.next().to_string();
+    auto password = tokens.next().to_string();
+    auto password_verify = tokens.next().to_string();
 
-    if (token0.first.empty() || token1.first.empty() || token2.first.empty())
+    if (account_name.empty() || password.empty() || password_verify.empty())
     {
         send_to_player(ctx, usage, player);
         return;
     }
 
-    auto account_name = token0.first;
     capitalise(account_name);
 
     std::shared_ptr<account> account;
@@ -103,9 +143,6 @@ PARADICE_COMMAND_IMPL(admin_set_password)
         return;
     }
 
-    auto password = token1.first;
-    auto password_verify = token2.first;
-
     if (password != password_verify)
     {
         send_to_player(ctx, "Passwords did not match.\n", player);
@@ -150,39 +187,110 @@ PARADICE_COMMAND_IMPL(admin_shutdown)
         return;
     }
 
-    // For each client, save its character (if possible), then close its
-    // socket.
+    // Save each client's character (if possible), then close their
+    // sockets.
+    if (!save_characters(ctx, player))
+    {
+        return;
+    }
+
     for (auto current_client : ctx->get_clients())
     {
-        auto ch = current_client->get_character();
+        current_client->disconnect();
+    }
 
-        if (ch != NULL)
-        {
-            try
-            {
-                ctx->save_character(ch);
-            }
-            catch(std::exception &ex)
-            {
-                std::printf("Error saving character %s: %s\n",
-                    ch->get_name().c_str(), ex.what());
+    // shutdown
+    ctx->shutdown();
+}
 
-                send_to_player(
-                    ctx
-                  , terminalpp::string(boost::str(boost::format(
-                        "\\[1Error saving character: %s.")
-                            % ch->get_name()))
-                  , player);
+// ==========================================================================
+// PARADICE COMMAND: ADMIN_RESTART
+// ==========================================================================
+PARADICE_COMMAND_IMPL(admin_restart)
+{
+    static std::string const usage =
+        "\n USAGE:    admin_restart now"
+        "\n\n Starts a new server process and hands every client over to it,"
+        "\n then shuts this one down.  Clients stay connected throughout."
+        "\n\n";
 
-                return;
-            }
-        }
+    auto token = odin::tokenise(arguments);
 
-        current_client->disconnect();
+    if (token.first != "now")
+    {
+        send_to_player(ctx, usage, player);
+        return;
     }
 
-    // shutdown
-    ctx->shutdown();
+    // The new process loads characters afresh, so they must be saved
+    // first.
+    if (!save_characters(ctx, player))
+    {
+        return;
+    }
+
+    try
+    {
+        ctx->restart();
+    }
+    catch(std::exception &ex)
+    {
+        std::printf("Error restarting: %s\n", ex.what());
+
+        send_to_player(
+            ctx
+          , terminalpp::string(boost::str(boost::format(
+                "\\[1Error restarting: %s.") % ex.what()))
+          , player);
+    }
+}
+
+// ==========================================================================
+// PARADICE COMMAND: ADMIN_STATS
+// ==========================================================================
+PARADICE_COMMAND_IMPL(admin_stats)
+{
+    std::stringstream stream;
+    stream << "\n";
+    odin::metrics::get_registry().write_summary(stream);
+    stream << "\n";
+
+    send_to_player(ctx, stream.str(), player);
+}
+
+// ==========================================================================
+// PARADICE COMMAND: ADMIN_TRACE
+// ==========================================================================
+PARADICE_COMMAND_IMPL(admin_trace)
+{
+    if (!odin::flight_recorder::is_enabled())
+    {
+        send_to_player(
+            ctx
+          , "\\[1The flight recorder is not enabled.  Start the server "
+            "with --trace to enable it."
+          , player);
+        return;
+    }
+
+    try
+    {
+        auto const filename = odin::flight_recorder::dump();
+
+        send_to_player(
+            ctx
+          , boost::str(boost::format(
+                "Flight recorder written to %s.") % filename)
+          , player);
+    }
+    catch (std::exception &ex)
+    {
+        send_to_player(
+            ctx
+          , boost::str(boost::format(
+                "\\[1Error writing flight recorder: %s.") % ex.what())
+          , player);
+    }
 }
 
 }
@@ -28,6 +28,7 @@
 #include "paradice/account.hpp"
 #include "paradice/admin.hpp"
 #include "paradice/character.hpp"
+#include "paradice/command_table.hpp"
 #include "paradice/communication.hpp"
 #include "paradice/configuration.hpp"
 #include "paradice/connection.hpp"
@@ -35,17 +36,22 @@
 #include "paradice/gm.hpp"
 #include "paradice/help.hpp"
 #include "paradice/rules.hpp"
+#include "paradice/table.hpp"
 #include "paradice/who.hpp"
 #include "hugin/user_interface.hpp"
 #include "munin/algorithm.hpp"
 #include "munin/container.hpp"
 #include "munin/grid_layout.hpp"
 #include "munin/window.hpp"
+#include "odin/flight_recorder.hpp"
+#include "odin/metrics.hpp"
 #include "odin/tokenise.hpp"
 #include "terminalpp/encoder.hpp"
 #include "terminalpp/string.hpp"
 #include <boost/asio/strand.hpp>
 #include <boost/format.hpp>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
 #include <deque>
 #include <mutex>
@@ -56,44 +62,25 @@ namespace paradice {
 
 namespace {
     #define PARADICE_CMD_ENTRY_NOP(name) \
-        { name,        NULL                                  , 0, 0 }
+        { name,  NULL,       0,       0,       true  }
 
     #define PARADICE_CMD_ENTRY(func) \
-        { #func,        [](auto ctx, auto args, auto player) \
-                        {do_##func(ctx, args, player);}, \
-                        0, 0 \
-        }
+        { #func, do_##func,  0,       0,       false }
 
     #define PARADICE_CMD_ALIAS(func, alias) \
-        { alias,        [](auto ctx, auto args, auto player) \
-                        {do_##func(ctx, args, player);}, \
-                        0, 0 \
-        }
+        { alias, do_##func,  0,       0,       false }
+
+    // Commands that are too consequential to be abbreviated.
+    #define PARADICE_CMD_ENTRY_IN_FULL(func) \
+        { #func, do_##func,  0,       0,       true  }
 
     #define PARADICE_ADMIN_ENTRY(func, level) \
-        { #func,        [](auto ctx, auto args, auto player) \
-                        {do_##func(ctx, args, player);}, \
-                        (level), 0 \
-        }
+        { #func, do_##func,  (level), 0,       true  }
 
     #define PARADICE_GM_ENTRY(func, level) \
-        { #func,        [](auto ctx, auto args, auto player) \
-                        {do_##func(ctx, args, player);}, \
-                        0, (level) \
-        }
-
-    typedef std::function<void (
-        std::shared_ptr<paradice::context> ctx,
-        std::string                        args,
-        std::shared_ptr<paradice::client>  player)> paradice_command;
+        { #func, do_##func,  0,       (level), false }
 
-    static struct command
-    {
-        std::string      command_;
-        paradice_command function_;
-        odin::u32        admin_level_required_;
-        odin::u32        gm_level_required_;
-    } const command_list[] =
+    static command_table const command_list =
     {
         PARADICE_CMD_ENTRY_NOP("!")
 
@@ -115,22 +102,29 @@ namespace {
       , PARADICE_CMD_ENTRY(rollprivate)
       , PARADICE_CMD_ENTRY(showrolls)
       , PARADICE_CMD_ENTRY(clearrolls)
+      , PARADICE_CMD_ENTRY(table)
 
       , PARADICE_CMD_ENTRY(help)
 
       , PARADICE_CMD_ENTRY(password)
-      , PARADICE_CMD_ENTRY(quit)
-      , PARADICE_CMD_ENTRY(logout)
+      , PARADICE_CMD_ENTRY_IN_FULL(quit)
+      , PARADICE_CMD_ENTRY_IN_FULL(logout)
 
       , PARADICE_GM_ENTRY(gm, 100)
 
       , PARADICE_ADMIN_ENTRY(admin_set_password, 100)
       , PARADICE_ADMIN_ENTRY(admin_shutdown,     100)
+      , PARADICE_ADMIN_ENTRY(admin_restart,      100)
+      , PARADICE_ADMIN_ENTRY(admin_stats,        100)
+      , PARADICE_ADMIN_ENTRY(admin_trace,        100)
     };
 
     #undef PARADICE_CMD_ENTRY_NOP
     #undef PARADICE_CMD_ENTRY
     #undef PARADICE_CMD_ALIAS
+    #undef PARADICE_CMD_ENTRY_IN_FULL
+    #undef PARADICE_ADMIN_ENTRY
+    #undef PARADICE_GM_ENTRY
 
     // ======================================================================
     // CAPITALISE
@@ -147,6 +141,44 @@ namespace {
             }
         }
     }
+
+    // The largest repaint that is treated as the echo of a keystroke.
+    BOOST_STATIC_CONSTANT(std::string::size_type, MAXIMUM_ECHO_SIZE = 256);
+
+    // ======================================================================
+    // GET_DISPATCH_QUEUE_DEPTH
+    // ======================================================================
+    odin::metrics::gauge &get_dispatch_queue_depth()
+    {
+        static auto &depth = odin::metrics::get_registry().get_gauge(
+            "paradice_dispatch_queue_depth",
+            "Events waiting in the clients' dispatch queues.");
+        return depth;
+    }
+
+    // ======================================================================
+    // GET_DISPATCH_WAIT_TIME
+    // ======================================================================
+    odin::metrics::histogram &get_dispatch_wait_time()
+    {
+        static auto &wait_time = odin::metrics::get_registry().get_histogram(
+            "paradice_dispatch_wait_seconds",
+            "Time that events wait for a client's strand.",
+            1e-9);
+        return wait_time;
+    }
+
+    // ======================================================================
+    // GET_COMMAND_TIME
+    // ======================================================================
+    odin::metrics::histogram &get_command_time()
+    {
+        static auto &command_time = odin::metrics::get_registry().get_histogram(
+            "paradice_command_seconds",
+            "Time taken to execute a command.",
+            1e-9);
+        return command_time;
+    }
 }
 
 // ==========================================================================
@@ -183,6 +215,15 @@ public :
         window_->set_size(terminalpp::extent(80, 24));
     }
 
+    // ======================================================================
+    // DESTRUCTOR
+    // ======================================================================
+    ~impl()
+    {
+        // Anything still queued will never be dispatched.
+        get_dispatch_queue_depth().add(-odin::s64(dispatch_queue_.size()));
+    }
+
     // ======================================================================
     // SET_CONNECTION
     // ======================================================================
@@ -194,10 +235,10 @@ public :
         connection_->on_data_read(
             [this](std::string const &data)
             {
-                std::unique_lock<std::mutex> lock(dispatch_queue_mutex_);
-                dispatch_queue_.push_back(
-                    bind(&munin::window::data, window_, data));
-                strand_.post(bind(&impl::dispatch_queue, shared_from_this()));
+                echo_pending_ = true;
+                enqueue(
+                    "client.input"
+                  , bind(&munin::window::data, window_, data));
             });
 
         connection_->on_window_size_changed(
@@ -206,6 +247,17 @@ public :
                 this->on_window_size_changed(width, height);
             });
 
+        connection_->on_idle_warning(
+            [this](std::chrono::seconds remaining)
+            {
+                strand_.post(odin::flight_recorder::trace(
+                    "client.idle_warning"
+                  , [pthis=shared_from_this(), remaining]
+                    {
+                        pthis->on_idle_warning(remaining);
+                    }));
+            });
+
         // WINDOW CALLBACKS
         window_->on_repaint.connect(
             [this](auto const &regions)
@@ -318,6 +370,14 @@ public :
         window_->use_alternate_screen_buffer();
     }
 
+    // ======================================================================
+    // GET_CONNECTION
+    // ======================================================================
+    std::shared_ptr<connection> get_connection()
+    {
+        return connection_;
+    }
+
     // ======================================================================
     // SET_ACCOUNT
     // ======================================================================
@@ -350,6 +410,139 @@ public :
         return character_;
     }
 
+    // ======================================================================
+    // SET_TABLE
+    // ======================================================================
+    void set_table(std::shared_ptr<table> const &tbl)
+    {
+        std::atomic_store(&table_, tbl);
+
+        if (tbl)
+        {
+            user_interface_->set_active_encounter(tbl->get_encounter());
+
+            if (tbl->is_encounter_visible())
+            {
+                user_interface_->show_active_encounter_window();
+            }
+            else
+            {
+                user_interface_->hide_active_encounter_window();
+            }
+        }
+        else
+        {
+            user_interface_->hide_active_encounter_window();
+            user_interface_->set_active_encounter({});
+        }
+    }
+
+    // ======================================================================
+    // GET_TABLE
+    // ======================================================================
+    std::shared_ptr<table> get_table()
+    {
+        return std::atomic_load(&table_);
+    }
+
+    // ======================================================================
+    // ON_TABLE_ENCOUNTER_CHANGED
+    // ======================================================================
+    void on_table_encounter_changed(
+        std::shared_ptr<table>                  const &tbl
+      , std::shared_ptr<active_encounter const> const &enc)
+    {
+        enqueue(
+            "client.table_encounter_changed"
+          , [this, tbl, enc]
+            {
+                // The client may have moved to another table since the
+                // snapshot was taken, and showing it now would replace
+                // that table's encounter with the old one.
+                if (get_table() == tbl)
+                {
+                    user_interface_->set_active_encounter(enc);
+                }
+            });
+    }
+
+    // ======================================================================
+    // ON_TABLE_ENCOUNTER_VISIBILITY_CHANGED
+    // ======================================================================
+    void on_table_encounter_visibility_changed(
+        std::shared_ptr<table> const &tbl
+      , bool                          visible)
+    {
+        enqueue(
+            "client.table_encounter_visibility_changed"
+          , [this, tbl, visible]
+            {
+                if (get_table() != tbl)
+                {
+                    return;
+                }
+
+                if (visible)
+                {
+                    user_interface_->show_active_encounter_window();
+                }
+                else
+                {
+                    user_interface_->hide_active_encounter_window();
+                }
+            });
+    }
+
+    // ======================================================================
+    // RESTORE
+    // ======================================================================
+    void restore(
+        std::shared_ptr<account>   acc,
+        std::shared_ptr<character> ch,
+        std::string const         &face)
+    {
+        account_   = acc;
+        character_ = ch;
+
+        auto selected_face = face;
+
+        if (account_ == NULL)
+        {
+            selected_face = hugin::FACE_INTRO;
+        }
+        else
+        {
+            update_character_names();
+
+            if (character_ == NULL
+             && (face == hugin::FACE_MAIN
+              || face == hugin::FACE_GM_TOOLS
+              || face == hugin::FACE_PASSWORD_CHANGE))
+            {
+                selected_face = hugin::FACE_CHAR_SELECTION;
+            }
+        }
+
+        if (character_ != NULL)
+        {
+            if (character_->get_gm_level() != 0)
+            {
+                user_interface_->set_beasts(character_->get_beasts());
+                user_interface_->set_encounters(character_->get_encounters());
+            }
+
+            set_window_title(character_->get_name() + " - Paradice9");
+
+            // Tables do not survive a restart, and so everyone returns to
+            // the default table.
+            set_table(context_->get_table(DEFAULT_TABLE_NAME));
+        }
+
+        user_interface_->select_face(
+            selected_face.empty() ? hugin::FACE_INTRO : selected_face);
+        user_interface_->set_focus();
+    }
+
     // ======================================================================
     // GET_USER_INTERFACE
     // ======================================================================
@@ -371,13 +564,9 @@ public :
     // ======================================================================
     void set_window_title(std::string const &title)
     {
-        {
-            std::unique_lock<std::mutex> lock(dispatch_queue_mutex_);
-            dispatch_queue_.push_back(bind(
-                &munin::window::set_title, window_, title));
-        }
-
-        strand_.post(bind(&impl::dispatch_queue, shared_from_this()));
+        enqueue(
+            "client.set_title"
+          , bind(&munin::window::set_title, window_, title));
     }
 
     // ======================================================================
@@ -385,13 +574,44 @@ public :
     // ======================================================================
     void set_window_size(odin::u16 width, odin::u16 height)
     {
-        {
-            std::unique_lock<std::mutex> lock(dispatch_queue_mutex_);
-            dispatch_queue_.push_back(bind(
-                &munin::window::set_size, window_, terminalpp::extent(width, height)));
-        }
+        enqueue(
+            "client.set_size"
+          , bind(
+                &munin::window::set_size
+              , window_
+              , terminalpp::extent(width, height)));
+    }
 
-        strand_.post(bind(&impl::dispatch_queue, shared_from_this()));
+    // ======================================================================
+    // ASYNC_GET_HANDOVER_STATE
+    // ======================================================================
+    void async_get_handover_state(
+        std::function<void (client::handover_state const &)> const &callback)
+    {
+        enqueue(
+            "client.get_handover_state"
+          , [this, callback]
+            {
+                client::handover_state state;
+
+                if (account_ != NULL)
+                {
+                    state.account_name = account_->get_name();
+                }
+
+                if (character_ != NULL)
+                {
+                    state.character_name = character_->get_name();
+                }
+
+                state.face = user_interface_->get_face();
+
+                auto const size = window_->get_size();
+                state.width  = odin::u16(size.width);
+                state.height = odin::u16(size.height);
+
+                callback(state);
+            });
     }
 
     // ======================================================================
@@ -416,10 +636,23 @@ private :
     // ======================================================================
     void on_window_size_changed(odin::u16 width, odin::u16 height)
     {
-        std::unique_lock<std::mutex> lock(dispatch_queue_mutex_);
-        dispatch_queue_.push_back(
-            bind(&munin::window::set_size, window_, terminalpp::extent(width, height)));
-        strand_.post(bind(&impl::dispatch_queue, shared_from_this()));
+        enqueue(
+            "client.window_size_changed"
+          , bind(
+                &munin::window::set_size
+              , window_
+              , terminalpp::extent(width, height)));
+    }
+
+    // ======================================================================
+    // ON_IDLE_WARNING
+    // ======================================================================
+    void on_idle_warning(std::chrono::seconds remaining)
+    {
+        user_interface_->set_statusbar_text(terminalpp::encode(
+            boost::str(boost::format(
+                "\\[3You will be disconnected for inactivity in %d seconds")
+                % remaining.count())));
     }
 
     // ======================================================================
@@ -427,7 +660,15 @@ private :
     // ======================================================================
     void on_repaint(std::string const &paint_data)
     {
-        connection_->write(paint_data);
+        // A small repaint that follows input is the echo of what was
+        // typed, and is sent at once rather than held for a full segment.
+        auto const cls = 
+            echo_pending_.exchange(false) 
+         && paint_data.size() <= MAXIMUM_ECHO_SIZE
+          ? connection::write_class::interactive
+          : connection::write_class::repaint;
+
+        connection_->write(paint_data, cls);
     }
 
     // ======================================================================
@@ -683,23 +924,25 @@ private :
             return;
         }
 
-        // If this is a GM character, then check for any other GM characters
-        // online, since there can only be one.
-        if (ch->get_gm_level() != 0)
+        // Players sit at the default table.  So does a GM, unless it already
+        // has one, since there can only be one GM at each table.  In that
+        // case, the GM sits at a new table of their own.  The character is
+        // taken up first, so that the seating sees whether it is a GM.
+        auto const player = self_.shared_from_this();
+        character_ = ch;
+
+        auto tbl = context_->seat_client(player, DEFAULT_TABLE_NAME);
+
+        if (tbl == NULL)
         {
-            for (auto cli : context_->get_clients())
-            {
-                if (cli.get() != &self_)
-                {
-                    auto other_ch = cli->get_character();
+            tbl = context_->seat_client(player, ch->get_name());
 
-                    if (other_ch && other_ch->get_gm_level() != 0)
-                    {
-                        user_interface_->set_statusbar_text(
-                            "\\[1There is already a GM character online."_ets);
-                        return;
-                    }
-                }
+            if (tbl == NULL)
+            {
+                character_.reset();
+                user_interface_->set_statusbar_text(
+                    "\\[1That character is already at a table."_ets);
+                return;
             }
         }
 
@@ -711,7 +954,6 @@ private :
             user_interface_->set_encounters(ch->get_encounters());
         }
 
-        character_ = ch;
         context_->update_names();
 
         user_interface_->select_face(hugin::FACE_MAIN);
@@ -842,8 +1084,11 @@ private :
     // ======================================================================
     void on_gm_fight_beast(std::shared_ptr<paradice::beast> beast)
     {
-        add_beast(context_->get_active_encounter(), beast);
-        context_->update_active_encounter();
+        get_table()->modify_encounter(
+            [beast](auto const &enc)
+            {
+                add_beast(enc, beast);
+            });
 
         user_interface_->set_statusbar_text(terminalpp::encode(
             boost::str(boost::format("\\[3Added \\x%s\\x\\[3 to active encounter")
@@ -855,14 +1100,14 @@ private :
     // ======================================================================
     void on_gm_fight_encounter(std::shared_ptr<paradice::encounter> encounter)
     {
-        auto enc = context_->get_active_encounter();
-
-        for (auto beast : encounter->get_beasts())
-        {
-            add_beast(enc, beast);
-        }
-
-        context_->update_active_encounter();
+        get_table()->modify_encounter(
+            [beasts=encounter->get_beasts()](auto const &enc)
+            {
+                for (auto beast : beasts)
+                {
+                    add_beast(enc, beast);
+                }
+            });
 
         user_interface_->set_statusbar_text(terminalpp::encode(
             boost::str(boost::format("\\[3Added \\x%s\\x\\[3 to active encounter!")
@@ -982,12 +1227,6 @@ private :
 
         auto arg = odin::tokenise(input);
 
-        // Transform the command to lower case.
-        for (auto ch = arg.first.begin(); ch != arg.first.end(); ++ch)
-        {
-            *ch = tolower(*ch);
-        }
-
         if (arg.first == "!")
         {
             on_input_entered(last_command_);
@@ -997,72 +1236,121 @@ private :
         auto admin_level = account_->get_admin_level();
         auto gm_level = player->get_character()->get_gm_level();
 
-        // Search through the list for commands
-        for (auto const &cur_command : command_list)
+        // Commands for which the account does not have the required access
+        // rights are not found, as if they didn't exist.
+        auto const found = command_list.find(arg.first, admin_level, gm_level);
+
+        if (found.command_ != nullptr)
         {
-            if (cur_command.command_ == arg.first)
             {
-                // If the account in question has the required access rights,
-                // then execute the command.  Otherwise, pretend it doesn't
-                // exist.
-                if (admin_level >= cur_command.admin_level_required_
-                 && gm_level >= cur_command.gm_level_required_)
-                {
-                    cur_command.function_(context_, arg.second, player);
-                    last_command_ = input;
-                    return;
-                }
+                odin::metrics::scoped_timer timer(get_command_time());
+                found.command_->function_(context_, arg.second, player);
             }
+
+            last_command_ = input;
+            return;
         }
 
-        std::string text =
-            "\nDidn't understand that.  Available commands are:\n";
+        std::string text;
 
-        for (auto const &cur_command : command_list)
+        if (found.ambiguous_)
         {
-            if (admin_level >= cur_command.admin_level_required_
-             && gm_level >= cur_command.gm_level_required_)
+            text = "\n\"" + arg.first.to_string() + "\" could be any of:\n";
+
+            for (auto const &name : command_list.find_abbreviated(
+                     arg.first, admin_level, gm_level))
             {
-                text += cur_command.command_ + " ";
+                text += name + " ";
             }
         }
+        else
+        {
+            text = "\nDidn't understand that.  Available commands are:\n"
+                 + command_list.get_listing(admin_level, gm_level);
+        }
 
         text += "\n";
 
         send_to_player(context_, text, player);
     }
 
+    // ======================================================================
+    // DISPATCH_ENTRY
+    // ======================================================================
+    struct dispatch_entry
+    {
+        char const                           *tag;
+        std::function<void ()>                fn;
+        std::chrono::steady_clock::time_point enqueue_time;
+    };
+
     client                                 &self_;
     boost::asio::strand                     strand_;
     std::shared_ptr<context>                context_;
     std::shared_ptr<account>                account_;
     std::shared_ptr<character>              character_;
 
+    // Read from other clients' threads, and so only accessed atomically.
+    std::shared_ptr<table>                  table_;
+
     std::shared_ptr<connection>             connection_;
     std::shared_ptr<munin::window>          window_;
     std::shared_ptr<hugin::user_interface>  user_interface_;
 
     std::mutex                              dispatch_queue_mutex_;
-    std::deque<std::function<void ()>>      dispatch_queue_;
+    std::deque<dispatch_entry>              dispatch_queue_;
+    std::atomic<bool>                       echo_pending_{false};
     std::string                             last_command_;
 
 private :
+    // ======================================================================
+    // ENQUEUE
+    // ======================================================================
+    void enqueue(char const *tag, std::function<void ()> const &fn)
+    {
+        {
+            std::unique_lock<std::mutex> lock(dispatch_queue_mutex_);
+            dispatch_queue_.push_back(
+                { tag, fn, std::chrono::steady_clock::now() });
+        }
+
+        get_dispatch_queue_depth().add(1);
+        strand_.post(bind(&impl::dispatch_queue, shared_from_this()));
+    }
+
     // ======================================================================
     // DISPATCH_QUEUE
     // ======================================================================
     void dispatch_queue()
     {
-        std::function<void ()> fn;
+        dispatch_entry entry;
 
         std::unique_lock<std::mutex> lock(dispatch_queue_mutex_);
 
         while (!dispatch_queue_.empty())
         {
-            fn = dispatch_queue_.front();
+            entry = dispatch_queue_.front();
             dispatch_queue_.pop_front();
             lock.unlock();
 
-            fn();
+            auto const started = std::chrono::steady_clock::now();
+
+            get_dispatch_queue_depth().add(-1);
+            get_dispatch_wait_time().record(started - entry.enqueue_time);
+
+            entry.fn();
+
+            // Each entry is recorded as a handler of its own, since it was
+            // queued on its own, even though several may be dispatched by
+            // the one handler.
+            if (odin::flight_recorder::is_enabled())
+            {
+                odin::flight_recorder::record(
+                    entry.tag
+                  , entry.enqueue_time
+                  , started
+                  , std::chrono::steady_clock::now());
+            }
 
             lock.lock();
         }
@@ -1095,6 +1383,14 @@ void client::set_connection(std::shared_ptr<connection> const &cnx)
     pimpl_->set_connection(cnx);
 }
 
+// ==========================================================================
+// GET_CONNECTION
+// ==========================================================================
+std::shared_ptr<connection> client::get_connection() const
+{
+    return pimpl_->get_connection();
+}
+
 // ==========================================================================
 // GET_USER_INTERFACE
 // ==========================================================================
@@ -1159,6 +1455,62 @@ std::shared_ptr<character> client::get_character() const
     return pimpl_->get_character();
 }
 
+// ==========================================================================
+// SET_TABLE
+// ==========================================================================
+void client::set_table(std::shared_ptr<table> const &tbl)
+{
+    pimpl_->set_table(tbl);
+}
+
+// ==========================================================================
+// GET_TABLE
+// ==========================================================================
+std::shared_ptr<table> client::get_table() const
+{
+    return pimpl_->get_table();
+}
+
+// ==========================================================================
+// ON_TABLE_ENCOUNTER_CHANGED
+// ==========================================================================
+void client::on_table_encounter_changed(
+    std::shared_ptr<table>                  const &tbl
+  , std::shared_ptr<active_encounter const> const &enc)
+{
+    pimpl_->on_table_encounter_changed(tbl, enc);
+}
+
+// ==========================================================================
+// ON_TABLE_ENCOUNTER_VISIBILITY_CHANGED
+// ==========================================================================
+void client::on_table_encounter_visibility_changed(
+    std::shared_ptr<table> const &tbl
+  , bool                          visible)
+{
+    pimpl_->on_table_encounter_visibility_changed(tbl, visible);
+}
+
+// ==========================================================================
+// RESTORE
+// ==========================================================================
+void client::restore(
+    std::shared_ptr<account>   const &acc
+  , std::shared_ptr<character> const &ch
+  , std::string                const &face)
+{
+    pimpl_->restore(acc, ch, face);
+}
+
+// ==========================================================================
+// ASYNC_GET_HANDOVER_STATE
+// ==========================================================================
+void client::async_get_handover_state(
+    std::function<void (handover_state const &)> const &callback)
+{
+    pimpl_->async_get_handover_state(callback);
+}
+
 // ==========================================================================
 // DISCONNECT
 // ==========================================================================
@@ -0,0 +1,361 @@
+// ==========================================================================
+// Paradice Command Table
+//
+// Copyright (C) 2013 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "paradice/command_table.hpp"
+#include <algorithm>
+#include <array>
+
+namespace paradice {
+
+namespace {
+
+// ==========================================================================
+// FOLD
+// ==========================================================================
+// Command names are plain ASCII, so there is no need to consult the locale
+// for this.
+char fold(char ch)
+{
+    return ch >= 'A' && ch <= 'Z' ? char(ch - 'A' + 'a') : ch;
+}
+
+// ==========================================================================
+// FOLDED
+// ==========================================================================
+std::string folded(std::string name)
+{
+    std::transform(name.begin(), name.end(), name.begin(), fold);
+    return name;
+}
+
+// ==========================================================================
+// IS_AVAILABLE
+// ==========================================================================
+bool is_available(
+    command_table::command const &cmd
+  , odin::u32                     admin_level
+  , odin::u32                     gm_level)
+{
+    return admin_level >= cmd.admin_level_required_
+        && gm_level >= cmd.gm_level_required_;
+}
+
+// ==========================================================================
+// ABBREVIATES
+// ==========================================================================
+// Returns true if name, folded, is a prefix of the (folded) command name.
+bool abbreviates(boost::string_view name, std::string const &command_name)
+{
+    return name.size() <= command_name.size()
+        && std::equal(
+               name.begin()
+             , name.end()
+             , command_name.begin()
+             , [](char lhs, char rhs)
+               {
+                   return fold(lhs) == rhs;
+               });
+}
+
+// ==========================================================================
+// PRECEDES
+// ==========================================================================
+// Returns true if the (folded) command name sorts before name, folded.
+bool precedes(std::string const &command_name, boost::string_view name)
+{
+    auto const length = (std::min)(command_name.size(), name.size());
+
+    for (std::size_t index = 0; index < length; ++index)
+    {
+        auto const lhs = command_name[index];
+        auto const rhs = fold(name[index]);
+
+        if (lhs != rhs)
+        {
+            return lhs < rhs;
+        }
+    }
+
+    return command_name.size() < name.size();
+}
+
+// ==========================================================================
+// LEVEL_INDEX
+// ==========================================================================
+// Returns the index of the greatest of the levels that does not exceed the
+// given level.  The levels are sorted and begin with 0.
+odin::u32 level_index(std::vector<odin::u32> const &levels, odin::u32 level)
+{
+    return odin::u32(
+        std::upper_bound(levels.begin(), levels.end(), level)
+      - levels.begin()
+      - 1);
+}
+
+// ==========================================================================
+// REQUIRED_LEVELS
+// ==========================================================================
+// Returns the distinct levels at which the set of available commands may
+// change, which always includes 0.
+template <class Projection>
+std::vector<odin::u32> required_levels(
+    std::vector<command_table::command> const &commands
+  , Projection                                 projection)
+{
+    std::vector<odin::u32> levels = { 0 };
+
+    for (auto const &cmd : commands)
+    {
+        levels.push_back(projection(cmd));
+    }
+
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+
+    return levels;
+}
+
+}
+
+// ==========================================================================
+// COMMAND_TABLE::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct command_table::impl
+{
+    // ======================================================================
+    // FIND_FIRST
+    // ======================================================================
+    // Returns the first position in the order at which a command that the
+    // name abbreviates may be found.
+    std::vector<odin::u32>::const_iterator find_first(
+        boost::string_view name) const
+    {
+        auto const initial = static_cast<unsigned char>(fold(name[0]));
+
+        return std::lower_bound(
+            order_.begin() + initials_[initial]
+          , order_.begin() + initials_[initial + 1]
+          , name
+          , [this](odin::u32 index, boost::string_view key)
+            {
+                return precedes(commands_[index].name_, key);
+            });
+    }
+
+    // The commands in the order given, with their names folded.
+    std::vector<command>     commands_;
+
+    // The indices of the commands, ordered by name.
+    std::vector<odin::u32>   order_;
+
+    // For each character, the position in the order of the first name that
+    // begins with it or with any later character.
+    std::array<odin::u32, 257> initials_;
+
+    // The listings for each combination of admin and GM levels.
+    std::vector<odin::u32>   admin_levels_;
+    std::vector<odin::u32>   gm_levels_;
+    std::vector<std::string> listings_;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+command_table::command_table(std::initializer_list<command> commands)
+    : pimpl_(std::make_shared<impl>())
+{
+    pimpl_->commands_.assign(commands.begin(), commands.end());
+
+    for (auto &cmd : pimpl_->commands_)
+    {
+        cmd.name_ = folded(cmd.name_);
+    }
+
+    for (odin::u32 index = 0; index < pimpl_->commands_.size(); ++index)
+    {
+        pimpl_->order_.push_back(index);
+    }
+
+    std::stable_sort(
+        pimpl_->order_.begin()
+      , pimpl_->order_.end()
+      , [this](odin::u32 lhs, odin::u32 rhs)
+        {
+            return pimpl_->commands_[lhs].name_
+                 < pimpl_->commands_[rhs].name_;
+        });
+
+    odin::u32 position = 0;
+
+    for (odin::u32 initial = 0; initial < pimpl_->initials_.size(); ++initial)
+    {
+        while (position < pimpl_->order_.size()
+            && static_cast<unsigned char>(
+                   pimpl_->commands_[pimpl_->order_[position]].name_[0])
+             < initial)
+        {
+            ++position;
+        }
+
+        pimpl_->initials_[initial] = position;
+    }
+
+    pimpl_->admin_levels_ = required_levels(
+        pimpl_->commands_
+      , [](command const &cmd) { return cmd.admin_level_required_; });
+    pimpl_->gm_levels_ = required_levels(
+        pimpl_->commands_
+      , [](command const &cmd) { return cmd.gm_level_required_; });
+
+    for (auto admin_level : pimpl_->admin_levels_)
+    {
+        for (auto gm_level : pimpl_->gm_levels_)
+        {
+            std::string listing;
+
+            for (auto const &cmd : pimpl_->commands_)
+            {
+                if (is_available(cmd, admin_level, gm_level))
+                {
+                    listing += cmd.name_ + " ";
+                }
+            }
+
+            pimpl_->listings_.push_back(listing);
+        }
+    }
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+command_table::~command_table()
+{
+}
+
+// ==========================================================================
+// FIND
+// ==========================================================================
+command_table::match command_table::find(
+    boost::string_view name
+  , odin::u32          admin_level
+  , odin::u32          gm_level) const
+{
+    match result = { nullptr, false };
+
+    if (name.empty())
+    {
+        return result;
+    }
+
+    auto const &commands = pimpl_->commands_;
+
+    for (auto position = pimpl_->find_first(name);
+         position != pimpl_->order_.end()
+      && abbreviates(name, commands[*position].name_);
+         ++position)
+    {
+        auto const &cmd = commands[*position];
+
+        if (!is_available(cmd, admin_level, gm_level))
+        {
+            continue;
+        }
+
+        // An exact match sorts before everything that it abbreviates, so
+        // it is always the first to be seen.
+        if (cmd.name_.size() == name.size())
+        {
+            result.command_ = &cmd;
+            return result;
+        }
+
+        if (cmd.in_full_)
+        {
+            continue;
+        }
+
+        if (result.command_ != nullptr)
+        {
+            result.command_   = nullptr;
+            result.ambiguous_ = true;
+            return result;
+        }
+
+        result.command_ = &cmd;
+    }
+
+    return result;
+}
+
+// ==========================================================================
+// FIND_ABBREVIATED
+// ==========================================================================
+std::vector<std::string> command_table::find_abbreviated(
+    boost::string_view name
+  , odin::u32          admin_level
+  , odin::u32          gm_level) const
+{
+    std::vector<std::string> names;
+
+    if (name.empty())
+    {
+        return names;
+    }
+
+    auto const &commands = pimpl_->commands_;
+
+    for (auto position = pimpl_->find_first(name);
+         position != pimpl_->order_.end()
+      && abbreviates(name, commands[*position].name_);
+         ++position)
+    {
+        auto const &cmd = commands[*position];
+
+        if (is_available(cmd, admin_level, gm_level) && !cmd.in_full_)
+        {
+            names.push_back(cmd.name_);
+        }
+    }
+
+    return names;
+}
+
+// ==========================================================================
+// GET_LISTING
+// ==========================================================================
+std::string const &command_table::get_listing(
+    odin::u32 admin_level
+  , odin::u32 gm_level) const
+{
+    auto const admin_index = level_index(pimpl_->admin_levels_, admin_level);
+    auto const gm_index    = level_index(pimpl_->gm_levels_, gm_level);
+
+    return pimpl_->listings_[
+        admin_index * pimpl_->gm_levels_.size() + gm_index];
+}
+
+}
@@ -115,9 +115,12 @@ void send_to_room(
     terminalpp::string const &text,
     std::shared_ptr<client>  &conn)
 {
+    // The room is the table at which the client sits.
+    auto const tbl = conn->get_table();
+
     for (auto cur_client : ctx->get_clients())
     {
-        if (cur_client != conn)
+        if (cur_client != conn && cur_client->get_table() == tbl)
         {
             cur_client->get_user_interface()->add_output_text(text);
         }
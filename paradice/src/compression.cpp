@@ -0,0 +1,342 @@
+// ==========================================================================
+// Paradice Compression
+//
+// Copyright (C) 2010 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "paradice/compression.hpp"
+#include <telnetpp/options/mccp/compressor.hpp>
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <zlib.h>
+
+namespace paradice {
+
+namespace {
+    // Output rates are measured over windows of at least this length.
+    std::chrono::milliseconds const RATE_WINDOW(1000);
+
+    BOOST_STATIC_CONSTANT(odin::u32, OUTPUT_BUFFER_SIZE = 1024);
+
+    // ======================================================================
+    // DEFLATE_STATE_DELETER
+    // ======================================================================
+    struct deflate_state_deleter
+    {
+        void operator()(z_stream *stream) const
+        {
+            deflateEnd(stream);
+            delete stream;
+        }
+    };
+
+    typedef std::unique_ptr<z_stream, deflate_state_deleter> deflate_state;
+
+    // ======================================================================
+    // CLAMP
+    // ======================================================================
+    template <class T>
+    T clamp(T value, T lowest, T highest)
+    {
+        return (std::min)((std::max)(value, lowest), highest);
+    }
+}
+
+// ==========================================================================
+// COMPRESSION_POOL::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct compression_pool::impl
+{
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(compression_settings const &settings)
+        : settings_(settings)
+    {
+        // Settings outside of the ranges that zlib accepts would cause every
+        // compressor to fail, so they are brought into range here.
+        settings_.memory_level = clamp(settings_.memory_level, 1, 9);
+        settings_.window_bits  = clamp(settings_.window_bits, 9, 15);
+        settings_.minimum_level = clamp(settings_.minimum_level, 0, 9);
+        settings_.maximum_level = clamp(
+            settings_.maximum_level, settings_.minimum_level, 9);
+        settings_.high_output_rate = (std::max)(
+            settings_.high_output_rate, settings_.low_output_rate + 1);
+    }
+
+    // ======================================================================
+    // ACQUIRE
+    // ======================================================================
+    deflate_state acquire()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++active_;
+
+            if (!pooled_.empty())
+            {
+                auto state = std::move(pooled_.back());
+                pooled_.pop_back();
+                return state;
+            }
+        }
+
+        deflate_state state(new z_stream{});
+
+        auto const result = deflateInit2(
+            state.get()
+          , settings_.maximum_level
+          , Z_DEFLATED
+          , settings_.window_bits
+          , settings_.memory_level
+          , Z_DEFAULT_STRATEGY);
+
+        if (result != Z_OK)
+        {
+            // The state was never initialised, so must not be ended.
+            delete state.release();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            --active_;
+            throw std::bad_alloc();
+        }
+
+        return state;
+    }
+
+    // ======================================================================
+    // RELEASE
+    // ======================================================================
+    void release(deflate_state state)
+    {
+        // Return the state to the condition that a newly-initialised one
+        // would be in, so that the next compressor can use it as-is.
+        deflateReset(state.get());
+        deflateParams(
+            state.get(), settings_.maximum_level, Z_DEFAULT_STRATEGY);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        --active_;
+
+        if (pooled_.size() < settings_.maximum_pooled_states)
+        {
+            pooled_.push_back(std::move(state));
+        }
+        else
+        {
+            // Free the state outside of the lock.
+            lock.unlock();
+            state.reset();
+        }
+    }
+
+    compression_settings        settings_;
+    mutable std::mutex          mutex_;
+    std::vector<deflate_state>  pooled_;
+    odin::u32                   active_ = 0;
+};
+
+// ==========================================================================
+// COMPRESSION_POOL::COMPRESSOR
+// ==========================================================================
+class compression_pool::compressor
+    : public telnetpp::options::mccp::compressor
+{
+public :
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    explicit compressor(std::shared_ptr<compression_pool::impl> const &pool)
+        : pool_(pool)
+    {
+    }
+
+    // ======================================================================
+    // DESTRUCTOR
+    // ======================================================================
+    ~compressor()
+    {
+        end_compression();
+    }
+
+    // ======================================================================
+    // TRANSFORM_CHUNK
+    // ======================================================================
+    telnetpp::u8stream transform_chunk(
+        telnetpp::u8stream const &stream) override
+    {
+        if (!state_)
+        {
+            state_        = pool_->acquire();
+            level_        = pool_->settings_.maximum_level;
+            window_start_ = std::chrono::steady_clock::now();
+            window_bytes_ = 0;
+        }
+
+        adapt_level(stream.size());
+
+        telnetpp::u8stream output;
+        std::array<Bytef, OUTPUT_BUFFER_SIZE> buffer;
+
+        state_->next_in  = const_cast<Bytef *>(stream.data());
+        state_->avail_in = uInt(stream.size());
+
+        // Each chunk is flushed so that the client can decompress it as
+        // soon as it arrives.
+        do
+        {
+            state_->next_out  = buffer.data();
+            state_->avail_out = uInt(buffer.size());
+
+            deflate(state_.get(), Z_SYNC_FLUSH);
+
+            output.insert(
+                output.end()
+              , buffer.begin()
+              , buffer.begin() + (buffer.size() - state_->avail_out));
+        } while (state_->avail_out == 0);
+
+        return output;
+    }
+
+    // ======================================================================
+    // END_COMPRESSION
+    // ======================================================================
+    void end_compression() override
+    {
+        if (state_)
+        {
+            pool_->release(std::move(state_));
+        }
+    }
+
+private :
+    // ======================================================================
+    // ADAPT_LEVEL
+    // ======================================================================
+    void adapt_level(std::size_t bytes)
+    {
+        window_bytes_ += bytes;
+
+        auto const now = std::chrono::steady_clock::now();
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                now - window_start_);
+
+        if (elapsed < RATE_WINDOW)
+        {
+            return;
+        }
+
+        auto const &settings = pool_->settings_;
+        auto const rate = window_bytes_ * 1000 / elapsed.count();
+
+        window_start_ = now;
+        window_bytes_ = 0;
+
+        // The busier the connection, the less effort is spent compressing
+        // its output.
+        odin::s32 level = settings.maximum_level;
+
+        if (rate >= settings.high_output_rate)
+        {
+            level = settings.minimum_level;
+        }
+        else if (rate > settings.low_output_rate)
+        {
+            level = settings.maximum_level - odin::s32(
+                (settings.maximum_level - settings.minimum_level)
+              * (rate - settings.low_output_rate)
+              / (settings.high_output_rate - settings.low_output_rate));
+        }
+
+        if (level != level_)
+        {
+            // The previous chunk was fully flushed, so the level can be
+            // changed without affecting any data already compressed.
+            deflateParams(state_.get(), level, Z_DEFAULT_STRATEGY);
+            level_ = level;
+        }
+    }
+
+    std::shared_ptr<compression_pool::impl> pool_;
+    deflate_state                           state_;
+    odin::s32                               level_ = 0;
+    std::chrono::steady_clock::time_point   window_start_;
+    std::size_t                             window_bytes_ = 0;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+compression_pool::compression_pool(compression_settings const &settings)
+    : pimpl_(std::make_shared<impl>(settings))
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+compression_pool::~compression_pool()
+{
+}
+
+// ==========================================================================
+// GET_SETTINGS
+// ==========================================================================
+compression_settings const &compression_pool::get_settings() const
+{
+    return pimpl_->settings_;
+}
+
+// ==========================================================================
+// MAKE_COMPRESSOR
+// ==========================================================================
+std::shared_ptr<telnetpp::options::mccp::compressor>
+    compression_pool::make_compressor()
+{
+    return std::make_shared<compressor>(pimpl_);
+}
+
+// ==========================================================================
+// GET_NUMBER_OF_ACTIVE_STATES
+// ==========================================================================
+odin::u32 compression_pool::get_number_of_active_states() const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    return pimpl_->active_;
+}
+
+// ==========================================================================
+// GET_NUMBER_OF_POOLED_STATES
+// ==========================================================================
+odin::u32 compression_pool::get_number_of_pooled_states() const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->mutex_);
+    return odin::u32(pimpl_->pooled_.size());
+}
+
+}
@@ -155,6 +155,7 @@ PARADICE_COMMAND_IMPL(logout)
       + " has left Paradice!\n"
       , player);
 
+    ctx->unseat_client(player);
     player->set_character({});
     player->set_account({});
 
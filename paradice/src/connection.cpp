@@ -25,25 +25,72 @@
 //             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 // ==========================================================================
 #include "paradice/connection.hpp"
+#include "paradice/compression.hpp"
+#include "paradice/idle_sweeper.hpp"
+#include "odin/metrics.hpp"
 #include "odin/net/socket.hpp"
+#include <boost/asio/strand.hpp>
 #include <telnetpp/telnetpp.hpp>
 #include <telnetpp/byte_converter.hpp>
 #include <telnetpp/options/echo/server.hpp>
 #include <telnetpp/options/mccp/codec.hpp>
 #include <telnetpp/options/mccp/server.hpp>
-#include <telnetpp/options/mccp/zlib/compressor.hpp>
 #include <telnetpp/options/mccp/zlib/decompressor.hpp>
 #include <telnetpp/options/naws/client.hpp>
 #include <telnetpp/options/suppress_ga/server.hpp>
 #include <telnetpp/options/terminal_type/client.hpp>
-#include <boost/asio/deadline_timer.hpp>
-#include <boost/asio/placeholders.hpp>
+#include <chrono>
 #include <deque>
 #include <string>
 #include <utility>
 
 namespace paradice {
 
+namespace {
+    // Telnet commands and option codes, used to replay a negotiation that
+    // took place in another process.
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_IAC  = 255);
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_DO   = 253);
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_WILL = 251);
+
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_OPTION_ECHO          = 1);
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_OPTION_SUPPRESS_GA   = 3);
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_OPTION_TERMINAL_TYPE = 24);
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_OPTION_NAWS          = 31);
+    BOOST_STATIC_CONSTANT(odin::u8, TELNET_OPTION_MCCP2         = 86);
+
+    // ======================================================================
+    // GET_TELNET_PARSE_TIME
+    // ======================================================================
+    odin::metrics::histogram &get_telnet_parse_time()
+    {
+        static auto &parse_time = odin::metrics::get_registry().get_histogram(
+            "paradice_telnet_parse_seconds",
+            "Time taken to parse and answer telnet input.",
+            1e-9);
+        return parse_time;
+    }
+
+    // ======================================================================
+    // TO_SOCKET_CLASS
+    // ======================================================================
+    odin::net::socket::write_class to_socket_class(
+        connection::write_class cls)
+    {
+        switch (cls)
+        {
+            case connection::write_class::interactive :
+                return odin::net::socket::write_class::interactive;
+
+            case connection::write_class::repaint :
+                return odin::net::socket::write_class::repaint;
+
+            default :
+                return odin::net::socket::write_class::bulk;
+        }
+    }
+}
+
 // ==========================================================================
 // CONNECTION::IMPLEMENTATION STRUCTURE
 // ==========================================================================
@@ -53,8 +100,15 @@ struct connection::impl
     // ======================================================================
     // CONSTRUCTOR
     // ======================================================================
-    impl(std::shared_ptr<odin::net::socket> const &socket)
+    impl(
+        std::shared_ptr<odin::net::socket> const &socket,
+        std::shared_ptr<compression_pool>  const &compression,
+        std::shared_ptr<idle_sweeper>      const &sweeper,
+        connection::telnet_state           const *resumed_state)
       : socket_(socket),
+        strand_(socket->get_strand()),
+        compression_(compression),
+        sweeper_(sweeper),
         telnet_session_(
             [this](auto &&text) -> std::vector<telnetpp::token>
             {
@@ -62,7 +116,7 @@ struct connection::impl
                 return {};
             }),
         telnet_mccp_codec_(
-            std::make_shared<telnetpp::options::mccp::zlib::compressor>(),
+            compression_->make_compressor(),
             std::make_shared<telnetpp::options::mccp::zlib::decompressor>())
     {
         telnet_echo_server_.set_activatable();
@@ -100,16 +154,20 @@ struct connection::impl
         telnet_session_.install(telnet_terminal_type_client_);
 
         telnet_mccp_server_.set_activatable();
-        write(telnet_session_.send(telnet_mccp_server_.begin_compression()));
+
+        if (resumed_state == nullptr)
+        {
+            write(telnet_session_.send(
+                telnet_mccp_server_.begin_compression()));
+        }
+
         telnet_session_.install(telnet_mccp_server_);
-        
-        // Begin the keepalive process.  This sends regular heartbeats to the
-        // client to help guard against his network settings timing him out
-        // due to lack of activity.
-        keepalive_timer_ =
-            std::make_shared<boost::asio::deadline_timer>(
-                std::ref(socket_->get_io_service()));
-        schedule_keepalive();
+
+        if (resumed_state != nullptr)
+        {
+            resume(*resumed_state);
+            return;
+        }
         
         // Send the required activations.
         write(telnet_session_.send(telnet_echo_server_.activate()));
@@ -119,27 +177,285 @@ struct connection::impl
         write(telnet_session_.send(telnet_mccp_server_.activate()));
     }
 
+    // ======================================================================
+    // RESUME
+    // ======================================================================
+    void resume(connection::telnet_state const &state)
+    {
+        // The client agreed to these options with the process that handed
+        // the connection over.  Its agreement is replayed into the session
+        // so that the options become active here too.  The session's
+        // replies would only confuse the client, so they are discarded.
+        std::vector<odin::u8> agreement;
+
+        auto const agree = [&agreement](odin::u8 command, odin::u8 option)
+        {
+            agreement.insert(agreement.end(), { TELNET_IAC, command, option });
+        };
+
+        if (state.echo)
+        {
+            agree(TELNET_DO, TELNET_OPTION_ECHO);
+        }
+
+        if (state.suppress_ga)
+        {
+            agree(TELNET_DO, TELNET_OPTION_SUPPRESS_GA);
+        }
+
+        if (state.naws)
+        {
+            agree(TELNET_WILL, TELNET_OPTION_NAWS);
+        }
+
+        if (state.terminal_type)
+        {
+            agree(TELNET_WILL, TELNET_OPTION_TERMINAL_TYPE);
+        }
+
+        if (state.mccp)
+        {
+            agree(TELNET_DO, TELNET_OPTION_MCCP2);
+        }
+
+        telnet_session_.receive({agreement.begin(), agreement.end()});
+
+        terminal_type_  = state.terminal_type_name;
+        unparsed_bytes_ = state.unread_input;
+
+        // The previous process ended its compressed stream before handing
+        // over, so a fresh one is begun.
+        if (state.mccp)
+        {
+            write(telnet_session_.send(
+                telnet_mccp_server_.begin_compression()));
+        }
+    }
+
+    // ======================================================================
+    // PREPARE_HANDOVER
+    // ======================================================================
+    void prepare_handover(
+        std::function<
+            void (connection::telnet_state const &,
+                  std::shared_ptr<odin::net::socket> const &)
+        > const &callback)
+    {
+        if (handing_over_ || !socket_->is_alive())
+        {
+            callback({}, nullptr);
+            return;
+        }
+
+        // Reading is stopped before the socket is handed over, so that
+        // nothing the client sends is consumed by this process.  Anything
+        // that arrives in the meantime is kept to be passed on.
+        sweeper_session_.reset();
+        handing_over_ = true;
+
+        auto pthis = shared_from_this();
+        socket_->async_cancel_reads(
+            [pthis, callback]
+            {
+                pthis->finish_handover(callback);
+            });
+    }
+
+    // ======================================================================
+    // FINISH_HANDOVER
+    // ======================================================================
+    void finish_handover(
+        std::function<
+            void (connection::telnet_state const &,
+                  std::shared_ptr<odin::net::socket> const &)
+        > const &callback)
+    {
+        connection::telnet_state state;
+
+        if (!socket_->is_alive())
+        {
+            callback(state, nullptr);
+            return;
+        }
+
+        state.echo               = telnet_echo_server_.is_active();
+        state.suppress_ga        = telnet_suppress_ga_server_.is_active();
+        state.naws               = telnet_naws_client_.is_active();
+        state.terminal_type      = telnet_terminal_type_client_.is_active();
+        state.mccp               = telnet_mccp_server_.is_active();
+        state.terminal_type_name = terminal_type_;
+        state.unread_input       = std::move(unparsed_bytes_);
+        unparsed_bytes_.clear();
+
+        // Ending the compressed stream leaves the client ready to accept
+        // the new stream that the next process begins.
+        if (state.mccp && !compression_suspended_)
+        {
+            write(telnet_session_.send(
+                telnet_mccp_server_.end_compression()));
+        }
+
+        handed_over_ = true;
+
+        callback(state, socket_);
+    }
+
     // ======================================================================
     // START
     // ======================================================================
     void start()
     {
+        // Keepalives are sent to the client to help guard against its
+        // network settings timing it out due to lack of activity.  They,
+        // and the disconnection of idle clients, are left to the sweeper.
+        // The sweeper calls from its own thread, so each of its actions is
+        // posted onto this connection's strand.
+        if (sweeper_ != nullptr)
+        {
+            std::weak_ptr<impl> weak_this = shared_from_this();
+
+            sweeper_session_ = sweeper_->add_session(
+                [weak_this]
+                {
+                    auto pthis = weak_this.lock();
+
+                    if (pthis != nullptr)
+                    {
+                        pthis->strand_.post(
+                            [pthis]
+                            {
+                                pthis->on_keepalive();
+                            });
+                    }
+                },
+                [weak_this](std::chrono::seconds remaining)
+                {
+                    auto pthis = weak_this.lock();
+
+                    if (pthis != nullptr)
+                    {
+                        pthis->strand_.post(
+                            [pthis, remaining]
+                            {
+                                if (pthis->on_idle_warning_)
+                                {
+                                    pthis->on_idle_warning_(remaining);
+                                }
+                            });
+                    }
+                },
+                [weak_this]
+                {
+                    auto pthis = weak_this.lock();
+
+                    if (pthis != nullptr)
+                    {
+                        pthis->strand_.post(
+                            [pthis]
+                            {
+                                pthis->disconnect();
+                            });
+                    }
+                });
+        }
+
+        // Anything that the client sent while its connection was being
+        // handed over is handled before anything further is read.
+        if (!unparsed_bytes_.empty())
+        {
+            auto const input = std::move(unparsed_bytes_);
+            unparsed_bytes_.clear();
+            handle_input(input);
+        }
+
         schedule_next_read();
     }
+
+    // ======================================================================
+    // DISCONNECT
+    // ======================================================================
+    void disconnect()
+    {
+        sweeper_session_.reset();
+        socket_->close();
+    }
     
     // ======================================================================
     // WRITE
     // ======================================================================
-    void write(std::vector<telnetpp::stream_token> const &data)
+    void write(
+        std::vector<telnetpp::stream_token> const &data,
+        connection::write_class                    cls = 
+            connection::write_class::bulk)
     {
+        // Once the connection has been handed over, it belongs to another
+        // process, and anything written here would interleave with it.
+        // Once it has been disconnected, there is nowhere to write to.
+        if (handed_over_ || !socket_->is_alive())
+        {
+            return;
+        }
+
         auto const &compressed_data = telnet_mccp_codec_.send(data);
         auto const &stream = telnet_byte_converter_.send(compressed_data);
         
         if (stream.size() != 0)
         {
-            socket_->write({stream.begin(), stream.end()});
+            socket_->write(
+                {stream.begin(), stream.end()}, to_socket_class(cls));
+
+            // A repaint is written whole, so it can be sent as soon as it
+            // has been written.
+            if (cls == connection::write_class::repaint)
+            {
+                socket_->flush();
+            }
+
+            if (sweeper_session_ != nullptr)
+            {
+                sweeper_session_->note_output();
+            }
+        }
+    }
+
+    // ======================================================================
+    // WRITE_TEXT
+    // ======================================================================
+    void write_text(std::string const &text, connection::write_class cls)
+    {
+        // If compression was ended because the connection was idle, then
+        // it is begun again now that there is something to send.
+        if (compression_suspended_)
+        {
+            compression_suspended_ = false;
+            write(telnet_session_.send(
+                telnet_mccp_server_.begin_compression()), cls);
+        }
+
+        last_activity_ = std::chrono::steady_clock::now();
+        write(telnet_session_.send({telnetpp::element(text)}), cls);
+    }
+
+    // ======================================================================
+    // SUSPEND_IDLE_COMPRESSION
+    // ======================================================================
+    void suspend_idle_compression()
+    {
+        auto const idle_time =
+            std::chrono::steady_clock::now() - last_activity_;
+
+        // Ending compression returns this connection's deflate state to the
+        // pool, so that idle connections do not hold on to it.  As with
+        // every write, this is on the strand, so it cannot fall between
+        // write_text beginning compression again and its text being sent.
+        if (!compression_suspended_
+         && telnet_mccp_server_.is_active()
+         && idle_time >= compression_->get_settings().idle_timeout)
+        {
+            write(telnet_session_.send(
+                telnet_mccp_server_.end_compression()));
+            compression_suspended_ = true;
         }
-        
     }
 
     // ======================================================================
@@ -147,7 +463,7 @@ struct connection::impl
     // ======================================================================
     void schedule_next_read()
     {
-        if (!socket_->is_alive())
+        if (handing_over_ || !socket_->is_alive())
         {
             return;
         }
@@ -157,6 +473,9 @@ struct connection::impl
                     ? *available 
                     : odin::net::socket::input_size_type{1};
                     
+        // The socket completes its reads within the strand that is shared
+        // with this connection, so the data is handled directly, and the
+        // next read is requested from within the completion of this one.
         socket_->async_read(
             amount,
             [this](auto &&data)
@@ -170,38 +489,47 @@ struct connection::impl
     // ======================================================================
     void on_data(std::vector<odin::u8> const &data)
     {
-        write(telnet_session_.send(
-            telnet_session_.receive({data.begin(), data.end()})));
-            
+        if (handing_over_)
+        {
+            unparsed_bytes_.insert(
+                unparsed_bytes_.end(), data.begin(), data.end());
+            return;
+        }
+
+        handle_input(data);
         schedule_next_read();
     }
-    
+
     // ======================================================================
-    // ON_KEEPALIVE
+    // HANDLE_INPUT
     // ======================================================================
-    void on_keepalive(boost::system::error_code const &error)
+    void handle_input(std::vector<odin::u8> const &data)
     {
-        if (!error && socket_->is_alive())
+        if (sweeper_session_ != nullptr)
         {
-            write(telnet_session_.send({
-                    telnetpp::element(telnetpp::command(telnetpp::nop))
-                }));
+            sweeper_session_->note_input();
+        }
 
-            schedule_keepalive();
+        {
+            odin::metrics::scoped_timer timer(get_telnet_parse_time());
+            write(telnet_session_.send(
+                telnet_session_.receive({data.begin(), data.end()})));
         }
     }
-
+    
     // ======================================================================
-    // SCHEDULE_KEEPALIVE
+    // ON_KEEPALIVE
     // ======================================================================
-    void schedule_keepalive()
+    void on_keepalive()
     {
-        keepalive_timer_->expires_from_now(boost::posix_time::seconds(30));
-        keepalive_timer_->async_wait(
-            [this](auto const &error_code)
-            {
-                this->on_keepalive(error_code);
-            });
+        if (socket_->is_alive())
+        {
+            suspend_idle_compression();
+
+            write(telnet_session_.send({
+                    telnetpp::element(telnetpp::command(telnetpp::nop))
+                }));
+        }
     }
 
     // ======================================================================
@@ -248,7 +576,20 @@ struct connection::impl
         terminal_type_requests_.clear();
     }
     
-    std::shared_ptr<odin::net::socket>                   socket_;
+    // The socket is kept for as long as the connection, since it owns the
+    // strand.  Everything below, including whether compression is
+    // suspended, is confined to that strand once the connection has been
+    // constructed.
+    std::shared_ptr<odin::net::socket> const             socket_;
+    boost::asio::strand                                 &strand_;
+    std::shared_ptr<compression_pool>                    compression_;
+    std::shared_ptr<idle_sweeper>                        sweeper_;
+    std::shared_ptr<idle_sweeper::session>               sweeper_session_;
+    std::chrono::steady_clock::time_point                last_activity_ =
+        std::chrono::steady_clock::now();
+    bool                                                 compression_suspended_ = false;
+    bool                                                 handing_over_ = false;
+    bool                                                 handed_over_ = false;
     std::vector<odin::u8>                                unparsed_bytes_;
     
     std::function<void (std::string const &)>            on_data_read_;
@@ -263,7 +604,7 @@ struct connection::impl
     telnetpp::byte_converter                             telnet_byte_converter_;
     
     std::function<void (odin::u16, odin::u16)>           on_window_size_changed_;
-    std::shared_ptr<boost::asio::deadline_timer>         keepalive_timer_;
+    std::function<void (std::chrono::seconds)>           on_idle_warning_;
 
     std::string                                          terminal_type_;
     std::vector<std::function<void (std::string)>>       terminal_type_requests_;
@@ -272,8 +613,23 @@ struct connection::impl
 // ==========================================================================
 // CONSTRUCTOR
 // ==========================================================================
-connection::connection(std::shared_ptr<odin::net::socket> const &socket)
-    : pimpl_(std::make_shared<impl>(socket))
+connection::connection(
+    std::shared_ptr<odin::net::socket> const &socket
+  , std::shared_ptr<compression_pool>  const &compression
+  , std::shared_ptr<idle_sweeper>      const &sweeper)
+    : pimpl_(std::make_shared<impl>(socket, compression, sweeper, nullptr))
+{
+}
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+connection::connection(
+    std::shared_ptr<odin::net::socket> const &socket
+  , std::shared_ptr<compression_pool>  const &compression
+  , std::shared_ptr<idle_sweeper>      const &sweeper
+  , telnet_state                       const &state)
+    : pimpl_(std::make_shared<impl>(socket, compression, sweeper, &state))
 {
 }
 
@@ -290,17 +646,27 @@ connection::~connection()
 // ==========================================================================
 void connection::start()
 {
-    pimpl_->start();
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl]
+        {
+            pimpl->start();
+        });
 }
 
 // ==========================================================================
 // WRITE
 // ==========================================================================
-void connection::write(std::string const &data)
+void connection::write(std::string const &data, write_class cls)
 {
-    pimpl_->write(pimpl_->telnet_session_.send({
-        telnetpp::element(data)
-    }));
+    // Writes are posted, rather than dispatched, so that they are sent in
+    // the order in which they were made.
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl, data, cls]
+        {
+            pimpl->write_text(data, cls);
+        });
 }
 
 // ==========================================================================
@@ -309,7 +675,12 @@ void connection::write(std::string const &data)
 void connection::on_data_read(
     std::function<void (std::string const &)> const &callback)
 {
-    pimpl_->on_data_read_ = callback;
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl, callback]
+        {
+            pimpl->on_data_read_ = callback;
+        });
 }
 
 // ==========================================================================
@@ -318,7 +689,12 @@ void connection::on_data_read(
 void connection::on_window_size_changed(
     std::function<void (odin::u16, odin::u16)> const &callback)
 {
-    pimpl_->on_window_size_changed_ = callback;
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl, callback]
+        {
+            pimpl->on_window_size_changed_ = callback;
+        });
 }
 
 // ==========================================================================
@@ -326,7 +702,33 @@ void connection::on_window_size_changed(
 // ==========================================================================
 void connection::on_socket_death(std::function<void ()> const &callback)
 {
-    pimpl_->socket_->on_death(callback);
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl, callback]
+        {
+            if (pimpl->socket_->is_alive())
+            {
+                pimpl->socket_->on_death(callback);
+            }
+            else if (callback)
+            {
+                callback();
+            }
+        });
+}
+
+// ==========================================================================
+// ON_IDLE_WARNING
+// ==========================================================================
+void connection::on_idle_warning(
+    std::function<void (std::chrono::seconds)> const &callback)
+{
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl, callback]
+        {
+            pimpl->on_idle_warning_ = callback;
+        });
 }
 
 // ==========================================================================
@@ -334,17 +736,13 @@ void connection::on_socket_death(std::function<void ()> const &callback)
 // ==========================================================================
 void connection::disconnect()
 {
-    if (pimpl_->keepalive_timer_ != nullptr)
-    {
-        boost::system::error_code unused_error_code;
-        pimpl_->keepalive_timer_->cancel(unused_error_code);
-    }
-
-    if (pimpl_->socket_ != nullptr)
-    {
-        pimpl_->socket_->close();
-        pimpl_->socket_.reset();
-    }
+    // Anything already written is sent before the socket is closed.
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl]
+        {
+            pimpl->disconnect();
+        });
 }
 
 // ==========================================================================
@@ -353,7 +751,29 @@ void connection::disconnect()
 void connection::async_get_terminal_type(
     std::function<void (std::string const &)> const &callback)
 {
-    pimpl_->terminal_type_requests_.push_back(callback);
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl, callback]
+        {
+            pimpl->terminal_type_requests_.push_back(callback);
+        });
+}
+
+// ==========================================================================
+// ASYNC_PREPARE_HANDOVER
+// ==========================================================================
+void connection::async_prepare_handover(
+    std::function<
+        void (telnet_state const &,
+              std::shared_ptr<odin::net::socket> const &)
+    > const &callback)
+{
+    auto pimpl = pimpl_;
+    pimpl_->strand_.post(
+        [pimpl, callback]
+        {
+            pimpl->prepare_handover(callback);
+        });
 }
 
 }
@@ -95,13 +95,14 @@ struct dice_roll_grammar
 /// For example, "2d6+3-4" will convert to a dice_roll of { 1, 2, 6, -1 };
 /// "3*2d20" will convert to a dice_roll of { 3, 2, 20, 0 };
 //* =========================================================================
-boost::optional<dice_roll> parse_dice_roll(
-    std::string::const_iterator &begin
-  , std::string::const_iterator  end)
+template <class Iterator>
+static boost::optional<dice_roll> parse_dice_roll_range(
+    Iterator &begin
+  , Iterator  end)
 {
-    dice_roll_grammar<std::string::const_iterator>  roll_grammar;
-    dice_roll                                       result;
-    dice_roll                                      &ref_result = result;
+    dice_roll_grammar<Iterator>  roll_grammar;
+    dice_roll                    result;
+    dice_roll                   &ref_result = result;
 
     if (phrase_parse(
         begin
@@ -118,4 +119,24 @@ boost::optional<dice_roll> parse_dice_roll(
     }
 }
 
+// ==========================================================================
+// PARSE_DICE_ROLL
+// ==========================================================================
+boost::optional<dice_roll> parse_dice_roll(
+    std::string::const_iterator &begin
+  , std::string::const_iterator  end)
+{
+    return parse_dice_roll_range(begin, end);
+}
+
+// ==========================================================================
+// PARSE_DICE_ROLL
+// ==========================================================================
+boost::optional<dice_roll> parse_dice_roll(
+    char const *&begin
+  , char const  *end)
+{
+    return parse_dice_roll_range(begin, end);
+}
+
 }
@@ -25,12 +25,15 @@
 #include "paradice/gm.hpp"
 #include "paradice/active_encounter.hpp"
 #include "paradice/client.hpp"
+#include "paradice/command_table.hpp"
 #include "paradice/communication.hpp"
 #include "paradice/context.hpp"
+#include "paradice/table.hpp"
 #include "hugin/user_interface.hpp"
 #include "odin/tokenise.hpp"
 #include <boost/lexical_cast.hpp>
 #include <boost/format.hpp>
+#include <vector>
 
 namespace paradice {
 
@@ -45,17 +48,17 @@ PARADICE_COMMAND_IMPL(gm_tools)
 
 PARADICE_COMMAND_IMPL(gm_encounter_show)
 {
-    ctx->set_active_encounter_visible(true);
+    player->get_table()->set_encounter_visible(true);
 }
 
 PARADICE_COMMAND_IMPL(gm_encounter_hide)
 {
-    ctx->set_active_encounter_visible(false);
+    player->get_table()->set_encounter_visible(false);
 }
 
 static void add_encounter_player(
     std::shared_ptr<character> ch,
-    std::shared_ptr<context> ctx)
+    std::shared_ptr<active_encounter> const &enc)
 {
     // Don't add the GM.
     if (ch->get_gm_level() != 0)
@@ -65,7 +68,6 @@ static void add_encounter_player(
 
     bool found = false;
 
-    auto enc = ctx->get_active_encounter();
     for (auto &entry : enc->entries_)
     {
         auto participant_player = 
@@ -98,71 +100,87 @@ static void add_encounter_player(
 
 static void remove_encounter_participant(
     odin::u32 id,
-    std::shared_ptr<context> ctx)
+    std::shared_ptr<table> tbl)
 {
-    auto enc = ctx->get_active_encounter();
-
-    enc->entries_.erase(
-        std::remove_if(
-            enc->entries_.begin(),
-            enc->entries_.end(),
-            [id](auto const &entry)
-            {
-                return entry.id_ == id;
-            }),
-        enc->entries_.end());
-
-    ctx->update_active_encounter();
+    tbl->modify_encounter(
+        [id](auto const &enc)
+        {
+            remove_participant(enc, id);
+        });
 }
 
 PARADICE_COMMAND_IMPL(gm_encounter_add_player)
 {
     auto arg0 = odin::tokenise(arguments);
     auto argument = arg0.first;
+    auto tbl = player->get_table();
 
+    // Only players sitting at the GM's table may join its encounter.
     for (auto cli : ctx->get_clients())
     {
+        if (cli->get_table() != tbl)
+        {
+            continue;
+        }
+
         auto ch = cli->get_character();
 
         if (ch->get_name() == argument)
         {
-            add_encounter_player(ch, ctx);
+            tbl->modify_encounter(
+                [ch](auto const &enc)
+                {
+                    add_encounter_player(ch, enc);
+                });
             break;
         }
     }
-
-    ctx->update_active_encounter();
 }
 
 PARADICE_COMMAND_IMPL(gm_encounter_add_players)
 {
+    auto tbl = player->get_table();
+    std::vector<std::shared_ptr<character>> characters;
+
     for (auto cli : ctx->get_clients())
     {
-        add_encounter_player(cli->get_character(), ctx);
+        if (cli->get_table() == tbl)
+        {
+            characters.push_back(cli->get_character());
+        }
     }
 
-    ctx->update_active_encounter();
+    tbl->modify_encounter(
+        [characters](auto const &enc)
+        {
+            for (auto const &ch : characters)
+            {
+                add_encounter_player(ch, enc);
+            }
+        });
 }
 
 PARADICE_COMMAND_IMPL(gm_encounter_add)
 {
+    static command_table const commands =
+    {
+        { "player",  do_gm_encounter_add_player,  0, 0, false }
+      , { "players", do_gm_encounter_add_players, 0, 0, false }
+    };
+
     auto arg0 = odin::tokenise(arguments);
     auto argument = arg0.first;
+    auto const found = commands.find(argument);
 
-#define DISPATCH_GM_ENCOUNTER_ADD_COMMAND(cmd) \
-    if (argument == #cmd) \
-    { \
-        INVOKE_PARADICE_COMMAND(gm_encounter_add_##cmd, ctx, arg0.second, player); \
-        return; \
+    if (found.command_ != nullptr)
+    {
+        found.command_->function_(ctx, arg0.second, player);
+        return;
     }
 
-    DISPATCH_GM_ENCOUNTER_ADD_COMMAND(player);
-    DISPATCH_GM_ENCOUNTER_ADD_COMMAND(players);
-#undef DISPATCH_GM_ENCOUNTER_ADD_COMMAND
-
     send_to_player(
         ctx
-      , "Unknown: gm encounter add " + argument
+      , "Unknown: gm encounter add " + argument.to_string()
       , player);
 
 }
@@ -174,9 +192,11 @@ PARADICE_COMMAND_IMPL(gm_encounter_remove)
 
     if (argument == "all")
     {
-        auto enc = ctx->get_active_encounter();
-        enc->entries_.clear();
-        ctx->update_active_encounter();
+        player->get_table()->modify_encounter(
+            [](auto const &enc)
+            {
+                clear_participants(enc);
+            });
     }
     else
     {
@@ -184,7 +204,8 @@ PARADICE_COMMAND_IMPL(gm_encounter_remove)
  
         try
         {
-            id = boost::lexical_cast<odin::u32>(argument);
+            id = boost::lexical_cast<odin::u32>(
+                argument.data(), argument.size());
         }
         catch(boost::bad_lexical_cast const &)
         {
@@ -195,8 +216,7 @@ PARADICE_COMMAND_IMPL(gm_encounter_remove)
             return;
         }
 
-        remove_encounter_participant(id, ctx);
-        ctx->update_active_encounter();
+        remove_encounter_participant(id, player->get_table());
         return;
     }
 
@@ -208,14 +228,14 @@ PARADICE_COMMAND_IMPL(gm_encounter_remove)
 
 PARADICE_COMMAND_IMPL(gm_encounter_move)
 {
-    auto arg0 = odin::tokenise(arguments);
-    auto id_arg = arg0.first;
+    odin::tokeniser tokens(arguments);
+    auto id_arg = tokens.next();
 
     odin::u32 id = 0;
 
     try
     {
-        id = boost::lexical_cast<odin::u32>(id_arg);
+        id = boost::lexical_cast<odin::u32>(id_arg.data(), id_arg.size());
     }
     catch(boost::bad_lexical_cast const &)
     {
@@ -226,93 +246,88 @@ PARADICE_COMMAND_IMPL(gm_encounter_move)
         return;
     }
 
-    auto enc = ctx->get_active_encounter();
-    auto entry_it = enc->entries_.begin();
-
-    for (; entry_it != enc->entries_.end(); ++entry_it)
-    {
-        if (entry_it->id_ == id)
-        {
-            break;
-        }
-    }
+    // The direction outlives the command line, so it is copied.
+    auto dir_arg = tokens.next().to_string();
 
-    if (entry_it == enc->entries_.end())
+    if (dir_arg != "up"
+     && dir_arg != "down"
+     && dir_arg != "top"
+     && dir_arg != "bottom")
     {
         send_to_player(
             ctx
-          , boost::str(boost::format(
-                "Error: No entry in the active encounter with id %d\n")
-                % id)
+          , "USAGE: gm encounter move <id> (up|down|top|bottom)\n"
           , player);
         return;
     }
 
-    auto arg1 = odin::tokenise(arg0.second);
-    auto dir_arg = arg1.first;
-
-    if (dir_arg == "up")
-    {
-        if (entry_it != enc->entries_.begin())
-        {
-            std::iter_swap(entry_it, entry_it - 1);
-            ctx->update_active_encounter();
-        }
-    }
-    else if (dir_arg == "down")
-    {
-        if (entry_it + 1 != enc->entries_.end())
+    player->get_table()->modify_encounter(
+        [ctx, player, id, dir_arg](auto const &enc) mutable
         {
-            std::iter_swap(entry_it, entry_it + 1);
-            ctx->update_active_encounter();
-        }
-    }
-    else if (dir_arg == "top")
-    {
-        active_encounter::entry cloned_entry = *entry_it;
-        enc->entries_.erase(entry_it);
-        enc->entries_.insert(enc->entries_.begin(), cloned_entry);
-        ctx->update_active_encounter();
-    }
-    else if (dir_arg == "bottom")
-    {
-        active_encounter::entry cloned_entry = *entry_it;
-        enc->entries_.erase(entry_it);
-        enc->entries_.insert(enc->entries_.end(), cloned_entry);
-        ctx->update_active_encounter();
-    }
-    else
-    {
-        send_to_player(
-            ctx
-          , "USAGE: gm encounter move <id> (up|down|top|bottom)\n"
-          , player);
-    }
+            auto const index = find_participant(enc, id);
+
+            if (!index)
+            {
+                send_to_player(
+                    ctx
+                  , boost::str(boost::format(
+                        "Error: No entry in the active encounter with id %d\n")
+                        % id)
+                  , player);
+                return;
+            }
+
+            auto const last_index = odin::u32(enc->entries_.size() - 1);
+
+            if (dir_arg == "up")
+            {
+                if (*index != 0)
+                {
+                    move_participant(enc, id, *index - 1);
+                }
+            }
+            else if (dir_arg == "down")
+            {
+                if (*index != last_index)
+                {
+                    move_participant(enc, id, *index + 1);
+                }
+            }
+            else if (dir_arg == "top")
+            {
+                move_participant(enc, id, 0);
+            }
+            else
+            {
+                move_participant(enc, id, last_index);
+            }
+        });
 }
 
 PARADICE_COMMAND_IMPL(gm_encounter)
 {
+    static command_table const commands =
+    {
+        { "add",    do_gm_encounter_add,    0, 0, false }
+      , { "hide",   do_gm_encounter_hide,   0, 0, false }
+      , { "move",   do_gm_encounter_move,   0, 0, false }
+      , { "remove", do_gm_encounter_remove, 0, 0, false }
+      , { "show",   do_gm_encounter_show,   0, 0, false }
+    };
+
     auto arg0 = odin::tokenise(arguments);
     auto argument = arg0.first;
+    auto const found = commands.find(argument);
 
-#define DISPATCH_GM_ENCOUNTER_COMMAND(cmd) \
-    if (argument == #cmd) \
-    { \
-        INVOKE_PARADICE_COMMAND(gm_encounter_##cmd, ctx, arg0.second, player); \
-        return; \
+    if (found.command_ != nullptr)
+    {
+        found.command_->function_(ctx, arg0.second, player);
+        return;
     }
 
-    DISPATCH_GM_ENCOUNTER_COMMAND(add);
-    DISPATCH_GM_ENCOUNTER_COMMAND(hide);
-    DISPATCH_GM_ENCOUNTER_COMMAND(move);
-    DISPATCH_GM_ENCOUNTER_COMMAND(remove);
-    DISPATCH_GM_ENCOUNTER_COMMAND(show);
-
-#undef DISPATCH_GM_ENCOUNTER_COMMAND
-
     send_to_player(
         ctx
-      , "Unknown: gm encounter " + argument
+      , "Unknown: gm encounter " + argument.to_string()
       , player);
 }
 
@@ -323,19 +338,20 @@ PARADICE_COMMAND_IMPL(gm_encounter)
 // ==========================================================================
 PARADICE_COMMAND_IMPL(gm)
 {
+    static command_table const commands =
+    {
+        { "tools",     do_gm_tools,     0, 0, false }
+      , { "encounter", do_gm_encounter, 0, 0, false }
+    };
+
     auto arg0 = odin::tokenise(arguments);
-    auto argument = arg0.first;
+    auto const found = commands.find(arg0.first);
 
-#define DISPATCH_GM_COMMAND(cmd) \
-    if (argument == #cmd) \
-    { \
-        INVOKE_PARADICE_COMMAND(gm_##cmd, ctx, arg0.second, player); \
-        return; \
+    if (found.command_ != nullptr)
+    {
+        found.command_->function_(ctx, arg0.second, player);
+        return;
     }
-    
-    DISPATCH_GM_COMMAND(tools);
-    DISPATCH_GM_COMMAND(encounter);
-#undef DISPATCH_GM_COMMAND
 
     send_to_player(
         ctx
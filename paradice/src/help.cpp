@@ -22,14 +22,21 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER 
 // DEALINGS IN THE SOFTWARE.
 // ==========================================================================
-#include "paradice/rules.hpp"
+#include "paradice/help.hpp"
 #include "paradice/client.hpp"
-#include "paradice/communication.hpp"
-#include "paradice/connection.hpp"
+#include "paradice/context.hpp"
+#include "paradice/help_corpus.hpp"
+#include "paradice/utility.hpp"
 #include "odin/tokenise.hpp"
 #include "hugin/user_interface.hpp"
 #include "terminalpp/encoder.hpp"
-#include <boost/format.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = boost::filesystem;
 
 namespace {
     static std::string const help_header =
@@ -149,6 +156,19 @@ namespace {
         "\n"
         "Clears all rolls from the specified category.\n";
         
+    static std::string const help_tables =
+        "COMMAND: TABLE\n"
+        "\n"
+        " USAGE:   table [<name>]\n"
+        " EXAMPLE: table\n"
+        " EXAMPLE: table dungeon\n"
+        "\n"
+        "With no name, lists the tables in play, with their players and GMs.\n"
+        "With a name, sits you at that table, setting it up if need be.  "
+        "Each table has its own encounter and roll categories, and what is "
+        "said at a table is only heard there.  A table may have only one "
+        "GM.\n";
+
     static std::string const help_password =
         "COMMAND: PASSWORD\n"
         "\n"
@@ -164,6 +184,13 @@ namespace {
         "\n"
         "Shows help on the specified subject.\n"
         "\n"
+        "  USAGE:   help search <words>\n"
+        "  EXAMPLE: help search dice\n"
+        "\n"
+        "Lists the subjects that mention all of the words.  A word also "
+        "matches any longer word that it begins, so that 'enc' finds "
+        "'encounter'.\n"
+        "\n"
         "  USAGE:   help close\n"
         "\n"
         "Closes the help window.\n";
@@ -177,81 +204,162 @@ namespace {
         "  TOOLS - brings up an screen of tools for GMs.\n"
         "  ENCOUNTER <command> - manipulate the live encounters (todo).\n";
 
-    static struct help_item 
-    {
-        std::string command;
-        std::string text;
-    } const help_table[] =
+    static std::string const help_search_usage =
+        "  USAGE:   help search <words>\n"
+        "  EXAMPLE: help search dice\n";
+}
+
+namespace paradice {
+
+// ==========================================================================
+// MAKE_HELP_CORPUS
+// ==========================================================================
+std::shared_ptr<help_corpus const> make_help_corpus(
+    std::string const &directory)
+{
+    std::vector<help_topic> topics =
     {
-        { "!",           help_repeat      }
-      , { "say",         help_say         }
-      , { ".",           help_say         }
-      , { "whisper",     help_whisper     }
-      , { ">",           help_whisper     }
-      , { "emote",       help_emote       }
-      , { ":",           help_emote       }
-      , { "set",         help_set         }
-      , { "title",       help_title       }
-      , { "surname",     help_title       }
-      , { "prefix",      help_prefix      }
-      , { "honorific",   help_prefix      }
-      , { "roll",        help_roll        }
-      , { "rollprivate", help_rollprivate }
-      , { "showrolls",   help_showrolls   }
-      , { "clearrolls",  help_clearrolls  }
-      , { "password",    help_password    }
-      , { "gm",          help_gm          }
-      , { "help",        help_help        }
+        { { "!"                       }, help_repeat      }
+      , { { "say",        "."         }, help_say         }
+      , { { "whisper",    ">"         }, help_whisper     }
+      , { { "emote",      ":"         }, help_emote       }
+      , { { "set"                     }, help_set         }
+      , { { "title",      "surname"   }, help_title       }
+      , { { "prefix",     "honorific" }, help_prefix      }
+      , { { "roll"                    }, help_roll        }
+      , { { "rollprivate"             }, help_rollprivate }
+      , { { "showrolls"               }, help_showrolls   }
+      , { { "clearrolls"              }, help_clearrolls  }
+      , { { "table"                   }, help_tables      }
+      , { { "password"                }, help_password    }
+      , { { "gm"                      }, help_gm          }
+      , { { "help"                    }, help_help        }
     };
+
+    if (!directory.empty())
+    {
+        if (!fs::is_directory(directory))
+        {
+            throw std::runtime_error(
+                "help directory not found: " + directory);
+        }
+
+        // Files are taken in order of name, so that the listing does not
+        // depend on the order in which the directory happens to be read.
+        std::vector<fs::path> paths;
+
+        for (auto const &entry : fs::directory_iterator(directory))
+        {
+            if (fs::is_regular_file(entry.status()))
+            {
+                paths.push_back(entry.path());
+            }
+        }
+
+        std::sort(paths.begin(), paths.end());
+
+        for (auto const &path : paths)
+        {
+            std::ifstream file(path.string());
+            std::stringstream text;
+
+            if (!file || !(text << file.rdbuf()))
+            {
+                throw std::runtime_error(
+                    "unable to read help file: " + path.string());
+            }
+
+            auto const name = path.stem().string();
+
+            // A file with the same name as a command replaces the help for
+            // that command.
+            auto const existing = std::find_if(
+                topics.begin()
+              , topics.end()
+              , [&name](auto const &topic)
+                {
+                    return std::any_of(
+                        topic.names_.begin()
+                      , topic.names_.end()
+                      , [&name](auto const &topic_name)
+                        {
+                            return is_iequal(topic_name, name);
+                        });
+                });
+
+            if (existing == topics.end())
+            {
+                topics.push_back({ { name }, text.str() });
+            }
+            else
+            {
+                existing->text_ = text.str();
+            }
+        }
+    }
+
+    return std::make_shared<help_corpus const>(topics, help_header);
 }
 
-namespace paradice {
 
 // ==========================================================================
 // PARADICE COMMAND: HELP
 // ==========================================================================
 PARADICE_COMMAND_IMPL(help)
 {
-    auto argument = odin::tokenise(arguments).first;
+    odin::tokeniser tokens(arguments);
+    auto const subject = tokens.next();
     auto user_interface = player->get_user_interface();
     
-    if (argument == "close")
+    if (subject == "close")
     {
         user_interface->hide_help_window();
+        return;
     }
-    else
+
+    auto const help = ctx->get_help();
+
+    if (subject == "search")
     {
-        for (size_t index = 0;
-             index < (sizeof(help_table) / sizeof(*help_table));
-             ++index)
+        auto const words = tokens.rest();
+        auto text = help_header;
+
+        if (words.empty())
         {
-            if (argument == help_table[index].command)
-            {
-                user_interface->set_help_window_text(
-                    terminalpp::encode(
-                        help_header
-                      + help_table[index].text));
-                user_interface->show_help_window();
-                return;
-            }
+            text += help_search_usage;
         }
-        
-        auto text = 
-            help_header
-          + "No help on that subject was found.  Available subjects are:\n";
-            
-        for (size_t index = 0;
-             index < (sizeof(help_table) / sizeof(*help_table));
-             ++index)
+        else
         {
-            text += help_table[index].command;
-            text += " ";
+            auto const titles = help->search(words);
+
+            if (titles.empty())
+            {
+                text += "No subjects were found that mention \""
+                      + words.to_string()
+                      + "\".\n";
+            }
+            else
+            {
+                text += "Subjects that mention \""
+                      + words.to_string()
+                      + "\" are:\n";
+
+                for (auto const &title : titles)
+                {
+                    text += title;
+                    text += " ";
+                }
+            }
         }
-        
+
         user_interface->set_help_window_text(terminalpp::encode(text));
         user_interface->show_help_window();
+        return;
     }
-}
 
+    auto const page = help->find(subject);
+    user_interface->set_help_window_text(page ? *page : *help->get_index());
+    user_interface->show_help_window();
 }
 
+}
@@ -0,0 +1,304 @@
+// ==========================================================================
+// Paradice Help Corpus
+//
+// Copyright (C) 2013 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "paradice/help_corpus.hpp"
+#include "odin/core.hpp"
+#include "terminalpp/encoder.hpp"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <utility>
+
+namespace paradice {
+
+namespace {
+
+// ==========================================================================
+// FOLD
+// ==========================================================================
+char fold(char ch)
+{
+    return ch >= 'A' && ch <= 'Z' ? char(ch - 'A' + 'a') : ch;
+}
+
+// ==========================================================================
+// IS_WORD_CHARACTER
+// ==========================================================================
+bool is_word_character(char ch)
+{
+    return (ch >= 'a' && ch <= 'z')
+        || (ch >= 'A' && ch <= 'Z')
+        || (ch >= '0' && ch <= '9');
+}
+
+// ==========================================================================
+// FOR_EACH_WORD
+// ==========================================================================
+// Calls fn with each of the words in the text, folded.
+template <class Function>
+void for_each_word(boost::string_view text, Function &&fn)
+{
+    auto current = text.begin();
+
+    for (;;)
+    {
+        current = std::find_if(current, text.end(), is_word_character);
+
+        if (current == text.end())
+        {
+            return;
+        }
+
+        auto const end = std::find_if_not(
+            current, text.end(), is_word_character);
+
+        std::string word(current, end);
+        std::transform(word.begin(), word.end(), word.begin(), fold);
+        fn(std::move(word));
+
+        current = end;
+    }
+}
+
+// ==========================================================================
+// PRECEDES
+// ==========================================================================
+// Returns true if the (folded) topic name sorts before name, folded.
+bool precedes(std::string const &topic_name, boost::string_view name)
+{
+    auto const length = (std::min)(topic_name.size(), name.size());
+
+    for (std::size_t index = 0; index < length; ++index)
+    {
+        auto const lhs = topic_name[index];
+        auto const rhs = fold(name[index]);
+
+        if (lhs != rhs)
+        {
+            return lhs < rhs;
+        }
+    }
+
+    return topic_name.size() < name.size();
+}
+
+// ==========================================================================
+// IS_FOLDED_EQUAL
+// ==========================================================================
+bool is_folded_equal(std::string const &topic_name, boost::string_view name)
+{
+    return topic_name.size() == name.size()
+        && std::equal(
+               name.begin()
+             , name.end()
+             , topic_name.begin()
+             , [](char lhs, char rhs)
+               {
+                   return fold(lhs) == rhs;
+               });
+}
+
+}
+
+// ==========================================================================
+// HELP_CORPUS::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct help_corpus::impl
+{
+    // The page of each topic, and the name under which it is listed in
+    // search results.
+    std::vector<page_type>   pages_;
+    std::vector<std::string> titles_;
+
+    // Every name of every topic, folded and sorted, with the index of the
+    // topic it names.
+    std::vector<std::pair<std::string, odin::u32>> names_;
+
+    // For each word, the indices of the topics that contain it, in
+    // ascending order.
+    std::map<std::string, std::vector<odin::u32>> words_;
+
+    page_type index_;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+help_corpus::help_corpus(
+    std::vector<help_topic> const &topics
+  , std::string const             &header)
+    : pimpl_(std::make_shared<impl>())
+{
+    auto listing =
+        header
+      + "No help on that subject was found.  Available subjects are:\n";
+
+    for (odin::u32 topic = 0; topic < topics.size(); ++topic)
+    {
+        auto const &current = topics[topic];
+
+        pimpl_->pages_.push_back(std::make_shared<terminalpp::string const>(
+            terminalpp::encode(header + current.text_)));
+        pimpl_->titles_.push_back(
+            current.names_.empty() ? std::string() : current.names_.front());
+
+        auto const add_word =
+            [this, topic](std::string &&word)
+            {
+                auto &containing = pimpl_->words_[std::move(word)];
+
+                if (containing.empty() || containing.back() != topic)
+                {
+                    containing.push_back(topic);
+                }
+            };
+
+        for (auto const &name : current.names_)
+        {
+            std::string folded_name(name);
+            std::transform(
+                folded_name.begin(), folded_name.end(), folded_name.begin(),
+                fold);
+            pimpl_->names_.emplace_back(std::move(folded_name), topic);
+
+            listing += name;
+            listing += " ";
+
+            for_each_word(name, add_word);
+        }
+
+        for_each_word(current.text_, add_word);
+    }
+
+    // A stable sort keeps the first topic of any that share a name at the
+    // front, where find() looks for it.
+    std::stable_sort(
+        pimpl_->names_.begin()
+      , pimpl_->names_.end()
+      , [](auto const &lhs, auto const &rhs)
+        {
+            return lhs.first < rhs.first;
+        });
+
+    pimpl_->index_ = std::make_shared<terminalpp::string const>(
+        terminalpp::encode(listing));
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+help_corpus::~help_corpus()
+{
+}
+
+// ==========================================================================
+// FIND
+// ==========================================================================
+help_corpus::page_type help_corpus::find(boost::string_view name) const
+{
+    auto const found = std::lower_bound(
+        pimpl_->names_.begin()
+      , pimpl_->names_.end()
+      , name
+      , [](auto const &entry, boost::string_view name)
+        {
+            return precedes(entry.first, name);
+        });
+
+    if (found == pimpl_->names_.end() || !is_folded_equal(found->first, name))
+    {
+        return {};
+    }
+
+    return pimpl_->pages_[found->second];
+}
+
+// ==========================================================================
+// GET_INDEX
+// ==========================================================================
+help_corpus::page_type help_corpus::get_index() const
+{
+    return pimpl_->index_;
+}
+
+// ==========================================================================
+// SEARCH
+// ==========================================================================
+std::vector<std::string> help_corpus::search(boost::string_view words) const
+{
+    std::vector<odin::u32> found;
+    bool first = true;
+
+    for_each_word(
+        words
+      , [this, &found, &first](std::string &&word)
+        {
+            // Gather the topics that contain any word that begins with
+            // this one.
+            std::vector<odin::u32> matches;
+
+            for (auto current = pimpl_->words_.lower_bound(word);
+                 current != pimpl_->words_.end()
+              && current->first.compare(0, word.size(), word) == 0;
+                 ++current)
+            {
+                matches.insert(
+                    matches.end()
+                  , current->second.begin()
+                  , current->second.end());
+            }
+
+            std::sort(matches.begin(), matches.end());
+            matches.erase(
+                std::unique(matches.begin(), matches.end()), matches.end());
+
+            if (first)
+            {
+                found = std::move(matches);
+                first = false;
+            }
+            else
+            {
+                std::vector<odin::u32> both;
+                std::set_intersection(
+                    found.begin(), found.end()
+                  , matches.begin(), matches.end()
+                  , std::back_inserter(both));
+                found = std::move(both);
+            }
+        });
+
+    std::vector<std::string> titles;
+
+    for (auto const topic : found)
+    {
+        titles.push_back(pimpl_->titles_[topic]);
+    }
+
+    return titles;
+}
+
+}
@@ -0,0 +1,426 @@
+// ==========================================================================
+// Paradice Idle Sweeper
+//
+// Copyright (C) 2009 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "paradice/idle_sweeper.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace paradice {
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    // Sessions are examined once per tick of the sweep interval, and kept
+    // in one of a ring of buckets according to the tick on which they are
+    // next due.  Those due more than a full turn of the ring ahead wait in
+    // their bucket until their turn comes round.
+    BOOST_STATIC_CONSTANT(odin::u32, NUMBER_OF_BUCKETS = 64);
+}
+
+// ==========================================================================
+// IDLE_SWEEPER::SESSION::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct idle_sweeper::session::impl
+{
+    std::function<void ()>                     send_keepalive_;
+    std::function<void (std::chrono::seconds)> warn_;
+    std::function<void ()>                     evict_;
+
+    std::atomic<clock_type::rep>               last_input_;
+    std::atomic<clock_type::rep>               last_output_;
+
+    // Only accessed by the sweeper, under its lock.
+    bool                                       warned_ = false;
+};
+
+// ==========================================================================
+// IDLE_SWEEPER::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct idle_sweeper::impl
+    : public std::enable_shared_from_this<idle_sweeper::impl>
+{
+    // ======================================================================
+    // ENTRY
+    // ======================================================================
+    struct entry
+    {
+        odin::u64                           due_tick;
+        std::weak_ptr<idle_sweeper::session> session;
+    };
+
+    // ======================================================================
+    // CONSTRUCTOR
+    // ======================================================================
+    impl(boost::asio::io_service &io_service, idle_settings const &settings)
+      : settings_(settings),
+        timer_(io_service),
+        start_time_(clock_type::now()),
+        buckets_(NUMBER_OF_BUCKETS)
+    {
+    }
+
+    // ======================================================================
+    // SCHEDULE_SWEEP
+    // ======================================================================
+    void schedule_sweep()
+    {
+        timer_.expires_from_now(settings_.sweep_interval);
+        timer_.async_wait(
+            [wp=std::weak_ptr<impl>(shared_from_this())](
+                boost::system::error_code const &ec)
+            {
+                auto pthis = wp.lock();
+
+                if (!ec && pthis != nullptr)
+                {
+                    pthis->sweep();
+                    pthis->schedule_sweep();
+                }
+            });
+    }
+
+    // ======================================================================
+    // ADD_SESSION
+    // ======================================================================
+    std::shared_ptr<idle_sweeper::session> add_session(
+        std::function<void ()>                     const &send_keepalive,
+        std::function<void (std::chrono::seconds)> const &warn,
+        std::function<void ()>                     const &evict)
+    {
+        std::shared_ptr<idle_sweeper::session> new_session(
+            new idle_sweeper::session(send_keepalive, warn, evict));
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        insert(new_session);
+
+        return new_session;
+    }
+
+    // ======================================================================
+    // INSERT
+    // ======================================================================
+    void insert(std::shared_ptr<idle_sweeper::session> const &sess)
+    {
+        // The session is due on the first tick at or after the time that
+        // it next needs attention, but never on the current tick.
+        auto const tick = settings_.sweep_interval;
+        auto const due = next_attention(*sess->pimpl_) - start_time_;
+        auto const due_tick = (std::max)(
+            odin::u64((due + tick - clock_type::duration(1)) / tick)
+          , current_tick_ + 1);
+
+        buckets_[due_tick % NUMBER_OF_BUCKETS].push_back({ due_tick, sess });
+    }
+
+    // ======================================================================
+    // NEXT_ATTENTION
+    // ======================================================================
+    clock_type::time_point next_attention(
+        idle_sweeper::session::impl const &sess) const
+    {
+        auto const last_input  = clock_type::time_point(
+            clock_type::duration(sess.last_input_.load()));
+        auto const last_output = clock_type::time_point(
+            clock_type::duration(sess.last_output_.load()));
+
+        auto next = last_output + settings_.keepalive_interval;
+
+        if (settings_.idle_timeout.count() != 0)
+        {
+            auto const timeout_time = last_input + settings_.idle_timeout;
+            auto const warning_time = timeout_time - settings_.idle_warning;
+
+            next = (std::min)(next, sess.warned_ ? timeout_time : warning_time);
+        }
+
+        return next;
+    }
+
+    // ======================================================================
+    // SWEEP
+    // ======================================================================
+    void sweep()
+    {
+        std::vector<std::function<void ()>> actions;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            auto const now = clock_type::now();
+            auto const target_tick = odin::u64(
+                (now - start_time_) / settings_.sweep_interval);
+
+            // If the sweeper has fallen behind, it catches up by sweeping
+            // each of the ticks that it missed.
+            while (current_tick_ < target_tick)
+            {
+                ++current_tick_;
+                sweep_bucket(now, actions);
+            }
+        }
+
+        // The actions may lead back into the sweeper, for example by 
+        // destroying a session, so they are taken outside of the lock.
+        for (auto const &action : actions)
+        {
+            action();
+        }
+    }
+
+    // ======================================================================
+    // SWEEP_BUCKET
+    // ======================================================================
+    void sweep_bucket(
+        clock_type::time_point const        &now,
+        std::vector<std::function<void ()>> &actions)
+    {
+        auto &bucket = buckets_[current_tick_ % NUMBER_OF_BUCKETS];
+        std::vector<entry> due_entries;
+
+        auto const not_due = std::partition(
+            bucket.begin(), bucket.end(),
+            [this](entry const &ent)
+            {
+                return ent.due_tick > current_tick_;
+            });
+
+        due_entries.assign(not_due, bucket.end());
+        bucket.erase(not_due, bucket.end());
+
+        for (auto const &ent : due_entries)
+        {
+            auto sess = ent.session.lock();
+
+            if (sess == nullptr)
+            {
+                continue;
+            }
+
+            if (examine(*sess->pimpl_, now, actions))
+            {
+                insert(sess);
+            }
+        }
+    }
+
+    // ======================================================================
+    // EXAMINE
+    // ======================================================================
+    bool examine(
+        idle_sweeper::session::impl         &sess,
+        clock_type::time_point const        &now,
+        std::vector<std::function<void ()>> &actions)
+    {
+        auto const input_idle = now - clock_type::time_point(
+            clock_type::duration(sess.last_input_.load()));
+        auto const output_idle = now - clock_type::time_point(
+            clock_type::duration(sess.last_output_.load()));
+
+        if (settings_.idle_timeout.count() != 0)
+        {
+            if (input_idle >= settings_.idle_timeout)
+            {
+                ++statistics_.evicted;
+                actions.push_back(sess.evict_);
+                return false;
+            }
+
+            auto const warning_idle = 
+                settings_.idle_timeout - settings_.idle_warning;
+
+            if (input_idle < warning_idle)
+            {
+                sess.warned_ = false;
+            }
+            else if (!sess.warned_)
+            {
+                sess.warned_ = true;
+                ++statistics_.warned;
+
+                // The time remaining is rounded up, so that a session is
+                // never told that it has no time left.
+                auto const remaining = 
+                    std::chrono::duration_cast<std::chrono::seconds>(
+                        settings_.idle_timeout - input_idle
+                      + std::chrono::seconds(1) - clock_type::duration(1));
+                actions.push_back(
+                    [warn=sess.warn_, remaining]{ warn(remaining); });
+            }
+        }
+
+        if (output_idle >= settings_.keepalive_interval)
+        {
+            ++statistics_.keepalives;
+            actions.push_back(sess.send_keepalive_);
+
+            // The keepalive counts as output.
+            sess.last_output_ = now.time_since_epoch().count();
+        }
+
+        return true;
+    }
+
+    // ======================================================================
+    // GET_STATISTICS
+    // ======================================================================
+    idle_sweeper::statistics get_statistics()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        auto stats = statistics_;
+        auto const now = clock_type::now();
+
+        for (auto const &bucket : buckets_)
+        {
+            for (auto const &ent : bucket)
+            {
+                auto sess = ent.session.lock();
+
+                if (sess != nullptr)
+                {
+                    ++stats.sessions;
+
+                    auto const last_input = clock_type::time_point(
+                        clock_type::duration(
+                            sess->pimpl_->last_input_.load()));
+
+                    if (now - last_input >= settings_.keepalive_interval)
+                    {
+                        ++stats.idle;
+                    }
+                }
+            }
+        }
+
+        return stats;
+    }
+
+    idle_settings                      settings_;
+    boost::asio::steady_timer          timer_;
+    clock_type::time_point             start_time_;
+
+    std::mutex                         mutex_;
+    odin::u64                          current_tick_ = 0;
+    std::vector<std::vector<entry>>    buckets_;
+    idle_sweeper::statistics           statistics_;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+idle_sweeper::idle_sweeper(
+    boost::asio::io_service &io_service
+  , idle_settings const     &settings)
+    : pimpl_(std::make_shared<impl>(io_service, settings))
+{
+    if (settings.sweep_interval.count() <= 0)
+    {
+        throw std::invalid_argument("the sweep interval must be positive");
+    }
+
+    if (settings.keepalive_interval.count() <= 0)
+    {
+        throw std::invalid_argument("the keepalive interval must be positive");
+    }
+
+    if (settings.idle_timeout.count() != 0
+     && settings.idle_warning >= settings.idle_timeout)
+    {
+        throw std::invalid_argument(
+            "the idle warning must be shorter than the idle timeout");
+    }
+
+    pimpl_->schedule_sweep();
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+idle_sweeper::~idle_sweeper()
+{
+    boost::system::error_code unused_error_code;
+    pimpl_->timer_.cancel(unused_error_code);
+}
+
+// ==========================================================================
+// ADD_SESSION
+// ==========================================================================
+std::shared_ptr<idle_sweeper::session> idle_sweeper::add_session(
+    std::function<void ()>                     const &send_keepalive
+  , std::function<void (std::chrono::seconds)> const &warn
+  , std::function<void ()>                     const &evict)
+{
+    return pimpl_->add_session(send_keepalive, warn, evict);
+}
+
+// ==========================================================================
+// GET_STATISTICS
+// ==========================================================================
+idle_sweeper::statistics idle_sweeper::get_statistics() const
+{
+    return pimpl_->get_statistics();
+}
+
+// ==========================================================================
+// SESSION CONSTRUCTOR
+// ==========================================================================
+idle_sweeper::session::session(
+    std::function<void ()>                     const &send_keepalive
+  , std::function<void (std::chrono::seconds)> const &warn
+  , std::function<void ()>                     const &evict)
+    : pimpl_(std::make_shared<impl>())
+{
+    auto const now = clock_type::now().time_since_epoch().count();
+
+    pimpl_->send_keepalive_ = send_keepalive;
+    pimpl_->warn_           = warn;
+    pimpl_->evict_          = evict;
+    pimpl_->last_input_     = now;
+    pimpl_->last_output_    = now;
+}
+
+// ==========================================================================
+// NOTE_INPUT
+// ==========================================================================
+void idle_sweeper::session::note_input()
+{
+    pimpl_->last_input_ = clock_type::now().time_since_epoch().count();
+}
+
+// ==========================================================================
+// NOTE_OUTPUT
+// ==========================================================================
+void idle_sweeper::session::note_output()
+{
+    pimpl_->last_output_ = clock_type::now().time_since_epoch().count();
+}
+
+}
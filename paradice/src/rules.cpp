@@ -31,10 +31,9 @@
 #include "paradice/active_encounter.hpp"
 #include "paradice/context.hpp"
 #include "paradice/random.hpp"
+#include "paradice/table.hpp"
 #include "odin/tokenise.hpp"
 #include <boost/format.hpp>
-#include <map>
-#include <mutex>
 #include <numeric>
 #include <thread>
 #include <vector>
@@ -42,14 +41,6 @@
 namespace paradice {
 
 namespace {
-    BOOST_STATIC_CONSTANT(odin::u32, max_encounter_rolls = 10);
-    
-    static std::map<
-        std::string,           // category.
-        std::vector<roll_data> // list of rolls in that category.
-    > roll_category;
-    std::mutex roll_category_mutex;
-    
     static bool sort_roll_data_by_score_ascending(
         roll_data const &lhs
       , roll_data const &rhs)
@@ -259,7 +250,7 @@ static void execute_roll(
             data.score = total;
             data.raw_score = subtotal;
             data.max_roll = (total == theoretical_max_roll);
-            roll_category[category].push_back(data);
+            player->get_table()->add_roll(category, data);
         }
     }
 
@@ -301,31 +292,26 @@ static void execute_roll(
           + " and scores ";
             send_to_room(ctx, third_person_lead + dice_text, player);
 
-        auto enc = ctx->get_active_encounter();
-        for (auto &entry : enc->entries_)
-        {
-            auto ply = boost::get<active_encounter::player>(&entry.participant_);
-     
-            if (ply != NULL)
+        player->get_table()->modify_encounter(
+            [name=player->get_character()->get_name(), result](
+                auto const &enc)
             {
-                auto ch = ply->character_.lock();
-
-                if (ch != NULL)
+                for (auto &entry : enc->entries_)
                 {
-                    if (ch->get_name() == player->get_character()->get_name())
+                    auto ply = boost::get<active_encounter::player>(
+                        &entry.participant_);
+
+                    if (ply != NULL)
                     {
-                        entry.roll_data_.push_back(result);
+                        auto ch = ply->character_.lock();
 
-                        if (entry.roll_data_.size() > max_encounter_rolls)
+                        if (ch != NULL && ch->get_name() == name)
                         {
-                            entry.roll_data_.pop_front();
+                            add_roll(enc, entry.id_, result);
                         }
-
-                        ctx->update_active_encounter();
                     }
                 }
-            }
-        }
+            });
     }
 }
 
@@ -353,7 +339,8 @@ PARADICE_COMMAND_IMPL(roll)
     }
 
     // Store a category if the user entered one.
-    auto category = odin::tokenise(std::string(begin, end)).first;
+    auto category = odin::tokenise(
+        boost::string_view(begin, std::size_t(end - begin))).first.to_string();
 
     execute_roll(ctx, category, rolls.get(), player, false);
 }
@@ -388,11 +375,9 @@ PARADICE_COMMAND_IMPL(rollprivate)
 // ==========================================================================
 PARADICE_COMMAND_IMPL(showrolls)
 {
-    auto tokens   = odin::tokenise(arguments);
-    auto category = tokens.first;
-    
-    tokens        = odin::tokenise(tokens.second);
-    auto order    = tokens.first;
+    odin::tokeniser tokens(arguments);
+    auto category = tokens.next().to_string();
+    auto order    = tokens.next();
     
     if (category == "")
     {
@@ -406,12 +391,7 @@ PARADICE_COMMAND_IMPL(showrolls)
         return;
     }
     
-    std::vector<roll_data> rolls;
-    
-    {
-        std::unique_lock<std::mutex> lock(roll_category_mutex);
-        rolls = roll_category[category];
-    }
+    auto rolls = player->get_table()->get_rolls(category);
     
     if (rolls.empty())
     {
@@ -471,7 +451,7 @@ PARADICE_COMMAND_IMPL(showrolls)
 // ==========================================================================
 PARADICE_COMMAND_IMPL(clearrolls)
 {
-    auto category = odin::tokenise(arguments).first;
+    auto category = odin::tokenise(arguments).first.to_string();
     
     if (category == "")
     {
@@ -484,10 +464,7 @@ PARADICE_COMMAND_IMPL(clearrolls)
         return;
     }
     
-    {
-        std::unique_lock<std::mutex> lock(roll_category_mutex);
-        roll_category[category].clear();
-    }
+    player->get_table()->clear_rolls(category);
 
     send_to_player(
         ctx
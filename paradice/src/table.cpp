@@ -0,0 +1,334 @@
+// ==========================================================================
+// Paradice Table
+//
+// Copyright (C) 2013 Matthew Chaplain, All Rights Reserved.
+//
+// Permission to reproduce, distribute, perform, display, and to prepare
+// derivitive works from this file under the following conditions:
+//
+// 1. Any copy, reproduction or derivitive work of any part of this file
+//    contains this copyright notice and licence in its entirety.
+//
+// 2. The rights granted to you under this license automatically terminate
+//    should you attempt to assert any patent claims against the licensor
+//    or contributors, which in any way restrict the ability of any party
+//    from using this software or portions thereof in any form under the
+//    terms of this license.
+//
+// Disclaimer: THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY
+//             KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+//             WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+//             PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS
+//             OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+//             OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+//             OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+// ==========================================================================
+#include "paradice/table.hpp"
+#include "paradice/active_encounter.hpp"
+#include "paradice/character.hpp"
+#include "paradice/client.hpp"
+#include "paradice/communication.hpp"
+#include "paradice/context.hpp"
+#include "paradice/who.hpp"
+#include "odin/flight_recorder.hpp"
+#include "odin/tokenise.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/format.hpp>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace paradice {
+
+namespace {
+    std::atomic<odin::u32> next_encounter_identity(1);
+}
+
+// ==========================================================================
+// TABLE::IMPLEMENTATION STRUCTURE
+// ==========================================================================
+struct table::impl
+{
+    impl(
+        boost::asio::io_service &io_service
+      , std::string const       &name
+      , table_settings const    &settings)
+      : strand_(io_service),
+        name_(name),
+        encounter_(std::make_shared<active_encounter>()),
+        visible_(false)
+    {
+        encounter_->identity_  = next_encounter_identity++;
+        encounter_->max_rolls_ = settings.max_encounter_rolls;
+        published_encounter_ =
+            std::make_shared<active_encounter const>(*encounter_);
+    }
+
+    // ======================================================================
+    // PUBLISH_ENCOUNTER
+    // ======================================================================
+    // Publishes a snapshot of the encounter if it has changed since the
+    // last one, and returns it.  Returns null if it has not changed.  This
+    // must only be called on the strand.
+    std::shared_ptr<active_encounter const> publish_encounter()
+    {
+        std::unique_lock<std::mutex> lock(published_encounter_mutex_);
+
+        if (published_encounter_->version_ == encounter_->version_)
+        {
+            return {};
+        }
+
+        published_encounter_ =
+            std::make_shared<active_encounter const>(*encounter_);
+        return published_encounter_;
+    }
+
+    boost::asio::strand                           strand_;
+    std::string const                             name_;
+
+    // Only accessed on the strand.
+    std::shared_ptr<active_encounter>             encounter_;
+
+    mutable std::mutex                            published_encounter_mutex_;
+    std::shared_ptr<active_encounter const>       published_encounter_;
+    std::atomic<bool>                             visible_;
+
+    mutable std::mutex                            rolls_mutex_;
+    std::map<std::string, std::vector<roll_data>> rolls_;
+};
+
+// ==========================================================================
+// CONSTRUCTOR
+// ==========================================================================
+table::table(
+    boost::asio::io_service &io_service
+  , std::string const       &name
+  , table_settings const    &settings)
+    : pimpl_(std::make_shared<impl>(std::ref(io_service), name, settings))
+{
+}
+
+// ==========================================================================
+// DESTRUCTOR
+// ==========================================================================
+table::~table()
+{
+}
+
+// ==========================================================================
+// GET_NAME
+// ==========================================================================
+std::string table::get_name() const
+{
+    return pimpl_->name_;
+}
+
+// ==========================================================================
+// MODIFY_ENCOUNTER
+// ==========================================================================
+void table::modify_encounter(
+    std::function<
+        void (std::shared_ptr<active_encounter> const &)
+    > const &fn)
+{
+    pimpl_->strand_.post(odin::flight_recorder::trace(
+        "table.modify_encounter"
+      , [self=shared_from_this(), fn]
+        {
+            fn(self->pimpl_->encounter_);
+
+            auto snapshot = self->pimpl_->publish_encounter();
+
+            if (snapshot)
+            {
+                self->on_encounter_changed(snapshot);
+            }
+        }));
+}
+
+// ==========================================================================
+// GET_ENCOUNTER
+// ==========================================================================
+std::shared_ptr<active_encounter const> table::get_encounter() const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->published_encounter_mutex_);
+    return pimpl_->published_encounter_;
+}
+
+// ==========================================================================
+// SET_ENCOUNTER_VISIBLE
+// ==========================================================================
+void table::set_encounter_visible(bool visible)
+{
+    pimpl_->strand_.post(odin::flight_recorder::trace(
+        "table.set_encounter_visible"
+      , [self=shared_from_this(), visible]
+        {
+            self->pimpl_->visible_ = visible;
+            self->on_encounter_visibility_changed(visible);
+        }));
+}
+
+// ==========================================================================
+// IS_ENCOUNTER_VISIBLE
+// ==========================================================================
+bool table::is_encounter_visible() const
+{
+    return pimpl_->visible_;
+}
+
+// ==========================================================================
+// ADD_ROLL
+// ==========================================================================
+void table::add_roll(std::string const &category, roll_data const &data)
+{
+    std::unique_lock<std::mutex> lock(pimpl_->rolls_mutex_);
+    pimpl_->rolls_[category].push_back(data);
+}
+
+// ==========================================================================
+// GET_ROLLS
+// ==========================================================================
+std::vector<roll_data> table::get_rolls(std::string const &category) const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->rolls_mutex_);
+    auto const rolls = pimpl_->rolls_.find(category);
+
+    return rolls == pimpl_->rolls_.end()
+         ? std::vector<roll_data>()
+         : rolls->second;
+}
+
+// ==========================================================================
+// CLEAR_ROLLS
+// ==========================================================================
+void table::clear_rolls(std::string const &category)
+{
+    std::unique_lock<std::mutex> lock(pimpl_->rolls_mutex_);
+    pimpl_->rolls_.erase(category);
+}
+
+// ==========================================================================
+// FIND_GM
+// ==========================================================================
+std::shared_ptr<client> find_gm(
+    std::shared_ptr<context> const &ctx
+  , std::shared_ptr<table>   const &tbl)
+{
+    for (auto const &cli : ctx->get_clients())
+    {
+        auto const ch = cli->get_character();
+
+        if (ch && ch->get_gm_level() != 0 && cli->get_table() == tbl)
+        {
+            return cli;
+        }
+    }
+
+    return {};
+}
+
+// ==========================================================================
+// PARADICE COMMAND: TABLE
+// ==========================================================================
+PARADICE_COMMAND_IMPL(table)
+{
+    auto const name = odin::tokenise(arguments).first.to_string();
+    auto const current_table = player->get_table();
+
+    if (name.empty())
+    {
+        auto text = boost::str(boost::format(
+            "\nYou are at the %s table.  The tables in play are:")
+            % current_table->get_name());
+
+        for (auto const &tbl : ctx->get_tables())
+        {
+            odin::u32 players = 0;
+
+            for (auto const &cli : ctx->get_clients())
+            {
+                if (cli->get_character() && cli->get_table() == tbl)
+                {
+                    ++players;
+                }
+            }
+
+            auto const gm = find_gm(ctx, tbl);
+
+            text += boost::str(boost::format("\n  %s - %d player%s%s")
+                % tbl->get_name()
+                % players
+                % (players == 1 ? "" : "s")
+                % (gm ? (", GM: " + gm->get_character()->get_name()) : ""));
+        }
+
+        send_to_player(ctx, text + "\n", player);
+        return;
+    }
+
+    if (!is_acceptible_name(name))
+    {
+        send_to_player(
+            ctx
+          , "\n USAGE:   table [<name>]"
+            "\n EXAMPLE: table dungeon"
+            "\n"
+          , player);
+        return;
+    }
+
+    if (current_table != NULL && current_table->get_name() == name)
+    {
+        send_to_player(
+            ctx
+          , boost::str(boost::format("You are already at the %s table.\n")
+                % name)
+          , player);
+        return;
+    }
+
+    auto const character = player->get_character();
+
+    // There can be only one GM at any table, which the seating enforces.
+    if (ctx->seat_client(player, name) == NULL)
+    {
+        send_to_player(
+            ctx
+          , boost::str(boost::format("The %s table already has a GM.\n")
+                % name)
+          , player);
+        return;
+    }
+
+    // The player has already left, so those at the old table are told
+    // directly.
+    auto const farewell = boost::str(
+        boost::format("%s leaves for the %s table.\n")
+            % character->get_name()
+            % name);
+
+    for (auto cli : ctx->get_clients())
+    {
+        if (cli != player && cli->get_table() == current_table)
+        {
+            send_to_player(ctx, farewell, cli);
+        }
+    }
+
+    send_to_player(
+        ctx
+      , boost::str(boost::format("You sit at the %s table.\n") % name)
+      , player);
+
+    send_to_room(
+        ctx
+      , boost::str(boost::format("%s sits at the table.\n")
+            % character->get_name())
+      , player);
+}
+
+}
@@ -31,7 +31,7 @@ namespace paradice {
 // ==========================================================================
 // IS_IEQUAL
 // ==========================================================================
-bool is_iequal(std::string const &lhs, std::string const &rhs)
+bool is_iequal(boost::string_view lhs, boost::string_view rhs)
 {
     if (lhs.size() != rhs.size())
     {
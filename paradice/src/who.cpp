@@ -35,7 +35,7 @@
 #include "odin/tokenise.hpp"
 #include "odin/core.hpp"
 #include "terminalpp/string.hpp"
-#include <boost/algorithm/string/trim.hpp>
+#include <boost/algorithm/string/classification.hpp>
 #include <boost/format.hpp>
 #include <cstdio>
 
@@ -71,7 +71,7 @@ PARADICE_COMMAND_IMPL(title)
     using namespace terminalpp::literals;
     
     auto character = player->get_character();
-    character->set_suffix(boost::algorithm::trim_copy(arguments));
+    character->set_suffix(odin::trim(arguments).to_string());
 
     send_to_player(ctx, boost::str(
         boost::format("\r\nYou are now %s.\r\n")
@@ -110,7 +110,7 @@ PARADICE_COMMAND_IMPL(prefix)
     using namespace terminalpp::literals;
 
     auto character = player->get_character();
-    character->set_prefix(boost::algorithm::trim_copy(arguments));
+    character->set_prefix(odin::trim(arguments).to_string());
 
     send_to_player(ctx, boost::str(
         boost::format("\r\nYou are now %s.\r\n")
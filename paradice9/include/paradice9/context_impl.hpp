@@ -28,22 +28,37 @@
 #define PARADICE9_CONTEXT_IMPL_HPP_
 
 #include "paradice/context.hpp"
+#include "paradice/help.hpp"
+#include "paradice/table.hpp"
+#include "odin/net/io_service_pool.hpp"
 #include "odin/net/server.hpp"
-#include <boost/asio/io_service.hpp>
 
 //* =========================================================================
 /// \brief Describes the context in which a Paradice server runs.
+/// \par
+/// The list of clients belongs to the home io_service of the pool.  Changes
+/// to it are posted there as messages, and readers on any io_service see
+/// the most recently published copy of it.
+/// \par
+/// Tables are spread across the io_services of the pool as they are set
+/// up, and each keeps the players sitting at it up to date with its
+/// encounter.
 //* =========================================================================
 class context_impl : public paradice::context
 {
 public :
     //* =====================================================================
     /// \brief Constructor
+    /// \param tables the settings for the tables that are set up.
+    /// \param help the help that is available to players.
     //* =====================================================================
     context_impl(
-        boost::asio::io_service                       &io_service
-      , std::shared_ptr<odin::net::server>             server
-      , std::shared_ptr<boost::asio::io_service::work> work);
+        odin::net::io_service_pool                          &pool
+      , std::shared_ptr<odin::net::server>                   server
+      , paradice::table_settings const                      &tables =
+            paradice::table_settings()
+      , std::shared_ptr<paradice::help_corpus const> const  &help =
+            paradice::make_help_corpus());
     
     //* =====================================================================
     /// \brief Denstructor
@@ -111,33 +126,49 @@ public :
     /// \brief Enacts a server shutdown.
     //* =====================================================================
     virtual void shutdown();
+
+    //* =====================================================================
+    /// \brief Enacts a server restart by calling the restart handler.
+    //* =====================================================================
+    virtual void restart();
+
+    //* =====================================================================
+    /// \brief Sets the function that performs a restart.  Until this is
+    /// called, restarts are not available.
+    //* =====================================================================
+    void on_restart(std::function<void ()> const &handler);
     
     //* =====================================================================
-    /// \brief Gets the currently active encounter
+    /// \brief Returns the table with the given name, setting it up first
+    /// if there is no such table yet.
     //* =====================================================================
-    virtual std::shared_ptr<paradice::active_encounter> get_active_encounter();
+    virtual std::shared_ptr<paradice::table> get_table(
+        std::string const &name);
 
     //* =====================================================================
-    /// \brief Sets the currently active encounter
+    /// \brief Returns all of the tables that have been set up.
     //* =====================================================================
-    virtual void set_active_encounter(
-        std::shared_ptr<paradice::active_encounter> const &enc);
+    virtual std::vector<std::shared_ptr<paradice::table>> get_tables();
 
     //* =====================================================================
-    /// \brief Gets the visibility of the encounter.
+    /// \brief Seats the client at the table with the given name, setting
+    /// the table up first if there is no such table yet.  A GM is not
+    /// seated at a table that already has one.  Returns the table at which
+    /// the client was seated, or null if it was not.
     //* =====================================================================
-    virtual bool is_active_encounter_visible() const;
+    virtual std::shared_ptr<paradice::table> seat_client(
+        std::shared_ptr<paradice::client> const &cli
+      , std::string const                       &name);
 
     //* =====================================================================
-    /// \brief Sets the visibility of the encounter for all players.
+    /// \brief Unseats the client from its table.
     //* =====================================================================
-    virtual void set_active_encounter_visible(bool visibility);
+    virtual void unseat_client(std::shared_ptr<paradice::client> const &cli);
 
     //* =====================================================================
-    /// \brief Informs the context that changes have been made to the
-    /// active encounter and that any related views should be updated.
+    /// \brief Returns the help that is available to players.
     //* =====================================================================
-    virtual void update_active_encounter();
+    virtual std::shared_ptr<paradice::help_corpus const> get_help();
 
 private :
     struct impl;
@@ -27,25 +27,109 @@
 #ifndef PARADICE9_HPP_
 #define PARADICE9_HPP_
 
-#include <boost/asio/io_service.hpp>
+#include "paradice/compression.hpp"
+#include "paradice/help.hpp"
+#include "paradice/idle_sweeper.hpp"
+#include "paradice/table.hpp"
+#include "odin/net/io_service_pool.hpp"
+#include "odin/net/server.hpp"
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 
 //* =========================================================================
 /// \brief A class that implements the main engine for the Paradice9 server.
-/// \param io_service - The engine will be run within using the dispatch
-///        mechanisms of this object.
-/// \brief work - A "work" object.  While this is not reset, the threads'
-///        run() methods will not terminate.  Resetting this work object
-///        is part of the shutdown protocol.
+/// \param pool - The engine will be run within the io_services of this
+///        pool.  The server runs on the pool's home io_service, and each
+///        connection is assigned to one of its io_services.  Releasing the
+///        pool's work is part of the shutdown protocol.
 /// \brief port - The server will be set up on this port number.
+/// \brief compression - The settings for compressed connections.
+/// \brief idle - The settings for keepalives and the disconnection of idle
+///        connections.
+/// \brief listener - Options for the listening sockets.  If these do not
+///        open a listener on each io_service, then accepted sockets are
+///        assigned to io_services by the pool.
+/// \brief handover - Settings for restarting the server by handing its
+///        listening sockets and clients over to a new process.
+/// \brief tables - The settings for the tables at which players sit.
+/// \brief help - The help that is available to players.
 //* =========================================================================
 class paradice9
 {
 public :
+    //* =====================================================================
+    /// \brief Statistics about the negotiation of new connections.
+    //* =====================================================================
+    struct negotiation_statistics
+    {
+        /// \brief The number of connections currently negotiating.
+        odin::u32 pending = 0;
+
+        /// \brief The number of negotiations that were answered.
+        odin::u32 completed = 0;
+
+        /// \brief The number of negotiations that passed their deadline
+        /// and continued with default settings.
+        odin::u32 timed_out = 0;
+
+        /// \brief The number of connections that died while negotiating.
+        odin::u32 abandoned = 0;
+
+        /// \brief The total and longest times taken by negotiations that
+        /// either completed or timed out.
+        std::chrono::milliseconds total_time{0};
+        std::chrono::milliseconds longest_time{0};
+    };
+
+    //* =====================================================================
+    /// \brief Settings for handing the server over to a new process.
+    //* =====================================================================
+    struct handover_settings
+    {
+        handover_settings()
+          : channel(-1)
+        {
+        }
+
+        /// \brief The command that starts a new server process on a
+        /// restart.  An argument of the form --handover-channel=<handle> is
+        /// appended to it.  If empty, restarting is not available.
+        std::vector<std::string> command_line;
+
+        /// \brief If not negative, the handle of a channel from a previous
+        /// server process.  The listening sockets and clients are taken
+        /// from that process rather than a new listener being opened.
+        int channel;
+    };
+
     paradice9(
-        boost::asio::io_service                        &io_service
-      , std::shared_ptr<boost::asio::io_service::work>  work
-      , unsigned int                                    port);
+        odin::net::io_service_pool            &pool
+      , unsigned int                           port
+      , paradice::compression_settings const  &compression =
+            paradice::compression_settings()
+      , paradice::idle_settings const         &idle =
+            paradice::idle_settings()
+      , odin::net::server::options const      &listener =
+            odin::net::server::options()
+      , handover_settings const               &handover =
+            handover_settings()
+      , paradice::table_settings const        &tables =
+            paradice::table_settings()
+      , std::shared_ptr<paradice::help_corpus const> const &help =
+            paradice::make_help_corpus());
+
+    //* =====================================================================
+    /// \brief Returns statistics about the negotiation of new connections.
+    //* =====================================================================
+    negotiation_statistics get_negotiation_statistics() const;
+
+    //* =====================================================================
+    /// \brief Returns counts of idle connections, and of the keepalives
+    /// sent to and disconnections of them, across all io_services.
+    //* =====================================================================
+    paradice::idle_sweeper::statistics get_idle_statistics() const;
     
 private :
     struct impl;
@@ -28,20 +28,48 @@
 #include "paradice/account.hpp"
 #include "paradice/character.hpp"
 #include "paradice/client.hpp"
+#include "paradice/table.hpp"
 #include "hugin/user_interface.hpp"
+#include "odin/flight_recorder.hpp"
+#include "odin/metrics.hpp"
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 #include <boost/filesystem.hpp>
 #include <algorithm>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace fs = boost::filesystem;
 
 namespace {
-    static std::shared_ptr<paradice::active_encounter> gm_encounter;
-    static bool gm_encounter_visible = false;
+    // ======================================================================
+    // GET_LOAD_TIME
+    // ======================================================================
+    odin::metrics::histogram &get_load_time()
+    {
+        static auto &load_time = odin::metrics::get_registry().get_histogram(
+            "paradice_persistence_load_seconds",
+            "Time taken to load an account or character.",
+            1e-9);
+        return load_time;
+    }
+
+    // ======================================================================
+    // GET_SAVE_TIME
+    // ======================================================================
+    odin::metrics::histogram &get_save_time()
+    {
+        static auto &save_time = odin::metrics::get_registry().get_histogram(
+            "paradice_persistence_save_seconds",
+            "Time taken to save an account or character.",
+            1e-9);
+        return save_time;
+    }
 }
 
 // ==========================================================================
@@ -107,15 +135,28 @@ static std::string get_character_address(
 // CONTEXT_IMPL IMPLEMENTATION STRUCTURE
 // ==========================================================================
 struct context_impl::impl
+    : public std::enable_shared_from_this<context_impl::impl>
 {
     impl(
-        boost::asio::io_service                       &io_service
-      , std::shared_ptr<odin::net::server>             server
-      , std::shared_ptr<boost::asio::io_service::work> work)
-      : strand_(io_service)
+        odin::net::io_service_pool                          &pool
+      , std::shared_ptr<odin::net::server>                   server
+      , paradice::table_settings const                      &tables
+      , std::shared_ptr<paradice::help_corpus const> const  &help)
+      : pool_(pool)
+      , strand_(pool.get_io_service())
       , server_(server)
-      , work_(work)
+      , table_settings_(tables)
+      , help_(help)
+    {
+    }
+
+    // ======================================================================
+    // GET_CLIENTS
+    // ======================================================================
+    std::vector<std::shared_ptr<paradice::client>> get_clients()
     {
+        std::unique_lock<std::mutex> lock(published_clients_mutex_);
+        return published_clients_;
     }
     
     // ======================================================================
@@ -124,6 +165,7 @@ struct context_impl::impl
     void add_client(std::shared_ptr<paradice::client> const &cli)
     {
         clients_.push_back(cli);
+        publish_clients();
     }
 
     // ======================================================================
@@ -137,6 +179,20 @@ struct context_impl::impl
               , clients_.end()
               , cli)
           , clients_.end());
+        publish_clients();
+
+        // The client may have been the last to sit at its table.
+        std::unique_lock<std::mutex> lock(tables_mutex_);
+        remove_empty_tables();
+    }
+
+    // ======================================================================
+    // PUBLISH_CLIENTS
+    // ======================================================================
+    void publish_clients()
+    {
+        std::unique_lock<std::mutex> lock(published_clients_mutex_);
+        published_clients_ = clients_;
     }
 
     // ======================================================================
@@ -178,6 +234,8 @@ struct context_impl::impl
     void load_account(
         std::string const &name, std::shared_ptr<paradice::account> &acct)
     {
+        odin::metrics::scoped_timer timer(get_load_time());
+        std::unique_lock<std::mutex> lock(storage_mutex_);
         auto account_path = get_accounts_path() / name;
         
         if (fs::exists(account_path))
@@ -195,6 +253,8 @@ struct context_impl::impl
     // ======================================================================
     void save_account(std::shared_ptr<paradice::account> const &acct)
     {
+        odin::metrics::scoped_timer timer(get_save_time());
+        std::unique_lock<std::mutex> lock(storage_mutex_);
         auto account_path = get_accounts_path() / acct->get_name();
         
         std::ofstream out(account_path.string().c_str());
@@ -209,6 +269,8 @@ struct context_impl::impl
         std::string const                    &name,
         std::shared_ptr<paradice::character> &ch)
     {
+        odin::metrics::scoped_timer timer(get_load_time());
+        std::unique_lock<std::mutex> lock(storage_mutex_);
         auto character_path = get_characters_path() / name;
         
         if (fs::exists(character_path))
@@ -226,6 +288,8 @@ struct context_impl::impl
     // ======================================================================
     void save_character(std::shared_ptr<paradice::character> const &ch)
     {
+        odin::metrics::scoped_timer timer(get_save_time());
+        std::unique_lock<std::mutex> lock(storage_mutex_);
         auto character_path = get_characters_path() / ch->get_name();
         
         std::ofstream out(character_path.string().c_str());
@@ -233,20 +297,210 @@ struct context_impl::impl
         oa << boost::serialization::make_nvp("character", *ch);
     }
 
+    // ======================================================================
+    // GET_TABLE
+    // ======================================================================
+    std::shared_ptr<paradice::table> get_table(std::string const &name)
+    {
+        std::unique_lock<std::mutex> lock(tables_mutex_);
+        return find_or_create_table(name);
+    }
+
+    // ======================================================================
+    // SEAT_CLIENT
+    // ======================================================================
+    std::shared_ptr<paradice::table> seat_client(
+        std::shared_ptr<paradice::client> const &cli
+      , std::string const                       &name)
+    {
+        std::unique_lock<std::mutex> lock(tables_mutex_);
+        auto const tbl = find_or_create_table(name);
+
+        // There can be only one GM at each table.  Since the check and the
+        // seating are both made under the lock, two GMs cannot both pass
+        // the check for the same table.
+        auto const ch = cli->get_character();
+
+        if (ch != NULL && ch->get_gm_level() != 0)
+        {
+            for (auto const &other : get_clients())
+            {
+                auto const other_ch = other->get_character();
+
+                if (other != cli
+                 && other_ch != NULL
+                 && other_ch->get_gm_level() != 0
+                 && other->get_table() == tbl)
+                {
+                    remove_empty_tables();
+                    return {};
+                }
+            }
+        }
+
+        cli->set_table(tbl);
+        remove_empty_tables();
+
+        return tbl;
+    }
+
+    // ======================================================================
+    // UNSEAT_CLIENT
+    // ======================================================================
+    void unseat_client(std::shared_ptr<paradice::client> const &cli)
+    {
+        std::unique_lock<std::mutex> lock(tables_mutex_);
+        cli->set_table({});
+        remove_empty_tables();
+    }
+
+    // ======================================================================
+    // FIND_OR_CREATE_TABLE
+    // ======================================================================
+    // Must be called with tables_mutex_ held.
+    std::shared_ptr<paradice::table> find_or_create_table(
+        std::string const &name)
+    {
+        auto &tbl = tables_[name];
+
+        if (!tbl)
+        {
+            // Each new table runs on the next io_service in turn, so that
+            // the work of several busy tables is spread across the pool.
+            auto &io_service = pool_.get_io_service(
+                next_table_shard_++ % pool_.get_size());
+
+            tbl = std::make_shared<paradice::table>(
+                std::ref(io_service), name, table_settings_);
+            connect_table(tbl);
+        }
+
+        return tbl;
+    }
+
+    // ======================================================================
+    // REMOVE_EMPTY_TABLES
+    // ======================================================================
+    // Removes the tables at which nobody sits, so that tables do not
+    // accumulate as players come and go.  The default table is kept, since
+    // it is where everyone starts.  Must be called with tables_mutex_ held.
+    void remove_empty_tables()
+    {
+        std::set<paradice::table const *> occupied;
+
+        for (auto const &cli : get_clients())
+        {
+            occupied.insert(cli->get_table().get());
+        }
+
+        for (auto tbl = tables_.begin(); tbl != tables_.end();)
+        {
+            if (tbl->first != paradice::DEFAULT_TABLE_NAME
+             && occupied.count(tbl->second.get()) == 0)
+            {
+                tbl = tables_.erase(tbl);
+            }
+            else
+            {
+                ++tbl;
+            }
+        }
+    }
+
+    // ======================================================================
+    // GET_TABLES
+    // ======================================================================
+    std::vector<std::shared_ptr<paradice::table>> get_tables()
+    {
+        std::unique_lock<std::mutex> lock(tables_mutex_);
+        std::vector<std::shared_ptr<paradice::table>> tables;
+
+        for (auto const &tbl : tables_)
+        {
+            tables.push_back(tbl.second);
+        }
+
+        return tables;
+    }
+
+    // ======================================================================
+    // CONNECT_TABLE
+    // ======================================================================
+    void connect_table(std::shared_ptr<paradice::table> const &tbl)
+    {
+        // The table owns these connections, and so they must not own the
+        // table in return.  A client may leave the table after it has been
+        // found here, so each change is tagged with the table and checked
+        // again from within the client's strand.
+        std::weak_ptr<paradice::table> weak_table = tbl;
+        std::weak_ptr<impl> wp = shared_from_this();
+
+        tbl->on_encounter_changed.connect(
+            [wp, weak_table](
+                std::shared_ptr<paradice::active_encounter const> const &enc)
+            {
+                auto pthis = wp.lock();
+                auto ptable = weak_table.lock();
+
+                if (pthis && ptable)
+                {
+                    for (auto &cli : pthis->get_clients())
+                    {
+                        if (cli->get_table() == ptable)
+                        {
+                            cli->on_table_encounter_changed(ptable, enc);
+                        }
+                    }
+                }
+            });
+
+        tbl->on_encounter_visibility_changed.connect(
+            [wp, weak_table](bool visible)
+            {
+                auto pthis = wp.lock();
+                auto ptable = weak_table.lock();
+
+                if (pthis && ptable)
+                {
+                    for (auto &cli : pthis->get_clients())
+                    {
+                        if (cli->get_table() == ptable)
+                        {
+                            cli->on_table_encounter_visibility_changed(
+                                ptable, visible);
+                        }
+                    }
+                }
+            });
+    }
+
+    odin::net::io_service_pool                    &pool_;
     boost::asio::strand                            strand_;
     std::shared_ptr<odin::net::server>             server_;
-    std::shared_ptr<boost::asio::io_service::work> work_;
+    paradice::table_settings const                 table_settings_;
+    std::shared_ptr<paradice::help_corpus const>   help_;
+    std::function<void ()>                         restart_handler_;
     std::vector<std::shared_ptr<paradice::client>> clients_;
+    std::mutex                                     published_clients_mutex_;
+    std::vector<std::shared_ptr<paradice::client>> published_clients_;
+    std::mutex                                     storage_mutex_;
+    std::mutex                                     tables_mutex_;
+    odin::u32                                      next_table_shard_ = 0;
+    std::map<
+        std::string
+      , std::shared_ptr<paradice::table>
+    >                                              tables_;
 };
 
 // ==========================================================================
 // CONSTRUCTOR
 // ==========================================================================
 context_impl::context_impl(
-    boost::asio::io_service                        &io_service
-  , std::shared_ptr<odin::net::server>              server
-  , std::shared_ptr<boost::asio::io_service::work>  work)
-    : pimpl_(new impl(io_service, server, work))
+    odin::net::io_service_pool                          &pool
+  , std::shared_ptr<odin::net::server>                   server
+  , paradice::table_settings const                      &tables
+  , std::shared_ptr<paradice::help_corpus const> const  &help)
+    : pimpl_(new impl(pool, server, tables, help))
 {
 }
     
@@ -262,7 +516,7 @@ context_impl::~context_impl()
 // ==========================================================================
 std::vector<std::shared_ptr<paradice::client>> context_impl::get_clients()
 {
-    return pimpl_->clients_;
+    return pimpl_->get_clients();
 }
 
 // ==========================================================================
@@ -270,7 +524,9 @@ std::vector<std::shared_ptr<paradice::client>> context_impl::get_clients()
 // ==========================================================================
 void context_impl::add_client(std::shared_ptr<paradice::client> const &cli)
 {
-    pimpl_->strand_.dispatch([this, cli]{pimpl_->add_client(cli);});
+    pimpl_->strand_.post(odin::flight_recorder::trace(
+        "context.add_client"
+      , [pimpl=pimpl_, cli]{pimpl->add_client(cli);}));
 }
 
 // ==========================================================================
@@ -278,7 +534,9 @@ void context_impl::add_client(std::shared_ptr<paradice::client> const &cli)
 // ==========================================================================
 void context_impl::remove_client(std::shared_ptr<paradice::client> const &cli)
 {
-    pimpl_->strand_.dispatch([this, cli]{pimpl_->remove_client(cli);});
+    pimpl_->strand_.post(odin::flight_recorder::trace(
+        "context.remove_client"
+      , [pimpl=pimpl_, cli]{pimpl->remove_client(cli);}));
 }
 
 // ==========================================================================
@@ -286,7 +544,9 @@ void context_impl::remove_client(std::shared_ptr<paradice::client> const &cli)
 // ==========================================================================
 void context_impl::update_names()
 {
-    pimpl_->strand_.dispatch([this]{pimpl_->update_names();});
+    pimpl_->strand_.post(odin::flight_recorder::trace(
+        "context.update_names"
+      , [pimpl=pimpl_]{pimpl->update_names();}));
 }
 
 // ==========================================================================
@@ -320,11 +580,10 @@ std::string context_impl::get_moniker(std::shared_ptr<paradice::character> const
 // ==========================================================================
 std::shared_ptr<paradice::account> context_impl::load_account(std::string const &name)
 {
+    // Loads must complete before returning, and so they are performed on
+    // the calling thread rather than posted to the home io_service.
     std::shared_ptr<paradice::account> acct;
-
-    pimpl_->strand_.dispatch([this, &name, &acct]{
-        pimpl_->load_account(name, acct);
-    });
+    pimpl_->load_account(name, acct);
 
     return acct;
 }
@@ -334,7 +593,7 @@ std::shared_ptr<paradice::account> context_impl::load_account(std::string const
 // ==========================================================================
 void context_impl::save_account(std::shared_ptr<paradice::account> const &acct)
 {
-    pimpl_->strand_.dispatch([this, acct]{pimpl_->save_account(acct);});
+    pimpl_->save_account(acct);
 }
 
 // ==========================================================================
@@ -344,9 +603,7 @@ std::shared_ptr<paradice::character> context_impl::load_character(
     std::string const &name)
 {
     std::shared_ptr<paradice::character> ch;
-    pimpl_->strand_.dispatch([this, &name, &ch]{
-        pimpl_->load_character(name, ch);
-    });
+    pimpl_->load_character(name, ch);
     
     return ch;
 }
@@ -356,7 +613,7 @@ std::shared_ptr<paradice::character> context_impl::load_character(
 // ==========================================================================
 void context_impl::save_character(std::shared_ptr<paradice::character> const &ch)
 {
-    pimpl_->strand_.dispatch([this, ch]{pimpl_->save_character(ch);});
+    pimpl_->save_character(ch);
 }
 
 // ==========================================================================
@@ -364,72 +621,70 @@ void context_impl::save_character(std::shared_ptr<paradice::character> const &ch
 // ==========================================================================
 void context_impl::shutdown()
 {
-    pimpl_->work_.reset();
+    pimpl_->pool_.release_work();
     pimpl_->server_->shutdown();
 }
 
 // ==========================================================================
-// GET_ACTIVE_ENCOUNTER
+// RESTART
 // ==========================================================================
-std::shared_ptr<paradice::active_encounter> context_impl::get_active_encounter()
+void context_impl::restart()
 {
-    if (!gm_encounter) {
-        gm_encounter = std::make_shared<paradice::active_encounter>();
+    if (!pimpl_->restart_handler_)
+    {
+        throw std::runtime_error("restarting is not available");
     }
 
-    return gm_encounter;
+    pimpl_->restart_handler_();
 }
 
 // ==========================================================================
-// SET_ACTIVE_ENCOUNTER
+// ON_RESTART
 // ==========================================================================
-void context_impl::set_active_encounter(
-    std::shared_ptr<paradice::active_encounter> const &enc)
+void context_impl::on_restart(std::function<void ()> const &handler)
 {
-    gm_encounter = enc;
+    pimpl_->restart_handler_ = handler;
 }
 
 // ==========================================================================
-// IS_ACTIVE_ENCOUNTER_VISIBLE
+// GET_TABLE
 // ==========================================================================
-bool context_impl::is_active_encounter_visible() const
+std::shared_ptr<paradice::table> context_impl::get_table(
+    std::string const &name)
 {
-    return gm_encounter_visible;
+    return pimpl_->get_table(name);
 }
 
 // ==========================================================================
-// SET_ACTIVE_ENCOUNTER_VISIBLE
+// GET_TABLES
 // ==========================================================================
-void context_impl::set_active_encounter_visible(bool visibility)
+std::vector<std::shared_ptr<paradice::table>> context_impl::get_tables()
 {
-    gm_encounter_visible = visibility;
+    return pimpl_->get_tables();
+}
 
-    for (auto &cli : pimpl_->clients_)
-    {
-        if (cli)
-        {
-            if (gm_encounter_visible)
-            {
-                cli->get_user_interface()->show_active_encounter_window();
-            }
-            else
-            {
-                cli->get_user_interface()->hide_active_encounter_window();
-            }
-        }
-    }
+// ==========================================================================
+// SEAT_CLIENT
+// ==========================================================================
+std::shared_ptr<paradice::table> context_impl::seat_client(
+    std::shared_ptr<paradice::client> const &cli
+  , std::string const                       &name)
+{
+    return pimpl_->seat_client(cli, name);
 }
 
 // ==========================================================================
-// UPDATE_ACTIVE_ENCOUNTER
+// UNSEAT_CLIENT
 // ==========================================================================
-void context_impl::update_active_encounter()
+void context_impl::unseat_client(std::shared_ptr<paradice::client> const &cli)
 {
-    for (auto &cli : pimpl_->clients_)
-    {
-        if (cli)
-        {
-            cli->get_user_interface()->set_active_encounter(gm_encounter);
-        }
-    }
+    pimpl_->unseat_client(cli);
+}
+
+// ==========================================================================
+// GET_HELP
+// ==========================================================================
+std::shared_ptr<paradice::help_corpus const> context_impl::get_help()
+{
+    return pimpl_->help_;
 }
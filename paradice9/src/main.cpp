@@ -25,32 +25,111 @@
 //             SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. 
 // ==========================================================================
 #include "paradice9/paradice9.hpp"
-#include <boost/asio/io_service.hpp>
+#include "paradice/compression.hpp"
+#include "paradice/help.hpp"
+#include "paradice/idle_sweeper.hpp"
+#include "odin/net/admission_control.hpp"
+#include "odin/net/io_service_pool.hpp"
+#include "odin/net/metrics_listener.hpp"
+#include "odin/flight_recorder.hpp"
+#include "odin/metrics.hpp"
 #include <boost/format.hpp>
 #include <boost/program_options.hpp>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
 
 namespace po = boost::program_options;
 
-static void run_io_service(boost::asio::io_service &io_service)
-{
-    io_service.run();
-}
-
 int main(int argc, char *argv[])
 {
     unsigned int port        = 4000;
     std::string  threads     = "";
     unsigned int concurrency = 0;
+    std::string  assignment  = "round-robin";
+    bool         sharded     = false;
+    bool         pin_threads = false;
+    bool         reuse_port  = false;
+    odin::s32    backlog     = 0;
+    odin::u16    stats_port  = 0;
+
+    odin::flight_recorder::settings trace;
+    odin::u32 trace_threshold = 0;
+
+    auto policy = odin::net::io_service_pool::assignment_policy::round_robin;
+
+    paradice::compression_settings compression;
+    auto idle_timeout = odin::u32(compression.idle_timeout.count());
+
+    paradice::idle_settings idle;
+    auto const in_seconds = [](std::chrono::milliseconds time)
+    {
+        return odin::u32(
+            std::chrono::duration_cast<std::chrono::seconds>(time).count());
+    };
+
+    auto keepalive_interval   = in_seconds(idle.keepalive_interval);
+    auto session_idle_timeout = in_seconds(idle.idle_timeout);
+    auto idle_warning         = in_seconds(idle.idle_warning);
+
+    paradice::table_settings tables;
+
+    std::string help_directory;
+    std::shared_ptr<paradice::help_corpus const> help;
+
+    odin::net::admission_control::settings admission_settings;
+    std::shared_ptr<odin::net::admission_control> admission;
+
+    // A restart starts a new process with the same command line as this
+    // one, except for the channel over which this one hands over.
+    paradice9::handover_settings handover;
+
+    for (int index = 0; index < argc; ++index)
+    {
+        std::string const argument = argv[index];
+
+        if (argument.compare(0, 18, "--handover-channel") != 0)
+        {
+            handover.command_line.push_back(argument);
+        }
+        else if (argument.size() == 18 && index + 1 < argc)
+        {
+            ++index;
+        }
+    }
     
     po::options_description description("Available options");
     description.add_options()
         ( "help,h",                                       "show this help message"                            )
         ( "port,p",    po::value<unsigned int>(&port),    "port number"                                       )
         ( "threads,t", po::value<std::string>(&threads),  "number of threads of execution (0 for autodetect)" )
+        ( "sharded",     po::bool_switch(&sharded),       "give each thread its own io_service, rather than sharing one" )
+        ( "pin-threads", po::bool_switch(&pin_threads),   "pin each thread to a processor core" )
+        ( "assignment", po::value<std::string>(&assignment), "how sharded connections are assigned: round-robin or least-loaded" )
+        ( "reuse-port",  po::bool_switch(&reuse_port),    "with --sharded, open a listening socket per thread with SO_REUSEPORT" )
+        ( "backlog",     po::value<odin::s32>(&backlog),  "length of the queue of connections waiting to be accepted (0 for the system default)" )
+        ( "compression-memory-level", po::value<odin::s32>(&compression.memory_level), "zlib memory level of compressed connections (1-9)" )
+        ( "compression-window-bits",  po::value<odin::s32>(&compression.window_bits),  "zlib window size of compressed connections (9-15)" )
+        ( "compression-idle-timeout", po::value<odin::u32>(&idle_timeout),             "seconds of idleness before a connection's compression state is released" )
+        ( "keepalive-interval", po::value<odin::u32>(&keepalive_interval),   "seconds without output before a keepalive is sent to a connection" )
+        ( "idle-timeout",       po::value<odin::u32>(&session_idle_timeout), "seconds without input before a connection is disconnected (0 for never)" )
+        ( "idle-warning",       po::value<odin::u32>(&idle_warning),         "seconds before an idle disconnection that the connection is warned" )
+        ( "encounter-rolls", po::value<odin::u32>(&tables.max_encounter_rolls), "number of recent rolls kept for each participant in an encounter" )
+        ( "help-directory",  po::value<std::string>(&help_directory), "directory of further help topics, one per file, each named after its subject" )
+        ( "max-connections", po::value<odin::u32>(&admission_settings.maximum_connections),  "maximum number of concurrent connections (0 for no limit)" )
+        ( "connection-rate", po::value<double>(&admission_settings.connections_per_second),  "connections per second permitted from each address (0 for no limit)" )
+        ( "connection-burst", po::value<odin::u32>(&admission_settings.connection_burst),    "connections an address may open at once before the rate applies" )
+        ( "allow", po::value<std::vector<std::string>>(&admission_settings.allow)->composing(), "only admit connections from this network (address[/prefix]); may be repeated" )
+        ( "deny",  po::value<std::vector<std::string>>(&admission_settings.deny)->composing(),  "refuse connections from this network (address[/prefix]); may be repeated" )
+        ( "stats-port", po::value<odin::u16>(&stats_port), "local port on which metrics are served to a scraper (0 to disable)" )
+        ( "trace",           po::bool_switch(&trace.enabled),                "record the handlers run by each thread, for admin_trace to write out" )
+        ( "trace-threshold", po::value<odin::u32>(&trace_threshold),         "with --trace, write out the recording when a handler takes at least this many milliseconds (0 for never)" )
+        ( "trace-prefix",    po::value<std::string>(&trace.dump_prefix),     "with --trace, the prefix of the files to which recordings are written" )
+        ( "handover-channel", po::value<int>(&handover.channel), "used by admin_restart to pass the listener and clients to the new process" )
         ;
 
     po::positional_options_description pos_description;
@@ -68,6 +147,53 @@ int main(int argc, char *argv[])
         
         po::notify(vm);
         
+        compression.idle_timeout = std::chrono::seconds(idle_timeout);
+        trace.slow_threshold = std::chrono::milliseconds(trace_threshold);
+
+        idle.keepalive_interval = std::chrono::seconds(keepalive_interval);
+        idle.idle_timeout       = std::chrono::seconds(session_idle_timeout);
+        idle.idle_warning       = std::chrono::seconds(idle_warning);
+
+        if (idle.keepalive_interval.count() == 0)
+        {
+            throw po::error("the keepalive interval must be positive");
+        }
+
+        if (idle.idle_timeout.count() != 0
+         && idle.idle_warning >= idle.idle_timeout)
+        {
+            throw po::error(
+                "the idle warning must be shorter than the idle timeout");
+        }
+
+        try
+        {
+            admission = std::make_shared<odin::net::admission_control>(
+                admission_settings);
+        }
+        catch (std::invalid_argument const &ex)
+        {
+            throw po::error(ex.what());
+        }
+
+        try
+        {
+            help = paradice::make_help_corpus(help_directory);
+        }
+        catch (std::runtime_error const &ex)
+        {
+            throw po::error(ex.what());
+        }
+
+        if (assignment == "least-loaded")
+        {
+            policy = odin::net::io_service_pool::assignment_policy::least_loaded;
+        }
+        else if (assignment != "round-robin")
+        {
+            throw po::error("Unknown assignment: " + assignment);
+        }
+
         if (vm.count("help") != 0)
         {
             throw po::error("");
@@ -131,26 +257,87 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    boost::asio::io_service io_service;
-    
-    paradice9 application(
-        io_service
-      , std::make_shared<boost::asio::io_service::work>(std::ref(io_service))
-      , port);
- 
-    std::vector<std::thread> threadpool;
+    odin::flight_recorder::configure(trace);
+
+    // In the shared model, all threads run a single io_service.  In the
+    // sharded model, each thread runs its own io_service, and connections
+    // are assigned between them.
+    odin::net::io_service_pool pool(
+        sharded ? concurrency : 1
+      , sharded ? 1 : concurrency
+      , policy
+      , pin_threads);
 
-    for (unsigned int thr = 0; thr < concurrency; ++thr)
+    odin::net::server::options listener;
+    listener.backlog   = backlog;
+    listener.admission = admission;
+
+    if (reuse_port)
     {
-        threadpool.emplace_back(&run_io_service, std::ref(io_service));
+        for (odin::u32 index = 0; index < pool.get_size(); ++index)
+        {
+            listener.reuse_port_io_services.push_back(
+                &pool.get_io_service(index));
+        }
     }
-    
-    for (auto &pthread : threadpool)
+
+    // The admission controller keeps its own counts; these are published
+    // alongside the rest of the metrics.
+    auto &registry = odin::metrics::get_registry();
+    std::vector<odin::metrics::registry::function_handle> admission_metrics;
+
+    auto const add_admission_metric =
+        [&](std::string const &name,
+            std::string const &help,
+            odin::u32 odin::net::admission_control::statistics::*field)
+        {
+            admission_metrics.push_back(registry.add_function(
+                name, help, [admission, field]
+                {
+                    return double(admission->get_statistics().*field);
+                }));
+        };
+
+    add_admission_metric(
+        "odin_admission_active",
+        "Connections currently admitted",
+        &odin::net::admission_control::statistics::active);
+    add_admission_metric(
+        "odin_admission_admitted_total",
+        "Connections admitted",
+        &odin::net::admission_control::statistics::admitted);
+    add_admission_metric(
+        "odin_admission_refused_access_total",
+        "Connections refused by the allow and deny lists",
+        &odin::net::admission_control::statistics::refused_access);
+    add_admission_metric(
+        "odin_admission_refused_rate_total",
+        "Connections refused for exceeding the connection rate",
+        &odin::net::admission_control::statistics::refused_rate);
+    add_admission_metric(
+        "odin_admission_refused_capacity_total",
+        "Connections refused for exceeding the maximum connections",
+        &odin::net::admission_control::statistics::refused_capacity);
+
+    std::unique_ptr<odin::net::metrics_listener> stats;
+
+    if (stats_port != 0)
     {
-        pthread.join();
+        stats = std::make_unique<odin::net::metrics_listener>(
+            pool.get_io_service()
+          , stats_port
+          , [&registry]
+            {
+                std::stringstream stream;
+                registry.write_exposition(stream);
+                return stream.str();
+            });
     }
-    
-    io_service.stop();
+
+    paradice9 application(
+        pool, port, compression, idle, listener, handover, tables, help);
+ 
+    pool.run();
 
     return EXIT_SUCCESS;
 }
@@ -26,65 +26,409 @@
 // ==========================================================================
 #include "paradice9/paradice9.hpp"
 #include "paradice9/context_impl.hpp"
+#include "paradice/account.hpp"
 #include "paradice/character.hpp"
 #include "paradice/client.hpp"
 #include "paradice/communication.hpp"
+#include "paradice/compression.hpp"
 #include "paradice/connection.hpp"
+#include "paradice/idle_sweeper.hpp"
+#include "hugin/user_interface.hpp"
+#include "munin/window.hpp"
+#include "odin/metrics.hpp"
+#include "odin/net/handover_channel.hpp"
 #include "odin/net/server.hpp"
 #include "odin/net/socket.hpp"
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
 #include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/placeholders.hpp>
-#include <map>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/optional.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 #include <utility>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define PARADICE9_RESTART_SUPPORTED 1
+#endif
+
+namespace {
+    // A connection that has not finished negotiating within this time is
+    // given a client anyway, using default settings.
+    std::chrono::seconds const NEGOTIATION_DEADLINE(10);
+
+    BOOST_STATIC_CONSTANT(odin::u16, DEFAULT_WINDOW_WIDTH  = 80);
+    BOOST_STATIC_CONSTANT(odin::u16, DEFAULT_WINDOW_HEIGHT = 24);
+
+    // The messages passed between processes during a restart.  The old
+    // process sends its listeners, to which the new process replies when
+    // it is ready.  The old process then sends each session, followed by
+    // the end marker.
+    std::string const HANDOVER_LISTENERS = "listeners";
+    std::string const HANDOVER_READY     = "ready";
+    std::string const HANDOVER_SESSION   = "session";
+    std::string const HANDOVER_END       = "end";
+
+    // ======================================================================
+    // SESSION_SNAPSHOT
+    // ======================================================================
+    struct session_snapshot
+    {
+        std::string                        account_name;
+        std::string                        character_name;
+        std::string                        face;
+        odin::u16                          width  = DEFAULT_WINDOW_WIDTH;
+        odin::u16                          height = DEFAULT_WINDOW_HEIGHT;
+        paradice::connection::telnet_state telnet;
+
+        template <class Archive>
+        void serialize(Archive &ar, unsigned int const /*version*/)
+        {
+            ar & account_name
+               & character_name
+               & face
+               & width
+               & height
+               & telnet.echo
+               & telnet.suppress_ga
+               & telnet.naws
+               & telnet.terminal_type
+               & telnet.mccp
+               & telnet.terminal_type_name
+               & telnet.unread_input;
+        }
+    };
+
+    // ======================================================================
+    // TO_PAYLOAD
+    // ======================================================================
+    std::string to_payload(session_snapshot const &snapshot)
+    {
+        std::ostringstream stream;
+        stream << HANDOVER_SESSION << "\n";
+
+        boost::archive::text_oarchive archive(stream);
+        archive << snapshot;
+
+        return stream.str();
+    }
+
+    // ======================================================================
+    // FROM_PAYLOAD
+    // ======================================================================
+    boost::optional<session_snapshot> from_payload(std::string const &payload)
+    {
+        std::istringstream stream(payload);
+        std::string kind;
+
+        if (!std::getline(stream, kind) || kind != HANDOVER_SESSION)
+        {
+            return {};
+        }
+
+        session_snapshot snapshot;
+        boost::archive::text_iarchive archive(stream);
+        archive >> snapshot;
+
+        return snapshot;
+    }
+}
+
 // ==========================================================================
 // PARADICE9::IMPLEMENTATION STRUCTURE
 // ==========================================================================
 struct paradice9::impl
 {
+    // ======================================================================
+    // PENDING_SESSION
+    // ======================================================================
+    struct pending_session
+    {
+        std::shared_ptr<paradice::connection>          connection_;
+        odin::u32                                      shard_;
+        std::chrono::steady_clock::time_point          start_time_;
+        std::unique_ptr<boost::asio::steady_timer>     deadline_;
+        boost::optional<std::pair<odin::u16, odin::u16>> window_size_;
+    };
+
+    // ======================================================================
+    // HANDOVER_PROGRESS
+    // ======================================================================
+    // The progress of handing sessions over to a new process.  This is
+    // only accessed from within the strand.
+    struct handover_progress
+    {
+        explicit handover_progress(odin::net::handover_channel const &channel)
+          : channel_(channel)
+        {
+        }
+
+        odin::net::handover_channel                        channel_;
+        odin::u32                                          outstanding_ = 0;
+        bool                                               failed_ = false;
+        std::vector<std::shared_ptr<paradice::connection>> handed_over_;
+    };
+
 public :
     // ======================================================================
     // CONSTRUCTOR
     // ======================================================================
     impl(
-        boost::asio::io_service                        &io_service
-      , std::shared_ptr<boost::asio::io_service::work>  work
-      , unsigned int                                    port)
-        : io_service_(io_service) 
+        odin::net::io_service_pool            &pool
+      , unsigned int                           port
+      , paradice::compression_settings const  &compression
+      , paradice::idle_settings const         &idle
+      , odin::net::server::options const      &listener
+      , paradice9::handover_settings const    &handover
+      , paradice::table_settings const        &tables
+      , std::shared_ptr<paradice::help_corpus const> const &help)
+        : pool_(pool)
+        , strand_(pool.get_io_service())
+        , handover_command_line_(handover.command_line)
+        , compression_(
+              std::make_shared<paradice::compression_pool>(compression))
+        , sweepers_(make_sweepers(pool, idle))
+        , handover_channel_(
+              handover.channel >= 0
+            ? boost::make_optional(
+                  odin::net::handover_channel(handover.channel))
+            : boost::none)
         , server_(new odin::net::server(
-              io_service_
+              pool.get_io_service()
             , port
             , [this](auto socket){
-                  this->on_accept(socket);
-              }))
+                  this->on_listener_accept(socket);
+              }
+            , make_listener_options(listener)))
         , context_(std::make_shared<context_impl>(
-              std::ref(io_service), server_, std::ref(work)))
+              std::ref(pool), server_, tables, help))
     {
+        std::static_pointer_cast<context_impl>(context_)->on_restart(
+            [this]{this->restart();});
+
+        register_metrics();
+
+        // If this process was started by another handing over to it, then
+        // it is now ready for the sessions.
+        if (handover_channel_)
+        {
+            handover_channel_->send({ HANDOVER_READY, {} });
+            strand_.post([this]{this->resume_sessions();});
+        }
+    }
+
+    // ======================================================================
+    // GET_IDLE_STATISTICS
+    // ======================================================================
+    paradice::idle_sweeper::statistics get_idle_statistics() const
+    {
+        paradice::idle_sweeper::statistics total;
+
+        for (auto const &sweeper : sweepers_)
+        {
+            auto const stats = sweeper->get_statistics();
+            total.sessions   += stats.sessions;
+            total.idle       += stats.idle;
+            total.keepalives += stats.keepalives;
+            total.warned     += stats.warned;
+            total.evicted    += stats.evicted;
+        }
+
+        return total;
     }
 
 private :
+    // ======================================================================
+    // REGISTER_METRICS
+    // ======================================================================
+    void register_metrics()
+    {
+        auto &registry = odin::metrics::get_registry();
+
+        auto const add_negotiation_metric = 
+            [this, &registry](
+                std::string const &name, 
+                std::string const &help,
+                odin::u32 negotiation_statistics::*member)
+            {
+                metric_functions_.push_back(registry.add_function(
+                    name, help,
+                    [this, member]
+                    {
+                        std::unique_lock<std::mutex> lock(statistics_mutex_);
+                        return double(statistics_.*member);
+                    }));
+            };
+
+        add_negotiation_metric(
+            "paradice9_negotiations_pending",
+            "Connections whose telnet negotiation is in progress.",
+            &negotiation_statistics::pending);
+        add_negotiation_metric(
+            "paradice9_negotiations_completed_total",
+            "Telnet negotiations that were answered.",
+            &negotiation_statistics::completed);
+        add_negotiation_metric(
+            "paradice9_negotiations_timed_out_total",
+            "Telnet negotiations that passed their deadline.",
+            &negotiation_statistics::timed_out);
+        add_negotiation_metric(
+            "paradice9_negotiations_abandoned_total",
+            "Connections that died while negotiating.",
+            &negotiation_statistics::abandoned);
+
+        metric_functions_.push_back(registry.add_function(
+            "paradice9_idle_sessions",
+            "Sessions without input for at least the keepalive interval.",
+            [this]{ return double(get_idle_statistics().idle); }));
+        metric_functions_.push_back(registry.add_function(
+            "paradice9_idle_evictions_total",
+            "Sessions disconnected for being idle.",
+            [this]{ return double(get_idle_statistics().evicted); }));
+        metric_functions_.push_back(registry.add_function(
+            "paradice9_keepalives_total",
+            "Keepalives sent to sessions without recent output.",
+            [this]{ return double(get_idle_statistics().keepalives); }));
+    }
+
+    // ======================================================================
+    // MAKE_SWEEPERS
+    // ======================================================================
+    static std::vector<std::shared_ptr<paradice::idle_sweeper>> make_sweepers(
+        odin::net::io_service_pool   &pool
+      , paradice::idle_settings const &idle)
+    {
+        // Each io_service sweeps its own connections, so that keepalives
+        // are sent from the threads that own the sockets.
+        std::vector<std::shared_ptr<paradice::idle_sweeper>> sweepers;
+
+        for (odin::u32 index = 0; index < pool.get_size(); ++index)
+        {
+            sweepers.push_back(std::make_shared<paradice::idle_sweeper>(
+                pool.get_io_service(index), idle));
+        }
+
+        return sweepers;
+    }
+
+    // ======================================================================
+    // MAKE_LISTENER_OPTIONS
+    // ======================================================================
+    odin::net::server::options make_listener_options(
+        odin::net::server::options listener)
+    {
+        listener_per_io_service_ = !listener.reuse_port_io_services.empty();
+
+        // The first message from a previous process carries its listeners.
+        if (handover_channel_)
+        {
+            auto msg = handover_channel_->receive();
+
+            if (!msg || msg->payload != HANDOVER_LISTENERS)
+            {
+                throw std::runtime_error(
+                    "no listeners were handed over by the previous process");
+            }
+
+            listener.inherited_handles = msg->handles;
+        }
+
+        // Unless each io_service has its own listener, accepted sockets are
+        // assigned to io_services by the pool.
+        if (!listener_per_io_service_)
+        {
+            listener.select_io_service =
+                [this]() -> boost::asio::io_service &
+                {
+                    return pool_.get_io_service(pool_.assign());
+                };
+        }
+
+        return listener;
+    }
+
+    // ======================================================================
+    // ON_LISTENER_ACCEPT
+    // ======================================================================
+    void on_listener_accept(std::shared_ptr<odin::net::socket> const &socket)
+    {
+        // This may be called from any of the listeners' io_services.  Where
+        // the socket was not assigned by the pool, its load is recorded
+        // against the io_service that accepted it.
+        if (listener_per_io_service_)
+        {
+            pool_.assign(pool_.get_index(socket->get_io_service()));
+        }
+
+        strand_.dispatch([this, socket]{this->on_accept(socket);});
+    }
+
     // ======================================================================
     // ON_ACCEPT
     // ======================================================================
     void on_accept(std::shared_ptr<odin::net::socket> const &socket)
     {
+        // The socket runs on the io_service it was assigned to, which may
+        // not be this one.  The negotiation callbacks below are therefore
+        // posted back to this strand, which owns the pending connections.
+        auto const shard = pool_.get_index(socket->get_io_service());
+
         // Create the connection and client structures for the socket.
-        auto connection = std::make_shared<paradice::connection>(socket);
-        pending_connections_.push_back(connection);
+        auto connection = std::make_shared<paradice::connection>(
+            socket, compression_, sweepers_[shard]);
+
+        auto &session = pending_sessions_[connection.get()];
+        session.connection_ = connection;
+        session.shard_      = shard;
+        session.start_time_ = std::chrono::steady_clock::now();
+        session.deadline_   = std::make_unique<boost::asio::steady_timer>(
+            pool_.get_io_service());
+
+        // If the client does not answer the negotiation in time, it is given
+        // a client with the default settings instead.
+        session.deadline_->expires_from_now(NEGOTIATION_DEADLINE);
+        session.deadline_->async_wait(strand_.wrap(
+            [this, wp=std::weak_ptr<paradice::connection>(connection)]
+            (boost::system::error_code const &ec)
+            {
+                if (!ec)
+                {
+                    this->on_negotiation_deadline(wp);
+                }
+            }));
+
+        update_statistics([](auto &stats){ ++stats.pending; });
         
         // Before creating a client object, we first negotiate some
         // knowledge about the connection.  Set up the callbacks for this.
         connection->on_socket_death(
-            [this, wp=std::weak_ptr<paradice::connection>(connection)] 
+            [this, shard, wp=std::weak_ptr<paradice::connection>(connection)] 
             {
-                this->on_connection_death(wp);
+                strand_.post([this, shard, wp]
+                {
+                    this->on_connection_death(wp, shard);
+                });
             });
     
         connection->on_window_size_changed(
             [this, wp=std::weak_ptr<paradice::connection>(connection)]
             (auto w, auto h) 
             {
-                this->on_window_size_changed(wp, w, h);
+                strand_.post([this, wp, w, h]
+                {
+                    this->on_window_size_changed(wp, w, h);
+                });
             });
 
         connection->async_get_terminal_type(
@@ -93,7 +437,10 @@ private :
              wc=std::weak_ptr<paradice::connection>(connection)]
             (auto const &type)
             {
-                this->on_terminal_type(ws, wc, type);
+                strand_.post([this, ws, wc, type]
+                {
+                    this->on_terminal_type(ws, wc, type);
+                });
             });
 
         connection->start();
@@ -114,77 +461,543 @@ private :
         
         if (socket != NULL && connection != NULL)
         {
-            auto pending_connection =
-                std::find(
-                    pending_connections_.begin()
-                  , pending_connections_.end()
-                  , connection);
-            
-            // There is a possibility that this is a stray terminal type.
-            // If so, ignore it.
-            if (pending_connection == pending_connections_.end())
+            // There is a possibility that this is a stray terminal type,
+            // for example one that arrived after the deadline.  If so, 
+            // ignore it.
+            auto session = pending_sessions_.find(connection.get());
+
+            if (session != pending_sessions_.end())
             {
-                return;
+                complete_negotiation(session, false);
             }
-            
-            pending_connections_.erase(pending_connection);
+        }
+    }
 
-            auto client =
-                std::make_shared<paradice::client>(std::ref(io_service_), context_);
-            client->set_connection(connection);
-            
-            client->on_connection_death(bind(
-                &impl::on_client_death
-              , this
-              , std::weak_ptr<paradice::client>(client)));
+    // ======================================================================
+    // ON_NEGOTIATION_DEADLINE
+    // ======================================================================
+    void on_negotiation_deadline(
+        std::weak_ptr<paradice::connection> const &weak_connection)
+    {
+        auto connection = weak_connection.lock();
 
-            context_->add_client(client);
-            context_->update_names();
-            
-            // If the window's size has been set by the NAWS process,
-            // then update it to that.  Otherwise, use the standard 80,24.
-            auto psize = pending_sizes_.find(connection);
-            
-            if (psize != pending_sizes_.end())
+        if (connection != NULL)
+        {
+            auto session = pending_sessions_.find(connection.get());
+
+            if (session != pending_sessions_.end())
             {
-                client->set_window_size(
-                    psize->second.first
-                  , psize->second.second);
-                pending_sizes_.erase(connection);
+                printf("Terminal type is: unknown (no answer)\n");
+                complete_negotiation(session, true);
             }
-            else
+        }
+    }
+
+    // ======================================================================
+    // COMPLETE_NEGOTIATION
+    // ======================================================================
+    void complete_negotiation(
+        std::unordered_map<
+            paradice::connection *, pending_session
+        >::iterator session
+      , bool timed_out)
+    {
+        auto const connection  = session->second.connection_;
+        auto const shard       = session->second.shard_;
+        auto const window_size = session->second.window_size_;
+        auto const duration    = 
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() 
+              - session->second.start_time_);
+
+        boost::system::error_code unused_error_code;
+        session->second.deadline_->cancel(unused_error_code);
+        pending_sessions_.erase(session);
+
+        update_statistics(
+            [timed_out, duration](auto &stats)
+            {
+                --stats.pending;
+                ++(timed_out ? stats.timed_out : stats.completed);
+                stats.total_time  += duration;
+                stats.longest_time = (std::max)(stats.longest_time, duration);
+            });
+
+        auto client = create_client(connection, shard);
+        context_->update_names();
+        
+        // If the window's size has been set by the NAWS process,
+        // then update it to that.  Otherwise, use the standard 80,24.
+        if (window_size)
+        {
+            client->set_window_size(window_size->first, window_size->second);
+        }
+        else
+        {
+            client->set_window_size(
+                DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
+        }
+    }
+
+    // ======================================================================
+    // CREATE_CLIENT
+    // ======================================================================
+    std::shared_ptr<paradice::client> create_client(
+        std::shared_ptr<paradice::connection> const &connection
+      , odin::u32                                    shard)
+    {
+        // The client runs on the same io_service as its socket.
+        auto client = std::make_shared<paradice::client>(
+            std::ref(pool_.get_io_service(shard)), context_);
+        client->set_connection(connection);
+        
+        client->on_connection_death(bind(
+            &impl::on_client_death
+          , this
+          , std::weak_ptr<paradice::client>(client)
+          , shard));
+
+        context_->add_client(client);
+
+        return client;
+    }
+
+    // ======================================================================
+    // RESTART
+    // ======================================================================
+    void restart()
+    {
+#if defined(PARADICE9_RESTART_SUPPORTED)
+        if (handover_command_line_.empty())
+        {
+            throw std::runtime_error("no command with which to restart");
+        }
+
+        auto channels = odin::net::handover_channel::create_pair();
+        auto const child_handle = channels.second.get_native_handle();
+
+        auto arguments = handover_command_line_;
+        arguments.push_back(
+            "--handover-channel=" + std::to_string(child_handle));
+
+        std::vector<char *> argv;
+
+        for (auto &argument : arguments)
+        {
+            argv.push_back(&argument[0]);
+        }
+
+        argv.push_back(nullptr);
+
+        auto const maximum_handle = int(::sysconf(_SC_OPEN_MAX));
+        auto const pid = ::fork();
+
+        if (pid < 0)
+        {
+            throw std::runtime_error("unable to start a new process");
+        }
+        else if (pid == 0)
+        {
+            // In the new process, only the standard handles and the 
+            // channel survive; anything else would keep the sockets that
+            // are about to be handed over open behind their backs.  Only
+            // async-signal-safe functions may be called here.
+            for (int handle = 3; handle < maximum_handle; ++handle)
             {
-                client->set_window_size(80, 24);
+                if (handle != child_handle)
+                {
+                    ::close(handle);
+                }
+            }
+
+            ::fcntl(child_handle, F_SETFD, 0);
+            ::execvp(argv[0], argv.data());
+            ::_exit(127);
+        }
+
+        channels.second.close();
+
+        strand_.post(
+            [this, channel=channels.first]() mutable
+            {
+                this->hand_over(channel);
+            });
+#else
+        throw std::runtime_error("restarting is not supported here");
+#endif
+    }
+
+    // ======================================================================
+    // HAND_OVER
+    // ======================================================================
+    void hand_over(odin::net::handover_channel &channel)
+    {
+        // Pass the listeners over first, and wait for the new process to
+        // show that it is able to take over from here.  The wait takes
+        // place within the io_service, so that this process carries on as
+        // before in the meantime, and also if the new process fails.
+        try
+        {
+            channel.send({ HANDOVER_LISTENERS, server_->get_native_handles() });
+            channel.async_receive(
+                pool_.get_io_service(),
+                strand_.wrap(
+                    [this, channel](auto const &error, auto const &reply)
+                    {
+                        this->on_handover_reply(channel, error, reply);
+                    }));
+        }
+        catch (std::exception const &ex)
+        {
+            printf("Restart abandoned: %s\n", ex.what());
+        }
+    }
+
+    // ======================================================================
+    // ON_HANDOVER_REPLY
+    // ======================================================================
+    void on_handover_reply(
+        odin::net::handover_channel                             channel
+      , boost::system::error_code                        const &error
+      , boost::optional<odin::net::handover_channel::message> const &reply)
+    {
+        if (!reply || reply->payload != HANDOVER_READY)
+        {
+            printf("Restart abandoned: the new process did not start%s%s\n",
+                error ? ": " : "",
+                error ? error.message().c_str() : "");
+            return;
+        }
+
+        // From here, clients leave quietly.
+        handing_over_ = true;
+        server_->shutdown();
+
+        // Each session is prepared from within its own strand, and the
+        // results are sent from within this one as they arrive.  One step
+        // is held back until every session has been asked for, so that
+        // the handover cannot finish early.
+        auto progress = std::make_shared<handover_progress>(channel);
+        progress->outstanding_ = 1;
+
+        // Connections that are still negotiating are handed over as if
+        // they had finished.
+        for (auto &pending : pending_sessions_)
+        {
+            boost::system::error_code unused_error_code;
+            pending.second.deadline_->cancel(unused_error_code);
+
+            session_snapshot snapshot;
+
+            if (pending.second.window_size_)
+            {
+                snapshot.width  = pending.second.window_size_->first;
+                snapshot.height = pending.second.window_size_->second;
             }
+
+            ++progress->outstanding_;
+            prepare_session(progress, pending.second.connection_, snapshot);
+        }
+
+        pending_sessions_.clear();
+
+        for (auto const &client : context_->get_clients())
+        {
+            ++progress->outstanding_;
+            client->async_get_handover_state(
+                [this, progress, client](auto const &state)
+                {
+                    session_snapshot snapshot;
+                    snapshot.account_name   = state.account_name;
+                    snapshot.character_name = state.character_name;
+                    snapshot.face           = state.face;
+                    snapshot.width          = state.width;
+                    snapshot.height         = state.height;
+
+                    auto const connection = client->get_connection();
+
+                    if (connection != NULL)
+                    {
+                        this->prepare_session(progress, connection, snapshot);
+                    }
+                    else
+                    {
+                        strand_.post(
+                            [this, progress]
+                            {
+                                this->finish_handover_step(progress);
+                            });
+                    }
+                });
         }
+
+        finish_handover_step(progress);
+    }
+
+    // ======================================================================
+    // PREPARE_SESSION
+    // ======================================================================
+    void prepare_session(
+        std::shared_ptr<handover_progress>    const &progress
+      , std::shared_ptr<paradice::connection> const &connection
+      , session_snapshot                      const &snapshot)
+    {
+        connection->async_prepare_handover(
+            [this, progress, connection, snapshot](
+                auto const &telnet, auto const &socket)
+            {
+                auto prepared = snapshot;
+                prepared.telnet = telnet;
+
+                strand_.post(
+                    [this, progress, connection, prepared, socket]
+                    {
+                        this->hand_over_session(
+                            progress, connection, prepared, socket);
+                    });
+            });
+    }
+
+    // ======================================================================
+    // HAND_OVER_SESSION
+    // ======================================================================
+    void hand_over_session(
+        std::shared_ptr<handover_progress>    const &progress
+      , std::shared_ptr<paradice::connection> const &connection
+      , session_snapshot                      const &snapshot
+      , std::shared_ptr<odin::net::socket>    const &socket)
+    {
+        if (socket != NULL)
+        {
+            progress->handed_over_.push_back(connection);
+
+            if (!progress->failed_)
+            {
+                try
+                {
+                    progress->channel_.send(
+                        { to_payload(snapshot), { socket->get_native_handle() } });
+                }
+                catch (std::exception const &ex)
+                {
+                    // The sessions that are not handed over are
+                    // disconnected, just as they would be by a shutdown.
+                    printf("Error during restart: %s\n", ex.what());
+                    progress->failed_ = true;
+                }
+            }
+        }
+
+        finish_handover_step(progress);
+    }
+
+    // ======================================================================
+    // FINISH_HANDOVER_STEP
+    // ======================================================================
+    void finish_handover_step(std::shared_ptr<handover_progress> const &progress)
+    {
+        if (--progress->outstanding_ != 0)
+        {
+            return;
+        }
+
+        if (!progress->failed_)
+        {
+            try
+            {
+                progress->channel_.send({ HANDOVER_END, {} });
+            }
+            catch (std::exception const &ex)
+            {
+                printf("Error during restart: %s\n", ex.what());
+            }
+        }
+
+        progress->channel_.close();
+
+        // This process's copies of the sockets can now be closed.  The new
+        // process holds its own copies, so the clients remain connected.
+        for (auto const &connection : progress->handed_over_)
+        {
+            connection->disconnect();
+        }
+
+        for (auto const &client : context_->get_clients())
+        {
+            client->disconnect();
+        }
+
+        context_->shutdown();
+    }
+
+    // ======================================================================
+    // RESUME_SESSIONS
+    // ======================================================================
+    void resume_sessions()
+    {
+        handover_channel_->async_receive(
+            pool_.get_io_service(),
+            strand_.wrap(
+                [this](auto const &error, auto const &msg)
+                {
+                    this->on_resumed_session(error, msg);
+                }));
+    }
+
+    // ======================================================================
+    // ON_RESUMED_SESSION
+    // ======================================================================
+    void on_resumed_session(
+        boost::system::error_code                        const &error
+      , boost::optional<odin::net::handover_channel::message> const &msg)
+    {
+        if (msg && msg->payload != HANDOVER_END)
+        {
+            try
+            {
+                auto const snapshot = from_payload(msg->payload);
+
+                if (snapshot && msg->handles.size() == 1)
+                {
+                    resume_session(*snapshot, msg->handles[0]);
+                }
+            }
+            catch (std::exception const &ex)
+            {
+                printf("Error resuming sessions: %s\n", ex.what());
+            }
+
+            resume_sessions();
+            return;
+        }
+
+        if (error)
+        {
+            printf("Error resuming sessions: %s\n", error.message().c_str());
+        }
+
+        handover_channel_->close();
+        handover_channel_ = boost::none;
+    }
+
+    // ======================================================================
+    // RESUME_SESSION
+    // ======================================================================
+    void resume_session(session_snapshot const &snapshot, int handle)
+    {
+        auto const shard = pool_.assign();
+
+        auto tcp_socket = std::make_shared<boost::asio::ip::tcp::socket>(
+            pool_.get_io_service(shard));
+
+        boost::system::error_code ec;
+        tcp_socket->assign(boost::asio::ip::tcp::v4(), handle, ec);
+
+        if (ec)
+        {
+            printf("Error resuming session: %s\n", ec.message().c_str());
+#if defined(PARADICE9_RESTART_SUPPORTED)
+            ::close(handle);
+#endif
+            pool_.release(shard);
+            return;
+        }
+
+        auto connection = std::make_shared<paradice::connection>(
+            std::make_shared<odin::net::socket>(tcp_socket)
+          , compression_
+          , sweepers_[shard]
+          , snapshot.telnet);
+
+        auto client = create_client(connection, shard);
+        client->set_window_size(snapshot.width, snapshot.height);
+
+        std::shared_ptr<paradice::account>   acc;
+        std::shared_ptr<paradice::character> ch;
+
+        try
+        {
+            if (!snapshot.account_name.empty())
+            {
+                acc = context_->load_account(snapshot.account_name);
+            }
+
+            if (acc != NULL && !snapshot.character_name.empty())
+            {
+                ch = context_->load_character(snapshot.character_name);
+            }
+        }
+        catch (std::exception const &ex)
+        {
+            printf("Error resuming session of %s: %s\n", 
+                snapshot.account_name.c_str(), ex.what());
+        }
+
+        // The client's window is new, so its first paint covers the whole
+        // of the terminal, replacing whatever the previous process drew.
+        client->restore(acc, ch, snapshot.face);
+        context_->update_names();
+
+        connection->start();
+    }
+
+    // ======================================================================
+    // UPDATE_STATISTICS
+    // ======================================================================
+    template <class Function>
+    void update_statistics(Function &&fn)
+    {
+        std::unique_lock<std::mutex> lock(statistics_mutex_);
+        fn(statistics_);
     }
     
     // ======================================================================
     // ON_CONNECTION_DEATH
     // ======================================================================
-    void on_connection_death(std::weak_ptr<paradice::connection> const &weak_connection)
+    void on_connection_death(
+        std::weak_ptr<paradice::connection> const &weak_connection
+      , odin::u32                                  shard)
     {
         auto connection = weak_connection.lock();
     
         if (connection != NULL)
         {
-            pending_connections_.erase(remove(
-                    pending_connections_.begin()
-                  , pending_connections_.end()
-                  , connection)
-              , pending_connections_.end());
-            pending_sizes_.erase(connection);
+            auto session = pending_sessions_.find(connection.get());
+
+            // Once negotiation has completed, the connection belongs to a
+            // client, whose death callback removes it and releases its
+            // shard.  That callback is called even if the socket died
+            // before it could be installed, so nothing is done here.
+            if (session != pending_sessions_.end())
+            {
+                pool_.release(shard);
+
+                boost::system::error_code unused_error_code;
+                session->second.deadline_->cancel(unused_error_code);
+                pending_sessions_.erase(session);
+
+                update_statistics(
+                    [](auto &stats)
+                    {
+                        --stats.pending;
+                        ++stats.abandoned;
+                    });
+            }
         }
     }
     
     // ======================================================================
     // ON_CLIENT_DEATH
     // ======================================================================
-    void on_client_death(std::weak_ptr<paradice::client> &weak_client)
+    void on_client_death(
+        std::weak_ptr<paradice::client> &weak_client
+      , odin::u32                        shard)
     {
+        pool_.release(shard);
+
         auto client = weak_client.lock();
         
-        if (client != NULL)
+        if (client != NULL && !handing_over_)
         {
             context_->remove_client(client);
             context_->update_names();
@@ -222,29 +1035,74 @@ private :
         
         if (connection != NULL)
         {
-            pending_sizes_[connection] = std::make_pair(width, height);
+            auto session = pending_sessions_.find(connection.get());
+
+            if (session != pending_sessions_.end())
+            {
+                session->second.window_size_ = std::make_pair(width, height);
+            }
         }
     }
     
-    boost::asio::io_service            &io_service_;
-    std::shared_ptr<odin::net::server>  server_;
-    std::shared_ptr<paradice::context>  context_;
+    odin::net::io_service_pool                   &pool_;
+    boost::asio::strand                           strand_;
+    bool                                          listener_per_io_service_;
+    std::vector<std::string>                      handover_command_line_;
+    std::atomic<bool>                             handing_over_{false};
+    std::shared_ptr<paradice::compression_pool>   compression_;
+    std::vector<std::shared_ptr<paradice::idle_sweeper>>
+                                                  sweepers_;
+    boost::optional<odin::net::handover_channel>  handover_channel_;
+    std::shared_ptr<odin::net::server>            server_;
+    std::shared_ptr<paradice::context>            context_;
     
-    // A vector of clients whose connections are being negotiated.
-    std::vector<std::shared_ptr<paradice::connection>> pending_connections_;
-    std::map<
-        std::shared_ptr<paradice::connection>, 
-        std::pair<odin::u16, odin::u16> > pending_sizes_; 
+    // Connections that are being negotiated, which are only accessed
+    // from within the strand.
+    std::unordered_map<paradice::connection *, pending_session>
+                                                  pending_sessions_;
+
+public :
+    mutable std::mutex                            statistics_mutex_;
+    negotiation_statistics                        statistics_;
+
+private :
+    // These are declared last so that the functions are removed from the
+    // registry before anything that they read is destroyed.
+    std::vector<odin::metrics::registry::function_handle>
+                                                  metric_functions_;
 };
 
 // ==========================================================================
 // CONSTRUCTOR
 // ==========================================================================
 paradice9::paradice9(
-    boost::asio::io_service                        &io_service
-  , std::shared_ptr<boost::asio::io_service::work>  work
-  , unsigned int                        port)
-    : pimpl_(new impl(io_service, work, port))  
+    odin::net::io_service_pool            &pool
+  , unsigned int                           port
+  , paradice::compression_settings const  &compression
+  , paradice::idle_settings const         &idle
+  , odin::net::server::options const      &listener
+  , handover_settings const               &handover
+  , paradice::table_settings const        &tables
+  , std::shared_ptr<paradice::help_corpus const> const &help)
+    : pimpl_(new impl(
+          pool, port, compression, idle, listener, handover, tables, help))
+{
+}
+
+// ==========================================================================
+// GET_NEGOTIATION_STATISTICS
+// ==========================================================================
+paradice9::negotiation_statistics paradice9::get_negotiation_statistics() const
+{
+    std::unique_lock<std::mutex> lock(pimpl_->statistics_mutex_);
+    return pimpl_->statistics_;
+}
+
+// ==========================================================================
+// GET_IDLE_STATISTICS
+// ==========================================================================
+paradice::idle_sweeper::statistics paradice9::get_idle_statistics() const
 {
+    return pimpl_->get_idle_statistics();
 }
 
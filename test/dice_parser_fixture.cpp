@@ -78,3 +78,26 @@ TEST(dice_parser, test_roll_extended_bonus)
     ASSERT_EQ(std::string("FOO"), std::string(begin, end));
 }
 
+
+//* =========================================================================
+//  A roll may be parsed from a range of characters, such as a view of the
+//  arguments to a command.
+//* =========================================================================
+TEST(dice_parser, test_roll_from_characters)
+{
+    char const text[] = "3*2d20+1 initiative";
+    char const *begin = text;
+    char const *end   = text + sizeof(text) - 1;
+    
+    auto roll = paradice::parse_dice_roll(begin, end);
+        
+    ASSERT_TRUE(roll.is_initialized());
+    
+    paradice::dice_roll result = roll.get();
+    
+    ASSERT_EQ(odin::u32(3), result.repetitions_);
+    ASSERT_EQ(odin::u32(2), result.amount_);
+    ASSERT_EQ(odin::u32(20), result.sides_);
+    ASSERT_EQ(odin::s32(1), result.bonus_);
+    ASSERT_EQ(std::string("initiative"), std::string(begin, end));
+}
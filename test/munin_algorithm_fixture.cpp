@@ -521,3 +521,78 @@ TEST(munin_algorithm, test_rectangular_slice)
 }
 
 
+
+TEST(munin_algorithm, test_rectangle_difference_no_overlap)
+{
+    // If the rectangles do not overlap, then the whole of the first
+    // rectangle remains.
+    using terminalpp::point;
+    using terminalpp::extent;
+    using munin::rectangle;
+
+    auto result = munin::difference(
+        rectangle(point(0,0), extent(2,2))
+      , rectangle(point(3,3), extent(2,2)));
+
+    ASSERT_EQ(1u, result.size());
+    ASSERT_EQ(rectangle(point(0,0), extent(2,2)), result[0]);
+}
+
+TEST(munin_algorithm, test_rectangle_difference_contain)
+{
+    // If the second rectangle covers the first, then nothing remains.
+    using terminalpp::point;
+    using terminalpp::extent;
+    using munin::rectangle;
+
+    auto result = munin::difference(
+        rectangle(point(1,1), extent(2,2))
+      , rectangle(point(0,0), extent(4,4)));
+
+    ASSERT_TRUE(result.empty());
+}
+
+TEST(munin_algorithm, test_rectangle_difference_hole)
+{
+    // If the second rectangle is inside the first, then the bands above and
+    // below it and the parts either side of it remain.
+    //
+    //  0123456       0123456
+    // 0+-----+      0AAAAAAA
+    // 1| L   |      1AAAAAAA
+    // 2| +-+ |  ->  2BB   CC
+    // 3| |R| |      3BB   CC
+    // 4| +-+ |      4DDDDDDD
+    // 5+-----+      5DDDDDDD
+    //
+    using terminalpp::point;
+    using terminalpp::extent;
+    using munin::rectangle;
+
+    auto result = munin::difference(
+        rectangle(point(0,0), extent(7,6))
+      , rectangle(point(2,2), extent(3,2)));
+
+    ASSERT_EQ(4u, result.size());
+    ASSERT_EQ(rectangle(point(0,0), extent(7,2)), result[0]);
+    ASSERT_EQ(rectangle(point(0,2), extent(2,2)), result[1]);
+    ASSERT_EQ(rectangle(point(5,2), extent(2,2)), result[2]);
+    ASSERT_EQ(rectangle(point(0,4), extent(7,2)), result[3]);
+}
+
+TEST(munin_algorithm, test_rectangle_difference_overlap_top_left)
+{
+    // If the second rectangle overlaps the top left of the first, then the
+    // part to the right of the overlap and the band below it remain.
+    using terminalpp::point;
+    using terminalpp::extent;
+    using munin::rectangle;
+
+    auto result = munin::difference(
+        rectangle(point(2,2), extent(4,4))
+      , rectangle(point(0,0), extent(4,4)));
+
+    ASSERT_EQ(2u, result.size());
+    ASSERT_EQ(rectangle(point(4,2), extent(2,2)), result[0]);
+    ASSERT_EQ(rectangle(point(2,4), extent(4,2)), result[1]);
+}
@@ -0,0 +1,175 @@
+#include "munin/basic_component.hpp"
+#include "munin/basic_container.hpp"
+#include "munin/context.hpp"
+#include "munin/filled_box.hpp"
+#include <terminalpp/canvas.hpp>
+#include <terminalpp/canvas_view.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// A component that fills whatever it is asked to draw with a glyph and
+// remembers the regions it was asked to draw.
+class patch : public munin::basic_component
+{
+public :
+    patch(char glyph, bool opaque)
+        : glyph_(glyph),
+          opaque_(opaque)
+    {
+    }
+
+    std::vector<munin::rectangle> drawn_regions;
+
+protected :
+    terminalpp::extent do_get_preferred_size() const override
+    {
+        return get_size();
+    }
+
+    bool do_is_opaque() const override
+    {
+        return opaque_;
+    }
+
+    void do_draw(
+        munin::context         &ctx
+      , munin::rectangle const &region) override
+    {
+        drawn_regions.push_back(region);
+
+        auto &cvs = ctx.get_canvas();
+
+        for (auto row = region.origin.y;
+             row < region.origin.y + region.size.height;
+             ++row)
+        {
+            for (auto column = region.origin.x;
+                 column < region.origin.x + region.size.width;
+                 ++column)
+            {
+                cvs[column][row] = glyph_;
+            }
+        }
+    }
+
+private :
+    char glyph_;
+    bool opaque_;
+};
+
+std::shared_ptr<patch> add_patch(
+    munin::container         &cont
+  , char                      glyph
+  , bool                      opaque
+  , munin::rectangle   const &bounds
+  , odin::u32                 layer)
+{
+    auto comp = std::make_shared<patch>(glyph, opaque);
+    comp->set_position(bounds.origin);
+    comp->set_size(bounds.size);
+    cont.add_component(comp, {}, layer);
+    return comp;
+}
+
+// Builds a stack of overlapping patches, like a window with a dialog and a
+// tooltip over it, and draws it onto a canvas.  The glyphs are the same
+// whether or not the patches are opaque, so the canvases must be too.
+terminalpp::canvas draw_stack(bool opaque)
+{
+    auto cont = std::make_shared<munin::basic_container>();
+    cont->set_size({10, 6});
+
+    add_patch(*cont, '.', opaque, {{0, 0}, {10, 6}}, 0);
+    add_patch(*cont, 'a', opaque, {{1, 1}, {6, 4}}, 1);
+    add_patch(*cont, 'b', false,  {{3, 2}, {6, 3}}, 2);
+    add_patch(*cont, 'c', opaque, {{5, 0}, {2, 6}}, 3);
+
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    terminalpp::canvas cvs({10, 6});
+    terminalpp::canvas_view cvs_view(cvs);
+    munin::context ctx(cvs_view, strand);
+
+    cont->draw(ctx, {{0, 0}, {10, 6}});
+    cont->draw(ctx, {{2, 1}, {5, 3}});
+
+    return cvs;
+}
+
+}
+
+TEST(munin_container, culled_canvas_is_identical_to_unculled_canvas)
+{
+    auto culled   = draw_stack(true);
+    auto unculled = draw_stack(false);
+
+    for (odin::s32 row = 0; row < 6; ++row)
+    {
+        for (odin::s32 column = 0; column < 10; ++column)
+        {
+            ASSERT_TRUE(culled[column][row] == unculled[column][row])
+                << "at (" << column << "," << row << ")";
+        }
+    }
+}
+
+TEST(munin_container, fully_occluded_component_is_not_drawn)
+{
+    auto cont = std::make_shared<munin::basic_container>();
+    cont->set_size({4, 4});
+
+    auto below = add_patch(*cont, 'x', true, {{1, 1}, {2, 2}}, 0);
+    auto above = add_patch(*cont, 'y', true, {{0, 0}, {4, 4}}, 1);
+
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    terminalpp::canvas cvs({4, 4});
+    terminalpp::canvas_view cvs_view(cvs);
+    munin::context ctx(cvs_view, strand);
+
+    cont->draw(ctx, {{0, 0}, {4, 4}});
+
+    ASSERT_TRUE(below->drawn_regions.empty());
+    ASSERT_EQ(1u, above->drawn_regions.size());
+}
+
+TEST(munin_container, partially_occluded_component_is_clipped)
+{
+    auto cont = std::make_shared<munin::basic_container>();
+    cont->set_size({4, 4});
+
+    auto below = add_patch(*cont, 'x', false, {{0, 0}, {4, 4}}, 0);
+    add_patch(*cont, 'y', true, {{0, 0}, {4, 3}}, 1);
+
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    terminalpp::canvas cvs({4, 4});
+    terminalpp::canvas_view cvs_view(cvs);
+    munin::context ctx(cvs_view, strand);
+
+    cont->draw(ctx, {{0, 0}, {4, 4}});
+
+    ASSERT_EQ(1u, below->drawn_regions.size());
+    ASSERT_EQ(munin::rectangle({0, 3}, {4, 1}), below->drawn_regions[0]);
+}
+
+TEST(munin_container, container_covered_by_opaque_components_is_opaque)
+{
+    auto cont = std::make_shared<munin::basic_container>();
+    cont->set_size({4, 4});
+
+    add_patch(*cont, 'x', false, {{0, 0}, {4, 4}}, 0);
+    add_patch(*cont, 'y', true,  {{0, 0}, {4, 2}}, 1);
+    ASSERT_FALSE(cont->is_opaque());
+
+    auto fill = munin::make_fill('z');
+    fill->set_position({0, 2});
+    fill->set_size({4, 2});
+    cont->add_component(fill);
+    ASSERT_TRUE(cont->is_opaque());
+}
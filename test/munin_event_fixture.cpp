@@ -0,0 +1,216 @@
+#include "munin/basic_component.hpp"
+#include "munin/basic_container.hpp"
+#include "munin/edit.hpp"
+#include "munin/event.hpp"
+#include "munin/text/document.hpp"
+#include <terminalpp/virtual_key.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ping
+{
+    std::string message;
+};
+
+// A component that records every event that reaches it.
+class recorder : public munin::basic_component
+{
+public :
+    std::vector<munin::event_type> events;
+
+protected :
+    terminalpp::extent do_get_preferred_size() const override
+    {
+        return {};
+    }
+
+    void do_draw(munin::context &, munin::rectangle const &) override
+    {
+    }
+
+    void do_event(munin::event_type const &event) override
+    {
+        events.push_back(event);
+        munin::basic_component::do_event(event);
+    }
+};
+
+std::string characters_of(terminalpp::string const &text)
+{
+    std::string result;
+
+    for (auto const &elem : text)
+    {
+        result += elem.glyph_.character_;
+    }
+
+    return result;
+}
+
+}
+
+TEST(munin_event, custom_event_is_found_by_its_type)
+{
+    munin::event_type const event = boost::any(ping{"hello"});
+
+    auto const *pinged = munin::custom_event_cast<ping>(event);
+    ASSERT_NE(nullptr, pinged);
+    ASSERT_EQ("hello", pinged->message);
+}
+
+TEST(munin_event, custom_event_is_not_found_by_another_type)
+{
+    munin::event_type const event = boost::any(ping{"hello"});
+
+    ASSERT_EQ(nullptr, munin::custom_event_cast<std::string>(event));
+}
+
+TEST(munin_event, terminal_event_is_not_a_custom_event)
+{
+    terminalpp::virtual_key vk;
+    vk.key = terminalpp::vk::enter;
+    vk.repeat_count = 1;
+    munin::event_type const event = vk;
+
+    ASSERT_EQ(nullptr, munin::custom_event_cast<terminalpp::virtual_key>(event));
+    ASSERT_NE(nullptr, boost::get<terminalpp::virtual_key>(&event));
+}
+
+TEST(munin_event, container_passes_events_to_the_focussed_component)
+{
+    auto cont = std::make_shared<munin::basic_container>();
+    auto unfocussed = std::make_shared<recorder>();
+    auto focussed = std::make_shared<recorder>();
+
+    focussed->set_can_focus(true);
+    cont->add_component(unfocussed);
+    cont->add_component(focussed);
+    focussed->set_focus();
+
+    terminalpp::virtual_key vk;
+    vk.key = terminalpp::vk::enter;
+    vk.repeat_count = 1;
+    cont->event(vk);
+    cont->event(boost::any(ping{"hello"}));
+
+    ASSERT_TRUE(unfocussed->events.empty());
+    ASSERT_EQ(2u, focussed->events.size());
+    ASSERT_NE(
+        nullptr,
+        boost::get<terminalpp::virtual_key>(&focussed->events[0]));
+    ASSERT_NE(
+        nullptr,
+        munin::custom_event_cast<ping>(focussed->events[1]));
+}
+
+TEST(munin_event, container_passes_events_to_a_newly_focussed_component)
+{
+    auto cont = std::make_shared<munin::basic_container>();
+    auto first = std::make_shared<recorder>();
+    auto second = std::make_shared<recorder>();
+
+    first->set_can_focus(true);
+    second->set_can_focus(true);
+    cont->add_component(first);
+    cont->add_component(second);
+
+    first->set_focus();
+    cont->event(boost::any(ping{"first"}));
+
+    second->set_focus();
+    cont->event(boost::any(ping{"second"}));
+
+    ASSERT_FALSE(first->has_focus());
+    ASSERT_EQ(1u, first->events.size());
+    ASSERT_EQ(1u, second->events.size());
+    ASSERT_EQ(
+        "second",
+        munin::custom_event_cast<ping>(second->events[0])->message);
+}
+
+TEST(munin_event, container_passes_mouse_reports_to_the_component_beneath)
+{
+    // Lay out a grid of components large enough that the container indexes
+    // them by row.
+    auto cont = std::make_shared<munin::basic_container>();
+    cont->set_size({8, 6});
+
+    std::vector<std::shared_ptr<recorder>> cells;
+
+    for (odin::s32 row = 0; row < 3; ++row)
+    {
+        for (odin::s32 column = 0; column < 4; ++column)
+        {
+            auto cell = std::make_shared<recorder>();
+            cell->set_position({column * 2, row * 2});
+            cell->set_size({2, 2});
+            cont->add_component(cell);
+            cells.push_back(cell);
+        }
+    }
+
+    terminalpp::ansi::mouse::report report;
+    report.button_ = terminalpp::ansi::mouse::report::LEFT_BUTTON_DOWN;
+    report.x_position_ = 5;
+    report.y_position_ = 3;
+    cont->event(report);
+
+    for (size_t index = 0; index < cells.size(); ++index)
+    {
+        ASSERT_EQ(index == 6 ? 1u : 0u, cells[index]->events.size());
+    }
+
+    auto const *subreport =
+        boost::get<terminalpp::ansi::mouse::report>(&cells[6]->events[0]);
+    ASSERT_NE(nullptr, subreport);
+    ASSERT_EQ(1, subreport->x_position_);
+    ASSERT_EQ(1, subreport->y_position_);
+
+    // Move the clicked component out of the way, and another into its
+    // place.  The report must follow them.
+    cells[6]->set_position({0, 6});
+    cells[0]->set_position({4, 2});
+    cont->event(report);
+
+    ASSERT_EQ(1u, cells[6]->events.size());
+    ASSERT_EQ(1u, cells[0]->events.size());
+}
+
+TEST(munin_event, edit_inserts_a_text_run_as_one_change)
+{
+    auto ed = munin::make_edit();
+    ed->set_size({20, 1});
+
+    ASSERT_TRUE(ed->accepts_text_runs());
+
+    auto document = ed->get_document();
+    document->insert_text(terminalpp::string("ad"));
+    document->set_caret_index(1);
+
+    std::vector<std::vector<munin::rectangle>> changes;
+    document->on_redraw.connect(
+        [&changes](std::vector<munin::rectangle> const &regions)
+        {
+            changes.push_back(regions);
+        });
+
+    ed->event(munin::text_run{terminalpp::string("bc")});
+
+    ASSERT_EQ("abcd", characters_of(document->get_line(0)));
+    ASSERT_EQ(3u, document->get_caret_index());
+
+    // The inserted text and everything after it is redrawn at once.
+    ASSERT_EQ(1u, changes.size());
+    ASSERT_EQ(1u, changes[0].size());
+    ASSERT_EQ(munin::rectangle({1, 0}, {3, 1}), changes[0][0]);
+}
+
+TEST(munin_event, components_do_not_accept_text_runs_by_default)
+{
+    auto rec = std::make_shared<recorder>();
+    ASSERT_FALSE(rec->accepts_text_runs());
+}
@@ -0,0 +1,187 @@
+#include "munin/list.hpp"
+#include "munin/list_model.hpp"
+#include <terminalpp/virtual_key.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct notification
+{
+    std::string kind;
+    odin::u32   index;
+    odin::u32   count;
+};
+
+void type(munin::list &lst, char ch)
+{
+    terminalpp::virtual_key vk;
+    vk.key = terminalpp::vk(ch);
+    vk.repeat_count = 1;
+    lst.event(vk);
+}
+
+void backspace(munin::list &lst)
+{
+    terminalpp::virtual_key vk;
+    vk.key = terminalpp::vk::bs;
+    vk.repeat_count = 1;
+    lst.event(vk);
+}
+
+}
+
+class string_list_model_fixture : public testing::Test
+{
+protected :
+    void SetUp() override
+    {
+        model_ = munin::make_string_list_model();
+
+        model_->on_items_inserted.connect(
+            [this](auto index, auto count)
+            {
+                notifications_.push_back({"insert", index, count});
+            });
+
+        model_->on_items_removed.connect(
+            [this](auto index, auto count)
+            {
+                notifications_.push_back({"remove", index, count});
+            });
+
+        model_->on_items_changed.connect(
+            [this](auto index, auto count)
+            {
+                notifications_.push_back({"change", index, count});
+            });
+    }
+
+    std::shared_ptr<munin::string_list_model> model_;
+    std::vector<notification>                 notifications_;
+};
+
+TEST_F(string_list_model_fixture, setting_items_on_empty_model_inserts_all)
+{
+    model_->set_items({"goblin", "orc", "troll"});
+    
+    ASSERT_EQ(3u, model_->get_number_of_items());
+    ASSERT_EQ(1u, notifications_.size());
+    ASSERT_EQ("insert", notifications_[0].kind);
+    ASSERT_EQ(0u, notifications_[0].index);
+    ASSERT_EQ(3u, notifications_[0].count);
+}
+
+TEST_F(string_list_model_fixture, setting_same_items_sends_nothing)
+{
+    model_->set_items({"goblin", "orc", "troll"});
+    notifications_.clear();
+    
+    model_->set_items({"goblin", "orc", "troll"});
+    
+    ASSERT_TRUE(notifications_.empty());
+}
+
+TEST_F(string_list_model_fixture, inserting_an_item_sends_only_an_insert)
+{
+    model_->set_items({"goblin", "orc", "troll"});
+    notifications_.clear();
+    
+    model_->set_items({"goblin", "ogre", "orc", "troll"});
+    
+    ASSERT_EQ(1u, notifications_.size());
+    ASSERT_EQ("insert", notifications_[0].kind);
+    ASSERT_EQ(1u, notifications_[0].index);
+    ASSERT_EQ(1u, notifications_[0].count);
+    ASSERT_EQ(4u, model_->get_item_width(1));
+}
+
+TEST_F(string_list_model_fixture, removing_an_item_sends_only_a_remove)
+{
+    model_->set_items({"goblin", "orc", "troll"});
+    notifications_.clear();
+    
+    model_->set_items({"goblin", "troll"});
+    
+    ASSERT_EQ(1u, notifications_.size());
+    ASSERT_EQ("remove", notifications_[0].kind);
+    ASSERT_EQ(1u, notifications_[0].index);
+    ASSERT_EQ(1u, notifications_[0].count);
+}
+
+TEST_F(string_list_model_fixture, renaming_an_item_sends_only_a_change)
+{
+    model_->set_items({"goblin", "orc", "troll"});
+    notifications_.clear();
+    
+    model_->set_items({"goblin", "orc chief", "troll"});
+    
+    ASSERT_EQ(1u, notifications_.size());
+    ASSERT_EQ("change", notifications_[0].kind);
+    ASSERT_EQ(1u, notifications_[0].index);
+    ASSERT_EQ(1u, notifications_[0].count);
+}
+
+TEST(munin_list, selection_follows_item_across_insertion)
+{
+    // Test that inserting items before the selected item does not change
+    // which item is selected.
+    auto model = munin::make_string_list_model();
+    auto lst = munin::make_list();
+    lst->set_model(model);
+    
+    model->set_items({"goblin", "orc", "troll"});
+    lst->set_item_index(1);
+    
+    model->set_items({"bugbear", "goblin", "orc", "troll"});
+    ASSERT_EQ(2, lst->get_item_index());
+    
+    model->set_items({"orc", "troll"});
+    ASSERT_EQ(0, lst->get_item_index());
+}
+
+TEST(munin_list, typing_filters_rows)
+{
+    // Test that typing narrows the rows to the items that contain the
+    // typed text, selecting the first match, and that backspace widens
+    // them again.
+    auto model = munin::make_string_list_model();
+    auto lst = munin::make_list();
+    lst->set_model(model);
+    
+    model->set_items({"goblin", "orc", "ogre", "troll"});
+    ASSERT_EQ(4, lst->get_preferred_size().height);
+    ASSERT_EQ(6, lst->get_preferred_size().width);
+    
+    type(*lst, 'O');
+    type(*lst, 'g');
+    ASSERT_EQ("og", lst->get_filter());
+    ASSERT_EQ(1, lst->get_preferred_size().height);
+    ASSERT_EQ(2, lst->get_item_index());
+    
+    backspace(*lst);
+    ASSERT_EQ(4, lst->get_preferred_size().height);
+    
+    backspace(*lst);
+    ASSERT_EQ("", lst->get_filter());
+    ASSERT_EQ(4, lst->get_preferred_size().height);
+    ASSERT_EQ(2, lst->get_item_index());
+}
+
+TEST(munin_list, selecting_a_filtered_out_item_clears_filter)
+{
+    // Test that selecting an item that is hidden by the filter removes
+    // the filter so that the selection can be seen.
+    auto model = munin::make_string_list_model();
+    auto lst = munin::make_list();
+    lst->set_model(model);
+    
+    model->set_items({"goblin", "orc", "ogre", "troll"});
+    lst->set_filter("gob");
+    ASSERT_EQ(1, lst->get_preferred_size().height);
+    
+    lst->set_item_index(3);
+    ASSERT_EQ("", lst->get_filter());
+    ASSERT_EQ(3, lst->get_item_index());
+}
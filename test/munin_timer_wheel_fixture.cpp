@@ -0,0 +1,241 @@
+#include "munin/timer_wheel.hpp"
+#include "run_for.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/strand.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+// The tests use a wheel with a short tick, so that they can cross the
+// levels of the wheel in a fraction of a second.  The first level spans
+// 64 ticks.
+auto const tick = 1ms;
+
+munin::timer_wheel &add_timer_wheel(
+    boost::asio::io_service   &io_service,
+    std::chrono::milliseconds  tick_interval = tick)
+{
+    auto *wheel = new munin::timer_wheel(io_service, tick_interval);
+    boost::asio::add_service(io_service, wheel);
+
+    return *wheel;
+}
+
+// Records the order in which timers fire, and whether any fired before
+// its delay had passed.
+class timer_log
+{
+public :
+    timer_log(munin::timer_wheel &wheel, boost::asio::strand &strand)
+      : wheel_(wheel),
+        strand_(strand),
+        start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    munin::timer_wheel::subscription at(
+        munin::timer_wheel::duration delay, std::string const &name)
+    {
+        return wheel_.schedule(
+            strand_,
+            delay,
+            [this, delay, name]
+            {
+                this->fire(delay, name);
+            });
+    }
+
+    void fire(munin::timer_wheel::duration delay, std::string const &name)
+    {
+        if (std::chrono::steady_clock::now() - start_ < delay)
+        {
+            early_ = true;
+        }
+
+        fired_.push_back(name);
+    }
+
+    std::vector<std::string> const &fired() const
+    {
+        return fired_;
+    }
+
+    bool early() const
+    {
+        return early_;
+    }
+
+private :
+    munin::timer_wheel                    &wheel_;
+    boost::asio::strand                   &strand_;
+    std::chrono::steady_clock::time_point  start_;
+    std::vector<std::string>               fired_;
+    bool                                   early_ = false;
+};
+
+}
+
+//* =========================================================================
+//  Timers expire in the order of their delays, including those that begin
+//  on the second level of the wheel and are spread across the first when
+//  it wraps around.
+//* =========================================================================
+TEST(timer_wheel, test_timers_expire_in_order_across_a_cascade)
+{
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    timer_log log(add_timer_wheel(io_service), strand);
+
+    auto const d = log.at(80 * tick, "d");
+    auto const c = log.at(66 * tick, "c");
+    auto const b = log.at(60 * tick, "b");
+    auto const a = log.at(2 * tick, "a");
+
+    run_for(io_service, 150 * tick);
+
+    ASSERT_EQ((std::vector<std::string>{"a", "b", "c", "d"}), log.fired());
+    ASSERT_FALSE(log.early());
+}
+
+//* =========================================================================
+//  A timer that is cancelled while it is still on the second level of the
+//  wheel does not fire, and does not affect its neighbours.
+//* =========================================================================
+TEST(timer_wheel, test_timer_cancelled_before_a_cascade_does_not_fire)
+{
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    timer_log log(add_timer_wheel(io_service), strand);
+
+    auto cancelled = log.at(73 * tick, "cancelled");
+    auto const kept = log.at(76 * tick, "kept");
+
+    cancelled.cancel();
+    ASSERT_FALSE(cancelled.active());
+    ASSERT_TRUE(kept.active());
+
+    run_for(io_service, 150 * tick);
+
+    ASSERT_EQ((std::vector<std::string>{"kept"}), log.fired());
+}
+
+//* =========================================================================
+//  A timer that is cancelled after it has been moved down to the first
+//  level of the wheel does not fire.
+//* =========================================================================
+TEST(timer_wheel, test_timer_cancelled_after_a_cascade_does_not_fire)
+{
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    auto &wheel = add_timer_wheel(io_service);
+    timer_log log(wheel, strand);
+
+    // The canceller falls due after the first level has wrapped around, by
+    // which time the cancelled timer has been moved down to it.
+    auto cancelled = log.at(73 * tick, "cancelled");
+    auto const canceller = wheel.schedule(
+        strand,
+        66 * tick,
+        [&]
+        {
+            log.fire(66 * tick, "canceller");
+            cancelled.cancel();
+        });
+
+    run_for(io_service, 150 * tick);
+
+    ASSERT_EQ((std::vector<std::string>{"canceller"}), log.fired());
+    ASSERT_FALSE(log.early());
+}
+
+//* =========================================================================
+//  A timer may be scheduled again from within its own callback, and each
+//  run waits for its full delay.
+//* =========================================================================
+TEST(timer_wheel, test_timer_may_be_rescheduled_from_its_own_callback)
+{
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    auto &wheel = add_timer_wheel(io_service);
+
+    std::vector<std::chrono::steady_clock::time_point> times;
+    munin::timer_wheel::subscription sub;
+    std::function<void ()> again;
+
+    // Three runs of 27 ticks each carry the timer past the point at which
+    // the first level wraps around.
+    again = [&]
+    {
+        times.push_back(std::chrono::steady_clock::now());
+
+        if (times.size() < 3)
+        {
+            sub = wheel.schedule(strand, 27 * tick, again);
+        }
+    };
+
+    auto const start = std::chrono::steady_clock::now();
+    sub = wheel.schedule(strand, 27 * tick, again);
+
+    run_for(io_service, 150 * tick);
+
+    ASSERT_EQ(3u, times.size());
+    ASSERT_GE(times[0] - start, 27 * tick);
+    ASSERT_GE(times[1] - times[0], 27 * tick);
+    ASSERT_GE(times[2] - times[1], 27 * tick);
+}
+
+//* =========================================================================
+//  Delays are rounded up to whole ticks.  Timers scheduled from a tick
+//  callback with delays shorter than a tick all run on the next tick, in
+//  the order in which they were scheduled rather than the order of their
+//  delays.  Even a timer with no delay waits for the next tick.
+//* =========================================================================
+TEST(timer_wheel, test_delays_are_rounded_up_to_whole_ticks)
+{
+    ASSERT_EQ(15ms, munin::timer_wheel::default_tick_interval);
+
+    // The tick is long enough that the callback below always runs well
+    // within the tick on which it was called.
+    auto const long_tick = 20ms;
+
+    boost::asio::io_service io_service;
+    boost::asio::strand strand(io_service);
+    auto &wheel = add_timer_wheel(io_service, long_tick);
+    timer_log log(wheel, strand);
+
+    ASSERT_EQ(long_tick, wheel.get_tick_interval());
+
+    std::vector<munin::timer_wheel::subscription> timers;
+    munin::timer_wheel::subscription ticks;
+
+    ticks = wheel.subscribe_to_ticks(
+        strand,
+        [&]
+        {
+            if (!timers.empty())
+            {
+                return;
+            }
+
+            ticks.cancel();
+            timers.push_back(log.at(0us, "immediate"));
+            timers.push_back(log.at(400us, "later"));
+            timers.push_back(log.at(200us, "sooner"));
+
+            ASSERT_TRUE(log.fired().empty());
+        });
+
+    run_for(io_service, 5 * long_tick);
+
+    ASSERT_EQ(
+        (std::vector<std::string>{"immediate", "later", "sooner"}),
+        log.fired());
+    ASSERT_FALSE(log.early());
+}
@@ -0,0 +1,101 @@
+#include "odin/net/admission_control.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+boost::asio::ip::address address(char const *text)
+{
+    return boost::asio::ip::address::from_string(text);
+}
+
+}
+
+TEST(admission_control, default_settings_admit_everything)
+{
+    odin::net::admission_control admission({});
+
+    for (int count = 0; count < 100; ++count)
+    {
+        ASSERT_TRUE(admission.admit(address("192.168.0.1")) != nullptr);
+    }
+
+    ASSERT_EQ(100u, admission.get_statistics().admitted);
+}
+
+TEST(admission_control, maximum_connections_is_released_with_tickets)
+{
+    odin::net::admission_control::settings config;
+    config.maximum_connections = 2;
+    odin::net::admission_control admission(config);
+
+    auto first  = admission.admit(address("10.0.0.1"));
+    auto second = admission.admit(address("10.0.0.2"));
+    ASSERT_TRUE(first != nullptr);
+    ASSERT_TRUE(second != nullptr);
+    ASSERT_TRUE(admission.admit(address("10.0.0.3")) == nullptr);
+    ASSERT_EQ(1u, admission.get_statistics().refused_capacity);
+
+    first.reset();
+    ASSERT_EQ(1u, admission.get_statistics().active);
+    ASSERT_TRUE(admission.admit(address("10.0.0.3")) != nullptr);
+}
+
+TEST(admission_control, rate_is_limited_per_address)
+{
+    odin::net::admission_control::settings config;
+    config.connections_per_second = 100;
+    config.connection_burst = 3;
+    odin::net::admission_control admission(config);
+
+    for (int count = 0; count < 3; ++count)
+    {
+        ASSERT_TRUE(admission.admit(address("10.0.0.1")) != nullptr);
+    }
+
+    ASSERT_TRUE(admission.admit(address("10.0.0.1")) == nullptr);
+    ASSERT_TRUE(admission.admit(address("10.0.0.2")) != nullptr);
+    ASSERT_EQ(1u, admission.get_statistics().refused_rate);
+
+    // At 100 per second, a token is returned every 10ms.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(admission.admit(address("10.0.0.1")) != nullptr);
+}
+
+TEST(admission_control, denied_networks_are_refused)
+{
+    odin::net::admission_control::settings config;
+    config.deny = { "10.1.0.0/16", "2001:db8::1" };
+    odin::net::admission_control admission(config);
+
+    ASSERT_TRUE(admission.admit(address("10.1.200.3")) == nullptr);
+    ASSERT_TRUE(admission.admit(address("2001:db8::1")) == nullptr);
+    ASSERT_TRUE(admission.admit(address("10.2.0.1")) != nullptr);
+    ASSERT_TRUE(admission.admit(address("2001:db8::2")) != nullptr);
+    ASSERT_EQ(2u, admission.get_statistics().refused_access);
+}
+
+TEST(admission_control, only_allowed_networks_are_admitted)
+{
+    odin::net::admission_control::settings config;
+    config.allow = { "192.168.0.0/20" };
+    config.deny  = { "192.168.1.1" };
+    odin::net::admission_control admission(config);
+
+    ASSERT_TRUE(admission.admit(address("192.168.15.255")) != nullptr);
+    ASSERT_TRUE(admission.admit(address("192.168.16.0")) == nullptr);
+    ASSERT_TRUE(admission.admit(address("192.168.1.1")) == nullptr);
+    ASSERT_TRUE(admission.admit(address("::ffff:192.168.2.1")) != nullptr);
+}
+
+TEST(admission_control, invalid_networks_are_rejected)
+{
+    odin::net::admission_control::settings config;
+    config.deny = { "10.0.0.0/33" };
+
+    ASSERT_THROW(
+        odin::net::admission_control admission(config),
+        std::invalid_argument);
+}
@@ -0,0 +1,112 @@
+#include "odin/flight_recorder.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::string get_trace()
+{
+    std::stringstream stream;
+    odin::flight_recorder::write_trace(stream);
+    return stream.str();
+}
+
+odin::flight_recorder::settings enabled_settings()
+{
+    odin::flight_recorder::settings config;
+    config.enabled = true;
+    return config;
+}
+
+}
+
+TEST(flight_recorder, disabled_recorder_runs_handlers_without_recording)
+{
+    odin::flight_recorder::configure({});
+
+    bool called = false;
+    auto handler = odin::flight_recorder::trace(
+        "test.disabled", [&called]{ called = true; });
+    handler();
+
+    ASSERT_TRUE(called);
+    ASSERT_EQ(std::string::npos, get_trace().find("test.disabled"));
+}
+
+TEST(flight_recorder, traced_handler_is_recorded_as_a_complete_event)
+{
+    odin::flight_recorder::configure(enabled_settings());
+
+    auto handler = odin::flight_recorder::trace("test.enabled", []{});
+    handler();
+
+    auto const trace = get_trace();
+    ASSERT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    ASSERT_NE(std::string::npos, trace.find(
+        "{\"name\":\"test.enabled\",\"cat\":\"handler\",\"ph\":\"X\""));
+    ASSERT_NE(std::string::npos, trace.find("\"queued_us\":"));
+
+    odin::flight_recorder::configure({});
+}
+
+TEST(flight_recorder, handler_traced_while_disabled_is_not_recorded)
+{
+    odin::flight_recorder::configure({});
+    auto handler = odin::flight_recorder::trace("test.late", []{});
+
+    odin::flight_recorder::configure(enabled_settings());
+    handler();
+
+    ASSERT_EQ(std::string::npos, get_trace().find("test.late"));
+
+    odin::flight_recorder::configure({});
+}
+
+TEST(flight_recorder, each_thread_records_into_its_own_ring)
+{
+    odin::flight_recorder::configure(enabled_settings());
+
+    std::thread thread([]
+    {
+        odin::flight_recorder::trace("test.other_thread", []{})();
+    });
+    thread.join();
+
+    odin::flight_recorder::trace("test.this_thread", []{})();
+
+    auto const trace = get_trace();
+    auto const other = trace.find("test.other_thread");
+    auto const mine  = trace.find("test.this_thread");
+    ASSERT_NE(std::string::npos, other);
+    ASSERT_NE(std::string::npos, mine);
+
+    auto const get_tid = [&trace](std::string::size_type position)
+    {
+        auto const tid = trace.find("\"tid\":", position);
+        return trace.substr(tid, trace.find(',', tid) - tid);
+    };
+
+    ASSERT_NE(get_tid(other), get_tid(mine));
+
+    odin::flight_recorder::configure({});
+}
+
+TEST(flight_recorder, ring_keeps_only_the_most_recent_handlers)
+{
+    odin::flight_recorder::configure(enabled_settings());
+
+    odin::flight_recorder::trace("test.oldest", []{})();
+
+    for (int index = 0; index < 5000; ++index)
+    {
+        odin::flight_recorder::trace("test.newer", []{})();
+    }
+
+    auto const trace = get_trace();
+    ASSERT_EQ(std::string::npos, trace.find("test.oldest"));
+    ASSERT_NE(std::string::npos, trace.find("test.newer"));
+
+    odin::flight_recorder::configure({});
+}
@@ -0,0 +1,107 @@
+#include "odin/net/handover_channel.hpp"
+#include <boost/asio/io_service.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+TEST(handover_channel, payload_without_handles_is_received)
+{
+    auto channels = odin::net::handover_channel::create_pair();
+
+    channels.first.send({ "hello", {} });
+
+    auto msg = channels.second.receive();
+    ASSERT_TRUE(msg.is_initialized());
+    ASSERT_EQ(std::string("hello"), msg->payload);
+    ASSERT_TRUE(msg->handles.empty());
+}
+
+TEST(handover_channel, handles_refer_to_the_same_open_file)
+{
+    auto channels = odin::net::handover_channel::create_pair();
+
+    int pipe_handles[2];
+    ASSERT_EQ(0, ::pipe(pipe_handles));
+
+    channels.first.send({ "pipe", { pipe_handles[1] } });
+    ::close(pipe_handles[1]);
+
+    auto msg = channels.second.receive();
+    ASSERT_TRUE(msg.is_initialized());
+    ASSERT_EQ(std::string("pipe"), msg->payload);
+    ASSERT_EQ(1u, msg->handles.size());
+
+    ASSERT_EQ(3, ::write(msg->handles[0], "abc", 3));
+    ::close(msg->handles[0]);
+
+    char buffer[4] = {};
+    ASSERT_EQ(3, ::read(pipe_handles[0], buffer, 3));
+    ASSERT_EQ(std::string("abc"), std::string(buffer));
+    ::close(pipe_handles[0]);
+}
+
+TEST(handover_channel, large_payloads_are_received_whole)
+{
+    auto channels = odin::net::handover_channel::create_pair();
+    std::string const payload(1 << 20, 'x');
+
+    std::thread sender([&]{ channels.first.send({ payload, {} }); });
+
+    auto msg = channels.second.receive();
+    sender.join();
+
+    ASSERT_TRUE(msg.is_initialized());
+    ASSERT_EQ(payload, msg->payload);
+}
+
+TEST(handover_channel, closed_channel_receives_nothing)
+{
+    auto channels = odin::net::handover_channel::create_pair();
+    channels.first.close();
+
+    ASSERT_FALSE(channels.second.receive().is_initialized());
+}
+
+TEST(handover_channel, async_receive_waits_within_the_io_service)
+{
+    boost::asio::io_service io_service;
+    auto channels = odin::net::handover_channel::create_pair();
+
+    std::string payload;
+    channels.second.async_receive(
+        io_service,
+        [&](auto const &error, auto const &msg)
+        {
+            ASSERT_FALSE(error);
+            ASSERT_TRUE(msg.is_initialized());
+            payload = msg->payload;
+        });
+
+    io_service.poll();
+    ASSERT_TRUE(payload.empty());
+
+    channels.first.send({ "ready", {} });
+    io_service.run();
+
+    ASSERT_EQ(std::string("ready"), payload);
+}
+
+TEST(handover_channel, async_receive_from_closed_channel_receives_nothing)
+{
+    boost::asio::io_service io_service;
+    auto channels = odin::net::handover_channel::create_pair();
+    channels.first.close();
+
+    bool called = false;
+    channels.second.async_receive(
+        io_service,
+        [&](auto const &, auto const &msg)
+        {
+            ASSERT_FALSE(msg.is_initialized());
+            called = true;
+        });
+
+    io_service.run();
+    ASSERT_TRUE(called);
+}
@@ -0,0 +1,75 @@
+#include "odin/net/io_service_pool.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using policy = odin::net::io_service_pool::assignment_policy;
+
+TEST(io_service_pool, round_robin_assigns_each_io_service_in_turn)
+{
+    odin::net::io_service_pool pool(3, 1, policy::round_robin);
+
+    ASSERT_EQ(0u, pool.assign());
+    ASSERT_EQ(1u, pool.assign());
+    ASSERT_EQ(2u, pool.assign());
+    ASSERT_EQ(0u, pool.assign());
+    ASSERT_EQ(2u, pool.get_load(0));
+}
+
+TEST(io_service_pool, least_loaded_assigns_to_the_least_loaded_io_service)
+{
+    odin::net::io_service_pool pool(3, 1, policy::least_loaded);
+
+    ASSERT_EQ(0u, pool.assign());
+    ASSERT_EQ(1u, pool.assign());
+    ASSERT_EQ(2u, pool.assign());
+
+    pool.release(1);
+    ASSERT_EQ(1u, pool.assign());
+
+    pool.release(2);
+    ASSERT_EQ(0u, pool.get_load(2));
+    ASSERT_EQ(2u, pool.assign());
+}
+
+TEST(io_service_pool, index_of_io_service_is_its_position)
+{
+    odin::net::io_service_pool pool(4, 1);
+
+    ASSERT_EQ(4u, pool.get_size());
+
+    for (odin::u32 index = 0; index < pool.get_size(); ++index)
+    {
+        ASSERT_EQ(index, pool.get_index(pool.get_io_service(index)));
+    }
+}
+
+TEST(io_service_pool, post_to_all_runs_once_on_each_io_service_thread)
+{
+    odin::net::io_service_pool pool(4, 1);
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> calls{0};
+
+    pool.post_to_all(
+        [&]
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            }
+
+            if (++calls == 4)
+            {
+                pool.release_work();
+            }
+        });
+
+    pool.run();
+
+    ASSERT_EQ(4, calls);
+    ASSERT_EQ(4u, threads.size());
+}
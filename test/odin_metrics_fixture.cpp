@@ -0,0 +1,141 @@
+#include "odin/metrics.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(metrics, counter_sums_additions_from_every_thread)
+{
+    odin::metrics::counter count;
+    std::vector<std::thread> threads;
+
+    for (int thread = 0; thread < 4; ++thread)
+    {
+        threads.emplace_back([&count]
+        {
+            for (int index = 0; index < 10000; ++index)
+            {
+                count.add();
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(40000u, count.get_value());
+}
+
+TEST(metrics, gauge_goes_up_and_down)
+{
+    odin::metrics::gauge depth;
+    depth.add(5);
+    depth.add(-3);
+
+    ASSERT_EQ(2, depth.get_value());
+}
+
+TEST(metrics, histogram_records_count_sum_and_max)
+{
+    odin::metrics::histogram hist;
+    hist.record(odin::u64(3));
+    hist.record(odin::u64(7));
+    hist.record(odin::u64(1000));
+
+    auto const snapshot = hist.get_snapshot();
+    ASSERT_EQ(3u, snapshot.count);
+    ASSERT_EQ(1010u, snapshot.sum);
+    ASSERT_EQ(1000u, snapshot.max);
+}
+
+TEST(metrics, histogram_quantiles_are_within_bucket_precision)
+{
+    odin::metrics::histogram hist;
+
+    for (odin::u64 value = 1; value <= 100000; ++value)
+    {
+        hist.record(value);
+    }
+
+    auto const snapshot = hist.get_snapshot();
+
+    // Buckets are an eighth of a power of two wide, so any quantile should
+    // be within an eighth of its true value.
+    auto const near = [](odin::u64 actual, double expected)
+    {
+        return actual >= expected * 0.875 && actual <= expected * 1.125;
+    };
+
+    ASSERT_TRUE(near(snapshot.get_quantile(0.5),  50000));
+    ASSERT_TRUE(near(snapshot.get_quantile(0.9),  90000));
+    ASSERT_TRUE(near(snapshot.get_quantile(0.99), 99000));
+    ASSERT_EQ(100000u, snapshot.get_quantile(1.0));
+}
+
+TEST(metrics, empty_histogram_has_zero_quantiles)
+{
+    odin::metrics::histogram hist;
+
+    ASSERT_EQ(0u, hist.get_snapshot().get_quantile(0.99));
+}
+
+TEST(metrics, registry_returns_the_same_metric_for_the_same_name)
+{
+    odin::metrics::registry registry;
+    auto &first  = registry.get_counter("requests_total", "Requests");
+    auto &second = registry.get_counter("requests_total", "Requests");
+
+    ASSERT_EQ(&first, &second);
+}
+
+TEST(metrics, registry_refuses_a_name_of_a_different_type)
+{
+    odin::metrics::registry registry;
+    registry.get_counter("requests_total", "Requests");
+
+    ASSERT_THROW(
+        registry.get_gauge("requests_total", "Requests"),
+        std::invalid_argument);
+}
+
+TEST(metrics, function_is_removed_with_its_handle)
+{
+    odin::metrics::registry registry;
+    auto handle = registry.add_function(
+        "pending", "Pending things", []{ return 42.0; });
+
+    std::stringstream with_function;
+    registry.write_exposition(with_function);
+    ASSERT_NE(std::string::npos, with_function.str().find("pending 42"));
+
+    handle.reset();
+
+    std::stringstream without_function;
+    registry.write_exposition(without_function);
+    ASSERT_EQ(std::string::npos, without_function.str().find("pending"));
+}
+
+TEST(metrics, exposition_is_in_the_prometheus_text_format)
+{
+    odin::metrics::registry registry;
+    registry.get_counter("requests_total", "Requests served").add(3);
+    registry.get_histogram("latency_seconds", "Latency", 1e-3)
+        .record(odin::u64(2));
+
+    std::stringstream stream;
+    registry.write_exposition(stream);
+    auto const text = stream.str();
+
+    ASSERT_NE(std::string::npos, text.find(
+        "# HELP requests_total Requests served\n"
+        "# TYPE requests_total counter\n"
+        "requests_total 3\n"));
+    ASSERT_NE(std::string::npos, text.find(
+        "# TYPE latency_seconds summary\n"));
+    ASSERT_NE(std::string::npos, text.find(
+        "latency_seconds{quantile=\"0.5\"} 0.002\n"));
+    ASSERT_NE(std::string::npos, text.find("latency_seconds_count 1\n"));
+}
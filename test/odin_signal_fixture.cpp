@@ -0,0 +1,150 @@
+#include "odin/signal.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(odin_signal, test_emit_with_no_slots)
+{
+    // Test that emitting a signal with no slots connected does nothing.
+    odin::signal<void (int)> sig;
+    ASSERT_TRUE(sig.empty());
+    
+    sig(42);
+}
+
+TEST(odin_signal, test_slots_called_in_order)
+{
+    // Test that slots are called with the emitted arguments in the order
+    // in which they were connected.
+    odin::signal<void (int)> sig;
+    std::vector<int> calls;
+    
+    sig.connect([&](int value){calls.push_back(value);});
+    sig.connect([&](int value){calls.push_back(value * 10);});
+    
+    sig(4);
+    
+    ASSERT_EQ(2u, calls.size());
+    ASSERT_EQ(4,  calls[0]);
+    ASSERT_EQ(40, calls[1]);
+}
+
+TEST(odin_signal, test_disconnect)
+{
+    // Test that a disconnected slot is no longer called, and that
+    // disconnecting twice is harmless.
+    odin::signal<void ()> sig;
+    int calls = 0;
+    
+    auto cnx = sig.connect([&]{++calls;});
+    ASSERT_TRUE(cnx.connected());
+    
+    sig();
+    cnx.disconnect();
+    cnx.disconnect();
+    sig();
+    
+    ASSERT_FALSE(cnx.connected());
+    ASSERT_TRUE(sig.empty());
+    ASSERT_EQ(1, calls);
+}
+
+TEST(odin_signal, test_scoped_connection)
+{
+    // Test that a scoped connection disconnects its slot when it is
+    // destroyed, but not when it is released.
+    odin::signal<void ()> sig;
+    int calls = 0;
+    
+    {
+        odin::scoped_connection cnx(sig.connect([&]{++calls;}));
+        sig();
+    }
+    
+    sig();
+    ASSERT_EQ(1, calls);
+    
+    odin::connection released;
+    
+    {
+        odin::scoped_connection cnx(sig.connect([&]{++calls;}));
+        released = cnx.release();
+    }
+    
+    sig();
+    ASSERT_EQ(2, calls);
+    ASSERT_TRUE(released.connected());
+}
+
+TEST(odin_signal, test_disconnect_during_emission)
+{
+    // Test that a slot may disconnect itself and a later slot during an
+    // emission.  The later slot must not then be called.
+    odin::signal<void ()> sig;
+    odin::connection first;
+    odin::connection second;
+    int calls = 0;
+    
+    first = sig.connect([&]
+    {
+        ++calls;
+        first.disconnect();
+        second.disconnect();
+    });
+    
+    second = sig.connect([&]{++calls;});
+    
+    sig();
+    sig();
+    
+    ASSERT_EQ(1, calls);
+    ASSERT_EQ(0u, sig.num_slots());
+}
+
+TEST(odin_signal, test_connect_during_emission)
+{
+    // Test that a slot connected during an emission is not called until
+    // the next emission.
+    odin::signal<void ()> sig;
+    odin::connection cnx;
+    int calls = 0;
+    
+    cnx = sig.connect([&]
+    {
+        cnx.disconnect();
+        sig.connect([&]{++calls;});
+    });
+    
+    sig();
+    ASSERT_EQ(0, calls);
+    
+    sig();
+    ASSERT_EQ(1, calls);
+}
+
+TEST(odin_signal, test_signal_destroyed_during_emission)
+{
+    // Test that a slot may destroy the signal that is calling it, and
+    // that its connection then reports that it is disconnected.
+    auto sig = new odin::signal<void ()>;
+    
+    auto cnx = sig->connect([&]{delete sig;});
+    (*sig)();
+    
+    ASSERT_FALSE(cnx.connected());
+    cnx.disconnect();
+}
+
+TEST(odin_signal, test_connect_signal_to_signal)
+{
+    // Test that a signal may be connected to another, and that emitting
+    // the first forwards its arguments to the second.
+    odin::signal<void (int)> first;
+    odin::signal<void (int)> second;
+    int total = 0;
+    
+    second.connect([&](int value){total += value;});
+    first.connect(second);
+    
+    first(5);
+    ASSERT_EQ(5, total);
+}
@@ -0,0 +1,116 @@
+#include "odin/net/socket.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace {
+
+// A connected pair of sockets on the loopback interface.  The server end
+// is the one wrapped by odin::net::socket.
+struct loopback_pair
+{
+    loopback_pair()
+      : server(std::make_shared<boost::asio::ip::tcp::socket>(io_service)),
+        client(io_service)
+    {
+        boost::asio::ip::tcp::acceptor acceptor(
+            io_service,
+            boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), 0));
+
+        client.connect(acceptor.local_endpoint());
+        acceptor.accept(*server);
+    }
+
+    boost::asio::io_service                       io_service;
+    std::shared_ptr<boost::asio::ip::tcp::socket> server;
+    boost::asio::ip::tcp::socket                  client;
+};
+
+}
+
+TEST(socket, cancelled_reads_leave_later_input_unread)
+{
+    loopback_pair sockets;
+    odin::net::socket sock(sockets.server);
+
+    std::string read;
+    bool cancelled = false;
+
+    sock.async_read(
+        1, [&](auto const &data){ read.append(data.begin(), data.end()); });
+    sock.get_strand().post(
+        [&]
+        {
+            sock.async_cancel_reads([&]{ cancelled = true; });
+        });
+
+    sockets.io_service.run();
+
+    ASSERT_TRUE(cancelled);
+    ASSERT_TRUE(read.empty());
+    ASSERT_TRUE(sock.is_alive());
+
+    // Whatever is sent now is left for whoever holds the socket next.
+    boost::asio::write(sockets.client, boost::asio::buffer("abc", 3));
+
+    char buffer[3];
+    boost::asio::read(*sockets.server, boost::asio::buffer(buffer));
+    ASSERT_EQ(std::string("abc"), std::string(buffer, 3));
+}
+
+TEST(socket, read_completed_before_cancellation_is_reported)
+{
+    loopback_pair sockets;
+    odin::net::socket sock(sockets.server);
+
+    std::string read;
+    bool cancelled = false;
+
+    sock.async_read(
+        1, [&](auto const &data){ read.append(data.begin(), data.end()); });
+    boost::asio::write(sockets.client, boost::asio::buffer("a", 1));
+
+    // The read completes, which leaves nothing for the cancellation to
+    // cancel.
+    while (read.empty())
+    {
+        sockets.io_service.run_one();
+    }
+
+    sockets.io_service.reset();
+    sock.get_strand().post(
+        [&]
+        {
+            sock.async_cancel_reads([&]{ cancelled = true; });
+        });
+
+    sockets.io_service.run();
+
+    ASSERT_TRUE(cancelled);
+    ASSERT_EQ(std::string("a"), read);
+    ASSERT_TRUE(sock.is_alive());
+}
+
+TEST(socket, death_callback_is_called_once_and_released)
+{
+    loopback_pair sockets;
+    odin::net::socket sock(sockets.server);
+
+    auto owner = std::make_shared<int>(0);
+    std::weak_ptr<int> weak_owner = owner;
+    int deaths = 0;
+
+    sock.on_death([owner, &deaths]{ ++deaths; });
+    owner.reset();
+
+    sock.close();
+    sock.close();
+
+    ASSERT_EQ(1, deaths);
+    ASSERT_TRUE(weak_owner.expired());
+}
@@ -0,0 +1,85 @@
+#include "odin/tokenise.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(odin_tokenise, splits_the_first_word_from_the_rest)
+{
+    auto const token = odin::tokenise("  roll   2d6+3  initiative ");
+
+    ASSERT_EQ("roll", token.first);
+    ASSERT_EQ("2d6+3  initiative", token.second);
+}
+
+TEST(odin_tokenise, words_are_separated_by_tabs)
+{
+    auto const token = odin::tokenise("\tsay\thello");
+
+    ASSERT_EQ("say", token.first);
+    ASSERT_EQ("hello", token.second);
+}
+
+TEST(odin_tokenise, text_without_words_gives_empty_views)
+{
+    auto const empty = odin::tokenise("");
+    ASSERT_TRUE(empty.first.empty());
+    ASSERT_TRUE(empty.second.empty());
+
+    auto const blank = odin::tokenise(" \t ");
+    ASSERT_TRUE(blank.first.empty());
+    ASSERT_TRUE(blank.second.empty());
+}
+
+TEST(odin_tokenise, quoted_word_may_contain_spaces)
+{
+    auto const token = odin::tokenise("\"the red dragon\" 3d6");
+    ASSERT_EQ("the red dragon", token.first);
+    ASSERT_EQ("3d6", token.second);
+
+    auto const unterminated = odin::tokenise("\"the red dragon");
+    ASSERT_EQ("the red dragon", unterminated.first);
+    ASSERT_TRUE(unterminated.second.empty());
+}
+
+TEST(odin_tokenise, views_refer_to_the_original_text)
+{
+    std::string const text = "whisper bob hello there";
+    auto const token = odin::tokenise(text);
+
+    ASSERT_EQ(text.data(), token.first.data());
+    ASSERT_EQ(text.data() + 8, token.second.data());
+}
+
+TEST(odin_tokenise, tokeniser_reads_words_in_turn)
+{
+    odin::tokeniser tokens("gm encounter  move 3 up");
+
+    ASSERT_EQ("gm", tokens.next());
+    ASSERT_EQ("encounter", tokens.next());
+    ASSERT_EQ("move 3 up", tokens.rest());
+    ASSERT_EQ("move", tokens.next());
+    ASSERT_EQ("3", tokens.next());
+    ASSERT_EQ("up", tokens.next());
+    ASSERT_TRUE(tokens.next().empty());
+    ASSERT_TRUE(tokens.rest().empty());
+}
+
+TEST(odin_tokenise, trim_removes_surrounding_spaces_and_tabs)
+{
+    ASSERT_EQ("the Great", odin::trim(" \tthe Great\t "));
+    ASSERT_TRUE(odin::trim("   ").empty());
+}
+
+TEST(odin_tokenise, line_endings_are_not_part_of_the_last_argument)
+{
+    ASSERT_EQ("the Great", odin::trim("the Great\r\n"));
+
+    auto const token = odin::tokenise("roll 2d6\r\n");
+    ASSERT_EQ("roll", token.first);
+    ASSERT_EQ("2d6", token.second);
+
+    odin::tokeniser tokens("say\vhello\fthere\r\n");
+    ASSERT_EQ("say", tokens.next());
+    ASSERT_EQ("hello", tokens.next());
+    ASSERT_EQ("there", tokens.next());
+    ASSERT_TRUE(tokens.next().empty());
+}
@@ -0,0 +1,161 @@
+#include "paradice/active_encounter.hpp"
+#include "paradice/beast.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace {
+
+std::shared_ptr<paradice::active_encounter> make_encounter(
+    std::initializer_list<char const *> names)
+{
+    auto enc = std::make_shared<paradice::active_encounter>();
+
+    for (auto const *name : names)
+    {
+        auto bst = std::make_shared<paradice::beast>();
+        bst->set_name(name);
+        paradice::add_beast(enc, bst);
+    }
+
+    return enc;
+}
+
+std::string characters_of(terminalpp::string const &text)
+{
+    std::string result;
+
+    for (auto const &elem : text)
+    {
+        result += elem.glyph_.character_;
+    }
+
+    return result;
+}
+
+paradice::dice_result make_result(odin::s32 score)
+{
+    paradice::dice_result result;
+    result.roll_ = {1, 1, 20, 0};
+    result.results_ = {{score}};
+    return result;
+}
+
+}
+
+TEST(active_encounter, every_change_increments_the_version)
+{
+    auto enc = make_encounter({"orc", "goblin"});
+    ASSERT_EQ(2u, enc->version_);
+
+    paradice::annotate_participant(enc, 1, "bloodied");
+    paradice::move_participant(enc, 1, 1);
+    paradice::remove_participant(enc, 2);
+    ASSERT_EQ(5u, enc->version_);
+
+    ASSERT_EQ(5u, enc->changes_.size());
+    ASSERT_EQ(5u, enc->changes_.back().version_);
+}
+
+TEST(active_encounter, change_to_an_unknown_participant_is_not_recorded)
+{
+    auto enc = make_encounter({"orc"});
+
+    ASSERT_FALSE(paradice::remove_participant(enc, 7));
+    ASSERT_FALSE(paradice::annotate_participant(enc, 7, "bloodied"));
+    ASSERT_EQ(1u, enc->version_);
+}
+
+TEST(active_encounter, move_records_both_indices)
+{
+    auto enc = make_encounter({"orc", "goblin", "troll"});
+
+    ASSERT_TRUE(paradice::move_participant(enc, 3, 0));
+    ASSERT_EQ(3u, enc->entries_[0].id_);
+    ASSERT_EQ(1u, enc->entries_[1].id_);
+    ASSERT_EQ(2u, enc->entries_[2].id_);
+
+    auto const &chg = enc->changes_.back();
+    ASSERT_TRUE(chg.kind_ == paradice::active_encounter::change_kind::moved);
+    ASSERT_EQ(0u, chg.index_);
+    ASSERT_EQ(2u, chg.from_index_);
+}
+
+TEST(active_encounter, move_towards_the_end_lands_on_the_index)
+{
+    auto enc = make_encounter({"orc", "goblin", "troll", "ogre"});
+
+    ASSERT_TRUE(paradice::move_participant(enc, 1, 2));
+    ASSERT_EQ(2u, enc->entries_[0].id_);
+    ASSERT_EQ(3u, enc->entries_[1].id_);
+    ASSERT_EQ(1u, enc->entries_[2].id_);
+    ASSERT_EQ(4u, enc->entries_[3].id_);
+
+    ASSERT_TRUE(paradice::move_participant(enc, 2, 99));
+    ASSERT_EQ(2u, enc->entries_[3].id_);
+    ASSERT_EQ(3u, *paradice::find_participant(enc, 2));
+    ASSERT_EQ(0u, *paradice::find_participant(enc, 3));
+}
+
+TEST(active_encounter, ids_are_not_reused)
+{
+    auto enc = make_encounter({"orc", "goblin"});
+
+    ASSERT_TRUE(paradice::remove_participant(enc, 2));
+    paradice::clear_participants(enc);
+
+    auto bst = std::make_shared<paradice::beast>();
+    bst->set_name("troll");
+    paradice::add_beast(enc, bst);
+
+    ASSERT_EQ(3u, enc->entries_[0].id_);
+    ASSERT_EQ(0u, *paradice::find_participant(enc, 3));
+    ASSERT_FALSE(paradice::find_participant(enc, 1));
+}
+
+TEST(active_encounter, entry_text_is_shared_with_its_change)
+{
+    auto enc = make_encounter({"orc"});
+
+    paradice::annotate_participant(enc, 1, "bloodied");
+    ASSERT_EQ("(1) orc [bloodied]", characters_of(*enc->entries_[0].text_));
+    ASSERT_EQ(enc->entries_[0].text_, enc->changes_.back().text_);
+
+    paradice::add_roll(enc, 1, make_result(12));
+    ASSERT_EQ(
+        "(1) orc [bloodied] | 1d20 -> 12",
+        characters_of(*enc->entries_[0].text_));
+}
+
+TEST(active_encounter, rolls_are_bounded)
+{
+    auto enc = make_encounter({"orc"});
+    enc->max_rolls_ = 3;
+
+    for (odin::s32 score = 1; score <= 5; ++score)
+    {
+        paradice::add_roll(enc, 1, make_result(score));
+    }
+
+    auto const &rolls = enc->entries_[0].roll_data_;
+    ASSERT_EQ(3u, rolls.size());
+    ASSERT_EQ(3, rolls.front().results_[0][0]);
+    ASSERT_EQ(5, rolls.back().results_[0][0]);
+}
+
+TEST(active_encounter, change_log_is_bounded)
+{
+    auto enc = make_encounter({"orc"});
+
+    for (odin::u32 index = 0;
+         index < paradice::active_encounter::max_changes * 2;
+         ++index)
+    {
+        paradice::annotate_participant(enc, 1, std::to_string(index));
+    }
+
+    ASSERT_EQ(
+        odin::u32(paradice::active_encounter::max_changes),
+        enc->changes_.size());
+    ASSERT_EQ(enc->version_, enc->changes_.back().version_);
+}
@@ -0,0 +1,93 @@
+#include "paradice/command_table.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+void do_nothing(
+    std::shared_ptr<paradice::context> &
+  , boost::string_view
+  , std::shared_ptr<paradice::client>  &)
+{
+}
+
+paradice::command_table const commands =
+{
+    { "say",         do_nothing, 0,   0,   false }
+  , { "set",         do_nothing, 0,   0,   false }
+  , { "showrolls",   do_nothing, 0,   0,   false }
+  , { "roll",        do_nothing, 0,   0,   false }
+  , { "rollprivate", do_nothing, 0,   0,   false }
+  , { "quit",        do_nothing, 0,   0,   true  }
+  , { "gm",          do_nothing, 0,   100, false }
+  , { "admin_stats", do_nothing, 100, 0,   true  }
+};
+
+std::string name_of(paradice::command_table::match const &found)
+{
+    return found.command_ == nullptr ? "" : found.command_->name_;
+}
+
+}
+
+TEST(command_table, finds_commands_by_name_regardless_of_case)
+{
+    ASSERT_EQ("say", name_of(commands.find("say")));
+    ASSERT_EQ("showrolls", name_of(commands.find("ShowRolls")));
+    ASSERT_EQ("", name_of(commands.find("shout")));
+    ASSERT_EQ("", name_of(commands.find("")));
+}
+
+TEST(command_table, finds_commands_by_unambiguous_abbreviation)
+{
+    ASSERT_EQ("showrolls", name_of(commands.find("sh")));
+    ASSERT_EQ("say", name_of(commands.find("SA")));
+    ASSERT_FALSE(commands.find("sa").ambiguous_);
+}
+
+TEST(command_table, ambiguous_abbreviation_finds_nothing)
+{
+    auto const found = commands.find("s");
+    ASSERT_EQ(nullptr, found.command_);
+    ASSERT_TRUE(found.ambiguous_);
+
+    ASSERT_EQ(
+        (std::vector<std::string>{"say", "set", "showrolls"}),
+        commands.find_abbreviated("s"));
+}
+
+TEST(command_table, exact_name_is_preferred_to_an_abbreviation)
+{
+    ASSERT_EQ("roll", name_of(commands.find("roll")));
+    ASSERT_EQ("rollprivate", name_of(commands.find("rollp")));
+}
+
+TEST(command_table, some_commands_must_be_given_in_full)
+{
+    ASSERT_EQ("", name_of(commands.find("qui")));
+    ASSERT_EQ("quit", name_of(commands.find("quit")));
+    ASSERT_EQ("", name_of(commands.find("admin", 100, 0)));
+}
+
+TEST(command_table, unprivileged_commands_are_not_found)
+{
+    ASSERT_EQ("", name_of(commands.find("gm")));
+    ASSERT_EQ("gm", name_of(commands.find("gm", 0, 100)));
+    ASSERT_EQ("gm", name_of(commands.find("g", 0, 200)));
+    ASSERT_EQ("", name_of(commands.find("admin_stats", 0, 100)));
+    ASSERT_EQ("admin_stats", name_of(commands.find("admin_stats", 100, 0)));
+}
+
+TEST(command_table, listing_depends_on_privilege)
+{
+    ASSERT_EQ(
+        "say set showrolls roll rollprivate quit ",
+        commands.get_listing());
+    ASSERT_EQ(
+        "say set showrolls roll rollprivate quit gm ",
+        commands.get_listing(0, 150));
+    ASSERT_EQ(
+        "say set showrolls roll rollprivate quit gm admin_stats ",
+        commands.get_listing(100, 100));
+}
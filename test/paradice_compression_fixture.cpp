@@ -0,0 +1,117 @@
+#include "paradice/compression.hpp"
+#include <telnetpp/options/mccp/compressor.hpp>
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <string>
+
+namespace {
+
+telnetpp::u8stream make_text()
+{
+    std::string text;
+
+    for (int index = 0; index < 1000; ++index)
+    {
+        text += "The goblin attacks! ";
+    }
+
+    return telnetpp::u8stream(text.begin(), text.end());
+}
+
+telnetpp::u8stream inflate_stream(telnetpp::u8stream &compressed)
+{
+    z_stream stream = {};
+    inflateInit(&stream);
+
+    telnetpp::u8stream output(1024 * 1024);
+    stream.next_in   = compressed.data();
+    stream.avail_in  = uInt(compressed.size());
+    stream.next_out  = output.data();
+    stream.avail_out = uInt(output.size());
+
+    inflate(&stream, Z_SYNC_FLUSH);
+    output.resize(output.size() - stream.avail_out);
+    inflateEnd(&stream);
+
+    return output;
+}
+
+}
+
+TEST(compression_pool, compressed_output_decompresses_to_input)
+{
+    auto pool = std::make_shared<paradice::compression_pool>();
+    auto compressor = pool->make_compressor();
+    auto const text = make_text();
+
+    auto compressed = compressor->transform_chunk(text);
+
+    ASSERT_LT(compressed.size(), text.size());
+    ASSERT_EQ(text, inflate_stream(compressed));
+}
+
+TEST(compression_pool, small_window_decompresses_to_input)
+{
+    paradice::compression_settings settings;
+    settings.memory_level = 1;
+    settings.window_bits  = 9;
+
+    auto pool = std::make_shared<paradice::compression_pool>(settings);
+    auto compressor = pool->make_compressor();
+    auto const text = make_text();
+
+    auto compressed = compressor->transform_chunk(text);
+
+    ASSERT_EQ(text, inflate_stream(compressed));
+}
+
+TEST(compression_pool, state_is_only_held_while_compressing)
+{
+    auto pool = std::make_shared<paradice::compression_pool>();
+    auto compressor = pool->make_compressor();
+
+    ASSERT_EQ(0u, pool->get_number_of_active_states());
+
+    compressor->transform_chunk(make_text());
+    ASSERT_EQ(1u, pool->get_number_of_active_states());
+    ASSERT_EQ(0u, pool->get_number_of_pooled_states());
+
+    compressor->end_compression();
+    ASSERT_EQ(0u, pool->get_number_of_active_states());
+    ASSERT_EQ(1u, pool->get_number_of_pooled_states());
+}
+
+TEST(compression_pool, pooled_state_is_reused_as_a_fresh_stream)
+{
+    auto pool = std::make_shared<paradice::compression_pool>();
+    auto first = pool->make_compressor();
+    auto second = pool->make_compressor();
+    auto const text = make_text();
+
+    first->transform_chunk(text);
+    first->end_compression();
+
+    auto compressed = second->transform_chunk(text);
+
+    ASSERT_EQ(0u, pool->get_number_of_pooled_states());
+    ASSERT_EQ(text, inflate_stream(compressed));
+}
+
+TEST(compression_pool, states_beyond_the_pool_size_are_freed)
+{
+    paradice::compression_settings settings;
+    settings.maximum_pooled_states = 1;
+
+    auto pool = std::make_shared<paradice::compression_pool>(settings);
+    auto first = pool->make_compressor();
+    auto second = pool->make_compressor();
+
+    first->transform_chunk(make_text());
+    second->transform_chunk(make_text());
+    ASSERT_EQ(2u, pool->get_number_of_active_states());
+
+    first.reset();
+    second.reset();
+    ASSERT_EQ(0u, pool->get_number_of_active_states());
+    ASSERT_EQ(1u, pool->get_number_of_pooled_states());
+}
@@ -0,0 +1,103 @@
+#include "paradice/help_corpus.hpp"
+#include "paradice/help.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+paradice::help_corpus const corpus(
+    {
+        { { "roll" },        "Rolls dice and shows the total to everyone." }
+      , { { "rollprivate" }, "Rolls dice and shows the total to you." }
+      , { { "say", "." },    "Sends a message to everyone." }
+      , { { "gm" },          "Manipulates the encounter at your table." }
+    }
+  , "HEADER ");
+
+std::string characters_of(terminalpp::string const &text)
+{
+    std::string result;
+
+    for (auto const &elem : text)
+    {
+        result += elem.glyph_.character_;
+    }
+
+    return result;
+}
+
+}
+
+TEST(help_corpus, topics_are_found_by_name_regardless_of_case)
+{
+    auto const page = corpus.find("ROLL");
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(
+        "HEADER Rolls dice and shows the total to everyone.",
+        characters_of(*page));
+
+    ASSERT_EQ(nullptr, corpus.find("rol"));
+    ASSERT_EQ(nullptr, corpus.find("shout"));
+    ASSERT_EQ(nullptr, corpus.find(""));
+}
+
+TEST(help_corpus, aliases_share_a_page)
+{
+    auto const page = corpus.find("say");
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(page, corpus.find("."));
+    ASSERT_EQ(page, corpus.find("say"));
+}
+
+TEST(help_corpus, index_lists_every_name)
+{
+    ASSERT_EQ(
+        "HEADER No help on that subject was found.  Available subjects are:\n"
+        "roll rollprivate say . gm ",
+        characters_of(*corpus.get_index()));
+}
+
+TEST(help_corpus, search_finds_topics_containing_every_word)
+{
+    ASSERT_EQ(
+        (std::vector<std::string>{"roll"}),
+        corpus.search("everyone dice"));
+    ASSERT_EQ(
+        (std::vector<std::string>{"roll", "say"}),
+        corpus.search("EVERYONE"));
+    ASSERT_EQ(
+        (std::vector<std::string>{"roll", "rollprivate"}),
+        corpus.search("dice total"));
+    ASSERT_TRUE(corpus.search("dice message").empty());
+    ASSERT_TRUE(corpus.search("").empty());
+}
+
+TEST(help_corpus, search_words_match_the_words_they_begin)
+{
+    ASSERT_EQ(
+        (std::vector<std::string>{"gm"}),
+        corpus.search("enc"));
+    ASSERT_EQ(
+        (std::vector<std::string>{"rollprivate"}),
+        corpus.search("rollp"));
+}
+
+TEST(help_corpus, commands_have_help)
+{
+    auto const help = paradice::make_help_corpus();
+
+    ASSERT_NE(nullptr, help->find("roll"));
+    ASSERT_EQ(help->find("whisper"), help->find(">"));
+    ASSERT_EQ(
+        (std::vector<std::string>{"roll", "rollprivate"}),
+        help->search("ten-sided"));
+}
+
+TEST(help_corpus, missing_directory_is_an_error)
+{
+    ASSERT_THROW(
+        paradice::make_help_corpus("no/such/help/directory"),
+        std::runtime_error);
+}
@@ -0,0 +1,156 @@
+#include "paradice/idle_sweeper.hpp"
+#include "run_for.hpp"
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <gtest/gtest.h>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::literals;
+
+namespace {
+
+// Settings scaled down from seconds to milliseconds, so that a session
+// passes through all of its stages in a fraction of a second.
+paradice::idle_settings short_settings()
+{
+    paradice::idle_settings settings;
+    settings.sweep_interval     = 5ms;
+    settings.keepalive_interval = 50ms;
+    settings.idle_timeout       = 150ms;
+    settings.idle_warning       = 50ms;
+
+    return settings;
+}
+
+}
+
+//* =========================================================================
+//  A warning that is not shorter than the idle timeout is rejected.
+//* =========================================================================
+TEST(idle_sweeper, test_rejects_a_warning_longer_than_the_timeout)
+{
+    boost::asio::io_service io_service;
+
+    auto settings = short_settings();
+    settings.idle_warning = settings.idle_timeout;
+
+    ASSERT_THROW(
+        paradice::idle_sweeper(io_service, settings), std::invalid_argument);
+}
+
+//* =========================================================================
+//  A sweep interval that is not positive is rejected.
+//* =========================================================================
+TEST(idle_sweeper, test_rejects_a_sweep_interval_that_is_not_positive)
+{
+    boost::asio::io_service io_service;
+
+    auto settings = short_settings();
+    settings.sweep_interval = 0ms;
+
+    ASSERT_THROW(
+        paradice::idle_sweeper(io_service, settings), std::invalid_argument);
+}
+
+//* =========================================================================
+//  A session to which nothing is sent is sent keepalives.
+//* =========================================================================
+TEST(idle_sweeper, test_sends_keepalives_to_a_session_without_output)
+{
+    boost::asio::io_service io_service;
+    paradice::idle_sweeper sweeper(io_service, short_settings());
+
+    int keepalives = 0;
+    auto session = sweeper.add_session(
+        [&keepalives]{ ++keepalives; }, [](auto){}, []{});
+
+    run_for(io_service, 125ms);
+
+    ASSERT_GE(keepalives, 1);
+    ASSERT_EQ(odin::u64(keepalives), sweeper.get_statistics().keepalives);
+}
+
+//* =========================================================================
+//  A session to which output is sent regularly is sent no keepalives.
+//* =========================================================================
+TEST(idle_sweeper, test_sends_no_keepalives_to_a_session_with_output)
+{
+    boost::asio::io_service io_service;
+    paradice::idle_sweeper sweeper(io_service, short_settings());
+
+    int keepalives = 0;
+    auto session = sweeper.add_session(
+        [&keepalives]{ ++keepalives; }, [](auto){}, []{});
+
+    boost::asio::steady_timer output_timer(io_service);
+    std::function<void ()> write_output = [&]
+    {
+        session->note_input();
+        session->note_output();
+        output_timer.expires_from_now(10ms);
+        output_timer.async_wait(
+            [&](auto const &ec){ if (!ec) write_output(); });
+    };
+    write_output();
+
+    run_for(io_service, 125ms);
+
+    ASSERT_EQ(0, keepalives);
+}
+
+//* =========================================================================
+//  A session from which nothing is received is warned once, and then
+//  evicted.
+//* =========================================================================
+TEST(idle_sweeper, test_warns_and_then_evicts_a_session_without_input)
+{
+    boost::asio::io_service io_service;
+    paradice::idle_sweeper sweeper(io_service, short_settings());
+
+    std::vector<std::chrono::seconds> warnings;
+    bool evicted = false;
+
+    auto session = sweeper.add_session(
+        []{},
+        [&warnings, &evicted](auto remaining)
+        {
+            ASSERT_FALSE(evicted);
+            warnings.push_back(remaining);
+        },
+        [&evicted]{ evicted = true; });
+
+    run_for(io_service, 225ms);
+
+    ASSERT_TRUE(evicted);
+    ASSERT_EQ(1u, warnings.size());
+    ASSERT_LE(warnings[0].count(), 1);
+
+    auto const stats = sweeper.get_statistics();
+    ASSERT_EQ(1u, stats.warned);
+    ASSERT_EQ(1u, stats.evicted);
+}
+
+//* =========================================================================
+//  A session that has been destroyed is neither called nor counted.
+//* =========================================================================
+TEST(idle_sweeper, test_forgets_destroyed_sessions)
+{
+    boost::asio::io_service io_service;
+    paradice::idle_sweeper sweeper(io_service, short_settings());
+
+    bool called = false;
+    auto session = sweeper.add_session(
+        [&called]{ called = true; },
+        [&called](auto){ called = true; },
+        [&called]{ called = true; });
+
+    ASSERT_EQ(1u, sweeper.get_statistics().sessions);
+
+    session.reset();
+    run_for(io_service, 75ms);
+
+    ASSERT_FALSE(called);
+    ASSERT_EQ(0u, sweeper.get_statistics().sessions);
+}
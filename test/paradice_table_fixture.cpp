@@ -0,0 +1,162 @@
+#include "paradice/table.hpp"
+#include "paradice/active_encounter.hpp"
+#include "paradice/beast.hpp"
+#include <boost/asio/io_service.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+void add_beast_named(
+    std::shared_ptr<paradice::table> const &tbl
+  , std::string const                      &name)
+{
+    auto bst = std::make_shared<paradice::beast>();
+    bst->set_name(name);
+
+    tbl->modify_encounter(
+        [bst](auto const &enc)
+        {
+            paradice::add_beast(enc, bst);
+        });
+}
+
+}
+
+TEST(table, encounter_is_modified_on_the_strand)
+{
+    boost::asio::io_service io_service;
+    auto tbl = std::make_shared<paradice::table>(
+        std::ref(io_service), "dungeon");
+
+    std::vector<std::shared_ptr<paradice::active_encounter const>> snapshots;
+    tbl->on_encounter_changed.connect(
+        [&snapshots](auto const &snapshot)
+        {
+            snapshots.push_back(snapshot);
+        });
+
+    add_beast_named(tbl, "orc");
+    ASSERT_TRUE(tbl->get_encounter()->entries_.empty());
+
+    io_service.run();
+
+    ASSERT_EQ(1u, snapshots.size());
+    ASSERT_EQ(1u, tbl->get_encounter()->entries_.size());
+    ASSERT_EQ(snapshots.back(), tbl->get_encounter());
+}
+
+TEST(table, snapshots_are_not_altered_by_later_changes)
+{
+    boost::asio::io_service io_service;
+    auto tbl = std::make_shared<paradice::table>(
+        std::ref(io_service), "dungeon");
+
+    add_beast_named(tbl, "orc");
+    io_service.run();
+    io_service.reset();
+
+    auto const snapshot = tbl->get_encounter();
+
+    add_beast_named(tbl, "goblin");
+    io_service.run();
+
+    ASSERT_EQ(1u, snapshot->entries_.size());
+    ASSERT_EQ(2u, tbl->get_encounter()->entries_.size());
+    ASSERT_EQ(snapshot->identity_, tbl->get_encounter()->identity_);
+}
+
+TEST(table, unaltered_encounter_is_not_republished)
+{
+    boost::asio::io_service io_service;
+    auto tbl = std::make_shared<paradice::table>(
+        std::ref(io_service), "dungeon");
+
+    odin::u32 changes = 0;
+    tbl->on_encounter_changed.connect(
+        [&changes](auto const &)
+        {
+            ++changes;
+        });
+
+    auto const snapshot = tbl->get_encounter();
+
+    tbl->modify_encounter(
+        [](auto const &enc)
+        {
+            paradice::remove_participant(enc, 1);
+        });
+    io_service.run();
+
+    ASSERT_EQ(0u, changes);
+    ASSERT_EQ(snapshot, tbl->get_encounter());
+}
+
+TEST(table, tables_have_separate_encounters_and_rolls)
+{
+    boost::asio::io_service io_service;
+    auto first = std::make_shared<paradice::table>(
+        std::ref(io_service), "first");
+    auto second = std::make_shared<paradice::table>(
+        std::ref(io_service), "second");
+
+    add_beast_named(first, "orc");
+
+    paradice::roll_data data;
+    data.name      = "bob";
+    data.roll_text = "1d20";
+    data.raw_score = 12;
+    data.score     = 12;
+    data.max_roll  = false;
+    first->add_roll("initiative", data);
+
+    io_service.run();
+
+    ASSERT_EQ(1u, first->get_encounter()->entries_.size());
+    ASSERT_TRUE(second->get_encounter()->entries_.empty());
+    ASSERT_NE(
+        first->get_encounter()->identity_,
+        second->get_encounter()->identity_);
+
+    ASSERT_EQ(1u, first->get_rolls("initiative").size());
+    ASSERT_TRUE(second->get_rolls("initiative").empty());
+
+    first->clear_rolls("initiative");
+    ASSERT_TRUE(first->get_rolls("initiative").empty());
+}
+
+TEST(table, encounter_rolls_are_bounded_by_the_settings)
+{
+    boost::asio::io_service io_service;
+
+    paradice::table_settings settings;
+    settings.max_encounter_rolls = 2;
+
+    auto tbl = std::make_shared<paradice::table>(
+        std::ref(io_service), "dungeon", settings);
+
+    ASSERT_EQ(2u, tbl->get_encounter()->max_rolls_);
+}
+
+TEST(table, visibility_is_set_on_the_strand)
+{
+    boost::asio::io_service io_service;
+    auto tbl = std::make_shared<paradice::table>(
+        std::ref(io_service), "dungeon");
+
+    std::vector<bool> visibilities;
+    tbl->on_encounter_visibility_changed.connect(
+        [&visibilities](bool visible)
+        {
+            visibilities.push_back(visible);
+        });
+
+    tbl->set_encounter_visible(true);
+    ASSERT_FALSE(tbl->is_encounter_visible());
+
+    io_service.run();
+
+    ASSERT_TRUE(tbl->is_encounter_visible());
+    ASSERT_EQ(std::vector<bool>{true}, visibilities);
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_RUN_FOR_HPP_
+#define TEST_RUN_FOR_HPP_
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+
+//* =========================================================================
+//  Runs the io_service for the given time, then leaves it ready to be run
+//  again.
+//* =========================================================================
+inline void run_for(
+    boost::asio::io_service   &io_service,
+    std::chrono::milliseconds  time)
+{
+    boost::asio::steady_timer timer(io_service);
+    timer.expires_from_now(time);
+    timer.async_wait([&io_service](auto const &){ io_service.stop(); });
+
+    io_service.run();
+    io_service.reset();
+}
+
+#endif